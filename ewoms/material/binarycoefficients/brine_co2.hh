@@ -43,6 +43,201 @@ class Brine_CO2 {
     static const int gasPhaseIdx = 1; // index of the gas phase
 
 public:
+    /*!
+     * \brief The quantities of the mutual solubility model of brine and CO2 for a
+     *        given temperature, gas phase pressure and salinity.
+     *
+     * The mutual solubilities depend on the fugacity coefficients of CO2 and H2O, which
+     * in turn depend on the same molar volume of CO2 and on the same Redlich-Kwong terms.
+     * This class evaluates all of these intermediate quantities exactly once. Also, the
+     * solubilities are often requested several times for the same conditions, e.g., for
+     * the gas dissolution factor and the formation volume factor of the same cell or for
+     * the fugacity coefficients of both components. update() thus does nothing if the
+     * temperature, the pressure and the salinity are the same as for the last call. To
+     * profit from this, the context must be kept by the caller, e.g., in the parameter
+     * cache of a fluid system.
+     */
+    template <class Evaluation>
+    class SolubilityContext
+    {
+    public:
+        SolubilityContext()
+            : salinity_(0.0)
+            , fugacityCoefficientsValid_(false)
+            , isValid_(false)
+        {}
+
+        /*!
+         * \brief Compute the fugacity coefficients of CO2 and H2O for a given
+         *        temperature [K] and gas phase pressure [Pa].
+         *
+         * The mutual solubilities are not computed by this method, i.e., afterwards
+         * only the fugacity coefficients may be accessed.
+         */
+        void updateFugacityCoefficients(const Evaluation& temperature, const Evaluation& pg)
+        {
+            if (fugacityCoefficientsValid_
+                && temperature == temperature_
+                && pg == pressure_)
+                return;
+
+            temperature_ = temperature;
+            pressure_ = pg;
+            fugacityCoefficientsValid_ = true;
+            isValid_ = false;
+
+            // fugacity coefficients according to Spycher, Pruess and Ennis-King (2003)
+            const Scalar b_CO2 = 27.8; // mixture parameter of Redlich-Kwong equation
+            const Scalar b_H2O = 18.18; // mixture parameter of Redlich-Kwong equation
+            const Scalar a_CO2_H2O = 7.89e7; // mixture parameter of Redlich-Kwong equation
+            const Scalar R = IdealGas::R * 10.; // ideal gas constant with unit bar cm^3 /(K mol)
+
+            const Evaluation& V = 1 / (CO2::gasDensity(temperature, pg) / CO2::molarMass()) * 1.e6; // molar volume in cm^3/mol
+            const Evaluation& pg_bar = pg / 1.e5; // gas phase pressure in bar
+            const Evaluation& a_CO2 = (7.54e7 - 4.13e4 * temperature); // mixture parameter of  Redlich-Kwong equation
+            const Evaluation& RT15 = R*Ewoms::pow(temperature, 1.5);
+            const Evaluation& logVb = Ewoms::log((V + b_CO2)/V);
+            const Evaluation& commonTerms =
+                Ewoms::log(V/(V - b_CO2)) - Ewoms::log(pg_bar*V/(R*temperature));
+            const Evaluation& rkTerm = (logVb - b_CO2/(V + b_CO2))/(RT15*b_CO2*b_CO2);
+
+            const Evaluation& lnPhiCO2 =
+                commonTerms
+                + b_CO2/(V - b_CO2)
+                - 2*a_CO2/(RT15*b_CO2)*logVb
+                + a_CO2*b_CO2*rkTerm;
+            const Evaluation& lnPhiH2O =
+                commonTerms
+                + b_H2O/(V - b_CO2)
+                - 2*a_CO2_H2O/(RT15*b_CO2)*logVb
+                + a_CO2*b_H2O*rkTerm;
+            phiCO2_ = Ewoms::exp(lnPhiCO2);
+            phiH2O_ = Ewoms::exp(lnPhiH2O);
+        }
+
+        /*!
+         * \brief Compute the mutual solubilities for a given temperature [K], gas
+         *        phase pressure [Pa] and salinity [kg NaCl / kg solution].
+         */
+        void update(const Evaluation& temperature, const Evaluation& pg, Scalar salinity)
+        {
+            if (isValid_
+                && salinity == salinity_
+                && temperature == temperature_
+                && pg == pressure_)
+                return;
+
+            updateFugacityCoefficients(temperature, pg);
+            salinity_ = salinity;
+            isValid_ = true;
+
+            const Scalar R = IdealGas::R * 10.; // ideal gas constant with unit bar cm^3 /(K mol)
+            const Evaluation& pg_bar = pg / 1.e5; // gas phase pressure in bar
+
+            // the parameters A and B of the mutual solubility in the water-CO2 system
+            const Evaluation& deltaP = pg_bar - 1; // pressure range [bar] from p0 = 1bar to pg[bar]
+            const Scalar v_av_H2O = 18.1; // average partial molar volume of H2O [cm^3/mol]
+            const Scalar v_av_CO2 = 32.6; // average partial molar volume of CO2 [cm^3/mol]
+            const Evaluation& RT = R*temperature;
+            A_ = equilibriumConstantH2O_(temperature)/(phiH2O_*pg_bar)*Ewoms::exp(deltaP*v_av_H2O/RT);
+            B_ = phiCO2_*pg_bar/(55.508*equilibriumConstantCO2_(temperature))*Ewoms::exp(-(deltaP*v_av_CO2)/RT);
+
+            // molality of CO2 in pure water
+            const Evaluation& yH2OinGas = (1 - B_) / (1. / A_ - B_); // equilibrium mol fraction of H2O in the gas phase
+            const Evaluation& xCO2inWater = B_ * (1 - yH2OinGas); // equilibrium mol fraction of CO2 in the water phase
+            const Evaluation& m0_CO2 = (xCO2inWater * 55.508) / (1 - xCO2inWater);
+
+            // the salt reduces the solubility of CO2 (Duan and Sun 2003)
+            x_NaCl_ = salinityToMolFrac_(salinity);
+            Scalar molalityNaCl = moleFracToMolality_(x_NaCl_);
+            const Evaluation& gammaStar = activityCoefficient_(temperature, pg, molalityNaCl);
+            const Evaluation& m_CO2 = m0_CO2 / gammaStar; // molality of CO2 in brine
+            xlCO2_ = m_CO2 / (molalityNaCl + 55.508 + m_CO2); // mole fraction of CO2 in brine
+            ygH2O_ = A_ * (1 - xlCO2_ - x_NaCl_); // mole fraction of water in the gas phase
+        }
+
+        //! The temperature [K] for which the context was computed
+        const Evaluation& temperature() const
+        { return temperature_; }
+
+        //! The gas phase pressure [Pa] for which the context was computed
+        const Evaluation& pressure() const
+        { return pressure_; }
+
+        //! The salinity [kg NaCl / kg solution] for which the context was computed
+        Scalar salinity() const
+        { return salinity_; }
+
+        //! Returns true if the mutual solubilities have been computed
+        bool isValid() const
+        { return isValid_; }
+
+        //! The fugacity coefficient of CO2 in the water-CO2 mixture
+        const Evaluation& fugacityCoefficientCO2() const
+        { return phiCO2_; }
+
+        //! The fugacity coefficient of H2O in the water-CO2 mixture
+        const Evaluation& fugacityCoefficientH2O() const
+        { return phiH2O_; }
+
+        //! The parameter A of Spycher, Pruess and Ennis-King (2003)
+        const Evaluation& A() const
+        { return A_; }
+
+        //! The parameter B of Spycher, Pruess and Ennis-King (2003)
+        const Evaluation& B() const
+        { return B_; }
+
+        //! The mole fraction of NaCl in brine [mol/mol]
+        Scalar moleFractionNaCl() const
+        { return x_NaCl_; }
+
+        //! The mole fraction of CO2 in brine [mol/mol] if both phases are present
+        const Evaluation& xlCO2() const
+        { return xlCO2_; }
+
+        //! The mole fraction of water in the gas phase [mol/mol] if both phases are present
+        const Evaluation& ygH2O() const
+        { return ygH2O_; }
+
+    private:
+        Evaluation temperature_;
+        Evaluation pressure_;
+        Scalar salinity_;
+        bool fugacityCoefficientsValid_;
+        bool isValid_;
+
+        Evaluation phiCO2_;
+        Evaluation phiH2O_;
+        Evaluation A_;
+        Evaluation B_;
+        Scalar x_NaCl_;
+        Evaluation xlCO2_;
+        Evaluation ygH2O_;
+    };
+
+    /*!
+     * \brief Returns the solubility context for a given temperature, gas phase pressure
+     *        and salinity.
+     *
+     * The context is owned by the caller. If the mutual solubilities are needed several
+     * times for the same conditions, the caller should keep the context and pass it to
+     * calculateMoleFractions() instead of calling this method again.
+     *
+     * \param temperature the temperature [K]
+     * \param pg the gas phase pressure [Pa]
+     * \param salinity the salinity [kg NaCl / kg solution]
+     */
+    template <class Evaluation>
+    static SolubilityContext<Evaluation> solubilityContext(const Evaluation& temperature,
+                                                           const Evaluation& pg,
+                                                           Scalar salinity)
+    {
+        SolubilityContext<Evaluation> context;
+        context.update(temperature, pg, salinity);
+        return context;
+    }
+
     /*!
      * \brief Binary diffusion coefficent [m^2/s] of water in the CO2 phase.
      *
@@ -99,20 +294,37 @@ public:
                                        Evaluation& xlCO2,
                                        Evaluation& ygH2O)
     {
-        Evaluation A = computeA_(temperature, pg);
+        calculateMoleFractions(solubilityContext(temperature, pg, salinity),
+                               knownPhaseIdx,
+                               xlCO2,
+                               ygH2O);
+    }
 
-        /* salinity: conversion from mass fraction to mol fraction */
-        Scalar x_NaCl = salinityToMolFrac_(salinity);
+    /*!
+     * \brief Returns the _mol_ (!) fraction of CO2 in the liquid
+     *        phase and the mol_ (!) fraction of H2O in the gas phase
+     *        using a solubility context.
+     *
+     * \param context the solubility context for the temperature, the gas phase pressure
+     *                and the salinity
+     * \param knownPhaseIdx indicates which phases are present
+     * \param xlCO2 mole fraction of CO2 in brine [mol/mol]
+     * \param ygH2O mole fraction of water in the gas phase [mol/mol]
+     */
+    template <class Evaluation>
+    static void calculateMoleFractions(const SolubilityContext<Evaluation>& context,
+                                       const int knownPhaseIdx,
+                                       Evaluation& xlCO2,
+                                       Evaluation& ygH2O)
+    {
+        const Evaluation& A = context.A();
+        Scalar x_NaCl = context.moleFractionNaCl();
 
         // if both phases are present the mole fractions in each phase can be calculate
         // with the mutual solubility function
         if (knownPhaseIdx < 0) {
-            Scalar molalityNaCl = moleFracToMolality_(x_NaCl); // molality of NaCl //CHANGED
-            Evaluation m0_CO2 = molalityCO2inPureWater_(temperature, pg); // molality of CO2 in pure water
-            Evaluation gammaStar = activityCoefficient_(temperature, pg, molalityNaCl);// activity coefficient of CO2 in brine
-            Evaluation m_CO2 = m0_CO2 / gammaStar; // molality of CO2 in brine
-            xlCO2 = m_CO2 / (molalityNaCl + 55.508 + m_CO2); // mole fraction of CO2 in brine
-            ygH2O = A * (1 - xlCO2 - x_NaCl); // mole fraction of water in the gas phase
+            xlCO2 = context.xlCO2();
+            ygH2O = context.ygH2O();
         }
 
         // if only liquid phase is present the mole fraction of CO2 in brine is given and
@@ -150,27 +362,9 @@ public:
         Valgrind::CheckDefined(temperature);
         Valgrind::CheckDefined(pg);
 
-        Evaluation V = 1 / (CO2::gasDensity(temperature, pg) / CO2::molarMass()) * 1.e6; // molar volume in cm^3/mol
-        Evaluation pg_bar = pg / 1.e5; // gas phase pressure in bar
-        Evaluation a_CO2 = (7.54e7 - 4.13e4 * temperature); // mixture parameter of  Redlich-Kwong equation
-        Scalar b_CO2 = 27.8; // mixture parameter of Redlich-Kwong equation
-        Scalar R = IdealGas::R * 10.; // ideal gas constant with unit bar cm^3 /(K mol)
-        Evaluation lnPhiCO2;
-
-        lnPhiCO2 = Ewoms::log(V / (V - b_CO2));
-        lnPhiCO2 += b_CO2 / (V - b_CO2);
-        lnPhiCO2 -= 2 * a_CO2 / (R * Ewoms::pow(temperature, 1.5) * b_CO2) * log((V + b_CO2) / V);
-        lnPhiCO2 +=
-            a_CO2 * b_CO2
-            / (R
-               * Ewoms::pow(temperature, 1.5)
-               * b_CO2
-               * b_CO2)
-            * (Ewoms::log((V + b_CO2) / V)
-               - b_CO2 / (V + b_CO2));
-        lnPhiCO2 -= Ewoms::log(pg_bar * V / (R * temperature));
-
-        return Ewoms::exp(lnPhiCO2); // fugacity coefficient of CO2
+        SolubilityContext<Evaluation> context;
+        context.updateFugacityCoefficients(temperature, pg);
+        return context.fugacityCoefficientCO2();
     }
 
     /*!
@@ -184,23 +378,9 @@ public:
     template <class Evaluation>
     static Evaluation fugacityCoefficientH2O(const Evaluation& temperature, const Evaluation& pg)
     {
-        const Evaluation& V = 1 / (CO2::gasDensity(temperature, pg) / CO2::molarMass()) * 1.e6; // molar volume in cm^3/mol
-        const Evaluation& pg_bar = pg / 1.e5; // gas phase pressure in bar
-        const Evaluation& a_CO2 = (7.54e7 - 4.13e4 * temperature);// mixture parameter of  Redlich-Kwong equation
-        Scalar a_CO2_H2O = 7.89e7;// mixture parameter of Redlich-Kwong equation
-        Scalar b_CO2 = 27.8;// mixture parameter of Redlich-Kwong equation
-        Scalar b_H2O = 18.18;// mixture parameter of Redlich-Kwong equation
-        Scalar R = IdealGas::R * 10.; // ideal gas constant with unit bar cm^3 /(K mol)
-        Evaluation lnPhiH2O;
-
-        lnPhiH2O =
-            Ewoms::log(V/(V - b_CO2))
-            + b_H2O/(V - b_CO2) - 2*a_CO2_H2O
-            / (R*Ewoms::pow(temperature, 1.5)*b_CO2)*Ewoms::log((V + b_CO2)/V)
-            + a_CO2*b_H2O/(R*Ewoms::pow(temperature, 1.5)*b_CO2*b_CO2)
-            *(Ewoms::log((V + b_CO2)/V) - b_CO2/(V + b_CO2))
-            - Ewoms::log(pg_bar*V/(R*temperature));
-        return Ewoms::exp(lnPhiH2O); // fugacity coefficient of H2O
+        SolubilityContext<Evaluation> context;
+        context.updateFugacityCoefficients(temperature, pg);
+        return context.fugacityCoefficientH2O();
     }
 
 private:
@@ -231,23 +411,6 @@ private:
         return 55.508 * x_NaCl / (1 - x_NaCl);
     }
 
-    /*!
-     * \brief Returns the equilibrium molality of CO2 (mol CO2 / kg water) for a
-     * CO2-water mixture at a given pressure and temperature
-     *
-     * \param temperature The temperature [K]
-     * \param pg The gas phase pressure [Pa]
-     */
-    template <class Evaluation>
-    static Evaluation molalityCO2inPureWater_(const Evaluation& temperature, const Evaluation& pg)
-    {
-        const Evaluation& A = computeA_(temperature, pg); // according to Spycher, Pruess and Ennis-King (2003)
-        const Evaluation& B = computeB_(temperature, pg); // according to Spycher, Pruess and Ennis-King (2003)
-        const Evaluation& yH2OinGas = (1 - B) / (1. / A - B); // equilibrium mol fraction of H2O in the gas phase
-        const Evaluation& xCO2inWater = B * (1 - yH2OinGas); // equilibrium mol fraction of CO2 in the water phase
-        return (xCO2inWater * 55.508) / (1 - xCO2inWater); // CO2 molality
-    }
-
     /*!
      * \brief Returns the activity coefficient of CO2 in brine for a
      *           molal description. According to "Duan and Sun 2003"
@@ -269,46 +432,6 @@ private:
         return Ewoms::exp(lnGammaStar);
     }
 
-    /*!
-     * \brief Returns the paramater A for the calculation of
-     * them mutual solubility in the water-CO2 system.
-     * Given in Spycher, Pruess and Ennis-King (2003)
-     *
-     * \param T the temperature [K]
-     * \param pg the gas phase pressure [Pa]
-     */
-    template <class Evaluation>
-    static Evaluation computeA_(const Evaluation& temperature, const Evaluation& pg)
-    {
-        const Evaluation& deltaP = pg / 1e5 - 1; // pressure range [bar] from p0 = 1bar to pg[bar]
-        Scalar v_av_H2O = 18.1; // average partial molar volume of H2O [cm^3/mol]
-        Scalar R = IdealGas::R * 10;
-        const Evaluation& k0_H2O = equilibriumConstantH2O_(temperature); // equilibrium constant for H2O at 1 bar
-        const Evaluation& phi_H2O = fugacityCoefficientH2O(temperature, pg); // fugacity coefficient of H2O for the water-CO2 system
-        const Evaluation& pg_bar = pg / 1.e5;
-        return k0_H2O/(phi_H2O*pg_bar)*Ewoms::exp(deltaP*v_av_H2O/(R*temperature));
-    }
-
-    /*!
-     * \brief Returns the paramater B for the calculation of
-     * the mutual solubility in the water-CO2 system.
-     * Given in Spycher, Pruess and Ennis-King (2003)
-     *
-     * \param temperature the temperature [K]
-     * \param pg the gas phase pressure [Pa]
-     */
-    template <class Evaluation>
-    static Evaluation computeB_(const Evaluation& temperature, const Evaluation& pg)
-    {
-        const Evaluation& deltaP = pg / 1e5 - 1; // pressure range [bar] from p0 = 1bar to pg[bar]
-        const Scalar v_av_CO2 = 32.6; // average partial molar volume of CO2 [cm^3/mol]
-        const Scalar R = IdealGas::R * 10;
-        const Evaluation& k0_CO2 = equilibriumConstantCO2_(temperature); // equilibrium constant for CO2 at 1 bar
-        const Evaluation& phi_CO2 = fugacityCoefficientCO2(temperature, pg); // fugacity coefficient of CO2 for the water-CO2 system
-        const Evaluation& pg_bar = pg / 1.e5;
-        return phi_CO2*pg_bar/(55.508*k0_CO2)*Ewoms::exp(-(deltaP*v_av_CO2)/(R*temperature));
-    }
-
     /*!
      * \brief Returns the parameter lambda, which is needed for the
      * calculation of the CO2 activity coefficient in the brine-CO2 system.
@@ -31,6 +31,44 @@
 namespace Ewoms {
 namespace BinaryCoeff {
 
+/*!
+ * \ingroup Binarycoefficients
+ * \brief The temperature and pressure independent part of the binary diffusion
+ *        coefficient according to the method by Fuller.
+ *
+ * \param M molar masses \f$\mathrm{[g/mol]}\f$
+ * \param SigmaNu atomic diffusion volume
+ *
+ * Multiplying this coefficient with \f$T^{1.75}/p\f$ yields the diffusion
+ * coefficient \f$\mathrm{[m^2/s]}\f$. Since it only depends on the properties of the
+ * components, it can be computed once per pair of components.
+ */
+template <class Scalar>
+inline Scalar fullerMethodCoefficient(const Scalar* M, // molar masses [g/mol]
+                                      const Scalar* SigmaNu) // atomic diffusion volume
+{
+    // "effective" molar mass in [g/m^3]
+    Scalar Mab = Ewoms::harmonicMean(M[0], M[1]);
+
+    Scalar tmp = std::pow(SigmaNu[0], 1./3) + std::pow(SigmaNu[1], 1./3);
+    return 1e-4 * 143.0/(std::sqrt(Mab)*tmp*tmp);
+}
+
+/*!
+ * \ingroup Binarycoefficients
+ * \brief Estimate binary diffusion coefficents \f$\mathrm{[m^2/s]}\f$ in gases
+ *        from the coefficient computed by fullerMethodCoefficient().
+ *
+ * \param coefficient The result of fullerMethodCoefficient() for the components
+ * \param temperature The temperature \f$\mathrm{[K]}\f$
+ * \param pressure phase pressure \f$\mathrm{[Pa]}\f$
+ */
+template <class Scalar, class Evaluation = Scalar>
+inline Evaluation fullerMethod(Scalar coefficient,
+                               const Evaluation& temperature, // [K]
+                               const Evaluation& pressure) // [Pa]
+{ return coefficient*Ewoms::pow(temperature, 1.75)/pressure; }
+
 /*!
  * \ingroup Binarycoefficients
  * \brief Estimate binary diffusion coefficents \f$\mathrm{[m^2/s]}\f$ in gases according to
@@ -53,14 +91,7 @@ inline Evaluation fullerMethod(const Scalar* M, // molar masses [g/mol]
                                const Scalar* SigmaNu, // atomic diffusion volume
                                const Evaluation& temperature, // [K]
                                const Evaluation& pressure) // [Pa]
-{
-    // "effective" molar mass in [g/m^3]
-    Scalar Mab = Ewoms::harmonicMean(M[0], M[1]);
-
-    // Fuller's method
-    const Evaluation& tmp = std::pow(SigmaNu[0], 1./3) + std::pow(SigmaNu[1], 1./3);
-    return 1e-4 * (143.0*Ewoms::pow(temperature, 1.75))/(pressure*std::sqrt(Mab)*tmp*tmp);
-}
+{ return fullerMethod(fullerMethodCoefficient(M, SigmaNu), temperature, pressure); }
 
 } // namespace BinaryCoeff
 } // namespace Ewoms
@@ -73,11 +73,13 @@ public:
         typedef Ewoms::SimpleCO2<Scalar> CO2;
 
         // atomic diffusion volumes
-        const Scalar SigmaNu[2] = { 13.1 /* H2O */,  26.9 /* CO2 */ };
+        static const Scalar SigmaNu[2] = { 13.1 /* H2O */,  26.9 /* CO2 */ };
         // molar masses [g/mol]
-        const Scalar M[2] = { H2O::molarMass()*1e3, CO2::molarMass()*1e3 };
+        static const Scalar M[2] = { H2O::molarMass()*1e3, CO2::molarMass()*1e3 };
+        // the coefficient only depends on the components, so compute it only once
+        static const Scalar coefficient = fullerMethodCoefficient(M, SigmaNu);
 
-        return fullerMethod(M, SigmaNu, temperature, pressure);
+        return fullerMethod(coefficient, temperature, pressure);
     }
 
     /*!
@@ -69,11 +69,13 @@ public:
         typedef Ewoms::N2<double> N2;
 
         // atomic diffusion volumes
-        const double SigmaNu[2] = { 13.1 /* H2O */,  18.5 /* N2 */ };
+        static const double SigmaNu[2] = { 13.1 /* H2O */,  18.5 /* N2 */ };
         // molar masses [g/mol]
-        const double M[2] = { H2O::molarMass()*1e3, N2::molarMass()*1e3 };
+        static const double M[2] = { H2O::molarMass()*1e3, N2::molarMass()*1e3 };
+        // the coefficient only depends on the components, so compute it only once
+        static const double coefficient = fullerMethodCoefficient(M, SigmaNu);
 
-        return fullerMethod(M, SigmaNu, temperature, pressure);
+        return fullerMethod(coefficient, temperature, pressure);
     }
 
     /*!
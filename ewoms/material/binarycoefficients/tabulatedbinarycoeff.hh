@@ -0,0 +1,219 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the eWoms project.
+
+  eWoms is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  eWoms is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with eWoms.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*!
+ * \file
+ * \copydoc Ewoms::BinaryCoeff::TabulatedBinaryCoeff
+ */
+#ifndef EWOMS_TABULATED_BINARY_COEFF_HH
+#define EWOMS_TABULATED_BINARY_COEFF_HH
+
+#include <ewoms/material/common/hermitetabulated1dfunction.hh>
+#include <ewoms/common/mathtoolbox.hh>
+
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace Ewoms {
+namespace BinaryCoeff {
+
+/*!
+ * \ingroup Binarycoefficients
+ * \brief Tabulates the temperature dependent binary coefficients of a pair of
+ *        components.
+ *
+ * The Henry coefficient and the binary diffusion coefficient in the gas phase are
+ * tabulated over temperature when init() is called. The gas phase diffusion
+ * coefficients are inversely proportional to pressure, so the product of the diffusion
+ * coefficient and the pressure is tabulated and the pressure dependence is applied
+ * analytically. Some correlations clamp the pressure, though. For this reason, init()
+ * checks that the tabulated product matches the untabulated coefficients at the bounds
+ * of the pressure range and discards the table if it does not. Outside of the
+ * tabulated temperature and pressure ranges and before init() has been called, the
+ * untabulated binary coefficients are used. Correlations which are clamped in
+ * temperature exhibit a kink which cannot be interpolated accurately, so the
+ * temperature range of their tables must end below the clamp.
+ *
+ * \tparam Scalar The type used for scalar values
+ * \tparam RawBinaryCoeff The binary coefficients which ought to be tabulated
+ */
+template <class Scalar, class RawBinaryCoeff>
+class TabulatedBinaryCoeff
+{
+    typedef Ewoms::HermiteTabulated1DFunction<Scalar> TabulatedFunction;
+
+public:
+    /*!
+     * \brief Initialize the tables.
+     *
+     * \param tempMin The minimum of the temperature range in \f$\mathrm{[K]}\f$
+     * \param tempMax The maximum of the temperature range in \f$\mathrm{[K]}\f$. If it
+     *                is not larger than the minimum, nothing is tabulated.
+     * \param pressMin The minimum of the pressure range in \f$\mathrm{[Pa]}\f$
+     * \param pressMax The maximum of the pressure range in \f$\mathrm{[Pa]}\f$
+     * \param tolerance The tolerated interpolation error relative to the largest
+     *                  tabulated value
+     */
+    static void init(Scalar tempMin,
+                     Scalar tempMax,
+                     Scalar pressMin,
+                     Scalar pressMax,
+                     Scalar tolerance = std::sqrt(std::numeric_limits<Scalar>::epsilon()))
+    {
+        assert(pressMin < pressMax);
+
+        if (tempMin >= tempMax) {
+            henryTable_.clear();
+            gasDiffCoeffTable_.clear();
+            return;
+        }
+
+        // not all binary coefficients provide all quantities. these throw a
+        // std::runtime_error, are not tabulated and calling the respective method will
+        // throw the original exception.
+        try { henryTable_.init(HenryFunction_(), tempMin, tempMax, tolerance); }
+        catch (const std::runtime_error&) { henryTable_.clear(); }
+
+        try {
+            if (gasDiffCoeffTable_.init(GasDiffCoeffFunction_(), tempMin, tempMax, tolerance)
+                && !pressureScalingApplies_(tempMin, tempMax, pressMin, pressMax, tolerance))
+                gasDiffCoeffTable_.clear();
+        }
+        catch (const std::runtime_error&) { gasDiffCoeffTable_.clear(); }
+
+        pressMin_ = pressMin;
+        pressMax_ = pressMax;
+    }
+
+    /*!
+     * \brief Henry coefficent \f$\mathrm{[N/m^2]}\f$ of the second component in the
+     *        liquid phase of the first one.
+     */
+    template <class Evaluation>
+    static Evaluation henry(const Evaluation& temperature)
+    {
+        if (henryTable_.applies(Ewoms::scalarValue(temperature)))
+            return henryTable_.eval(temperature);
+
+        return RawBinaryCoeff::henry(temperature);
+    }
+
+    /*!
+     * \brief Binary diffusion coefficent \f$\mathrm{[m^2/s]}\f$ in the gas phase.
+     */
+    template <class Evaluation>
+    static Evaluation gasDiffCoeff(const Evaluation& temperature, const Evaluation& pressure)
+    {
+        if (gasDiffCoeffTable_.applies(Ewoms::scalarValue(temperature))
+            && pressMin_ <= Ewoms::scalarValue(pressure)
+            && Ewoms::scalarValue(pressure) <= pressMax_)
+            return gasDiffCoeffTable_.eval(temperature)/pressure;
+
+        return RawBinaryCoeff::gasDiffCoeff(temperature, pressure);
+    }
+
+    /*!
+     * \brief Binary diffusion coefficent \f$\mathrm{[m^2/s]}\f$ in the liquid phase.
+     *
+     * This quantity is not tabulated.
+     */
+    template <class Evaluation>
+    static Evaluation liquidDiffCoeff(const Evaluation& temperature, const Evaluation& pressure)
+    { return RawBinaryCoeff::liquidDiffCoeff(temperature, pressure); }
+
+    /*!
+     * \brief Returns the table for the Henry coefficient.
+     */
+    static const TabulatedFunction& henryTable()
+    { return henryTable_; }
+
+    /*!
+     * \brief Returns the table for the product of the gas phase diffusion coefficient
+     *        and the pressure.
+     */
+    static const TabulatedFunction& gasDiffCoeffTable()
+    { return gasDiffCoeffTable_; }
+
+private:
+    struct HenryFunction_
+    {
+        template <class Evaluation>
+        Evaluation operator()(const Evaluation& temperature) const
+        { return RawBinaryCoeff::henry(temperature); }
+    };
+
+    struct GasDiffCoeffFunction_
+    {
+        template <class Evaluation>
+        Evaluation operator()(const Evaluation& temperature) const
+        {
+            // the result does not depend on the reference pressure
+            const Scalar pRef = 1e5;
+            return RawBinaryCoeff::gasDiffCoeff(temperature, Evaluation(pRef))*pRef;
+        }
+    };
+
+    // returns true if the untabulated diffusion coefficient is inversely proportional
+    // to the pressure on the whole pressure range, i.e., if it is not clamped
+    static bool pressureScalingApplies_(Scalar tempMin,
+                                        Scalar tempMax,
+                                        Scalar pressMin,
+                                        Scalar pressMax,
+                                        Scalar tolerance)
+    {
+        const GasDiffCoeffFunction_ pD;
+        unsigned numTemp = gasDiffCoeffTable_.numSamples();
+        for (unsigned i = 0; i < numTemp; ++i) {
+            Scalar T = tempMin + (tempMax - tempMin)*i/(numTemp - 1);
+            Scalar pDRef = pD(T);
+
+            // the lower bound is only checked for positive pressures
+            if (pressMin > 0.0
+                && std::abs(RawBinaryCoeff::gasDiffCoeff(T, pressMin)*pressMin - pDRef)
+                > tolerance*std::abs(pDRef))
+                return false;
+
+            if (std::abs(RawBinaryCoeff::gasDiffCoeff(T, pressMax)*pressMax - pDRef)
+                > tolerance*std::abs(pDRef))
+                return false;
+        }
+
+        return true;
+    }
+
+    static TabulatedFunction henryTable_;
+    static TabulatedFunction gasDiffCoeffTable_;
+    static Scalar pressMin_;
+    static Scalar pressMax_;
+};
+
+template <class Scalar, class RawBinaryCoeff>
+HermiteTabulated1DFunction<Scalar> TabulatedBinaryCoeff<Scalar, RawBinaryCoeff>::henryTable_;
+template <class Scalar, class RawBinaryCoeff>
+HermiteTabulated1DFunction<Scalar> TabulatedBinaryCoeff<Scalar, RawBinaryCoeff>::gasDiffCoeffTable_;
+template <class Scalar, class RawBinaryCoeff>
+Scalar TabulatedBinaryCoeff<Scalar, RawBinaryCoeff>::pressMin_;
+template <class Scalar, class RawBinaryCoeff>
+Scalar TabulatedBinaryCoeff<Scalar, RawBinaryCoeff>::pressMax_;
+
+} // namespace BinaryCoeff
+} // namespace Ewoms
+
+#endif
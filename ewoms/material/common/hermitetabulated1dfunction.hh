@@ -0,0 +1,278 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the eWoms project.
+
+  eWoms is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  eWoms is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with eWoms.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*!
+ * \file
+ * \copydoc Ewoms::HermiteTabulated1DFunction
+ */
+#ifndef EWOMS_MATERIAL_HERMITE_TABULATED_1D_FUNCTION_HH
+#define EWOMS_MATERIAL_HERMITE_TABULATED_1D_FUNCTION_HH
+
+#include <ewoms/common/densead/evaluation.hh>
+#include <ewoms/common/densead/math.hh>
+#include <ewoms/common/mathtoolbox.hh>
+
+#include <vector>
+#include <algorithm>
+#include <type_traits>
+#include <cmath>
+#include <cassert>
+
+namespace Ewoms {
+
+/*!
+ * \brief A function of one variable which is tabulated on an equidistant grid and
+ *        interpolated using cubic Hermite polynomials.
+ *
+ * The table stores the value and the derivative of the function at each sampling point.
+ * The number of sampling points is doubled until the interpolation error at the
+ * quarter, middle and three-quarter points of each interval is below a given tolerance,
+ * i.e., the accuracy of the table is checked when it is created.
+ *
+ * If the table is evaluated for a function evaluation, the derivatives of the result
+ * are those of the interpolating polynomial, i.e., they are consistent with the
+ * tabulated values.
+ */
+template <class Scalar>
+class HermiteTabulated1DFunction
+{
+public:
+    HermiteTabulated1DFunction()
+    { clear(); }
+
+    /*!
+     * \brief Sample a function on the interval [xMin, xMax].
+     *
+     * The function object must provide a templated call operator which accepts
+     * arbitrary function evaluations. The tolerance is relative to the largest absolute
+     * value of the function on the sampling points. If the tolerance cannot be reached
+     * using at most maxSamples sampling points, the table is left empty and false is
+     * returned.
+     */
+    template <class Function>
+    bool init(const Function& f,
+              Scalar xMin,
+              Scalar xMax,
+              Scalar tolerance,
+              unsigned minSamples = 16,
+              unsigned maxSamples = 1 << 16)
+    { return init_(f, xMin, xMax, tolerance, minSamples, maxSamples, /*pointwise=*/false); }
+
+    /*!
+     * \brief Sample a function on the interval [xMin, xMax] with a pointwise relative
+     *        tolerance.
+     *
+     * This is the same as init(), but the interpolation error at each checked position
+     * is compared to the absolute value of the function at this position. This is
+     * required for functions which vary by orders of magnitude, e.g., vapor pressures.
+     * The function must not be zero on the interval. maxError() returns the largest
+     * relative error in this case.
+     */
+    template <class Function>
+    bool initRelative(const Function& f,
+                      Scalar xMin,
+                      Scalar xMax,
+                      Scalar tolerance,
+                      unsigned minSamples = 16,
+                      unsigned maxSamples = 1 << 16)
+    { return init_(f, xMin, xMax, tolerance, minSamples, maxSamples, /*pointwise=*/true); }
+
+    /*!
+     * \brief Remove all sampling points.
+     *
+     * Afterwards, the table does not apply to any value.
+     */
+    void clear()
+    {
+        xMin_ = 1.0;
+        xMax_ = -1.0;
+        invH_ = 0.0;
+        maxError_ = 0.0;
+        data_.clear();
+    }
+
+    /*!
+     * \brief Returns true if the table covers a given position.
+     */
+    bool applies(Scalar x) const
+    { return xMin_ <= x && x <= xMax_; }
+
+    /*!
+     * \brief Returns the number of sampling points.
+     */
+    unsigned numSamples() const
+    { return static_cast<unsigned>(data_.size()/2); }
+
+    /*!
+     * \brief Returns the largest interpolation error which was observed when the
+     *        table was created.
+     */
+    Scalar maxError() const
+    { return maxError_; }
+
+    /*!
+     * \brief Evaluate the interpolated function.
+     *
+     * The position must be covered by the table.
+     */
+    template <class Evaluation>
+    Evaluation eval(const Evaluation& x) const
+    {
+        // if no derivatives are required, only the value of the polynomial is computed
+        if (std::is_same<Evaluation, Scalar>::value)
+            return Evaluation(valueAt_(Ewoms::scalarValue(x)));
+
+        Scalar xv = Ewoms::scalarValue(x);
+        Scalar y;
+        Scalar dy_dx;
+        evalScalar_(xv, y, dy_dx);
+
+        // chain rule: the derivatives of the result w.r.t. the primary variables are
+        // those of x times the slope of the interpolating polynomial
+        return y + dy_dx*(x - xv);
+    }
+
+private:
+    template <class Function>
+    bool init_(const Function& f,
+               Scalar xMin,
+               Scalar xMax,
+               Scalar tolerance,
+               unsigned minSamples,
+               unsigned maxSamples,
+               bool pointwise)
+    {
+        assert(xMin < xMax);
+        assert(minSamples >= 2);
+
+        for (unsigned numSamples = minSamples; numSamples <= maxSamples; numSamples *= 2) {
+            sample_(f, xMin, xMax, numSamples);
+
+            Scalar maxValue = 1.0;
+            if (!pointwise) {
+                maxValue = 0.0;
+                for (unsigned i = 0; i < numSamples; ++i)
+                    maxValue = std::max(maxValue, std::abs(data_[2*i]));
+            }
+
+            Scalar error = computeMaxError_(f, pointwise);
+            if (error <= tolerance*maxValue) {
+                maxError_ = error;
+                return true;
+            }
+        }
+
+        clear();
+        return false;
+    }
+
+    template <class Function>
+    void sample_(const Function& f, Scalar xMin, Scalar xMax, unsigned numSamples)
+    {
+        typedef Ewoms::DenseAd::Evaluation<Scalar, 1> Eval;
+
+        xMin_ = xMin;
+        xMax_ = xMax;
+        Scalar h = (xMax - xMin)/(numSamples - 1);
+        invH_ = 1.0/h;
+
+        // values and derivatives are interleaved and the derivatives are pre-multiplied
+        // by the interval width
+        data_.resize(2*numSamples);
+        for (unsigned i = 0; i < numSamples; ++i) {
+            Scalar x = (i == numSamples - 1) ? xMax : xMin + i*h;
+            const Eval& y = f(Eval::createVariable(x, 0));
+            data_[2*i] = y.value();
+            data_[2*i + 1] = y.derivative(0)*h;
+        }
+    }
+
+    template <class Function>
+    Scalar computeMaxError_(const Function& f, bool pointwise) const
+    {
+        Scalar error = 0.0;
+        unsigned n = numSamples();
+        Scalar h = 1.0/invH_;
+        for (unsigned i = 0; i < n - 1; ++i) {
+            for (unsigned j = 1; j < 4; ++j) {
+                Scalar x = xMin_ + (i + 0.25*j)*h;
+                Scalar y = f(x);
+                Scalar delta = std::abs(valueAt_(x) - y);
+                if (pointwise)
+                    delta /= std::abs(y);
+                error = std::max(error, delta);
+            }
+        }
+        return error;
+    }
+
+    // returns the index of the interval which contains a position and the position
+    // within this interval, normalized to [0, 1]
+    unsigned findInterval_(Scalar x, Scalar& t) const
+    {
+        assert(applies(x));
+
+        Scalar u = (x - xMin_)*invH_;
+        unsigned i = std::min(static_cast<unsigned>(u), numSamples() - 2);
+        t = u - i;
+        return i;
+    }
+
+    // the polynomials are evaluated in Horner form. their coefficients in terms of the
+    // normalized position within the interval are
+    //
+    // c0 = y0, c1 = m0, c2 = 3*(y1 - y0) - 2*m0 - m1, c3 = 2*(y0 - y1) + m0 + m1
+    Scalar valueAt_(Scalar x) const
+    {
+        Scalar t;
+        const Scalar* p = &data_[2*findInterval_(x, t)];
+        Scalar y0 = p[0];
+        Scalar m0 = p[1];
+        Scalar y1 = p[2];
+        Scalar m1 = p[3];
+
+        Scalar c2 = 3*(y1 - y0) - 2*m0 - m1;
+        Scalar c3 = 2*(y0 - y1) + m0 + m1;
+        return y0 + t*(m0 + t*(c2 + t*c3));
+    }
+
+    void evalScalar_(Scalar x, Scalar& y, Scalar& dy_dx) const
+    {
+        Scalar t;
+        const Scalar* p = &data_[2*findInterval_(x, t)];
+        Scalar y0 = p[0];
+        Scalar m0 = p[1];
+        Scalar y1 = p[2];
+        Scalar m1 = p[3];
+
+        Scalar c2 = 3*(y1 - y0) - 2*m0 - m1;
+        Scalar c3 = 2*(y0 - y1) + m0 + m1;
+        y = y0 + t*(m0 + t*(c2 + t*c3));
+        dy_dx = (m0 + t*(2*c2 + 3*t*c3))*invH_;
+    }
+
+    Scalar xMin_;
+    Scalar xMax_;
+    Scalar invH_;
+    Scalar maxError_;
+    std::vector<Scalar> data_;
+};
+
+} // namespace Ewoms
+
+#endif
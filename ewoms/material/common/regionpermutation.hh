@@ -0,0 +1,189 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the eWoms project.
+
+  eWoms is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  eWoms is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with eWoms.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*!
+ * \file
+ * \copydoc Ewoms::RegionPermutation
+ */
+#ifndef EWOMS_MATERIAL_REGION_PERMUTATION_HH
+#define EWOMS_MATERIAL_REGION_PERMUTATION_HH
+
+#include <vector>
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <stdexcept>
+
+namespace Ewoms {
+
+/*!
+ * \brief A permutation of the cells of a grid which groups them by their region index.
+ *
+ * Saturation functions (SATNUM, IMBNUM) and PVT relations (PVTNUM) are tabulated per
+ * region, but the cells of the different regions are usually interleaved in grid
+ * order. Evaluating them in grid order thus hops between the tables of different
+ * regions. If the cells are instead processed region by region using this permutation,
+ * the tables of the current region stay in the CPU caches.
+ *
+ * The permutation is stable, i.e., the cells of each region are ordered in the same
+ * way as in the original array.
+ */
+class RegionPermutation
+{
+public:
+    typedef std::vector<unsigned>::const_iterator const_iterator;
+
+    RegionPermutation()
+    { regionOffsets_.push_back(0); }
+
+    /*!
+     * \brief Create the permutation from an array which contains the zero-based region
+     *        index of each cell.
+     */
+    template <class RegionArray>
+    explicit RegionPermutation(const RegionArray& regionArray)
+    { update(regionArray); }
+
+    /*!
+     * \brief Update the permutation from an array which contains the zero-based region
+     *        index of each cell.
+     *
+     * This uses a counting sort, i.e., its cost is linear in the number of cells.
+     */
+    template <class RegionArray>
+    void update(const RegionArray& regionArray)
+    {
+        const std::size_t numCells = regionArray.size();
+
+        // count the number of cells per region
+        std::size_t numRegions = 0;
+        for (std::size_t cellIdx = 0; cellIdx < numCells; ++cellIdx) {
+            if (static_cast<long long>(regionArray[cellIdx]) < 0)
+                throw std::invalid_argument("Region indices must not be negative");
+            numRegions = std::max<std::size_t>(numRegions, static_cast<std::size_t>(regionArray[cellIdx]) + 1);
+        }
+
+        regionOffsets_.assign(numRegions + 1, 0);
+        for (std::size_t cellIdx = 0; cellIdx < numCells; ++cellIdx)
+            ++ regionOffsets_[static_cast<std::size_t>(regionArray[cellIdx]) + 1];
+
+        for (std::size_t regionIdx = 0; regionIdx < numRegions; ++regionIdx)
+            regionOffsets_[regionIdx + 1] += regionOffsets_[regionIdx];
+
+        // distribute the cells to the regions
+        cells_.resize(numCells);
+        std::vector<std::size_t> nextPos(regionOffsets_.begin(), regionOffsets_.end() - 1);
+        for (std::size_t cellIdx = 0; cellIdx < numCells; ++cellIdx) {
+            std::size_t regionIdx = static_cast<std::size_t>(regionArray[cellIdx]);
+            cells_[nextPos[regionIdx]++] = static_cast<unsigned>(cellIdx);
+        }
+    }
+
+    /*!
+     * \brief Returns the total number of cells.
+     */
+    std::size_t size() const
+    { return cells_.size(); }
+
+    /*!
+     * \brief Returns the number of regions.
+     *
+     * This is the largest region index plus one, i.e., regions may be empty.
+     */
+    std::size_t numRegions() const
+    { return regionOffsets_.size() - 1; }
+
+    /*!
+     * \brief Returns the number of cells of a region.
+     */
+    std::size_t numCells(std::size_t regionIdx) const
+    {
+        assert(regionIdx < numRegions());
+        return regionOffsets_[regionIdx + 1] - regionOffsets_[regionIdx];
+    }
+
+    /*!
+     * \brief Returns the index of the cell at a given position of the permutation.
+     */
+    unsigned operator[](std::size_t pos) const
+    { return cells_[pos]; }
+
+    /*!
+     * \brief Returns the position of the first cell of a region within the permutation.
+     */
+    std::size_t regionOffset(std::size_t regionIdx) const
+    { return regionOffsets_[regionIdx]; }
+
+    /*!
+     * \brief Iterator to the index of the first cell of a region.
+     */
+    const_iterator regionBegin(std::size_t regionIdx) const
+    { return cells_.begin() + static_cast<std::ptrdiff_t>(regionOffsets_[regionIdx]); }
+
+    /*!
+     * \brief Iterator past the index of the last cell of a region.
+     */
+    const_iterator regionEnd(std::size_t regionIdx) const
+    { return cells_.begin() + static_cast<std::ptrdiff_t>(regionOffsets_[regionIdx + 1]); }
+
+    /*!
+     * \brief Iterator to the first cell of the permutation.
+     */
+    const_iterator begin() const
+    { return cells_.begin(); }
+
+    /*!
+     * \brief Iterator past the last cell of the permutation.
+     */
+    const_iterator end() const
+    { return cells_.end(); }
+
+    /*!
+     * \brief Copy the entries of a per-cell array to an array in which the cells are
+     *        ordered by region.
+     */
+    template <class DestArray, class SrcArray>
+    void gather(DestArray& dest, const SrcArray& src) const
+    {
+        assert(src.size() == size());
+        dest.resize(size());
+        for (std::size_t pos = 0; pos < cells_.size(); ++pos)
+            dest[pos] = src[cells_[pos]];
+    }
+
+    /*!
+     * \brief Copy the entries of an array in which the cells are ordered by region back to
+     *        a per-cell array.
+     */
+    template <class DestArray, class SrcArray>
+    void scatter(DestArray& dest, const SrcArray& src) const
+    {
+        assert(src.size() == size());
+        dest.resize(size());
+        for (std::size_t pos = 0; pos < cells_.size(); ++pos)
+            dest[cells_[pos]] = src[pos];
+    }
+
+private:
+    std::vector<unsigned> cells_;
+    std::vector<std::size_t> regionOffsets_;
+};
+
+} // namespace Ewoms
+
+#endif
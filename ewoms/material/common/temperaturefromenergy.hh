@@ -0,0 +1,179 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the eWoms project.
+
+  eWoms is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  eWoms is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with eWoms.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*!
+ * \file
+ * \copydoc Ewoms::TemperatureFromEnergy
+ */
+#ifndef EWOMS_MATERIAL_TEMPERATURE_FROM_ENERGY_HH
+#define EWOMS_MATERIAL_TEMPERATURE_FROM_ENERGY_HH
+
+#include <ewoms/common/densead/evaluation.hh>
+#include <ewoms/common/densead/math.hh>
+#include <ewoms/common/mathtoolbox.hh>
+#include <ewoms/common/exceptions.hh>
+
+#include <cmath>
+#include <limits>
+#include <sstream>
+#include <type_traits>
+
+namespace Ewoms {
+
+/*!
+ * \brief Computes the temperature at which the specific enthalpy or internal energy of
+ *        a fluid exhibits a given value.
+ *
+ * The energy must be strictly increasing with temperature, i.e., the heat capacity must
+ * be positive. The equation is solved for the scalar values using Newton's method which
+ * is safeguarded by bisection, i.e., the iterations never leave the bracket of
+ * temperatures which is specified by the caller. If the caller knows an approximate
+ * solution, e.g., the temperature of the last time step, it can be passed as the
+ * initial guess. Otherwise the iterations start in the middle of the bracket.
+ *
+ * The derivatives of the result are computed using the implicit function theorem,
+ * i.e., the energy needs to be evaluated only once using the caller's evaluation type.
+ *
+ * The function objects which compute the energy must provide a templated call
+ * operator which accepts the temperature and the pressure as arbitrary function
+ * evaluations.
+ */
+template <class Scalar>
+class TemperatureFromEnergy
+{
+    typedef Ewoms::DenseAd::Evaluation<Scalar, 1> TemperatureEvaluation;
+
+public:
+    /*!
+     * \brief The default relative tolerance of the temperature.
+     *
+     * The solution is refined by one additional Newton step, so the actual error is
+     * much smaller.
+     */
+    static Scalar defaultTolerance()
+    { return std::sqrt(std::numeric_limits<Scalar>::epsilon()); }
+
+    /*!
+     * \brief Returns the temperature in [temperatureMin, temperatureMax] for which a
+     *        single phase fluid exhibits a given specific energy.
+     *
+     * If the equation does not exhibit a solution within the bracket, a
+     * NumericalIssue exception is thrown.
+     */
+    template <class EnergyFunction, class Evaluation>
+    static Evaluation solve(const EnergyFunction& energyFn,
+                            const Evaluation& energy,
+                            const Evaluation& pressure,
+                            Scalar temperatureMin,
+                            Scalar temperatureMax,
+                            Scalar temperatureGuess = 0.0,
+                            Scalar tolerance = defaultTolerance())
+    {
+        const Scalar targetValue = Ewoms::scalarValue(energy);
+        const TemperatureEvaluation p(Ewoms::scalarValue(pressure));
+
+        Scalar lo = temperatureMin;
+        Scalar hi = temperatureMax;
+        Scalar T = temperatureGuess;
+        if (!(lo < T && T < hi))
+            T = (lo + hi)/2;
+
+        static const unsigned maxIterations = 100;
+        for (unsigned iterNum = 0; iterNum < maxIterations; ++iterNum) {
+            const TemperatureEvaluation& e =
+                energyFn(TemperatureEvaluation::createVariable(T, 0), p);
+            Scalar f = e.value() - targetValue;
+            Scalar df_dT = e.derivative(0);
+
+            if (f > 0.0)
+                hi = T;
+            else
+                lo = T;
+
+            if (df_dT > 0.0 && std::abs(f) <= tolerance*T*df_dT) {
+                // the last Newton step is also used to compute the derivatives of the
+                // result: dT = (de - de/dp*dp)/(de/dT)
+                if (std::is_same<Evaluation, Scalar>::value)
+                    return Evaluation(T - f/df_dT);
+
+                const Evaluation& e2 = energyFn(Evaluation(T), pressure);
+                return T + (energy - e2)/df_dT;
+            }
+
+            // if the bracket collapsed without converging, the solution is not within
+            // the bracket
+            if (hi - lo <= 1e-2*tolerance*T)
+                break;
+
+            // take a Newton step if it stays within the bracket. otherwise, bisect.
+            Scalar nextT = T - f/df_dT;
+            if (!(df_dT > 0.0) || !(lo < nextT && nextT < hi))
+                nextT = (lo + hi)/2;
+            T = nextT;
+        }
+
+        std::ostringstream oss;
+        oss << "Could not determine the temperature for a specific energy of " << targetValue
+            << " J/kg at a pressure of " << Ewoms::scalarValue(pressure) << " Pa within ["
+            << temperatureMin << ", " << temperatureMax << "] K";
+        throw NumericalIssue(oss.str());
+    }
+
+    /*!
+     * \brief Returns the temperature in [temperatureMin, temperatureMax] for which a
+     *        fluid which may change its phase exhibits a given specific energy.
+     *
+     * Below the saturation temperature, the fluid is liquid, above it is gaseous. If the
+     * energy is between the ones of the saturated liquid and of the saturated gas, both
+     * phases coexist and the result is the saturation temperature.
+     */
+    template <class LiquidEnergyFunction, class GasEnergyFunction, class Evaluation>
+    static Evaluation solveWithPhaseChange(const LiquidEnergyFunction& liquidEnergyFn,
+                                           const GasEnergyFunction& gasEnergyFn,
+                                           const Evaluation& energy,
+                                           const Evaluation& pressure,
+                                           const Evaluation& saturationTemperature,
+                                           Scalar temperatureMin,
+                                           Scalar temperatureMax,
+                                           Scalar temperatureGuess = 0.0,
+                                           Scalar tolerance = defaultTolerance())
+    {
+        Scalar Tsat = Ewoms::scalarValue(saturationTemperature);
+        if (Tsat >= temperatureMax)
+            return solve(liquidEnergyFn, energy, pressure, temperatureMin, temperatureMax,
+                         temperatureGuess, tolerance);
+        if (Tsat <= temperatureMin)
+            return solve(gasEnergyFn, energy, pressure, temperatureMin, temperatureMax,
+                         temperatureGuess, tolerance);
+
+        const Scalar p = Ewoms::scalarValue(pressure);
+        const Scalar e = Ewoms::scalarValue(energy);
+        if (e <= liquidEnergyFn(Tsat, p))
+            return solve(liquidEnergyFn, energy, pressure, temperatureMin, Tsat,
+                         temperatureGuess, tolerance);
+        if (e >= gasEnergyFn(Tsat, p))
+            return solve(gasEnergyFn, energy, pressure, Tsat, temperatureMax,
+                         temperatureGuess, tolerance);
+
+        return saturationTemperature;
+    }
+};
+
+} // namespace Ewoms
+
+#endif
@@ -25,6 +25,7 @@
 #define EWOMS_BRINE_HH
 
 #include <ewoms/material/components/component.hh>
+#include <ewoms/material/common/temperaturefromenergy.hh>
 #include <ewoms/common/mathtoolbox.hh>
 
 namespace Ewoms {
@@ -227,6 +228,66 @@ public:
             pressure/liquidDensity(temperature, pressure);
     }
 
+    /*!
+     * \brief The temperature \f$\mathrm{[K]}\f$ of brine at a given specific enthalpy
+     *        and pressure.
+     *
+     * Brine is only considered as a liquid, i.e., this is the same as
+     * liquidTemperatureFromEnthalpy().
+     */
+    template <class Evaluation>
+    static Evaluation temperatureFromEnthalpy(const Evaluation& enthalpy,
+                                              const Evaluation& pressure,
+                                              Scalar temperatureGuess = 0.0)
+    { return liquidTemperatureFromEnthalpy(enthalpy, pressure, temperatureGuess); }
+
+    /*!
+     * \brief The temperature \f$\mathrm{[K]}\f$ of brine at a given specific internal
+     *        energy and pressure.
+     *
+     * Brine is only considered as a liquid, i.e., this is the same as
+     * liquidTemperatureFromInternalEnergy().
+     */
+    template <class Evaluation>
+    static Evaluation temperatureFromInternalEnergy(const Evaluation& internalEnergy,
+                                                    const Evaluation& pressure,
+                                                    Scalar temperatureGuess = 0.0)
+    { return liquidTemperatureFromInternalEnergy(internalEnergy, pressure, temperatureGuess); }
+
+    /*!
+     * \brief The temperature \f$\mathrm{[K]}\f$ of liquid brine at a given specific
+     *        enthalpy and pressure.
+     *
+     * This is the inverse of liquidEnthalpy(). See Ewoms::TemperatureFromEnergy for
+     * details.
+     */
+    template <class Evaluation>
+    static Evaluation liquidTemperatureFromEnthalpy(const Evaluation& enthalpy,
+                                                    const Evaluation& pressure,
+                                                    Scalar temperatureGuess = 0.0)
+    {
+        return TemperatureFromEnergy<Scalar>::solve(LiquidEnthalpyFunction_(), enthalpy, pressure,
+                                                    tripleTemperature(), maxTemperature_(),
+                                                    temperatureGuess);
+    }
+
+    /*!
+     * \brief The temperature \f$\mathrm{[K]}\f$ of liquid brine at a given specific
+     *        internal energy and pressure.
+     *
+     * This is the inverse of liquidInternalEnergy(). See Ewoms::TemperatureFromEnergy for
+     * details.
+     */
+    template <class Evaluation>
+    static Evaluation liquidTemperatureFromInternalEnergy(const Evaluation& internalEnergy,
+                                                          const Evaluation& pressure,
+                                                          Scalar temperatureGuess = 0.0)
+    {
+        return TemperatureFromEnergy<Scalar>::solve(LiquidInternalEnergyFunction_(), internalEnergy, pressure,
+                                                    tripleTemperature(), maxTemperature_(),
+                                                    temperatureGuess);
+    }
+
     /*!
      * \copydoc H2O::gasDensity
      */
@@ -243,11 +304,30 @@ public:
      */
     template <class Evaluation>
     static Evaluation liquidDensity(const Evaluation& temperature, const Evaluation& pressure)
+    {
+        const Evaluation& rhow = H2O::liquidDensity(temperature, pressure);
+        return liquidDensityFromWater(temperature, pressure, rhow);
+    }
+
+    /*!
+     * \brief The density of brine given the density of pure water at the same
+     *        temperature and pressure.
+     *
+     * This allows code which needs both densities to evaluate the one of pure water
+     * only once.
+     *
+     * \param temperature temperature of component in \f$\mathrm{[K]}\f$
+     * \param pressure pressure of component in \f$\mathrm{[Pa]}\f$
+     * \param rhow density of pure water in \f$\mathrm{[kg/m^3]}\f$
+     */
+    template <class Evaluation>
+    static Evaluation liquidDensityFromWater(const Evaluation& temperature,
+                                             const Evaluation& pressure,
+                                             const Evaluation& rhow)
     {
         Evaluation tempC = temperature - 273.15;
         Evaluation pMPa = pressure/1.0E6;
 
-        const Evaluation rhow = H2O::liquidDensity(temperature, pressure);
         return
             rhow +
             1000*salinity*(
@@ -330,6 +410,26 @@ public:
 
         return mu_brine/1000.0; // convert to [Pa s] (todo: check if correct cP->Pa s is times 10...)
     }
+
+private:
+    // the upper temperature limit of the enthalpy of water
+    static Scalar maxTemperature_()
+    { return 623.15; }
+
+    // the function objects which are used to invert the specific energies
+    struct LiquidEnthalpyFunction_
+    {
+        template <class Evaluation>
+        Evaluation operator()(const Evaluation& temperature, const Evaluation& pressure) const
+        { return liquidEnthalpy(temperature, pressure); }
+    };
+
+    struct LiquidInternalEnergyFunction_
+    {
+        template <class Evaluation>
+        Evaluation operator()(const Evaluation& temperature, const Evaluation& pressure) const
+        { return liquidInternalEnergy(temperature, pressure); }
+    };
 };
 
 /*!
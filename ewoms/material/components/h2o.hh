@@ -31,11 +31,15 @@
 #include "component.hh"
 
 #include <ewoms/material/idealgas.hh>
+#include <ewoms/material/common/hermitetabulated1dfunction.hh>
+#include <ewoms/material/common/temperaturefromenergy.hh>
+#include <ewoms/common/mathtoolbox.hh>
 #include <ewoms/common/exceptions.hh>
 #include <ewoms/common/valgrind.hh>
 
 #include <cmath>
 #include <cassert>
+#include <limits>
 #include <sstream>
 
 namespace Ewoms {
@@ -64,6 +68,12 @@ class H2O : public Component<Scalar, H2O<Scalar> >
     static const Scalar Rs; // specific gas constant of water
 
 public:
+    //! The type of the values stored by the tables of the saturation curve
+    typedef typename Ewoms::MathToolbox<Scalar>::Scalar TableScalar;
+
+    //! The type of the tables of the saturation curve
+    typedef HermiteTabulated1DFunction<TableScalar> SaturationTable;
+
     /*!
      * \brief A human readable name for the water.
      */
@@ -112,6 +122,52 @@ public:
     static const Scalar triplePressure()
     { return Common::triplePressure; }
 
+    /*!
+     * \brief Tabulate the saturation curve of water.
+     *
+     * Afterwards, vaporPressure() and vaporTemperature() evaluate a cubic Hermite
+     * polynomial instead of the equations of region 4 of IAPWS '97. The vapor pressure
+     * is sampled as a function of temperature and the saturation temperature as a
+     * function of the fourth root of the pressure, which is the variable of the IAPWS
+     * backward equation. Both tables cover the range between the triple point and the
+     * critical point. The relative interpolation error of the vapor pressure is below
+     * the tolerance at each point, the one of the saturation temperature is below the
+     * tolerance times the critical temperature. Since both directions are
+     * sampled independently, they are the inverse of each other only up to this
+     * tolerance. If the tolerance cannot be reached, the respective equation of region 4
+     * continues to be used.
+     *
+     * \param tolerance The relative tolerance of the interpolation
+     */
+    static void initSaturationTables(TableScalar tolerance = std::sqrt(std::numeric_limits<TableScalar>::epsilon()))
+    {
+        vaporPressureTable_.initRelative(VaporPressureFunction_(),
+                                         tripleTemperature(),
+                                         criticalTemperature(),
+                                         tolerance);
+        vaporTemperatureTable_.init(VaporTemperatureFunction_(),
+                                    std::sqrt(std::sqrt(triplePressure())),
+                                    std::sqrt(std::sqrt(criticalPressure())),
+                                    tolerance);
+    }
+
+    /*!
+     * \brief Returns the table of the vapor pressure over temperature.
+     *
+     * The table is empty unless initSaturationTables() was called.
+     */
+    static const SaturationTable& vaporPressureTable()
+    { return vaporPressureTable_; }
+
+    /*!
+     * \brief Returns the table of the saturation temperature over the fourth root of
+     *        the pressure.
+     *
+     * The table is empty unless initSaturationTables() was called.
+     */
+    static const SaturationTable& vaporTemperatureTable()
+    { return vaporTemperatureTable_; }
+
     /*!
      * \brief The vapor pressure in \f$\mathrm{[Pa]}\f$ of pure water
      *        at a given temperature.
@@ -122,7 +178,9 @@ public:
      * 1997 for the Thermodynamic Properties of Water and Steam",
      * http://www.iapws.org/relguide/IF97-Rev.pdf
      *
-     * \param T Absolute temperature of the system in \f$\mathrm{[K]}\f$
+     * If initSaturationTables() was called, the result is interpolated.
+     *
+     * \param temperature Absolute temperature of the system in \f$\mathrm{[K]}\f$
      */
     template <class Evaluation>
     static Evaluation vaporPressure(Evaluation temperature)
@@ -132,6 +190,9 @@ public:
         if (temperature < tripleTemperature())
             temperature = tripleTemperature();
 
+        if (vaporPressureTable_.applies(Ewoms::scalarValue(temperature)))
+            return vaporPressureTable_.eval(temperature);
+
         return Region4::saturationPressure(temperature);
     }
     /*!
@@ -144,16 +205,24 @@ public:
      * 1997 for the Thermodynamic Properties of Water and Steam",
      * http://www.iapws.org/relguide/IF97-Rev.pdf
      *
+     * If initSaturationTables() was called, the result is interpolated.
+     *
      * \param pressure Phase pressure in \f$\mathrm{[Pa]}\f$
      */
     template <class Evaluation>
-    static Evaluation vaporTemperature(const Evaluation& pressure)
+    static Evaluation vaporTemperature(Evaluation pressure)
     {
         if (pressure > criticalPressure())
             pressure = criticalPressure();
         if (pressure < triplePressure())
             pressure = triplePressure();
 
+        if (vaporTemperatureTable_.numSamples() > 0) {
+            const Evaluation& beta = Ewoms::sqrt(Ewoms::sqrt(pressure));
+            if (vaporTemperatureTable_.applies(Ewoms::scalarValue(beta)))
+                return vaporTemperatureTable_.eval(beta);
+        }
+
         return Region4::vaporTemperature(pressure);
     }
 
@@ -863,7 +932,198 @@ public:
         return Common::thermalConductivityIAPWS(temperature, rho);
     }
 
+    /*!
+     * \brief The temperature \f$\mathrm{[K]}\f$ of water at a given specific
+     *        enthalpy and pressure.
+     *
+     * This is the inverse of liquidEnthalpy() and gasEnthalpy(): Below the saturation
+     * temperature, water is liquid, above it is steam. If the enthalpy is between the
+     * ones of saturated liquid water and saturated steam, both phases coexist and the
+     * result is the saturation temperature. See Ewoms::TemperatureFromEnergy for
+     * details on the solution procedure.
+     *
+     * \param enthalpy Specific enthalpy of the fluid in \f$\mathrm{[J/kg]}\f$
+     * \param pressure Phase pressure in \f$\mathrm{[Pa]}\f$
+     * \param temperatureGuess An optional initial guess for the temperature
+     */
+    template <class Evaluation>
+    static Evaluation temperatureFromEnthalpy(const Evaluation& enthalpy,
+                                              const Evaluation& pressure,
+                                              Scalar temperatureGuess = 0.0)
+    {
+        return TemperatureFromEnergy<Scalar>::solveWithPhaseChange(LiquidEnthalpyFunction_(),
+                                                                   GasEnthalpyFunction_(),
+                                                                   enthalpy,
+                                                                   pressure,
+                                                                   vaporTemperature(pressure),
+                                                                   tripleTemperature(),
+                                                                   maxTemperature_(),
+                                                                   temperatureGuess);
+    }
+
+    /*!
+     * \brief The temperature \f$\mathrm{[K]}\f$ of water at a given specific
+     *        internal energy and pressure.
+     *
+     * This is the inverse of liquidInternalEnergy() and gasInternalEnergy(). The
+     * phase state is determined like for temperatureFromEnthalpy().
+     *
+     * \param internalEnergy Specific internal energy of the fluid in \f$\mathrm{[J/kg]}\f$
+     * \param pressure Phase pressure in \f$\mathrm{[Pa]}\f$
+     * \param temperatureGuess An optional initial guess for the temperature
+     */
+    template <class Evaluation>
+    static Evaluation temperatureFromInternalEnergy(const Evaluation& internalEnergy,
+                                                    const Evaluation& pressure,
+                                                    Scalar temperatureGuess = 0.0)
+    {
+        return TemperatureFromEnergy<Scalar>::solveWithPhaseChange(LiquidInternalEnergyFunction_(),
+                                                                   GasInternalEnergyFunction_(),
+                                                                   internalEnergy,
+                                                                   pressure,
+                                                                   vaporTemperature(pressure),
+                                                                   tripleTemperature(),
+                                                                   maxTemperature_(),
+                                                                   temperatureGuess);
+    }
+
+    /*!
+     * \brief The temperature \f$\mathrm{[K]}\f$ of liquid water at a given specific
+     *        enthalpy and pressure.
+     *
+     * This is the inverse of liquidEnthalpy().
+     *
+     * \param enthalpy Specific enthalpy of the fluid in \f$\mathrm{[J/kg]}\f$
+     * \param pressure Phase pressure in \f$\mathrm{[Pa]}\f$
+     * \param temperatureGuess An optional initial guess for the temperature
+     */
+    template <class Evaluation>
+    static Evaluation liquidTemperatureFromEnthalpy(const Evaluation& enthalpy,
+                                                    const Evaluation& pressure,
+                                                    Scalar temperatureGuess = 0.0)
+    {
+        return TemperatureFromEnergy<Scalar>::solve(LiquidEnthalpyFunction_(), enthalpy, pressure,
+                                                    tripleTemperature(), maxTemperature_(),
+                                                    temperatureGuess);
+    }
+
+    /*!
+     * \brief The temperature \f$\mathrm{[K]}\f$ of steam at a given specific
+     *        enthalpy and pressure.
+     *
+     * This is the inverse of gasEnthalpy().
+     *
+     * \param enthalpy Specific enthalpy of the fluid in \f$\mathrm{[J/kg]}\f$
+     * \param pressure Phase pressure in \f$\mathrm{[Pa]}\f$
+     * \param temperatureGuess An optional initial guess for the temperature
+     */
+    template <class Evaluation>
+    static Evaluation gasTemperatureFromEnthalpy(const Evaluation& enthalpy,
+                                                 const Evaluation& pressure,
+                                                 Scalar temperatureGuess = 0.0)
+    {
+        return TemperatureFromEnergy<Scalar>::solve(GasEnthalpyFunction_(), enthalpy, pressure,
+                                                    tripleTemperature(), maxTemperature_(),
+                                                    temperatureGuess);
+    }
+
+    /*!
+     * \brief The temperature \f$\mathrm{[K]}\f$ of liquid water at a given specific
+     *        internal energy and pressure.
+     *
+     * This is the inverse of liquidInternalEnergy().
+     *
+     * \param internalEnergy Specific internal energy of the fluid in \f$\mathrm{[J/kg]}\f$
+     * \param pressure Phase pressure in \f$\mathrm{[Pa]}\f$
+     * \param temperatureGuess An optional initial guess for the temperature
+     */
+    template <class Evaluation>
+    static Evaluation liquidTemperatureFromInternalEnergy(const Evaluation& internalEnergy,
+                                                          const Evaluation& pressure,
+                                                          Scalar temperatureGuess = 0.0)
+    {
+        return TemperatureFromEnergy<Scalar>::solve(LiquidInternalEnergyFunction_(), internalEnergy, pressure,
+                                                    tripleTemperature(), maxTemperature_(),
+                                                    temperatureGuess);
+    }
+
+    /*!
+     * \brief The temperature \f$\mathrm{[K]}\f$ of steam at a given specific
+     *        internal energy and pressure.
+     *
+     * This is the inverse of gasInternalEnergy().
+     *
+     * \param internalEnergy Specific internal energy of the fluid in \f$\mathrm{[J/kg]}\f$
+     * \param pressure Phase pressure in \f$\mathrm{[Pa]}\f$
+     * \param temperatureGuess An optional initial guess for the temperature
+     */
+    template <class Evaluation>
+    static Evaluation gasTemperatureFromInternalEnergy(const Evaluation& internalEnergy,
+                                                       const Evaluation& pressure,
+                                                       Scalar temperatureGuess = 0.0)
+    {
+        return TemperatureFromEnergy<Scalar>::solve(GasInternalEnergyFunction_(), internalEnergy, pressure,
+                                                    tripleTemperature(), maxTemperature_(),
+                                                    temperatureGuess);
+    }
+
 private:
+    // the upper temperature limit of the equations for the regions 1 and 2 of IAPWS '97
+    // as far as they are implemented
+    static Scalar maxTemperature_()
+    { return 623.15; }
+
+    // the function objects which are used to invert the specific energies
+    struct LiquidEnthalpyFunction_
+    {
+        template <class Evaluation>
+        Evaluation operator()(const Evaluation& temperature, const Evaluation& pressure) const
+        { return liquidEnthalpy(temperature, pressure); }
+    };
+
+    struct GasEnthalpyFunction_
+    {
+        template <class Evaluation>
+        Evaluation operator()(const Evaluation& temperature, const Evaluation& pressure) const
+        { return gasEnthalpy(temperature, pressure); }
+    };
+
+    struct LiquidInternalEnergyFunction_
+    {
+        template <class Evaluation>
+        Evaluation operator()(const Evaluation& temperature, const Evaluation& pressure) const
+        { return liquidInternalEnergy(temperature, pressure); }
+    };
+
+    struct GasInternalEnergyFunction_
+    {
+        template <class Evaluation>
+        Evaluation operator()(const Evaluation& temperature, const Evaluation& pressure) const
+        { return gasInternalEnergy(temperature, pressure); }
+    };
+
+    // the function objects which are used to sample the saturation curve
+    struct VaporPressureFunction_
+    {
+        template <class Evaluation>
+        Evaluation operator()(const Evaluation& temperature) const
+        { return Region4::saturationPressure(temperature); }
+    };
+
+    struct VaporTemperatureFunction_
+    {
+        template <class Evaluation>
+        Evaluation operator()(const Evaluation& beta) const
+        {
+            Evaluation pressure = beta*beta;
+            pressure *= pressure;
+            return Region4::vaporTemperature(pressure);
+        }
+    };
+
+    static SaturationTable vaporPressureTable_;
+    static SaturationTable vaporTemperatureTable_;
+
     // the unregularized specific enthalpy for liquid water
     template <class Evaluation>
     static Evaluation enthalpyRegion1_(const Evaluation& temperature, const Evaluation& pressure)
@@ -975,6 +1235,12 @@ private:
 
 template <class Scalar>
 const Scalar H2O<Scalar>::Rs = Common::Rs;
+
+template <class Scalar>
+typename H2O<Scalar>::SaturationTable H2O<Scalar>::vaporPressureTable_;
+
+template <class Scalar>
+typename H2O<Scalar>::SaturationTable H2O<Scalar>::vaporTemperatureTable_;
 } // namespace Ewoms
 
 #endif
@@ -28,18 +28,79 @@
 #include <limits>
 #include <cassert>
 #include <iostream>
+#include <stdexcept>
+#include <type_traits>
 
+#include <ewoms/material/common/hermitetabulated1dfunction.hh>
+#include <ewoms/material/common/temperaturefromenergy.hh>
 #include <ewoms/common/mathtoolbox.hh>
+#include <ewoms/common/hasmembergeneratormacros.hh>
 
 namespace Ewoms {
+namespace TabulatedComponentDetail {
+EWOMS_GENERATE_HAS_MEMBER(gasPressure, 0.0, 0.0) // Creates 'HasMember_gasPressure<T>'.
+EWOMS_GENERATE_HAS_MEMBER(liquidPressure, 0.0, 0.0) // Creates 'HasMember_liquidPressure<T>'.
+
+// the pressure as a function of density is not part of the generic component API
+template <class RawComponent, class Scalar>
+typename std::enable_if<HasMember_gasPressure<RawComponent>::value, Scalar>::type
+gasPressure(Scalar temperature, Scalar density)
+{ return RawComponent::gasPressure(temperature, density); }
+
+template <class RawComponent, class Scalar>
+typename std::enable_if<!HasMember_gasPressure<RawComponent>::value, Scalar>::type
+gasPressure(Scalar /*temperature*/, Scalar /*density*/)
+{ throw std::runtime_error("Not implemented: gasPressure()"); }
+
+template <class RawComponent, class Scalar>
+typename std::enable_if<HasMember_liquidPressure<RawComponent>::value, Scalar>::type
+liquidPressure(Scalar temperature, Scalar density)
+{ return RawComponent::liquidPressure(temperature, density); }
+
+template <class RawComponent, class Scalar>
+typename std::enable_if<!HasMember_liquidPressure<RawComponent>::value, Scalar>::type
+liquidPressure(Scalar /*temperature*/, Scalar /*density*/)
+{ throw std::runtime_error("Not implemented: liquidPressure()"); }
+} // namespace TabulatedComponentDetail
+
 /*!
  * \ingroup Components
  *
  * \brief A generic class which tabulates all thermodynamic properties
  *        of a given component.
  *
- * At the moment, this class can only handle the sub-critical fluids
- * since it tabulates along the vapor pressure curve.
+ * If the vapor pressure is used, the pressure ranges of the gas and liquid tables
+ * follow the vapor pressure curve. At temperatures for which the component does not
+ * exhibit a vapor pressure, e.g., for supercritical temperatures, the full pressure
+ * range [p_min, p_max] is tabulated for both phases. Components which only
+ * provide a subset of the properties, e.g., components which are only defined for
+ * a single phase, can be tabulated as well: The quantities which cannot be computed
+ * are not tabulated and calling the respective method yields the result of the raw
+ * component.
+ *
+ * If the vapor pressure is used, the sampling points on the pressure axis can
+ * optionally be graded towards the vapor pressure, i.e., towards the end of the
+ * pressure range of each phase where the properties are least linear. For a grading
+ * factor g, the spacing of the sampling points at the vapor pressure is (1 - g)/(1 + g)
+ * times the one at the other end of the range. Since the mapping from pressure to the
+ * position in the table can be inverted analytically, looking up a value stays O(1),
+ * but it requires an additional square root per temperature sampling point involved.
+ *
+ * The gain of grading is limited to a band around the vapor pressure: There, a graded
+ * table with fewer pressure sampling points, i.e., less memory (each of the twelve
+ * tables stores nTemp*nPress values), can be as accurate as a larger uniform one. It
+ * does not generally reach the accuracy of the larger uniform table on the whole
+ * range, though: For water with 200 temperature sampling points, the largest error of
+ * the liquid enthalpy is about 1.8e-4 for a graded table with 25 pressure sampling
+ * points and g = 0.8, but about 2e-5 for a uniform table with 50 pressure sampling
+ * points. Far from the vapor pressure, graded tables are also less accurate than
+ * uniform ones with the same number of sampling points. Whether this affects the
+ * largest error on the whole range depends on the component and on the temperature
+ * axis: For water with 25 pressure sampling points and g = 0.8, the graded tables are
+ * at least as accurate as the uniform ones if 50 temperature sampling points are used.
+ * With 200 temperature sampling points, the error of the liquid enthalpy is about eight
+ * times larger than the one of the uniform table. The temperature-density tables used
+ * by gasPressure() and liquidPressure() are not graded.
  *
  * \tparam Scalar The type used for scalar values
  * \tparam RawComponent The component which ought to be tabulated
@@ -64,10 +125,17 @@ public:
      * \param pressMin The minimum of the pressure range in \f$\mathrm{[Pa]}\f$
      * \param pressMax The maximum of the pressure range in \f$\mathrm{[Pa]}\f$
      * \param nPress The number of entries/steps within the pressure range
+     * \param pressureGrading The grading factor g in [0, 1) of the pressure axis
+     *                        towards the vapor pressure. 0 means uniform spacing.
      */
     static void init(Scalar tempMin, Scalar tempMax, unsigned nTemp,
-                     Scalar pressMin, Scalar pressMax, unsigned nPress)
+                     Scalar pressMin, Scalar pressMax, unsigned nPress,
+                     Scalar pressureGrading = 0.0)
     {
+        if (!(0.0 <= pressureGrading && pressureGrading < 1.0))
+            throw std::invalid_argument("The grading factor of the pressure axis must be in [0, 1)");
+
+        pressureGrading_ = pressureGrading;
         tempMin_ = tempMin;
         tempMax_ = tempMax;
         nTemp_ = nTemp;
@@ -99,6 +167,16 @@ public:
         assert(std::numeric_limits<Scalar>::has_quiet_NaN);
         Scalar NaN = std::numeric_limits<Scalar>::quiet_NaN();
 
+        // if possible, the vapor pressure is interpolated using cubic Hermite
+        // polynomials. this is much more accurate than interpolating the sampled values
+        // linearly. since the vapor pressure varies by orders of magnitude, the
+        // tolerance applies to each point individually.
+        try {
+            vaporPressureTable_.initRelative(VaporPressureFunction_(), tempMin_, tempMax_,
+                                             std::sqrt(std::numeric_limits<Scalar>::epsilon()));
+        }
+        catch (const std::exception&) { vaporPressureTable_.clear(); }
+
         // fill the temperature-pressure arrays
         for (unsigned iT = 0; iT < nTemp_; ++ iT) {
             Scalar temperature = iT * (tempMax_ - tempMin_)/(nTemp_ - 1) + tempMin_;
@@ -111,7 +189,9 @@ public:
 
             // fill the temperature, pressure gas arrays
             for (unsigned iP = 0; iP < nPress_; ++ iP) {
-                Scalar pressure = iP * (pgMax - pgMin)/(nPress_ - 1) + pgMin;
+                // the vapor pressure is at the upper end of the gas pressure range
+                Scalar x = gradedPosition_(Scalar(nPress_ - 1 - iP)/(nPress_ - 1), iT);
+                Scalar pressure = pgMax - x*(pgMax - pgMin);
 
                 unsigned i = iT + iP*nTemp_;
 
@@ -134,7 +214,8 @@ public:
             Scalar plMin = minLiquidPressure_(iT);
             Scalar plMax = maxLiquidPressure_(iT);
             for (unsigned iP = 0; iP < nPress_; ++ iP) {
-                Scalar pressure = iP * (plMax - plMin)/(nPress_ - 1) + plMin;
+                Scalar x = gradedPosition_(Scalar(iP)/(nPress_ - 1), iT);
+                Scalar pressure = plMin + x*(plMax - plMin);
 
                 unsigned i = iT + iP*nTemp_;
 
@@ -161,11 +242,12 @@ public:
 
             // calculate the minimum and maximum values for the gas
             // densities
-            minGasDensity__[iT] = RawComponent::gasDensity(temperature, minGasPressure_(iT));
-            if (iT < nTemp_ - 1)
-                maxGasDensity__[iT] = RawComponent::gasDensity(temperature, maxGasPressure_(iT + 1));
-            else
-                maxGasDensity__[iT] = RawComponent::gasDensity(temperature, maxGasPressure_(iT));
+            try { minGasDensity__[iT] = RawComponent::gasDensity(temperature, minGasPressure_(iT)); }
+            catch (const std::exception&) { minGasDensity__[iT] = NaN; }
+
+            unsigned iTMax = std::min(iT + 1, nTemp_ - 1);
+            try { maxGasDensity__[iT] = RawComponent::gasDensity(temperature, maxGasPressure_(iTMax)); }
+            catch (const std::exception&) { maxGasDensity__[iT] = NaN; }
 
             // fill the temperature, density gas arrays
             for (unsigned iRho = 0; iRho < nDensity_; ++ iRho) {
@@ -177,17 +259,17 @@ public:
 
                 unsigned i = iT + iRho*nTemp_;
 
-                try { gasPressure_[i] = RawComponent::gasPressure(temperature, density); }
+                try { gasPressure_[i] = TabulatedComponentDetail::gasPressure<RawComponent>(temperature, density); }
                 catch (const std::exception&) { gasPressure_[i] = NaN; };
             };
 
             // calculate the minimum and maximum values for the liquid
             // densities
-            minLiquidDensity__[iT] = RawComponent::liquidDensity(temperature, minLiquidPressure_(iT));
-            if (iT < nTemp_ - 1)
-                maxLiquidDensity__[iT] = RawComponent::liquidDensity(temperature, maxLiquidPressure_(iT + 1));
-            else
-                maxLiquidDensity__[iT] = RawComponent::liquidDensity(temperature, maxLiquidPressure_(iT));
+            try { minLiquidDensity__[iT] = RawComponent::liquidDensity(temperature, minLiquidPressure_(iT)); }
+            catch (const std::exception&) { minLiquidDensity__[iT] = NaN; }
+
+            try { maxLiquidDensity__[iT] = RawComponent::liquidDensity(temperature, maxLiquidPressure_(iTMax)); }
+            catch (const std::exception&) { maxLiquidDensity__[iT] = NaN; }
 
             // fill the temperature, density liquid arrays
             for (unsigned iRho = 0; iRho < nDensity_; ++ iRho) {
@@ -199,7 +281,7 @@ public:
 
                 unsigned i = iT + iRho*nTemp_;
 
-                try { liquidPressure_[i] = RawComponent::liquidPressure(temperature, density); }
+                try { liquidPressure_[i] = TabulatedComponentDetail::liquidPressure<RawComponent>(temperature, density); }
                 catch (const std::exception&) { liquidPressure_[i] = NaN; };
             };
         }
@@ -229,6 +311,12 @@ public:
     static Scalar criticalPressure()
     { return RawComponent::criticalPressure(); }
 
+    /*!
+     * \brief Returns the acentric factor of the component.
+     */
+    static Scalar acentricFactor()
+    { return RawComponent::acentricFactor(); }
+
     /*!
      * \brief Returns the temperature in \f$\mathrm{[K]}\f$ at the component's triple point.
      */
@@ -250,12 +338,28 @@ public:
     template <class Evaluation>
     static Evaluation vaporPressure(const Evaluation& temperature)
     {
+        if (vaporPressureTable_.applies(Ewoms::scalarValue(temperature)))
+            return vaporPressureTable_.eval(temperature);
+
         const Evaluation& result = interpolateT_(vaporPressure_, temperature);
         if (std::isnan(Ewoms::scalarValue(result)))
             return RawComponent::vaporPressure(temperature);
         return result;
     }
 
+    /*!
+     * \brief The saturation temperature in \f$\mathrm{[K]}\f$ of the component at a
+     *        given pressure.
+     *
+     * This quantity is not tabulated, i.e., the raw component is called. The saturation
+     * curve of water can be tabulated using H2O::initSaturationTables().
+     *
+     * \param pressure pressure of component in \f$\mathrm{[Pa]}\f$
+     */
+    template <class Evaluation>
+    static Evaluation vaporTemperature(const Evaluation& pressure)
+    { return RawComponent::vaporTemperature(pressure); }
+
     /*!
      * \brief Specific enthalpy of the gas \f$\mathrm{[J/kg]}\f$.
      *
@@ -344,6 +448,128 @@ public:
     static Evaluation liquidInternalEnergy(const Evaluation& temperature, const Evaluation& pressure)
     { return liquidEnthalpy(temperature, pressure) - pressure/liquidDensity(temperature, pressure); }
 
+    /*!
+     * \brief The temperature \f$\mathrm{[K]}\f$ of the component at a given specific
+     *        enthalpy and pressure.
+     *
+     * This inverts the tabulated enthalpies of the liquid and of the gas. The phase
+     * state is determined by the saturation temperature of the raw component, i.e.,
+     * if the enthalpy is between the ones of the saturated liquid and the saturated
+     * gas, the result is the saturation temperature. The temperature is searched within
+     * the temperature range of the tables. See Ewoms::TemperatureFromEnergy for details.
+     *
+     * \param enthalpy specific enthalpy of component in \f$\mathrm{[J/kg]}\f$
+     * \param pressure pressure of component in \f$\mathrm{[Pa]}\f$
+     * \param temperatureGuess an optional initial guess for the temperature
+     */
+    template <class Evaluation>
+    static Evaluation temperatureFromEnthalpy(const Evaluation& enthalpy,
+                                              const Evaluation& pressure,
+                                              Scalar temperatureGuess = 0.0)
+    {
+        return TemperatureFromEnergy<Scalar>::solveWithPhaseChange(LiquidEnthalpyFunction_(),
+                                                                   GasEnthalpyFunction_(),
+                                                                   enthalpy,
+                                                                   pressure,
+                                                                   vaporTemperature(pressure),
+                                                                   tempMin_,
+                                                                   tempMax_,
+                                                                   temperatureGuess);
+    }
+
+    /*!
+     * \brief The temperature \f$\mathrm{[K]}\f$ of the component at a given specific
+     *        internal energy and pressure.
+     *
+     * The phase state is determined like for temperatureFromEnthalpy().
+     *
+     * \param internalEnergy specific internal energy of component in \f$\mathrm{[J/kg]}\f$
+     * \param pressure pressure of component in \f$\mathrm{[Pa]}\f$
+     * \param temperatureGuess an optional initial guess for the temperature
+     */
+    template <class Evaluation>
+    static Evaluation temperatureFromInternalEnergy(const Evaluation& internalEnergy,
+                                                    const Evaluation& pressure,
+                                                    Scalar temperatureGuess = 0.0)
+    {
+        return TemperatureFromEnergy<Scalar>::solveWithPhaseChange(LiquidInternalEnergyFunction_(),
+                                                                   GasInternalEnergyFunction_(),
+                                                                   internalEnergy,
+                                                                   pressure,
+                                                                   vaporTemperature(pressure),
+                                                                   tempMin_,
+                                                                   tempMax_,
+                                                                   temperatureGuess);
+    }
+
+    /*!
+     * \brief The temperature \f$\mathrm{[K]}\f$ of the liquid at a given specific
+     *        enthalpy and pressure.
+     *
+     * \param enthalpy specific enthalpy of component in \f$\mathrm{[J/kg]}\f$
+     * \param pressure pressure of component in \f$\mathrm{[Pa]}\f$
+     * \param temperatureGuess an optional initial guess for the temperature
+     */
+    template <class Evaluation>
+    static Evaluation liquidTemperatureFromEnthalpy(const Evaluation& enthalpy,
+                                                    const Evaluation& pressure,
+                                                    Scalar temperatureGuess = 0.0)
+    {
+        return TemperatureFromEnergy<Scalar>::solve(LiquidEnthalpyFunction_(), enthalpy, pressure,
+                                                    tempMin_, tempMax_, temperatureGuess);
+    }
+
+    /*!
+     * \brief The temperature \f$\mathrm{[K]}\f$ of the gas at a given specific
+     *        enthalpy and pressure.
+     *
+     * \param enthalpy specific enthalpy of component in \f$\mathrm{[J/kg]}\f$
+     * \param pressure pressure of component in \f$\mathrm{[Pa]}\f$
+     * \param temperatureGuess an optional initial guess for the temperature
+     */
+    template <class Evaluation>
+    static Evaluation gasTemperatureFromEnthalpy(const Evaluation& enthalpy,
+                                                 const Evaluation& pressure,
+                                                 Scalar temperatureGuess = 0.0)
+    {
+        return TemperatureFromEnergy<Scalar>::solve(GasEnthalpyFunction_(), enthalpy, pressure,
+                                                    tempMin_, tempMax_, temperatureGuess);
+    }
+
+    /*!
+     * \brief The temperature \f$\mathrm{[K]}\f$ of the liquid at a given specific
+     *        internal energy and pressure.
+     *
+     * \param internalEnergy specific internal energy of component in \f$\mathrm{[J/kg]}\f$
+     * \param pressure pressure of component in \f$\mathrm{[Pa]}\f$
+     * \param temperatureGuess an optional initial guess for the temperature
+     */
+    template <class Evaluation>
+    static Evaluation liquidTemperatureFromInternalEnergy(const Evaluation& internalEnergy,
+                                                          const Evaluation& pressure,
+                                                          Scalar temperatureGuess = 0.0)
+    {
+        return TemperatureFromEnergy<Scalar>::solve(LiquidInternalEnergyFunction_(), internalEnergy, pressure,
+                                                    tempMin_, tempMax_, temperatureGuess);
+    }
+
+    /*!
+     * \brief The temperature \f$\mathrm{[K]}\f$ of the gas at a given specific
+     *        internal energy and pressure.
+     *
+     * \param internalEnergy specific internal energy of component in \f$\mathrm{[J/kg]}\f$
+     * \param pressure pressure of component in \f$\mathrm{[Pa]}\f$
+     * \param temperatureGuess an optional initial guess for the temperature
+     */
+    template <class Evaluation>
+    static Evaluation gasTemperatureFromInternalEnergy(const Evaluation& internalEnergy,
+                                                       const Evaluation& pressure,
+                                                       Scalar temperatureGuess = 0.0)
+    {
+        return TemperatureFromEnergy<Scalar>::solve(GasInternalEnergyFunction_(), internalEnergy, pressure,
+                                                    tempMin_, tempMax_, temperatureGuess);
+    }
+
     /*!
      * \brief The pressure of gas in \f$\mathrm{[Pa]}\f$ at a given density and temperature.
      *
@@ -600,6 +826,8 @@ private:
 
         Evaluation alphaP1 = densityGasIdx_(rho, iT);
         Evaluation alphaP2 = densityGasIdx_(rho, iT + 1);
+        if (std::isnan(Ewoms::scalarValue(alphaP1)) || std::isnan(Ewoms::scalarValue(alphaP2)))
+            return std::numeric_limits<Scalar>::quiet_NaN();
         unsigned iP1 =
             std::max(0,
                      std::min(static_cast<int>(nDensity_ - 2),
@@ -629,6 +857,8 @@ private:
 
         Evaluation alphaP1 = densityLiquidIdx_(rho, iT);
         Evaluation alphaP2 = densityLiquidIdx_(rho, iT + 1);
+        if (std::isnan(Ewoms::scalarValue(alphaP1)) || std::isnan(Ewoms::scalarValue(alphaP2)))
+            return std::numeric_limits<Scalar>::quiet_NaN();
         unsigned iP1 = std::max<int>(0, std::min<int>(nDensity_ - 2, static_cast<int>(alphaP1)));
         unsigned iP2 = std::max<int>(0, std::min<int>(nDensity_ - 2, static_cast<int>(alphaP2)));
         alphaP1 -= iP1;
@@ -655,7 +885,8 @@ private:
         Scalar plMin = minLiquidPressure_(tempIdx);
         Scalar plMax = maxLiquidPressure_(tempIdx);
 
-        return (nPress_ - 1)*(pressure - plMin)/(plMax - plMin);
+        const Evaluation& x = (pressure - plMin)/(plMax - plMin);
+        return (nPress_ - 1)*gradedIndex_(x, tempIdx);
     }
 
     // returns the index of an entry in a temperature field
@@ -665,7 +896,41 @@ private:
         Scalar pgMin = minGasPressure_(tempIdx);
         Scalar pgMax = maxGasPressure_(tempIdx);
 
-        return (nPress_ - 1)*(pressure - pgMin)/(pgMax - pgMin);
+        const Evaluation& x = (pgMax - pressure)/(pgMax - pgMin);
+        return (nPress_ - 1)*(1.0 - gradedIndex_(x, tempIdx));
+    }
+
+    // returns true iff the pressure axis of a given temperature index is graded
+    static bool isGraded_(size_t tempIdx)
+    { return useVaporPressure && pressureGrading_ > 0.0 && !std::isnan(vaporPressure_[tempIdx]); }
+
+    // maps the normalized index u in [0, 1] of a pressure sampling point to its
+    // normalized distance from the vapor pressure end of the range
+    static Scalar gradedPosition_(Scalar u, size_t tempIdx)
+    {
+        if (!isGraded_(tempIdx))
+            return u;
+
+        const Scalar g = pressureGrading_;
+        return (1 - g)*u + g*u*u;
+    }
+
+    // the inverse of gradedPosition_(). outside of the tabulated range, the mapping is
+    // extrapolated linearly.
+    template <class Evaluation>
+    static Evaluation gradedIndex_(const Evaluation& x, size_t tempIdx)
+    {
+        if (!isGraded_(tempIdx))
+            return x;
+
+        const Scalar g = pressureGrading_;
+        if (x < 0.0)
+            return x/(1 - g);
+        if (x > 1.0)
+            return 1.0 + (x - 1.0)/(1 + g);
+
+        // this is the positive root of the quadratic, written to avoid cancellation
+        return 2*x/((1 - g) + Ewoms::sqrt((1 - g)*(1 - g) + 4*g*x));
     }
 
     // returns the index of an entry in a density field
@@ -690,7 +955,7 @@ private:
     // temperature index
     static Scalar minLiquidPressure_(size_t tempIdx)
     {
-        if (!useVaporPressure)
+        if (!useVaporPressure || std::isnan(vaporPressure_[tempIdx]))
             return pressMin_;
         else
             return std::max<Scalar>(pressMin_, vaporPressure_[tempIdx] / 1.1);
@@ -700,7 +965,7 @@ private:
     // temperature index
     static Scalar maxLiquidPressure_(size_t tempIdx)
     {
-        if (!useVaporPressure)
+        if (!useVaporPressure || std::isnan(vaporPressure_[tempIdx]))
             return pressMax_;
         else
             return std::max<Scalar>(pressMax_, vaporPressure_[tempIdx] * 1.1);
@@ -710,7 +975,7 @@ private:
     // temperature index
     static Scalar minGasPressure_(size_t tempIdx)
     {
-        if (!useVaporPressure)
+        if (!useVaporPressure || std::isnan(vaporPressure_[tempIdx]))
             return pressMin_;
         else
             return std::min<Scalar>(pressMin_, vaporPressure_[tempIdx] / 1.1 );
@@ -720,7 +985,7 @@ private:
     // temperature index
     static Scalar maxGasPressure_(size_t tempIdx)
     {
-        if (!useVaporPressure)
+        if (!useVaporPressure || std::isnan(vaporPressure_[tempIdx]))
             return pressMax_;
         else
             return std::min<Scalar>(pressMax_, vaporPressure_[tempIdx] * 1.1);
@@ -746,8 +1011,46 @@ private:
     static Scalar maxGasDensity_(size_t tempIdx)
     { return maxGasDensity__[tempIdx]; }
 
+    // the function objects which are used to invert the specific energies
+    struct LiquidEnthalpyFunction_
+    {
+        template <class Evaluation>
+        Evaluation operator()(const Evaluation& temperature, const Evaluation& pressure) const
+        { return liquidEnthalpy(temperature, pressure); }
+    };
+
+    struct GasEnthalpyFunction_
+    {
+        template <class Evaluation>
+        Evaluation operator()(const Evaluation& temperature, const Evaluation& pressure) const
+        { return gasEnthalpy(temperature, pressure); }
+    };
+
+    struct LiquidInternalEnergyFunction_
+    {
+        template <class Evaluation>
+        Evaluation operator()(const Evaluation& temperature, const Evaluation& pressure) const
+        { return liquidInternalEnergy(temperature, pressure); }
+    };
+
+    struct GasInternalEnergyFunction_
+    {
+        template <class Evaluation>
+        Evaluation operator()(const Evaluation& temperature, const Evaluation& pressure) const
+        { return gasInternalEnergy(temperature, pressure); }
+    };
+
+    // the function object which is used to sample the vapor pressure
+    struct VaporPressureFunction_
+    {
+        template <class Evaluation>
+        Evaluation operator()(const Evaluation& temperature) const
+        { return RawComponent::vaporPressure(temperature); }
+    };
+
     // 1D fields with the temperature as degree of freedom
     static Scalar* vaporPressure_;
+    static HermiteTabulated1DFunction<Scalar> vaporPressureTable_;
 
     static Scalar* minLiquidDensity__;
     static Scalar* maxLiquidDensity__;
@@ -785,6 +1088,7 @@ private:
     static Scalar pressMin_;
     static Scalar pressMax_;
     static unsigned nPress_;
+    static Scalar pressureGrading_;
 
     static Scalar densityMin_;
     static Scalar densityMax_;
@@ -794,6 +1098,8 @@ private:
 template <class Scalar, class RawComponent, bool useVaporPressure>
 Scalar* TabulatedComponent<Scalar, RawComponent, useVaporPressure>::vaporPressure_;
 template <class Scalar, class RawComponent, bool useVaporPressure>
+HermiteTabulated1DFunction<Scalar> TabulatedComponent<Scalar, RawComponent, useVaporPressure>::vaporPressureTable_;
+template <class Scalar, class RawComponent, bool useVaporPressure>
 Scalar* TabulatedComponent<Scalar, RawComponent, useVaporPressure>::minLiquidDensity__;
 template <class Scalar, class RawComponent, bool useVaporPressure>
 Scalar* TabulatedComponent<Scalar, RawComponent, useVaporPressure>::maxLiquidDensity__;
@@ -838,6 +1144,8 @@ Scalar TabulatedComponent<Scalar, RawComponent, useVaporPressure>::pressMax_;
 template <class Scalar, class RawComponent, bool useVaporPressure>
 unsigned TabulatedComponent<Scalar, RawComponent, useVaporPressure>::nPress_;
 template <class Scalar, class RawComponent, bool useVaporPressure>
+Scalar TabulatedComponent<Scalar, RawComponent, useVaporPressure>::pressureGrading_;
+template <class Scalar, class RawComponent, bool useVaporPressure>
 Scalar TabulatedComponent<Scalar, RawComponent, useVaporPressure>::densityMin_;
 template <class Scalar, class RawComponent, bool useVaporPressure>
 Scalar TabulatedComponent<Scalar, RawComponent, useVaporPressure>::densityMax_;
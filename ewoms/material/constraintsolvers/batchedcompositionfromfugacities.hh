@@ -0,0 +1,261 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the eWoms project.
+
+  eWoms is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  eWoms is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with eWoms.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*!
+ * \file
+ * \copydoc Ewoms::BatchedCompositionFromFugacities
+ */
+#ifndef EWOMS_BATCHED_COMPOSITION_FROM_FUGACITIES_HH
+#define EWOMS_BATCHED_COMPOSITION_FROM_FUGACITIES_HH
+
+#include "compositionfromfugacities.hh"
+
+#include <ewoms/common/mathtoolbox.hh>
+#include <ewoms/common/exceptions.hh>
+#include <ewoms/common/valgrind.hh>
+
+#include <dune/common/fvector.hh>
+#include <dune/common/fmatrix.hh>
+
+#include <vector>
+#include <limits>
+#include <sstream>
+#include <cstddef>
+#include <cassert>
+
+namespace Ewoms {
+
+/*!
+ * \brief Calculates the chemical equilibrium from the component fugacities in a phase
+ *        for a whole set of cells.
+ *
+ * This constraint solver yields the same results as calling \c
+ * CompositionFromFugacities::solve() for each cell, but the Newton iterations of all
+ * cells are done in lockstep: In each iteration, the fugacity coefficient of a given
+ * component is evaluated for all cells which have not yet converged before the next
+ * component is considered. This keeps the code path through the fluid system the same
+ * for consecutive calls, which allows the compiler to vectorize the loops over the
+ * cells and which makes much better use of the instruction cache and of the branch
+ * predictor than solving for the cells one after another. Cells which are converged
+ * are removed from the set of active cells, i.e., they do not cause any further
+ * evaluations of the fluid system.
+ */
+template <class Scalar, class FluidSystem, class Evaluation = Scalar>
+class BatchedCompositionFromFugacities
+    : public CompositionFromFugacities<Scalar, FluidSystem, Evaluation>
+{
+    typedef CompositionFromFugacities<Scalar, FluidSystem, Evaluation> ParentType;
+
+    enum { numComponents = FluidSystem::numComponents };
+
+    typedef Dune::FieldMatrix<Evaluation, numComponents, numComponents> Matrix;
+    typedef Dune::FieldVector<Evaluation, numComponents> Vector;
+
+public:
+    typedef typename ParentType::ComponentVector ComponentVector;
+
+    /*!
+     * \brief Guess an initial value for the composition of the phase in all cells.
+     */
+    template <class FluidStateContainer, class FugacityContainer>
+    static void guessInitial(FluidStateContainer& fluidStates,
+                             unsigned phaseIdx,
+                             const FugacityContainer& targetFugacities)
+    {
+        for (std::size_t cellIdx = 0; cellIdx < fluidStates.size(); ++cellIdx)
+            ParentType::guessInitial(fluidStates[cellIdx], phaseIdx, targetFugacities[cellIdx]);
+    }
+
+    /*!
+     * \brief Calculates the chemical equilibrium from the component fugacities of a phase
+     *        in all cells.
+     *
+     * The containers for the fluid states, the parameter caches and the target
+     * fugacities must be of the same size and must provide random access via
+     * operator[]. The initial guess for the composition is taken from the fluid states.
+     */
+    template <class FluidStateContainer, class ParamCacheContainer, class FugacityContainer>
+    static void solve(FluidStateContainer& fluidStates,
+                      ParamCacheContainer& paramCaches,
+                      unsigned phaseIdx,
+                      const FugacityContainer& targetFugacities)
+    {
+        const std::size_t numCells = fluidStates.size();
+        assert(paramCaches.size() == numCells);
+        assert(targetFugacities.size() == numCells);
+
+        // use a much more efficient method in case the phase is an
+        // ideal mixture
+        if (FluidSystem::isIdealMixture(phaseIdx)) {
+            for (std::size_t cellIdx = 0; cellIdx < numCells; ++cellIdx)
+                ParentType::solveIdealMix_(fluidStates[cellIdx],
+                                           paramCaches[cellIdx],
+                                           phaseIdx,
+                                           targetFugacities[cellIdx]);
+            return;
+        }
+
+        // the indices of the cells which are not yet converged
+        std::vector<std::size_t> activeCells(numCells);
+        for (std::size_t cellIdx = 0; cellIdx < numCells; ++cellIdx) {
+            activeCells[cellIdx] = cellIdx;
+            paramCaches[cellIdx].updatePhase(fluidStates[cellIdx], phaseIdx);
+        }
+
+        /////////////////////////
+        // Newton method
+        /////////////////////////
+
+        // Jacobian matrices, updates and defects of the active cells
+        std::vector<Matrix> J(numCells);
+        std::vector<Vector> x(numCells);
+        std::vector<Vector> b(numCells);
+
+        // maximum number of iterations
+        const int nMax = 25;
+        for (int nIdx = 0; nIdx < nMax && !activeCells.empty(); ++nIdx) {
+            // calculate Jacobian matrices and right hand sides
+            linearize_(J, b, fluidStates, paramCaches, activeCells, phaseIdx, targetFugacities);
+
+            // solve J*x = b and update the compositions of all active cells. the
+            // converged cells are removed from the set of active cells.
+            std::size_t numActive = 0;
+            for (std::size_t activeIdx = 0; activeIdx < activeCells.size(); ++activeIdx) {
+                std::size_t cellIdx = activeCells[activeIdx];
+                Valgrind::CheckDefined(J[activeIdx]);
+                Valgrind::CheckDefined(b[activeIdx]);
+
+                x[activeIdx] = 0.0;
+                try { J[activeIdx].solve(x[activeIdx], b[activeIdx]); }
+                catch (const Dune::FMatrixError& e)
+                { throw Ewoms::NumericalIssue(e.what()); }
+                Valgrind::CheckDefined(x[activeIdx]);
+
+                Scalar relError = ParentType::update_(fluidStates[cellIdx],
+                                                      paramCaches[cellIdx],
+                                                      x[activeIdx],
+                                                      b[activeIdx],
+                                                      phaseIdx,
+                                                      targetFugacities[cellIdx]);
+
+                if (relError < 1e-9) {
+                    const Evaluation& rho =
+                        FluidSystem::density(fluidStates[cellIdx], paramCaches[cellIdx], phaseIdx);
+                    fluidStates[cellIdx].setDensity(phaseIdx, rho);
+                }
+                else
+                    activeCells[numActive++] = cellIdx;
+            }
+            activeCells.resize(numActive);
+        }
+
+        if (!activeCells.empty()) {
+            std::size_t cellIdx = activeCells.front();
+            const auto& fluidState = fluidStates[cellIdx];
+
+            std::ostringstream oss;
+            oss << "Calculating the " << FluidSystem::phaseName(phaseIdx)
+                << "Phase composition failed for " << activeCells.size() << " of "
+                << numCells << " cells. First failed cell: " << cellIdx
+                << ", {fug_t} = {" << targetFugacities[cellIdx] << "}, p = "
+                << fluidState.pressure(phaseIdx)
+                << ", T = " << fluidState.temperature(phaseIdx);
+            throw Ewoms::NumericalIssue(oss.str());
+        }
+    }
+
+protected:
+    template <class FluidStateContainer, class ParamCacheContainer, class FugacityContainer>
+    static void linearize_(std::vector<Matrix>& J,
+                           std::vector<Vector>& defect,
+                           FluidStateContainer& fluidStates,
+                           ParamCacheContainer& paramCaches,
+                           const std::vector<std::size_t>& activeCells,
+                           unsigned phaseIdx,
+                           const FugacityContainer& targetFugacities)
+    {
+        const std::size_t numActive = activeCells.size();
+
+        // calculate the defect (deviation of the current fugacities
+        // from the target fugacities)
+        for (unsigned i = 0; i < numComponents; ++ i) {
+            for (std::size_t activeIdx = 0; activeIdx < numActive; ++activeIdx) {
+                std::size_t cellIdx = activeCells[activeIdx];
+                auto& fluidState = fluidStates[cellIdx];
+
+                const Evaluation& phi = FluidSystem::fugacityCoefficient(fluidState,
+                                                                         paramCaches[cellIdx],
+                                                                         phaseIdx,
+                                                                         i);
+                const Evaluation& f = phi*fluidState.pressure(phaseIdx)*fluidState.moleFraction(phaseIdx, i);
+                fluidState.setFugacityCoefficient(phaseIdx, i, phi);
+
+                defect[activeIdx][i] = targetFugacities[cellIdx][i] - f;
+            }
+        }
+
+        // assemble jacobian matrices of the constraints for the composition using
+        // forward differences
+        static const Scalar eps = std::numeric_limits<Scalar>::epsilon()*1e6;
+        std::vector<Evaluation> origX(numActive);
+        for (unsigned i = 0; i < numComponents; ++ i) {
+            // deviate the mole fraction of the i-th component
+            for (std::size_t activeIdx = 0; activeIdx < numActive; ++activeIdx) {
+                std::size_t cellIdx = activeCells[activeIdx];
+                auto& fluidState = fluidStates[cellIdx];
+
+                origX[activeIdx] = fluidState.moleFraction(phaseIdx, i);
+                fluidState.setMoleFraction(phaseIdx, i, origX[activeIdx] + eps);
+                paramCaches[cellIdx].updateSingleMoleFraction(fluidState, phaseIdx, i);
+            }
+
+            // compute the derivatives of the defects of all component fugacities
+            for (unsigned j = 0; j < numComponents; ++j) {
+                for (std::size_t activeIdx = 0; activeIdx < numActive; ++activeIdx) {
+                    std::size_t cellIdx = activeCells[activeIdx];
+                    const auto& fluidState = fluidStates[cellIdx];
+
+                    const Evaluation& phi = FluidSystem::fugacityCoefficient(fluidState,
+                                                                             paramCaches[cellIdx],
+                                                                             phaseIdx,
+                                                                             j);
+                    const Evaluation& f =
+                        phi *
+                        fluidState.pressure(phaseIdx) *
+                        fluidState.moleFraction(phaseIdx, j);
+                    const Evaluation& defJPlusEps = targetFugacities[cellIdx][j] - f;
+
+                    J[activeIdx][j][i] = (defJPlusEps - defect[activeIdx][j])/eps;
+                }
+            }
+
+            // reset the compositions to their original values
+            for (std::size_t activeIdx = 0; activeIdx < numActive; ++activeIdx) {
+                std::size_t cellIdx = activeCells[activeIdx];
+                auto& fluidState = fluidStates[cellIdx];
+
+                fluidState.setMoleFraction(phaseIdx, i, origX[activeIdx]);
+                paramCaches[cellIdx].updateSingleMoleFraction(fluidState, phaseIdx, i);
+            }
+        }
+    }
+};
+
+} // namespace Ewoms
+
+#endif
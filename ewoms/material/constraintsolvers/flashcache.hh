@@ -0,0 +1,319 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the eWoms project.
+
+  eWoms is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  eWoms is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with eWoms.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*!
+ * \file
+ * \copydoc Ewoms::FlashCache
+ */
+#ifndef EWOMS_FLASH_CACHE_HH
+#define EWOMS_FLASH_CACHE_HH
+
+#include <ewoms/common/mathtoolbox.hh>
+#include <ewoms/common/exceptions.hh>
+
+#include <dune/common/fvector.hh>
+
+#include <ostream>
+#include <vector>
+#include <cmath>
+#include <cstddef>
+
+namespace Ewoms {
+
+/*!
+ * \brief Stores the results of flash calculations for a set of cells and uses them to
+ *        speed up subsequent flash calculations for the same cells.
+ *
+ * The flash solvers (\c NcpFlash, \c ImmiscibleFlash, \c RachfordRiceFlash) start from
+ * the quantities which are stored by the fluid state that gets passed to them. Since
+ * the total amount of substance in a cell usually does not change much between two
+ * flash calculations, e.g., between two Newton iterations or time steps of a
+ * simulator, the converged fluid state of the previous calculation for the same cell is
+ * a much better initial guess than the one produced by \c guessInitial(). This class
+ * keeps the converged fluid state of each cell, i.e., its pressures, saturations and
+ * phase compositions (and thus its equilibrium ratios), and
+ *
+ * - skips the flash calculation entirely if neither the temperature nor any of the
+ *   total molarities have changed by more than a relative tolerance. In this case, the
+ *   cached result is copied to the fluid state.
+ * - otherwise, uses the cached result as the initial guess of the flash solver.
+ * - uses the \c guessInitial() method of the flash solver if no result is stored for
+ *   the cell or if the flash solver did not converge starting from the cached result.
+ *
+ * Note that skipping a flash calculation means that the result does not exactly
+ * correspond to the total molarities and that the derivatives of the result are the
+ * ones of the cached solution if the fluid state uses automatic differentiation. The
+ * skip tolerance thus defaults to zero, i.e., by default the cache is only used to
+ * warm-start the flash calculations.
+ *
+ * \tparam Scalar The floating point type used for the tolerances and statistics
+ * \tparam FluidSystem The fluid system which is used by the flash solver
+ * \tparam FluidState The type of the fluid states which are passed to the flash solver
+ */
+template <class Scalar, class FluidSystem, class FluidState>
+class FlashCache
+{
+    enum { numComponents = FluidSystem::numComponents };
+
+    typedef typename FluidState::Scalar Evaluation;
+    typedef Dune::FieldVector<Evaluation, numComponents> ComponentVector;
+
+    struct Entry
+    {
+        Entry()
+            : isValid(false)
+        {}
+
+        FluidState fluidState;
+        ComponentVector globalMolarities;
+        bool isValid;
+    };
+
+public:
+    /*!
+     * \brief Counters of how the flash calculations went.
+     */
+    struct Statistics
+    {
+        Statistics()
+        { reset(); }
+
+        void reset()
+        {
+            numSkipped = 0;
+            numWarmStarts = 0;
+            numColdStarts = 0;
+            numFailedWarmStarts = 0;
+            numWarmIterations = 0;
+            numColdIterations = 0;
+        }
+
+        //! The total number of flash calculations which were requested
+        std::size_t numFlashes() const
+        { return numSkipped + numWarmStarts + numColdStarts; }
+
+        //! The fraction of flash calculations which could use a cached result
+        Scalar hitRate() const
+        {
+            std::size_t n = numFlashes();
+            return (n == 0)?0.0:static_cast<Scalar>(numSkipped + numWarmStarts)/n;
+        }
+
+        //! The average number of iterations of the flashes which used a cached result
+        Scalar averageWarmIterations() const
+        { return (numWarmStarts == 0)?0.0:static_cast<Scalar>(numWarmIterations)/numWarmStarts; }
+
+        //! The average number of iterations of the flashes which started from scratch
+        Scalar averageColdIterations() const
+        { return (numColdStarts == 0)?0.0:static_cast<Scalar>(numColdIterations)/numColdStarts; }
+
+        //! Print the statistics in a human readable form
+        void print(std::ostream& os) const
+        {
+            os << "flash calculations: " << numFlashes()
+               << ", skipped: " << numSkipped
+               << ", warm starts: " << numWarmStarts
+               << " (" << numFailedWarmStarts << " failed)"
+               << ", cold starts: " << numColdStarts
+               << ", hit rate: " << hitRate()
+               << ", avg. iterations warm/cold: "
+               << averageWarmIterations() << "/" << averageColdIterations()
+               << "\n";
+        }
+
+        std::size_t numSkipped;
+        std::size_t numWarmStarts;
+        std::size_t numColdStarts;
+        std::size_t numFailedWarmStarts;
+        std::size_t numWarmIterations;
+        std::size_t numColdIterations;
+    };
+
+    explicit FlashCache(std::size_t numCells = 0, Scalar skipTolerance = 0.0)
+        : entries_(numCells)
+        , skipTolerance_(skipTolerance)
+    {}
+
+    /*!
+     * \brief Set the number of cells. This invalidates all cached results.
+     */
+    void resize(std::size_t numCells)
+    {
+        entries_.clear();
+        entries_.resize(numCells);
+    }
+
+    /*!
+     * \brief Returns the number of cells for which results can be stored.
+     */
+    std::size_t size() const
+    { return entries_.size(); }
+
+    /*!
+     * \brief Set the relative change of the temperature and of the total molarities
+     *        below which the flash calculation is skipped.
+     *
+     * A value of zero means that flash calculations are never skipped.
+     */
+    void setSkipTolerance(Scalar value)
+    { skipTolerance_ = value; }
+
+    /*!
+     * \brief Returns the relative change of the input quantities below which the flash
+     *        calculation is skipped.
+     */
+    Scalar skipTolerance() const
+    { return skipTolerance_; }
+
+    /*!
+     * \brief Remove the cached result of a cell.
+     */
+    void invalidate(std::size_t cellIdx)
+    { entries_[cellIdx].isValid = false; }
+
+    /*!
+     * \brief Remove the cached results of all cells.
+     */
+    void invalidateAll()
+    {
+        for (auto& entry : entries_)
+            entry.isValid = false;
+    }
+
+    /*!
+     * \brief Returns true if a result is stored for a cell.
+     */
+    bool isCached(std::size_t cellIdx) const
+    { return entries_[cellIdx].isValid; }
+
+    /*!
+     * \brief Returns the statistics of the flash calculations done via the cache.
+     */
+    const Statistics& statistics() const
+    { return statistics_; }
+
+    /*!
+     * \brief Reset the statistics of the flash calculations.
+     */
+    void resetStatistics()
+    { statistics_.reset(); }
+
+    /*!
+     * \brief Calculate the chemical equilibrium of a cell using a flash solver.
+     *
+     * The temperature of the fluid state must be set. The return value is the number of
+     * iterations needed by the flash solver. (zero means that the flash calculation was
+     * skipped.) In either case, the parameter cache is consistent with the resulting
+     * fluid state.
+     */
+    template <class Flash, class MaterialLaw>
+    unsigned solve(std::size_t cellIdx,
+                   FluidState& fluidState,
+                   const typename MaterialLaw::Params& matParams,
+                   typename FluidSystem::template ParameterCache<Evaluation>& paramCache,
+                   const ComponentVector& globalMolarities,
+                   Scalar flashTolerance = -1.0)
+    {
+        Entry& entry = entries_[cellIdx];
+        const Evaluation T = fluidState.temperature(/*phaseIdx=*/0);
+
+        if (entry.isValid) {
+            if (canSkip_(entry, T, globalMolarities)) {
+                fluidState = entry.fluidState;
+                paramCache.updateAll(fluidState);
+                ++ statistics_.numSkipped;
+                return 0;
+            }
+
+            // start the flash solver from the cached result
+            fluidState = entry.fluidState;
+            fluidState.setTemperature(T);
+            try {
+                unsigned numIterations =
+                    Flash::template solve<MaterialLaw>(fluidState, matParams, paramCache,
+                                                       globalMolarities, flashTolerance);
+                ++ statistics_.numWarmStarts;
+                statistics_.numWarmIterations += numIterations;
+                store_(entry, fluidState, globalMolarities);
+                return numIterations;
+            }
+            catch (const NumericalIssue&) {
+                // fall back to the regular initial guess
+                ++ statistics_.numFailedWarmStarts;
+                entry.isValid = false;
+                fluidState.setTemperature(T);
+            }
+        }
+
+        Flash::guessInitial(fluidState, globalMolarities);
+        unsigned numIterations =
+            Flash::template solve<MaterialLaw>(fluidState, matParams, paramCache,
+                                               globalMolarities, flashTolerance);
+        ++ statistics_.numColdStarts;
+        statistics_.numColdIterations += numIterations;
+        store_(entry, fluidState, globalMolarities);
+        return numIterations;
+    }
+
+private:
+    bool canSkip_(const Entry& entry,
+                  const Evaluation& T,
+                  const ComponentVector& globalMolarities) const
+    {
+        if (skipTolerance_ <= 0.0)
+            return false;
+
+        Scalar TVal = Ewoms::scalarValue(T);
+        Scalar TCached = Ewoms::scalarValue(entry.fluidState.temperature(/*phaseIdx=*/0));
+        if (std::abs(TVal - TCached) > skipTolerance_*std::abs(TCached))
+            return false;
+
+        // the changes of the molarities are measured relative to the total molarity so
+        // that components which are present only in traces do not prevent skipping
+        Scalar totalMolarity = 0.0;
+        for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx)
+            totalMolarity += std::abs(Ewoms::scalarValue(entry.globalMolarities[compIdx]));
+
+        for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx) {
+            Scalar delta =
+                Ewoms::scalarValue(globalMolarities[compIdx])
+                - Ewoms::scalarValue(entry.globalMolarities[compIdx]);
+            if (std::abs(delta) > skipTolerance_*totalMolarity)
+                return false;
+        }
+
+        return true;
+    }
+
+    static void store_(Entry& entry,
+                       const FluidState& fluidState,
+                       const ComponentVector& globalMolarities)
+    {
+        entry.fluidState = fluidState;
+        entry.globalMolarities = globalMolarities;
+        entry.isValid = true;
+    }
+
+    std::vector<Entry> entries_;
+    Scalar skipTolerance_;
+    Statistics statistics_;
+};
+
+} // namespace Ewoms
+
+#endif
@@ -102,14 +102,16 @@ public:
      * \brief Calculates the chemical equilibrium from the component
      *        fugacities in a phase.
      *
-     * The phase's fugacities must already be set.
+     * The phase's fugacities must already be set. The return value is the number of
+     * Newton iterations which were required. If all phases are incompressible, the
+     * saturations are determined directly, which counts as a single iteration.
      */
     template <class MaterialLaw, class FluidState>
-    static void solve(FluidState& fluidState,
-                      const typename MaterialLaw::Params& matParams,
-                      typename FluidSystem::template ParameterCache<typename FluidState::Scalar>& paramCache,
-                      const Dune::FieldVector<typename FluidState::Scalar, numComponents>& globalMolarities,
-                      Scalar tolerance = -1)
+    static unsigned solve(FluidState& fluidState,
+                          const typename MaterialLaw::Params& matParams,
+                          typename FluidSystem::template ParameterCache<typename FluidState::Scalar>& paramCache,
+                          const Dune::FieldVector<typename FluidState::Scalar, numComponents>& globalMolarities,
+                          Scalar tolerance = -1)
     {
         typedef typename FluidState::Scalar InputEval;
 
@@ -130,7 +132,7 @@ public:
             // determination is much simpler than a full flash calculation.)
             paramCache.updateAll(fluidState);
             solveAllIncompressible_(fluidState, paramCache, globalMolarities);
-            return;
+            return 1;
         }
 
         typedef Dune::FieldMatrix<InputEval, numEq, numEq> Matrix;
@@ -208,7 +210,7 @@ public:
 
             if (relError < tolerance) {
                 assignOutputFluidState_(flashFluidState, fluidState);
-                return;
+                return nIdx + 1;
             }
         }
 
@@ -37,6 +37,7 @@
 #include <dune/common/fmatrix.hh>
 #include <dune/common/version.hh>
 
+#include <array>
 #include <limits>
 #include <iostream>
 
@@ -138,25 +139,25 @@ public:
      * \brief Calculates the chemical equilibrium from the component
      *        fugacities in a phase.
      *
-     * The phase's fugacities must already be set.
+     * The phase's fugacities must already be set. The return value is the number of
+     * Newton iterations which were required.
      */
     template <class MaterialLaw, class FluidState>
-    static void solve(FluidState& fluidState,
-                      const typename MaterialLaw::Params& matParams,
-                      typename FluidSystem::template ParameterCache<typename FluidState::Scalar>& paramCache,
-                      const Dune::FieldVector<typename FluidState::Scalar, numComponents>& globalMolarities,
-                      Scalar tolerance = -1.0)
+    static unsigned solve(FluidState& fluidState,
+                          const typename MaterialLaw::Params& matParams,
+                          typename FluidSystem::template ParameterCache<typename FluidState::Scalar>& paramCache,
+                          const Dune::FieldVector<typename FluidState::Scalar, numComponents>& globalMolarities,
+                          Scalar tolerance = -1.0)
     {
         typedef typename FluidState::Scalar InputEval;
 
         typedef Dune::FieldMatrix<InputEval, numEq, numEq> Matrix;
         typedef Dune::FieldVector<InputEval, numEq> Vector;
 
-        typedef Ewoms::DenseAd::Evaluation</*Scalar=*/InputEval,
-                                         /*numDerivs=*/numEq> FlashEval;
-
-        typedef Dune::FieldVector<FlashEval, numEq> FlashDefectVector;
-        typedef Ewoms::CompositionalFluidState<FlashEval, FluidSystem, /*energy=*/false> FlashFluidState;
+        // the fluid state of the flash solver only stores values. the derivatives which
+        // are required to assemble the Jacobian matrix are determined phase by phase,
+        // see linearize_().
+        typedef Ewoms::CompositionalFluidState<InputEval, FluidSystem, /*energy=*/false> FlashFluidState;
 
 #if ! DUNE_VERSION_NEWER(DUNE_COMMON, 2,7)
         Dune::FMatrixPrecision<InputEval>::set_singular_limit(1e-35);
@@ -166,7 +167,7 @@ public:
             tolerance = std::min<Scalar>(1e-3,
                                          1e8*std::numeric_limits<Scalar>::epsilon());
 
-        typename FluidSystem::template ParameterCache<FlashEval> flashParamCache;
+        typename FluidSystem::template ParameterCache<InputEval> flashParamCache;
         flashParamCache.assignPersistentData(paramCache);
 
         /////////////////////////
@@ -185,30 +186,12 @@ public:
         Valgrind::SetUndefined(b);
 
         FlashFluidState flashFluidState;
-        assignFlashFluidState_<MaterialLaw>(fluidState, flashFluidState, matParams, flashParamCache);
+        assignFlashFluidState_(fluidState, flashFluidState);
 
-        // copy the global molarities to a vector of evaluations. Remember that the
-        // global molarities are constants. (but we need to copy them to a vector of
-        // FlashEvals anyway in order to avoid getting into hell's kitchen.)
-        Dune::FieldVector<FlashEval, numComponents> flashGlobalMolarities;
-        for (unsigned compIdx = 0; compIdx < numComponents; ++ compIdx)
-            flashGlobalMolarities[compIdx] = globalMolarities[compIdx];
-
-        FlashDefectVector defect;
         const unsigned nMax = 50; // <- maximum number of newton iterations
         for (unsigned nIdx = 0; nIdx < nMax; ++nIdx) {
             // calculate the defect of the flash equations and their derivatives
-            evalDefect_(defect, flashFluidState, flashGlobalMolarities);
-            Valgrind::CheckDefined(defect);
-
-            // create field matrices and vectors out of the evaluation vector to solve
-            // the linear system of equations.
-            for (unsigned eqIdx = 0; eqIdx < numEq; ++ eqIdx) {
-                for (unsigned pvIdx = 0; pvIdx < numEq; ++ pvIdx)
-                    J[eqIdx][pvIdx] = defect[eqIdx].derivative(pvIdx);
-
-                b[eqIdx] = defect[eqIdx].value();
-            }
+            linearize_<MaterialLaw>(J, b, flashFluidState, matParams, paramCache, globalMolarities);
             Valgrind::CheckDefined(J);
             Valgrind::CheckDefined(b);
 
@@ -221,11 +204,12 @@ public:
             Valgrind::CheckDefined(deltaX);
 
             // update the fluid quantities.
-            Scalar relError = update_<MaterialLaw>(flashFluidState, matParams, flashParamCache, deltaX);
+            Scalar relError = update_(flashFluidState, deltaX);
 
             if (relError < tolerance) {
+                completeFluidState_<MaterialLaw>(flashFluidState, flashParamCache, matParams);
                 assignOutputFluidState_(flashFluidState, fluidState);
-                return;
+                return nIdx + 1;
             }
         }
 
@@ -304,11 +288,9 @@ protected:
         std::cout << "\n";
     }
 
-    template <class MaterialLaw, class InputFluidState, class FlashFluidState>
+    template <class InputFluidState, class FlashFluidState>
     static void assignFlashFluidState_(const InputFluidState& inputFluidState,
-                                       FlashFluidState& flashFluidState,
-                                       const typename MaterialLaw::Params& matParams,
-                                       typename FluidSystem::template ParameterCache<typename FlashFluidState::Scalar>& flashParamCache)
+                                       FlashFluidState& flashFluidState)
     {
         typedef typename FlashFluidState::Scalar FlashEval;
 
@@ -323,96 +305,184 @@ protected:
         // is one minus the sum of the former.
         FlashEval Slast = 1.0;
         for (unsigned phaseIdx = 0; phaseIdx < numPhases - 1; ++phaseIdx) {
-            FlashEval S = inputFluidState.saturation(phaseIdx);
-            S.setDerivative(S0PvIdx + phaseIdx, 1.0);
-
+            const FlashEval& S = inputFluidState.saturation(phaseIdx);
             Slast -= S;
-
             flashFluidState.setSaturation(phaseIdx, S);
         }
         flashFluidState.setSaturation(numPhases - 1, Slast);
 
-        // copy the pressures: the first pressure is the first primary variable, the
-        // remaining ones are given as p_beta = p_alpha + p_calpha,beta
-        FlashEval p0 = inputFluidState.pressure(0);
-        p0.setDerivative(p0PvIdx, 1.0);
-
-        std::array<FlashEval, numPhases> pc;
-        MaterialLaw::capillaryPressures(pc, matParams, flashFluidState);
+        // copy the pressures. the pressures of all phases except the first one are
+        // overwritten using the capillary pressures in linearize_()
         for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx)
-            flashFluidState.setPressure(phaseIdx, p0 + (pc[phaseIdx] - pc[0]));
+            flashFluidState.setPressure(phaseIdx, inputFluidState.pressure(phaseIdx));
 
         // copy the mole fractions: all of them are primary variables
-        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
-            for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx) {
-                FlashEval x = inputFluidState.moleFraction(phaseIdx, compIdx);
-                x.setDerivative(x00PvIdx + phaseIdx*numComponents + compIdx, 1.0);
-                flashFluidState.setMoleFraction(phaseIdx, compIdx, x);
-            }
-        }
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx)
+            for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx)
+                flashFluidState.setMoleFraction(phaseIdx, compIdx,
+                                                inputFluidState.moleFraction(phaseIdx, compIdx));
+    }
 
-        flashParamCache.updateAll(flashFluidState);
+    template <class FlashFluidState, class OutputFluidState>
+    static void assignOutputFluidState_(const FlashFluidState& flashFluidState,
+                                        OutputFluidState& outputFluidState)
+    {
+        outputFluidState.setTemperature(flashFluidState.temperature(/*phaseIdx=*/0));
 
-        // compute the density of each phase and the fugacity coefficient of each
-        // component in each phase.
+        // copy the saturations, pressures and densities
         for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
-            const FlashEval& rho = FluidSystem::density(flashFluidState, flashParamCache, phaseIdx);
-            flashFluidState.setDensity(phaseIdx, rho);
+            outputFluidState.setSaturation(phaseIdx, flashFluidState.saturation(phaseIdx));
+            outputFluidState.setPressure(phaseIdx, flashFluidState.pressure(phaseIdx));
+            outputFluidState.setDensity(phaseIdx, flashFluidState.density(phaseIdx));
+        }
 
+        // copy the mole fractions and fugacity coefficients
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
             for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx) {
-                const FlashEval& fugCoeff = FluidSystem::fugacityCoefficient(flashFluidState, flashParamCache, phaseIdx, compIdx);
-                flashFluidState.setFugacityCoefficient(phaseIdx, compIdx, fugCoeff);
+                outputFluidState.setMoleFraction(phaseIdx, compIdx,
+                                                 flashFluidState.moleFraction(phaseIdx, compIdx));
+                outputFluidState.setFugacityCoefficient(phaseIdx, compIdx,
+                                                        flashFluidState.fugacityCoefficient(phaseIdx, compIdx));
             }
         }
     }
 
-    template <class FlashFluidState, class OutputFluidState>
-    static void assignOutputFluidState_(const FlashFluidState& flashFluidState,
-                                        OutputFluidState& outputFluidState)
+    /*!
+     * \brief Assemble the Jacobian matrix and the defect of the flash equations.
+     *
+     * Instead of evaluating all quantities using M*(N + 1) derivatives, this method
+     * exploits the structure of the system of equations: The density and the fugacity
+     * coefficients of a phase only depend on temperature, the pressure and the
+     * composition of the phase itself. These quantities are thus evaluated for each phase
+     * separately with N + 1 derivatives. The saturations only enter via the capillary
+     * pressure and the total molarities, which are evaluated using M - 1 derivatives.
+     * The resulting derivatives are then combined into the rows of the Jacobian using
+     * the chain rule:
+     *
+     * - The fugacity equations only couple the pressure, the capillary pressures and the
+     *   compositions of two phases.
+     * - The equations for the total molarities couple everything.
+     * - The NCP constraints are either given by a single saturation or by the mole
+     *   fractions of a single phase.
+     */
+    template <class MaterialLaw, class FlashFluidState, class Matrix, class Vector, class InputParamCache, class ComponentVector>
+    static void linearize_(Matrix& J,
+                           Vector& b,
+                           FlashFluidState& fluidState,
+                           const typename MaterialLaw::Params& matParams,
+                           const InputParamCache& inputParamCache,
+                           const ComponentVector& globalMolarities)
     {
-        outputFluidState.setTemperature(flashFluidState.temperature(/*phaseIdx=*/0).value());
+        typedef typename FlashFluidState::Scalar InputEval;
+
+        // evaluation which uses the saturations of the first M - 1 phases as primary
+        // variables
+        typedef Ewoms::DenseAd::Evaluation<InputEval, numPhases - 1> SatEval;
+        typedef Ewoms::CompositionalFluidState<SatEval, FluidSystem, /*energy=*/false> SatFluidState;
+
+        // evaluation which uses the pressure and the mole fractions of a single phase
+        // as primary variables
+        typedef Ewoms::DenseAd::Evaluation<InputEval, numComponents + 1> PhaseEval;
+        typedef Ewoms::CompositionalFluidState<PhaseEval, FluidSystem, /*energy=*/false> PhaseFluidState;
+
+        J = 0.0;
+
+        /////////////////////////
+        // saturations and capillary pressures
+        /////////////////////////
+        SatFluidState satFluidState;
+        satFluidState.setTemperature(fluidState.temperature(/*phaseIdx=*/0));
+
+        std::array<SatEval, numPhases> S;
+        S[numPhases - 1] = 1.0;
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases - 1; ++phaseIdx) {
+            S[phaseIdx] = fluidState.saturation(phaseIdx);
+            S[phaseIdx].setDerivative(phaseIdx, 1.0);
+            S[numPhases - 1] -= S[phaseIdx];
+        }
 
-        // copy the saturations, pressures and densities
         for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
-            const auto& S = flashFluidState.saturation(phaseIdx).value();
-            outputFluidState.setSaturation(phaseIdx, S);
+            satFluidState.setSaturation(phaseIdx, S[phaseIdx]);
+            satFluidState.setPressure(phaseIdx, fluidState.pressure(phaseIdx));
+        }
+        fluidState.setSaturation(numPhases - 1, S[numPhases - 1].value());
 
-            const auto& p = flashFluidState.pressure(phaseIdx).value();
-            outputFluidState.setPressure(phaseIdx, p);
+        // the pressures of the phases: p_alpha = p_0 + pc_alpha - pc_0. the derivative
+        // with regard to p_0 is always 1, so only the one with regard to the saturations
+        // is stored.
+        std::array<SatEval, numPhases> pc;
+        MaterialLaw::capillaryPressures(pc, matParams, satFluidState);
 
-            const auto& rho = flashFluidState.density(phaseIdx).value();
-            outputFluidState.setDensity(phaseIdx, rho);
+        std::array<SatEval, numPhases> p;
+        const InputEval p0 = fluidState.pressure(/*phaseIdx=*/0);
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+            p[phaseIdx] = p0 + (pc[phaseIdx] - pc[0]);
+            fluidState.setPressure(phaseIdx, p[phaseIdx].value());
         }
 
-        // copy the mole fractions and fugacity coefficients
+        /////////////////////////
+        // phase-local quantities
+        /////////////////////////
+        PhaseFluidState phaseFluidState;
+        phaseFluidState.setTemperature(fluidState.temperature(/*phaseIdx=*/0));
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+            phaseFluidState.setPressure(phaseIdx, fluidState.pressure(phaseIdx));
+            for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx)
+                phaseFluidState.setMoleFraction(phaseIdx, compIdx, fluidState.moleFraction(phaseIdx, compIdx));
+        }
+
+        typename FluidSystem::template ParameterCache<PhaseEval> phaseParamCache;
+        phaseParamCache.assignPersistentData(inputParamCache);
+
+        // the fugacities and molarities of all components in all phases. their
+        // derivatives are with regard to the pressure and the composition of the
+        // respective phase.
+        std::array<std::array<PhaseEval, numComponents>, numPhases> fugacity;
+        std::array<std::array<PhaseEval, numComponents>, numPhases> molarity;
         for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+            PhaseEval pPhase = fluidState.pressure(phaseIdx);
+            pPhase.setDerivative(/*pvIdx=*/0, 1.0);
+            phaseFluidState.setPressure(phaseIdx, pPhase);
+
+            for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx) {
+                PhaseEval x = fluidState.moleFraction(phaseIdx, compIdx);
+                x.setDerivative(/*pvIdx=*/1 + compIdx, 1.0);
+                phaseFluidState.setMoleFraction(phaseIdx, compIdx, x);
+            }
+
+            phaseParamCache.updatePhase(phaseFluidState, phaseIdx);
+
+            const PhaseEval& rho = FluidSystem::density(phaseFluidState, phaseParamCache, phaseIdx);
+            phaseFluidState.setDensity(phaseIdx, rho);
+            fluidState.setDensity(phaseIdx, rho.value());
+
             for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx) {
-                const auto& moleFrac =
-                    flashFluidState.moleFraction(phaseIdx, compIdx).value();
-                outputFluidState.setMoleFraction(phaseIdx, compIdx, moleFrac);
+                const PhaseEval& phi =
+                    FluidSystem::fugacityCoefficient(phaseFluidState, phaseParamCache, phaseIdx, compIdx);
+                fluidState.setFugacityCoefficient(phaseIdx, compIdx, phi.value());
 
-                const auto& fugCoeff =
-                    flashFluidState.fugacityCoefficient(phaseIdx, compIdx).value();
-                outputFluidState.setFugacityCoefficient(phaseIdx, compIdx, fugCoeff);
+                fugacity[phaseIdx][compIdx] = phi*phaseFluidState.moleFraction(phaseIdx, compIdx)*pPhase;
+                molarity[phaseIdx][compIdx] = phaseFluidState.molarity(phaseIdx, compIdx);
             }
-        }
-    }
 
-    template <class FlashFluidState, class FlashDefectVector, class FlashComponentVector>
-    static void evalDefect_(FlashDefectVector& b,
-                            const FlashFluidState& fluidState,
-                            const FlashComponentVector& globalMolarities)
-    {
-        typedef typename FlashFluidState::Scalar FlashEval;
+            // the quantities of the phase are constants for the remaining phases
+            phaseFluidState.setPressure(phaseIdx, fluidState.pressure(phaseIdx));
+            phaseFluidState.setDensity(phaseIdx, rho.value());
+            for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx)
+                phaseFluidState.setMoleFraction(phaseIdx, compIdx, fluidState.moleFraction(phaseIdx, compIdx));
+        }
 
+        /////////////////////////
+        // assemble the rows of the Jacobian matrix
+        /////////////////////////
         unsigned eqIdx = 0;
 
         // fugacity of any component must be equal in all phases
         for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx) {
             for (unsigned phaseIdx = 1; phaseIdx < numPhases; ++phaseIdx) {
-                b[eqIdx] =
-                    fluidState.fugacity(/*phaseIdx=*/0, compIdx)
-                    - fluidState.fugacity(phaseIdx, compIdx);
+                b[eqIdx] = fugacity[0][compIdx].value() - fugacity[phaseIdx][compIdx].value();
+                addPhaseDerivatives_(J[eqIdx], fugacity[0][compIdx], p[0], /*phaseIdx=*/0, 1.0);
+                addPhaseDerivatives_(J[eqIdx], fugacity[phaseIdx][compIdx], p[phaseIdx], phaseIdx, -1.0);
                 ++eqIdx;
             }
         }
@@ -423,41 +493,68 @@ protected:
 
         // global molarities are given
         for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx) {
-            b[eqIdx] = 0.0;
+            b[eqIdx] = -globalMolarities[compIdx];
             for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
-                b[eqIdx] +=
-                    fluidState.saturation(phaseIdx)
-                    * fluidState.molarity(phaseIdx, compIdx);
-            }
+                const PhaseEval& c = molarity[phaseIdx][compIdx];
+                b[eqIdx] += S[phaseIdx].value()*c.value();
 
-            b[eqIdx] -= globalMolarities[compIdx];
+                addPhaseDerivatives_(J[eqIdx], c, p[phaseIdx], phaseIdx, S[phaseIdx].value());
+                for (unsigned satIdx = 0; satIdx < numPhases - 1; ++satIdx)
+                    J[eqIdx][S0PvIdx + satIdx] += c.value()*S[phaseIdx].derivative(satIdx);
+            }
             ++eqIdx;
         }
 
         // model assumptions (-> non-linear complementarity functions) must be adhered
         for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
-            FlashEval oneMinusSumMoleFrac = 1.0;
+            InputEval oneMinusSumMoleFrac = 1.0;
             for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx)
                 oneMinusSumMoleFrac -= fluidState.moleFraction(phaseIdx, compIdx);
 
-            if (oneMinusSumMoleFrac > fluidState.saturation(phaseIdx))
-                b[eqIdx] = fluidState.saturation(phaseIdx);
-            else
+            if (oneMinusSumMoleFrac > S[phaseIdx].value()) {
+                b[eqIdx] = S[phaseIdx].value();
+                for (unsigned satIdx = 0; satIdx < numPhases - 1; ++satIdx)
+                    J[eqIdx][S0PvIdx + satIdx] = S[phaseIdx].derivative(satIdx);
+            }
+            else {
                 b[eqIdx] = oneMinusSumMoleFrac;
+                for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx)
+                    J[eqIdx][x00PvIdx + phaseIdx*numComponents + compIdx] = -1.0;
+            }
 
             ++eqIdx;
         }
     }
 
-    template <class MaterialLaw, class FlashFluidState, class EvalVector>
+    /*!
+     * \brief Add the derivatives of a quantity which only depends on the pressure and
+     *        the composition of a phase to a row of the Jacobian matrix.
+     */
+    template <class Row, class PhaseEval, class SatEval>
+    static void addPhaseDerivatives_(Row& row,
+                                     const PhaseEval& quantity,
+                                     const SatEval& phasePressure,
+                                     unsigned phaseIdx,
+                                     Scalar factor)
+    {
+        // pressure of the first phase and saturations via the capillary pressure
+        const auto& dq_dp = quantity.derivative(/*pvIdx=*/0);
+        row[p0PvIdx] += factor*dq_dp;
+        for (unsigned satIdx = 0; satIdx < numPhases - 1; ++satIdx)
+            row[S0PvIdx + satIdx] += factor*dq_dp*phasePressure.derivative(satIdx);
+
+        // mole fractions of the phase
+        for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx)
+            row[x00PvIdx + phaseIdx*numComponents + compIdx] += factor*quantity.derivative(/*pvIdx=*/1 + compIdx);
+    }
+
+    template <class FlashFluidState, class EvalVector>
     static Scalar update_(FlashFluidState& fluidState,
-                          const typename MaterialLaw::Params& matParams,
-                          typename FluidSystem::template ParameterCache<typename FlashFluidState::Scalar>& paramCache,
                           const EvalVector& deltaX)
     {
-        // note that it is possible that FlashEval::Scalar is an Evaluation itself
-        typedef typename FlashFluidState::Scalar FlashEval;
-        typedef typename FlashEval::ValueType InnerEval;
+        // note that it is possible that the scalar type of the flash fluid state is an
+        // Evaluation itself
+        typedef typename FlashFluidState::Scalar InputEval;
 
 #ifndef NDEBUG
         // make sure we don't swallow non-finite update vectors
@@ -468,8 +565,8 @@ protected:
 
         Scalar relError = 0;
         for (unsigned pvIdx = 0; pvIdx < numEq; ++ pvIdx) {
-            FlashEval tmp = getQuantity_(fluidState, pvIdx);
-            InnerEval delta = deltaX[pvIdx];
+            InputEval tmp = getQuantity_(fluidState, pvIdx);
+            InputEval delta = deltaX[pvIdx];
 
             relError = std::max(relError,
                                 std::abs(Ewoms::scalarValue(delta))
@@ -485,8 +582,8 @@ protected:
             }
             else if (isPressureIdx_(pvIdx)) {
                 // dampen to at most 50% change in pressure per iteration
-                delta = Ewoms::min(0.5*fluidState.pressure(0).value(),
-                                 Ewoms::max(-0.5*fluidState.pressure(0).value(),
+                delta = Ewoms::min(0.5*fluidState.pressure(0),
+                                 Ewoms::max(-0.5*fluidState.pressure(0),
                                           delta));
             }
 
@@ -494,8 +591,6 @@ protected:
             setQuantity_(fluidState, pvIdx, tmp);
         }
 
-        completeFluidState_<MaterialLaw>(fluidState, paramCache, matParams);
-
         return relError;
     }
 
@@ -0,0 +1,808 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the eWoms project.
+
+  eWoms is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  eWoms is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with eWoms.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*!
+ * \file
+ * \copydoc Ewoms::RachfordRiceFlash
+ */
+#ifndef EWOMS_RACHFORD_RICE_FLASH_HH
+#define EWOMS_RACHFORD_RICE_FLASH_HH
+
+#include <ewoms/material/constraintsolvers/ncpflash.hh>
+#include <ewoms/material/fluidmatrixinteractions/nullmaterial.hh>
+#include <ewoms/material/fluidmatrixinteractions/materialtraits.hh>
+#include <ewoms/material/fluidstates/compositionalfluidstate.hh>
+#include <ewoms/common/densead/evaluation.hh>
+#include <ewoms/common/densead/math.hh>
+#include <ewoms/common/mathtoolbox.hh>
+#include <ewoms/common/valgrind.hh>
+
+#include <ewoms/common/exceptions.hh>
+
+#include <dune/common/fvector.hh>
+#include <dune/common/fmatrix.hh>
+
+#include <array>
+#include <limits>
+#include <sstream>
+
+namespace Ewoms {
+
+/*!
+ * \brief Determines the phase compositions, pressures and saturations of a two-phase
+ *        system given the total mass of all components using a reduced set of
+ *        variables.
+ *
+ * This constraint solver solves the same problem as the \c NcpFlash, but instead of
+ * solving for all M*(N + 1) unknowns at once, it splits the problem into a sequence of
+ * much smaller ones:
+ *
+ * - An outer Newton method which only uses the pressure of the first phase as primary
+ *   variable and matches the volume occupied by the fluids with the pore volume.
+ * - For a given pressure, the phase split is determined by a stability test which is
+ *   followed by a successive substitution of the equilibrium ratios
+ *   \f$K^\kappa = x_1^\kappa/x_0^\kappa\f$. In each of its iterations, the amount of
+ *   substance of the second phase \f$\beta\f$ is given by the Rachford-Rice equation
+ *   \f[ \sum_\kappa \frac{z^\kappa (K^\kappa - 1)}{1 + \beta (K^\kappa - 1)} = 0 \f]
+ * - Once the successive substitution is close to the solution, it is accelerated by a
+ *   Newton method which only uses the N logarithms of the equilibrium ratios as primary
+ *   variables.
+ *
+ * As a result, the largest linear system of equations which needs to be solved is of
+ * size N x N instead of M*(N + 1) x M*(N + 1) and the fluid system only needs to be
+ * evaluated with a single derivative during the bulk of the iterations. Like for the
+ * \c NcpFlash, the composition of a phase which is not present is given by the
+ * fugacities of the present phase, i.e., its mole fractions do not necessarily sum up
+ * to one.
+ *
+ * Since the Rachford-Rice equation describes the split of a mixture into two parts,
+ * this constraint solver is restricted to fluid systems which exhibit two fluid
+ * phases.
+ *
+ * Note that this solver is not necessarily faster than the \c NcpFlash: Each
+ * iteration of the pressure loop requires a full phase split, and the Newton method
+ * for the equilibrium ratios evaluates the fluid system with N derivatives. For the
+ * six hydrocarbon components of the SPE-5 problem and the Peng-Robinson equation of
+ * state, it is currently about three times slower than the \c NcpFlash (see
+ * test_pengrobinson). For the water-nitrogen cases of test_ncpflash, it is faster if
+ * only a single phase is present and slower if both phases are present.
+ */
+template <class Scalar, class FluidSystem>
+class RachfordRiceFlash
+{
+    enum { numPhases = FluidSystem::numPhases };
+    enum { numComponents = FluidSystem::numComponents };
+
+    static_assert(numPhases == 2,
+                  "The Rachford-Rice flash requires fluid systems with two phases");
+
+    // the phases which are present for a given pressure
+    enum PhaseState {
+        onlyPhase0,
+        onlyPhase1,
+        bothPhases
+    };
+
+public:
+    /*!
+     * \brief Guess initial values for all quantities.
+     */
+    template <class FluidState, class Evaluation = typename FluidState::Scalar>
+    static void guessInitial(FluidState& fluidState,
+                             const Dune::FieldVector<Evaluation, numComponents>& globalMolarities)
+    { NcpFlash<Scalar, FluidSystem>::guessInitial(fluidState, globalMolarities); }
+
+    /*!
+     * \brief Calculates the chemical equilibrium from the total amount of substance of
+     *        each component.
+     *
+     * The pressure and the saturations of the fluid state are used as the initial
+     * guess. The return value is the number of iterations of the pressure loop which
+     * were required.
+     */
+    template <class MaterialLaw, class FluidState>
+    static unsigned solve(FluidState& fluidState,
+                          const typename MaterialLaw::Params& matParams,
+                          typename FluidSystem::template ParameterCache<typename FluidState::Scalar>& paramCache,
+                          const Dune::FieldVector<typename FluidState::Scalar, numComponents>& globalMolarities,
+                          Scalar tolerance = -1.0)
+    {
+        typedef typename FluidState::Scalar InputEval;
+        typedef Dune::FieldVector<InputEval, numComponents> ComponentVector;
+
+        // the evaluation type of the outer iterations: the only primary variable is the
+        // pressure of the first phase
+        typedef Ewoms::DenseAd::Evaluation</*Scalar=*/InputEval,
+                                         /*numDerivs=*/1> FlashEval;
+
+        typedef Ewoms::CompositionalFluidState<FlashEval, FluidSystem, /*energy=*/false> FlashFluidState;
+        typedef Ewoms::CompositionalFluidState<InputEval, FluidSystem, /*energy=*/false> EquilFluidState;
+
+        if (tolerance <= 0)
+            tolerance = std::min<Scalar>(1e-3,
+                                         1e8*std::numeric_limits<Scalar>::epsilon());
+
+        // the overall composition of the mixture
+        InputEval totalMolarity = 0.0;
+        for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx)
+            totalMolarity += globalMolarities[compIdx];
+
+        ComponentVector z;
+        for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx)
+            z[compIdx] = globalMolarities[compIdx]/totalMolarity;
+
+        typename FluidSystem::template ParameterCache<FlashEval> flashParamCache;
+        flashParamCache.assignPersistentData(paramCache);
+
+        FlashFluidState flashFluidState;
+        EquilFluidState equilFluidState;
+        flashFluidState.setTemperature(fluidState.temperature(/*phaseIdx=*/0));
+        equilFluidState.setTemperature(fluidState.temperature(/*phaseIdx=*/0));
+
+        InputEval p0 = fluidState.pressure(/*phaseIdx=*/0);
+        std::array<InputEval, numPhases> S;
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx)
+            S[phaseIdx] = fluidState.saturation(phaseIdx);
+
+        // the equilibrium ratios of the last outer iteration are used as the starting
+        // point of the next one if both phases were present.
+        ComponentVector K;
+        bool haveK = false;
+
+        const unsigned nMax = 50; // <- maximum number of newton iterations
+        for (unsigned nIdx = 0; nIdx < nMax; ++nIdx) {
+            const FlashEval& defect =
+                evalVolumeDefect_<MaterialLaw>(flashFluidState, flashParamCache,
+                                               equilFluidState, paramCache,
+                                               matParams, p0, S, z, K, haveK,
+                                               totalMolarity, tolerance);
+
+            if (!std::isfinite(Ewoms::scalarValue(defect.derivative(0)))
+                || Ewoms::scalarValue(defect.derivative(0)) == 0.0)
+                break;
+
+            InputEval deltaP = defect.value()/defect.derivative(0);
+
+            // dampen to at most 50% change in pressure per iteration
+            deltaP = Ewoms::min(0.5*p0, Ewoms::max(-0.5*p0, deltaP));
+
+            Scalar relError = std::abs(Ewoms::scalarValue(deltaP)/Ewoms::scalarValue(p0));
+
+            // the saturations are the fractions of the fluid volume occupied by the
+            // respective phases
+            InputEval sumS = 0.0;
+            for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx)
+                sumS += flashFluidState.saturation(phaseIdx).value();
+            for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+                const InputEval& newS = flashFluidState.saturation(phaseIdx).value()/sumS;
+                relError = std::max(relError, std::abs(Ewoms::scalarValue(newS - S[phaseIdx])));
+                S[phaseIdx] = newS;
+            }
+
+            p0 -= deltaP;
+
+            if (relError < tolerance) {
+                // update all quantities for the final pressure
+                evalVolumeDefect_<MaterialLaw>(flashFluidState, flashParamCache,
+                                               equilFluidState, paramCache,
+                                               matParams, p0, S, z, K, haveK,
+                                               totalMolarity, tolerance);
+
+                assignOutputFluidState_(flashFluidState, fluidState);
+                return nIdx + 1;
+            }
+        }
+
+        std::ostringstream oss;
+        oss << "RachfordRiceFlash solver failed:"
+            << " {c_alpha^kappa} = {" << globalMolarities << "}, "
+            << " T = " << fluidState.temperature(/*phaseIdx=*/0);
+        throw NumericalIssue(oss.str());
+    }
+
+    /*!
+     * \brief Calculates the chemical equilibrium from the total amount of substance of
+     *        each component.
+     *
+     * This is a convenience method which assumes that the capillary pressure is
+     * zero. Like the general method, it returns the number of iterations of the
+     * pressure loop.
+     */
+    template <class FluidState, class ComponentVector>
+    static unsigned solve(FluidState& fluidState,
+                          const ComponentVector& globalMolarities,
+                          Scalar tolerance = 0.0)
+    {
+        typedef NullMaterialTraits<Scalar, numPhases> MaterialTraits;
+        typedef NullMaterial<MaterialTraits> MaterialLaw;
+        typedef typename MaterialLaw::Params MaterialLawParams;
+        typedef typename FluidState::Scalar InputEval;
+
+        MaterialLawParams matParams;
+        typename FluidSystem::template ParameterCache<InputEval> paramCache;
+        paramCache.updateAll(fluidState);
+        return solve<MaterialLaw>(fluidState, matParams, paramCache, globalMolarities, tolerance);
+    }
+
+protected:
+    /*!
+     * \brief Computes the phase equilibrium for the given pressure and returns the
+     *        difference between the volume occupied by the fluids and the pore volume.
+     *
+     * The derivative of the result is the one with regard to the pressure of the first
+     * phase.
+     */
+    template <class MaterialLaw, class FlashFluidState, class FlashParamCache,
+              class EquilFluidState, class EquilParamCache, class InputEval, class ComponentVector>
+    static typename FlashFluidState::Scalar
+    evalVolumeDefect_(FlashFluidState& flashFluidState,
+                      FlashParamCache& flashParamCache,
+                      EquilFluidState& equilFluidState,
+                      EquilParamCache& equilParamCache,
+                      const typename MaterialLaw::Params& matParams,
+                      const InputEval& p0,
+                      const std::array<InputEval, numPhases>& S,
+                      const ComponentVector& z,
+                      ComponentVector& K,
+                      bool& haveK,
+                      const InputEval& totalMolarity,
+                      Scalar tolerance)
+    {
+        typedef typename FlashFluidState::Scalar FlashEval;
+
+        // set the pressures. the capillary pressure is taken into account explicitly,
+        // i.e., it uses the saturations of the last iteration.
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx)
+            flashFluidState.setSaturation(phaseIdx, S[phaseIdx]);
+
+        FlashEval p0Eval = p0;
+        p0Eval.setDerivative(/*pvIdx=*/0, 1.0);
+
+        std::array<FlashEval, numPhases> pc;
+        MaterialLaw::capillaryPressures(pc, matParams, flashFluidState);
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+            flashFluidState.setPressure(phaseIdx, p0Eval + (pc[phaseIdx] - pc[0]));
+            equilFluidState.setPressure(phaseIdx, flashFluidState.pressure(phaseIdx).value());
+        }
+
+        // determine the phase split for the current pressures
+        InputEval beta;
+        PhaseState phaseState =
+            computeEquilibrium_(equilFluidState, equilParamCache, z, K, beta, haveK, tolerance);
+        haveK = (phaseState == bothPhases);
+
+        // copy the compositions to the fluid state which is used for the pressure
+        // derivatives. the equilibrium ratios are then re-evaluated in order to get the
+        // derivatives of the phase split.
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx)
+            for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx)
+                flashFluidState.setMoleFraction(phaseIdx, compIdx,
+                                                equilFluidState.moleFraction(phaseIdx, compIdx));
+        flashParamCache.updateAll(flashFluidState);
+
+        std::array<FlashEval, numComponents> flashK;
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+            for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx) {
+                const FlashEval& phi =
+                    FluidSystem::fugacityCoefficient(flashFluidState, flashParamCache, phaseIdx, compIdx);
+                flashFluidState.setFugacityCoefficient(phaseIdx, compIdx, phi);
+            }
+        }
+
+        FlashEval flashBeta = beta;
+        if (phaseState == bothPhases) {
+            for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx)
+                flashK[compIdx] =
+                    flashFluidState.fugacityCoefficient(/*phaseIdx=*/0, compIdx)
+                    * flashFluidState.pressure(/*phaseIdx=*/0)
+                    / (flashFluidState.fugacityCoefficient(/*phaseIdx=*/1, compIdx)
+                       * flashFluidState.pressure(/*phaseIdx=*/1));
+
+            solveRachfordRice_(flashBeta, z, flashK);
+            setPhaseCompositions_(flashFluidState, z, flashK, flashBeta);
+            flashParamCache.updateAll(flashFluidState, /*except=*/FlashParamCache::Temperature);
+        }
+
+        // calculate the volume occupied by each phase
+        FlashEval defect = -1.0;
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+            const FlashEval& rho = FluidSystem::density(flashFluidState, flashParamCache, phaseIdx);
+            flashFluidState.setDensity(phaseIdx, rho);
+
+            FlashEval phaseMoles = totalMolarity;
+            if (phaseIdx == 0)
+                phaseMoles *= 1.0 - flashBeta;
+            else
+                phaseMoles *= flashBeta;
+
+            FlashEval phaseVolume = 0.0;
+            if (phaseMoles > 0.0)
+                phaseVolume = phaseMoles/flashFluidState.molarDensity(phaseIdx);
+
+            flashFluidState.setSaturation(phaseIdx, phaseVolume);
+            defect += phaseVolume;
+        }
+
+        return defect;
+    }
+
+    /*!
+     * \brief Determine the phase split at constant pressures and temperature.
+     *
+     * If \c haveK is true, the equilibrium ratios are used as the starting point of the
+     * successive substitution. Else the stability test is run first.
+     */
+    template <class EquilFluidState, class EquilParamCache, class ComponentVector, class InputEval>
+    static PhaseState computeEquilibrium_(EquilFluidState& fluidState,
+                                          EquilParamCache& paramCache,
+                                          const ComponentVector& z,
+                                          ComponentVector& K,
+                                          InputEval& beta,
+                                          bool haveK,
+                                          Scalar tolerance)
+    {
+        if (haveK) {
+            PhaseState phaseState = successiveSubstitution_(fluidState, paramCache, z, K, beta, tolerance);
+            if (phaseState == bothPhases)
+                return phaseState;
+        }
+
+        PhaseState phaseState = stabilityTest_(fluidState, paramCache, z, K, tolerance);
+        if (phaseState == bothPhases) {
+            phaseState = successiveSubstitution_(fluidState, paramCache, z, K, beta, tolerance);
+            if (phaseState == bothPhases)
+                return phaseState;
+
+            // the stability test and the phase split disagree. this only happens very
+            // close to the phase boundary, so we use the single phase which is
+            // indicated by the Rachford-Rice equation.
+            unsigned presentPhaseIdx = (phaseState == onlyPhase0)?0:1;
+            Scalar gibbs;
+            incipientPhase_(fluidState, paramCache, z, presentPhaseIdx, gibbs, tolerance);
+        }
+
+        beta = (phaseState == onlyPhase0)?0.0:1.0;
+        return phaseState;
+    }
+
+    /*!
+     * \brief Check which phases are present for the overall composition of the mixture.
+     *
+     * This is the tangent plane criterion of Michelsen: For each phase, the composition
+     * of an incipient second phase that is in equilibrium with the first phase at the
+     * overall composition is determined. The mixture is unstable if the sum of the mole
+     * fractions of the incipient phase is larger than one. If both phases are unstable,
+     * the equilibrium ratios are initialized using the incipient phase compositions.
+     */
+    template <class EquilFluidState, class EquilParamCache, class ComponentVector>
+    static PhaseState stabilityTest_(EquilFluidState& fluidState,
+                                     EquilParamCache& paramCache,
+                                     const ComponentVector& z,
+                                     ComponentVector& K,
+                                     Scalar tolerance)
+    {
+        typedef typename EquilFluidState::Scalar InputEval;
+
+        // feed as phase 1, incipient phase 0
+        Scalar gibbs1;
+        const InputEval& sumX = incipientPhase_(fluidState, paramCache, z, /*presentPhaseIdx=*/1, gibbs1, tolerance);
+        ComponentVector x;
+        for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx)
+            x[compIdx] = fluidState.moleFraction(/*phaseIdx=*/0, compIdx);
+
+        // feed as phase 0, incipient phase 1
+        Scalar gibbs0;
+        const InputEval& sumY = incipientPhase_(fluidState, paramCache, z, /*presentPhaseIdx=*/0, gibbs0, tolerance);
+
+        bool phase0Stable = (sumY <= 1.0);
+        bool phase1Stable = (sumX <= 1.0);
+        if (phase0Stable && (!phase1Stable || gibbs0 <= gibbs1))
+            // the fluid state already represents the single-phase state of phase 0
+            return onlyPhase0;
+        else if (phase1Stable) {
+            incipientPhase_(fluidState, paramCache, z, /*presentPhaseIdx=*/1, gibbs1, tolerance);
+            return onlyPhase1;
+        }
+
+        // both single-phase states are unstable
+        for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx) {
+            const InputEval& y = fluidState.moleFraction(/*phaseIdx=*/1, compIdx);
+            K[compIdx] = (y/sumY)/Ewoms::max(x[compIdx]/sumX, 1e-100);
+        }
+
+        return bothPhases;
+    }
+
+    /*!
+     * \brief Set the composition of a phase to the overall composition and compute the
+     *        composition of the other phase from the fugacities of the former.
+     *
+     * The return value is the sum of the mole fractions of the incipient phase. The
+     * molar Gibbs energy of the present phase, divided by RT and up to a constant, is
+     * stored in the 'gibbs' argument.
+     */
+    template <class EquilFluidState, class EquilParamCache, class ComponentVector>
+    static typename EquilFluidState::Scalar
+    incipientPhase_(EquilFluidState& fluidState,
+                    EquilParamCache& paramCache,
+                    const ComponentVector& z,
+                    unsigned presentPhaseIdx,
+                    Scalar& gibbs,
+                    Scalar tolerance)
+    {
+        typedef typename EquilFluidState::Scalar InputEval;
+
+        unsigned otherPhaseIdx = 1 - presentPhaseIdx;
+        for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx) {
+            fluidState.setMoleFraction(presentPhaseIdx, compIdx, z[compIdx]);
+            fluidState.setMoleFraction(otherPhaseIdx, compIdx, z[compIdx]);
+        }
+        paramCache.updateAll(fluidState);
+
+        // the fugacities of the present phase do not change anymore
+        ComponentVector f;
+        gibbs = 0.0;
+        const InputEval& pPresent = fluidState.pressure(presentPhaseIdx);
+        for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx) {
+            const InputEval& phi =
+                FluidSystem::fugacityCoefficient(fluidState, paramCache, presentPhaseIdx, compIdx);
+            fluidState.setFugacityCoefficient(presentPhaseIdx, compIdx, phi);
+            f[compIdx] = phi*z[compIdx]*pPresent;
+
+            if (z[compIdx] > 0.0)
+                gibbs += Ewoms::scalarValue(z[compIdx]*Ewoms::log(phi*pPresent));
+        }
+
+        // the fugacity coefficients of the incipient phase are evaluated for its
+        // normalized composition. (equations of state are usually not meaningful for
+        // compositions which do not sum up to one.)
+        const InputEval& pOther = fluidState.pressure(otherPhaseIdx);
+        ComponentVector x;
+        InputEval sumX = 0.0;
+        const unsigned nMax = 100;
+        for (unsigned nIdx = 0; nIdx < nMax; ++nIdx) {
+            sumX = 0.0;
+            for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx) {
+                const InputEval& phi =
+                    FluidSystem::fugacityCoefficient(fluidState, paramCache, otherPhaseIdx, compIdx);
+                fluidState.setFugacityCoefficient(otherPhaseIdx, compIdx, phi);
+
+                x[compIdx] = f[compIdx]/(phi*pOther);
+                sumX += x[compIdx];
+            }
+
+            Scalar maxDelta = 0.0;
+            for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx) {
+                const InputEval& xNorm = x[compIdx]/sumX;
+                maxDelta = std::max(maxDelta,
+                                    std::abs(Ewoms::scalarValue(xNorm - fluidState.moleFraction(otherPhaseIdx, compIdx))));
+                fluidState.setMoleFraction(otherPhaseIdx, compIdx, xNorm);
+            }
+
+            if (maxDelta < tolerance)
+                break;
+
+            paramCache.updateComposition(fluidState, otherPhaseIdx);
+        }
+
+        // the composition of the incipient phase is given by the fugacities of the
+        // present phase, i.e., its mole fractions do not sum up to one
+        for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx)
+            fluidState.setMoleFraction(otherPhaseIdx, compIdx, x[compIdx]);
+
+        return sumX;
+    }
+
+    /*!
+     * \brief Improve the equilibrium ratios by means of successive substitution.
+     *
+     * If the successive substitution got close enough to the solution, the remaining
+     * iterations use Newton's method for the logarithms of the equilibrium ratios.
+     */
+    template <class EquilFluidState, class EquilParamCache, class ComponentVector, class InputEval>
+    static PhaseState successiveSubstitution_(EquilFluidState& fluidState,
+                                              EquilParamCache& paramCache,
+                                              const ComponentVector& z,
+                                              ComponentVector& K,
+                                              InputEval& beta,
+                                              Scalar tolerance)
+    {
+        // switch to Newton's method once the equilibrium ratios change by less than
+        // this (in logarithmic space)
+        const Scalar newtonThreshold = 1e-2;
+
+        const unsigned nMax = 100;
+        for (unsigned nIdx = 0; nIdx < nMax; ++nIdx) {
+            PhaseState phaseState = solveRachfordRice_(beta, z, K);
+            if (phaseState != bothPhases)
+                return phaseState;
+
+            setPhaseCompositions_(fluidState, z, K, beta);
+            paramCache.updateAll(fluidState, /*except=*/EquilParamCache::Temperature);
+
+            Scalar maxDelta = 0.0;
+            for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx) {
+                const InputEval& newK = equilibriumRatio_(fluidState, paramCache, compIdx);
+                maxDelta = std::max(maxDelta, std::abs(Ewoms::scalarValue(Ewoms::log(newK/K[compIdx]))));
+                K[compIdx] = newK;
+            }
+
+            if (maxDelta < tolerance) {
+                phaseState = solveRachfordRice_(beta, z, K);
+                if (phaseState == bothPhases)
+                    setPhaseCompositions_(fluidState, z, K, beta);
+                return phaseState;
+            }
+
+            if (maxDelta < newtonThreshold
+                && newtonIterations_(fluidState, paramCache, z, K, beta, tolerance))
+                return bothPhases;
+        }
+
+        // the successive substitution did not converge
+        std::ostringstream oss;
+        oss << "Successive substitution of the RachfordRiceFlash did not converge";
+        throw NumericalIssue(oss.str());
+    }
+
+    /*!
+     * \brief Solve the equations for the phase equilibrium at constant pressures using
+     *        the logarithms of the equilibrium ratios as primary variables.
+     *
+     * The return value is 'false' if the Newton method did not converge or if it would
+     * lead to a single-phase state. In this case, the equilibrium ratios are left
+     * untouched.
+     */
+    template <class EquilFluidState, class EquilParamCache, class ComponentVector, class InputEval>
+    static bool newtonIterations_(EquilFluidState& fluidState,
+                                  EquilParamCache& paramCache,
+                                  const ComponentVector& z,
+                                  ComponentVector& K,
+                                  InputEval& beta,
+                                  Scalar tolerance)
+    {
+        typedef Ewoms::DenseAd::Evaluation<InputEval, /*numDerivs=*/numComponents> KEval;
+        typedef Ewoms::CompositionalFluidState<KEval, FluidSystem, /*energy=*/false> KFluidState;
+        typedef Dune::FieldMatrix<InputEval, numComponents, numComponents> Matrix;
+        typedef Dune::FieldVector<InputEval, numComponents> Vector;
+
+        typename FluidSystem::template ParameterCache<KEval> kParamCache;
+        kParamCache.assignPersistentData(paramCache);
+
+        KFluidState kFluidState;
+        kFluidState.setTemperature(fluidState.temperature(/*phaseIdx=*/0));
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx)
+            kFluidState.setPressure(phaseIdx, fluidState.pressure(phaseIdx));
+
+        ComponentVector newK(K);
+        std::array<KEval, numComponents> kEval;
+        Matrix J;
+        Vector b;
+        Vector deltaLnK;
+
+        const unsigned nMax = 10;
+        for (unsigned nIdx = 0; nIdx < nMax; ++nIdx) {
+            for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx) {
+                KEval lnK = Ewoms::log(newK[compIdx]);
+                lnK.setDerivative(compIdx, 1.0);
+                kEval[compIdx] = Ewoms::exp(lnK);
+            }
+
+            KEval kBeta;
+            if (solveRachfordRice_(kBeta, z, kEval) != bothPhases)
+                return false;
+
+            setPhaseCompositions_(kFluidState, z, kEval, kBeta);
+            kParamCache.updateAll(kFluidState);
+
+            for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx) {
+                const KEval& defect =
+                    Ewoms::log(kEval[compIdx]/equilibriumRatio_(kFluidState, kParamCache, compIdx));
+                for (unsigned pvIdx = 0; pvIdx < numComponents; ++pvIdx)
+                    J[compIdx][pvIdx] = defect.derivative(pvIdx);
+                b[compIdx] = defect.value();
+            }
+
+            deltaLnK = 0.0;
+            try { J.solve(deltaLnK, b); }
+            catch (const Dune::FMatrixError& e) {
+                return false;
+            }
+
+            Scalar maxDelta = 0.0;
+            for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx) {
+                // dampen to at most a change of the equilibrium ratios by a factor of e
+                const InputEval& delta = Ewoms::min(1.0, Ewoms::max(-1.0, deltaLnK[compIdx]));
+                maxDelta = std::max(maxDelta, std::abs(Ewoms::scalarValue(delta)));
+                newK[compIdx] *= Ewoms::exp(-delta);
+            }
+
+            if (!std::isfinite(maxDelta))
+                return false;
+
+            if (maxDelta < tolerance) {
+                if (solveRachfordRice_(beta, z, newK) != bothPhases)
+                    return false;
+
+                K = newK;
+                setPhaseCompositions_(fluidState, z, K, beta);
+                paramCache.updateAll(fluidState, /*except=*/EquilParamCache::Temperature);
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    /*!
+     * \brief Returns the equilibrium ratio of a component as given by the fugacity
+     *        coefficients of the current phase compositions.
+     */
+    template <class FluidState, class ParamCache>
+    static typename FluidState::Scalar equilibriumRatio_(const FluidState& fluidState,
+                                                         const ParamCache& paramCache,
+                                                         unsigned compIdx)
+    {
+        typedef typename FluidState::Scalar Evaluation;
+
+        const Evaluation& phi0 = FluidSystem::fugacityCoefficient(fluidState, paramCache, /*phaseIdx=*/0, compIdx);
+        const Evaluation& phi1 = FluidSystem::fugacityCoefficient(fluidState, paramCache, /*phaseIdx=*/1, compIdx);
+
+        return
+            phi0*fluidState.pressure(/*phaseIdx=*/0)
+            /(phi1*fluidState.pressure(/*phaseIdx=*/1));
+    }
+
+    /*!
+     * \brief Set the phase compositions for given equilibrium ratios and fraction of
+     *        the substance in the second phase.
+     */
+    template <class FluidState, class ComponentVector, class KVector, class Evaluation>
+    static void setPhaseCompositions_(FluidState& fluidState,
+                                      const ComponentVector& z,
+                                      const KVector& K,
+                                      const Evaluation& beta)
+    {
+        for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx) {
+            const Evaluation& x = z[compIdx]/(1.0 + beta*(K[compIdx] - 1.0));
+            fluidState.setMoleFraction(/*phaseIdx=*/0, compIdx, x);
+            fluidState.setMoleFraction(/*phaseIdx=*/1, compIdx, x*K[compIdx]);
+        }
+    }
+
+    /*!
+     * \brief Solve the Rachford-Rice equation for the fraction of the total amount of
+     *        substance which is part of the second phase.
+     *
+     * The equation is solved by means of a safeguarded Newton method on the scalar
+     * values. Then a final Newton step is done using the full evaluations, which
+     * yields the derivatives of the phase split with regard to the equilibrium ratios.
+     */
+    template <class Evaluation, class ComponentVector, class KVector>
+    static PhaseState solveRachfordRice_(Evaluation& beta,
+                                         const ComponentVector& z,
+                                         const KVector& K)
+    {
+        // the Rachford-Rice function is monotonically decreasing, so only a single
+        // phase is present if it does not exhibit a root in (0, 1)
+        Scalar defectLow = -1.0;
+        Scalar defectHigh = 1.0;
+        for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx) {
+            Scalar zVal = Ewoms::scalarValue(z[compIdx]);
+            Scalar KVal = Ewoms::scalarValue(K[compIdx]);
+            defectLow += zVal*KVal;
+            defectHigh -= zVal/KVal;
+        }
+
+        if (defectLow <= 0.0) {
+            beta = 0.0;
+            return onlyPhase0;
+        }
+        else if (defectHigh >= 0.0) {
+            beta = 1.0;
+            return onlyPhase1;
+        }
+
+        Scalar betaLow = 0.0;
+        Scalar betaHigh = 1.0;
+        Scalar betaVal = 0.5;
+        const unsigned nMax = 100;
+        for (unsigned nIdx = 0; nIdx < nMax; ++nIdx) {
+            Scalar defect = 0.0;
+            Scalar dDefect_dBeta = 0.0;
+            for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx) {
+                Scalar zVal = Ewoms::scalarValue(z[compIdx]);
+                Scalar KMinusOne = Ewoms::scalarValue(K[compIdx]) - 1.0;
+                Scalar denom = 1.0 + betaVal*KMinusOne;
+                defect += zVal*KMinusOne/denom;
+                dDefect_dBeta -= zVal*KMinusOne*KMinusOne/(denom*denom);
+            }
+
+            if (defect > 0.0)
+                betaLow = betaVal;
+            else
+                betaHigh = betaVal;
+
+            Scalar newBeta = betaVal - defect/dDefect_dBeta;
+            if (!(betaLow < newBeta && newBeta < betaHigh))
+                // the Newton step leaves the bracket. use bisection instead
+                newBeta = (betaLow + betaHigh)/2;
+
+            Scalar delta = std::abs(newBeta - betaVal);
+            betaVal = newBeta;
+            if (delta < 10*std::numeric_limits<Scalar>::epsilon())
+                break;
+        }
+
+        // final Newton step using the full evaluations
+        Evaluation defect = 0.0;
+        Scalar dDefect_dBeta = 0.0;
+        for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx) {
+            Scalar KMinusOne = Ewoms::scalarValue(K[compIdx]) - 1.0;
+            Scalar denom = 1.0 + betaVal*KMinusOne;
+            defect += z[compIdx]*(K[compIdx] - 1.0)/(1.0 + betaVal*(K[compIdx] - 1.0));
+            dDefect_dBeta -= Ewoms::scalarValue(z[compIdx])*KMinusOne*KMinusOne/(denom*denom);
+        }
+        beta = betaVal - defect/dDefect_dBeta;
+
+        return bothPhases;
+    }
+
+    template <class FlashFluidState, class OutputFluidState>
+    static void assignOutputFluidState_(const FlashFluidState& flashFluidState,
+                                        OutputFluidState& outputFluidState)
+    {
+        typedef typename OutputFluidState::Scalar OutputEval;
+
+        outputFluidState.setTemperature(flashFluidState.temperature(/*phaseIdx=*/0).value());
+
+        // copy the saturations, pressures and densities. the saturations are normalized
+        // because the volume is only matched up to the tolerance of the solver.
+        OutputEval sumS = 0.0;
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx)
+            sumS += flashFluidState.saturation(phaseIdx).value();
+
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+            const auto& S = flashFluidState.saturation(phaseIdx).value();
+            outputFluidState.setSaturation(phaseIdx, S/sumS);
+
+            const auto& p = flashFluidState.pressure(phaseIdx).value();
+            outputFluidState.setPressure(phaseIdx, p);
+
+            const auto& rho = flashFluidState.density(phaseIdx).value();
+            outputFluidState.setDensity(phaseIdx, rho);
+        }
+
+        // copy the mole fractions and fugacity coefficients
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+            for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx) {
+                const auto& moleFrac =
+                    flashFluidState.moleFraction(phaseIdx, compIdx).value();
+                outputFluidState.setMoleFraction(phaseIdx, compIdx, moleFrac);
+
+                const auto& fugCoeff =
+                    flashFluidState.fugacityCoefficient(phaseIdx, compIdx).value();
+                outputFluidState.setFugacityCoefficient(phaseIdx, compIdx, fugCoeff);
+            }
+        }
+    }
+};
+
+} // namespace Ewoms
+
+#endif
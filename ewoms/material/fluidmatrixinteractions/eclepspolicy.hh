@@ -0,0 +1,192 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the eWoms project.
+
+  eWoms is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  eWoms is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with eWoms.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*!
+ * \file
+ * \copydoc Ewoms::EclEpsStaticPolicy
+ */
+#ifndef EWOMS_ECL_EPS_POLICY_HH
+#define EWOMS_ECL_EPS_POLICY_HH
+
+#include "eclepsconfig.hh"
+
+#include <array>
+
+namespace Ewoms {
+
+/*!
+ * \ingroup FluidMatrixInteractions
+ *
+ * \brief The endpoint scaling policy which determines the scaling variant from the
+ *        run-time configuration object of the parameters.
+ *
+ * This is the default policy of \c EclEpsTwoPhaseLaw.
+ */
+struct EclEpsRuntimePolicy
+{
+    //! The run-time policy can be used for any configuration
+    static bool isCompatible(const EclEpsConfig&)
+    { return true; }
+
+    template <class Params>
+    static bool enableSatScaling(const Params& params)
+    { return params.config().enableSatScaling(); }
+
+    template <class Params>
+    static bool enableThreePointKrSatScaling(const Params& params)
+    { return params.config().enableThreePointKrSatScaling(); }
+
+    template <class Params>
+    static bool enablePcScaling(const Params& params)
+    { return params.config().enablePcScaling(); }
+
+    template <class Params>
+    static bool enableLeverettScaling(const Params& params)
+    { return params.config().enableLeverettScaling(); }
+
+    template <class Params>
+    static bool enableKrwScaling(const Params& params)
+    { return params.config().enableKrwScaling(); }
+
+    template <class Params>
+    static bool enableKrnScaling(const Params& params)
+    { return params.config().enableKrnScaling(); }
+};
+
+/*!
+ * \ingroup FluidMatrixInteractions
+ *
+ * \brief The endpoint scaling policy for which the scaling variant is fixed at compile
+ *        time.
+ *
+ * With this policy, \c EclEpsTwoPhaseLaw does not access the configuration object of
+ * the parameters and all branches on the scaling variant are resolved by the
+ * compiler. Since the configuration is fixed for a given deck, \c EclEpsPolicyDispatcher
+ * can be used to select the matching instantiation once during initialization.
+ */
+template <bool satScaling,
+          bool threePointKrSatScaling,
+          bool pcScaling,
+          bool leverettScaling,
+          bool krwScaling,
+          bool krnScaling>
+struct EclEpsStaticPolicy
+{
+    //! Returns true iff the scaling variant of the policy matches a configuration
+    static bool isCompatible(const EclEpsConfig& config)
+    {
+        return
+            config.enableSatScaling() == satScaling
+            && config.enableThreePointKrSatScaling() == threePointKrSatScaling
+            && config.enablePcScaling() == pcScaling
+            && config.enableLeverettScaling() == leverettScaling
+            && config.enableKrwScaling() == krwScaling
+            && config.enableKrnScaling() == krnScaling;
+    }
+
+    template <class Params>
+    static constexpr bool enableSatScaling(const Params&)
+    { return satScaling; }
+
+    template <class Params>
+    static constexpr bool enableThreePointKrSatScaling(const Params&)
+    { return threePointKrSatScaling; }
+
+    template <class Params>
+    static constexpr bool enablePcScaling(const Params&)
+    { return pcScaling; }
+
+    template <class Params>
+    static constexpr bool enableLeverettScaling(const Params&)
+    { return leverettScaling; }
+
+    template <class Params>
+    static constexpr bool enableKrwScaling(const Params&)
+    { return krwScaling; }
+
+    template <class Params>
+    static constexpr bool enableKrnScaling(const Params&)
+    { return krnScaling; }
+};
+
+/*!
+ * \ingroup FluidMatrixInteractions
+ *
+ * \brief The endpoint scaling policy for decks which do not use endpoint scaling.
+ */
+typedef EclEpsStaticPolicy</*satScaling=*/false,
+                           /*threePointKrSatScaling=*/false,
+                           /*pcScaling=*/false,
+                           /*leverettScaling=*/false,
+                           /*krwScaling=*/false,
+                           /*krnScaling=*/false> EclEpsDisabledPolicy;
+
+/*!
+ * \ingroup FluidMatrixInteractions
+ *
+ * \brief Selects the \c EclEpsStaticPolicy which corresponds to a run-time endpoint
+ *        scaling configuration.
+ *
+ * The visitor object must provide a <tt>template <class Policy> void apply()</tt>
+ * method, which is called with the policy that matches the configuration. This
+ * instantiates the visitor for all scaling variants, so it should only be used at a
+ * coarse granularity, e.g., to select the code path for a whole simulation.
+ */
+class EclEpsPolicyDispatcher
+{
+    enum { numFlags = 6 };
+    typedef std::array<bool, numFlags> Flags;
+
+    template <unsigned remaining, bool... flags>
+    struct Select_
+    {
+        template <class Visitor>
+        static void apply(const Flags& f, Visitor& visitor)
+        {
+            if (f[numFlags - remaining])
+                Select_<remaining - 1, flags..., true>::apply(f, visitor);
+            else
+                Select_<remaining - 1, flags..., false>::apply(f, visitor);
+        }
+    };
+
+    template <bool... flags>
+    struct Select_<0, flags...>
+    {
+        template <class Visitor>
+        static void apply(const Flags&, Visitor& visitor)
+        { visitor.template apply<EclEpsStaticPolicy<flags...> >(); }
+    };
+
+public:
+    template <class Visitor>
+    static void apply(const EclEpsConfig& config, Visitor& visitor)
+    {
+        Flags f = {{ config.enableSatScaling(),
+                     config.enableThreePointKrSatScaling(),
+                     config.enablePcScaling(),
+                     config.enableLeverettScaling(),
+                     config.enableKrwScaling(),
+                     config.enableKrnScaling() }};
+        Select_<numFlags>::apply(f, visitor);
+    }
+};
+
+} // namespace Ewoms
+
+#endif
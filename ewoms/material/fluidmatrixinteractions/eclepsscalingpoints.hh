@@ -793,6 +793,93 @@ private:
     std::array<Scalar, 3> saturationKrnPoints_;
 };
 
+/*!
+ * \brief The piecewise linear transformation between scaled and unscaled saturations
+ *        which is defined by a set of endpoint scaling points.
+ *
+ * The slopes and offsets of the pieces are computed once when the object is
+ * initialized, so converting a saturation only requires a multiply-add. The first
+ * piece is the two-point transformation, the three-point transformation additionally
+ * uses the second piece for saturations beyond the middle scaling point.
+ */
+template <class Scalar>
+class EclEpsSaturationTransform
+{
+public:
+    /*!
+     * \brief Compute the coefficients of the transformation.
+     *
+     * The containers must provide either two or three scaling points. If only two points
+     * are given, the three-point transformation is the same as the two-point one.
+     */
+    template <class PointsContainer>
+    void init(const PointsContainer& unscaledSats, const PointsContainer& scaledSats)
+    {
+        setPiece_(/*pieceIdx=*/0, unscaledSats[0], unscaledSats[1], scaledSats[0], scaledSats[1]);
+
+        scaledMidpoint_ = scaledSats[1];
+        unscaledMidpoint_ = unscaledSats[1];
+        if (unscaledSats.size() < 3 || unscaledSats[1] >= unscaledSats[2]) {
+            // the three-point scaling degenerates to the two-point one
+            scaledToUnscaledSlope_[1] = scaledToUnscaledSlope_[0];
+            scaledToUnscaledOffset_[1] = scaledToUnscaledOffset_[0];
+            unscaledToScaledSlope_[1] = unscaledToScaledSlope_[0];
+            unscaledToScaledOffset_[1] = unscaledToScaledOffset_[0];
+        }
+        else
+            setPiece_(/*pieceIdx=*/1, unscaledSats[1], unscaledSats[2], scaledSats[1], scaledSats[2]);
+    }
+
+    template <class Evaluation>
+    Evaluation scaledToUnscaledTwoPoint(const Evaluation& scaledSat) const
+    { return scaledToUnscaledOffset_[0] + scaledToUnscaledSlope_[0]*scaledSat; }
+
+    template <class Evaluation>
+    Evaluation unscaledToScaledTwoPoint(const Evaluation& unscaledSat) const
+    { return unscaledToScaledOffset_[0] + unscaledToScaledSlope_[0]*unscaledSat; }
+
+    template <class Evaluation>
+    Evaluation scaledToUnscaledThreePoint(const Evaluation& scaledSat) const
+    {
+        unsigned pieceIdx = (scaledSat < scaledMidpoint_) ? 0 : 1;
+        return scaledToUnscaledOffset_[pieceIdx] + scaledToUnscaledSlope_[pieceIdx]*scaledSat;
+    }
+
+    template <class Evaluation>
+    Evaluation unscaledToScaledThreePoint(const Evaluation& unscaledSat) const
+    {
+        unsigned pieceIdx = (unscaledSat < unscaledMidpoint_) ? 0 : 1;
+        return unscaledToScaledOffset_[pieceIdx] + unscaledToScaledSlope_[pieceIdx]*unscaledSat;
+    }
+
+private:
+    void setPiece_(unsigned pieceIdx,
+                   Scalar unscaledSat0, Scalar unscaledSat1,
+                   Scalar scaledSat0, Scalar scaledSat1)
+    {
+        Scalar scaledDelta = scaledSat1 - scaledSat0;
+        if (scaledDelta <= 1e-20)
+            scaledDelta = 1.0; // prevent division by zero for (possibly) incorrect input data
+
+        Scalar unscaledDelta = unscaledSat1 - unscaledSat0;
+        if (unscaledDelta <= 1e-20)
+            unscaledDelta = 1.0; // prevent division by zero for (possibly) incorrect input data
+
+        scaledToUnscaledSlope_[pieceIdx] = (unscaledSat1 - unscaledSat0)/scaledDelta;
+        scaledToUnscaledOffset_[pieceIdx] = unscaledSat0 - scaledSat0*scaledToUnscaledSlope_[pieceIdx];
+
+        unscaledToScaledSlope_[pieceIdx] = (scaledSat1 - scaledSat0)/unscaledDelta;
+        unscaledToScaledOffset_[pieceIdx] = scaledSat0 - unscaledSat0*unscaledToScaledSlope_[pieceIdx];
+    }
+
+    std::array<Scalar, 2> scaledToUnscaledSlope_;
+    std::array<Scalar, 2> scaledToUnscaledOffset_;
+    std::array<Scalar, 2> unscaledToScaledSlope_;
+    std::array<Scalar, 2> unscaledToScaledOffset_;
+    Scalar scaledMidpoint_;
+    Scalar unscaledMidpoint_;
+};
+
 } // namespace Ewoms
 
 #endif
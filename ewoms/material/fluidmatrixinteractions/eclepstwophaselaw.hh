@@ -24,6 +24,7 @@
 #define EWOMS_ECL_EPS_TWO_PHASE_LAW_HH
 
 #include "eclepstwophaselawparams.hh"
+#include "eclepspolicy.hh"
 
 #include <ewoms/material/fluidstates/saturationoverlayfluidstate.hh>
 
@@ -38,12 +39,18 @@ namespace Ewoms {
  * and produce unscaled quantities. This class implements the "impedance adaption" layer
  * between the two worlds. The basic purpose of it is thus the same as the one of \a
  * EffToAbsLaw, but it is quite a bit more complex.
+ *
+ * The PolicyT template argument determines how the scaling variant is selected: By
+ * default, it is taken from the configuration object of the parameters at run time. If
+ * \c EclEpsStaticPolicy is used instead, the variant is fixed at compile time.
  */
 template <class EffLawT,
-          class ParamsT = EclEpsTwoPhaseLawParams<EffLawT> >
+          class ParamsT = EclEpsTwoPhaseLawParams<EffLawT>,
+          class PolicyT = EclEpsRuntimePolicy>
 class EclEpsTwoPhaseLaw : public EffLawT::Traits
 {
     typedef EffLawT EffLaw;
+    typedef PolicyT Policy;
 
 public:
     typedef typename EffLaw::Traits Traits;
@@ -261,27 +268,23 @@ public:
     template <class Evaluation>
     static Evaluation scaledToUnscaledSatPc(const Params& params, const Evaluation& SwScaled)
     {
-        if (!params.config().enableSatScaling())
+        if (!Policy::enableSatScaling(params))
             return SwScaled;
 
         // the saturations of capillary pressure are always scaled using two-point
         // scaling
-        return scaledToUnscaledSatTwoPoint_(SwScaled,
-                                            params.unscaledPoints().saturationPcPoints(),
-                                            params.scaledPoints().saturationPcPoints());
+        return params.pcSatTransform().scaledToUnscaledTwoPoint(SwScaled);
     }
 
     template <class Evaluation>
     static Evaluation unscaledToScaledSatPc(const Params& params, const Evaluation& SwUnscaled)
     {
-        if (!params.config().enableSatScaling())
+        if (!Policy::enableSatScaling(params))
             return SwUnscaled;
 
         // the saturations of capillary pressure are always scaled using two-point
         // scaling
-        return unscaledToScaledSatTwoPoint_(SwUnscaled,
-                                            params.unscaledPoints().saturationPcPoints(),
-                                            params.scaledPoints().saturationPcPoints());
+        return params.pcSatTransform().unscaledToScaledTwoPoint(SwUnscaled);
     }
 
     /*!
@@ -291,37 +294,25 @@ public:
     template <class Evaluation>
     static Evaluation scaledToUnscaledSatKrw(const Params& params, const Evaluation& SwScaled)
     {
-        if (!params.config().enableSatScaling())
+        if (!Policy::enableSatScaling(params))
             return SwScaled;
 
-        if (params.config().enableThreePointKrSatScaling()) {
-            return scaledToUnscaledSatThreePoint_(SwScaled,
-                                                  params.unscaledPoints().saturationKrwPoints(),
-                                                  params.scaledPoints().saturationKrwPoints());
-        }
-        else { // two-point relperm saturation scaling
-            return scaledToUnscaledSatTwoPoint_(SwScaled,
-                                                params.unscaledPoints().saturationKrwPoints(),
-                                                params.scaledPoints().saturationKrwPoints());
-        }
+        if (Policy::enableThreePointKrSatScaling(params))
+            return params.krwSatTransform().scaledToUnscaledThreePoint(SwScaled);
+        else // two-point relperm saturation scaling
+            return params.krwSatTransform().scaledToUnscaledTwoPoint(SwScaled);
     }
 
     template <class Evaluation>
     static Evaluation unscaledToScaledSatKrw(const Params& params, const Evaluation& SwUnscaled)
     {
-        if (!params.config().enableSatScaling())
+        if (!Policy::enableSatScaling(params))
             return SwUnscaled;
 
-        if (params.config().enableThreePointKrSatScaling()) {
-            return unscaledToScaledSatThreePoint_(SwUnscaled,
-                                                  params.unscaledPoints().saturationKrwPoints(),
-                                                  params.scaledPoints().saturationKrwPoints());
-        }
-        else { // two-point relperm saturation scaling
-            return unscaledToScaledSatTwoPoint_(SwUnscaled,
-                                                params.unscaledPoints().saturationKrwPoints(),
-                                                params.scaledPoints().saturationKrwPoints());
-        }
+        if (Policy::enableThreePointKrSatScaling(params))
+            return params.krwSatTransform().unscaledToScaledThreePoint(SwUnscaled);
+        else // two-point relperm saturation scaling
+            return params.krwSatTransform().unscaledToScaledTwoPoint(SwUnscaled);
     }
 
     /*!
@@ -331,131 +322,39 @@ public:
     template <class Evaluation>
     static Evaluation scaledToUnscaledSatKrn(const Params& params, const Evaluation& SwScaled)
     {
-        if (!params.config().enableSatScaling())
+        if (!Policy::enableSatScaling(params))
             return SwScaled;
 
-        if (params.config().enableThreePointKrSatScaling())
-            return scaledToUnscaledSatThreePoint_(SwScaled,
-                                                  params.unscaledPoints().saturationKrnPoints(),
-                                                  params.scaledPoints().saturationKrnPoints());
+        if (Policy::enableThreePointKrSatScaling(params))
+            return params.krnSatTransform().scaledToUnscaledThreePoint(SwScaled);
         else // two-point relperm saturation scaling
-            return scaledToUnscaledSatTwoPoint_(SwScaled,
-                                                params.unscaledPoints().saturationKrnPoints(),
-                                                params.scaledPoints().saturationKrnPoints());
+            return params.krnSatTransform().scaledToUnscaledTwoPoint(SwScaled);
     }
 
     template <class Evaluation>
     static Evaluation unscaledToScaledSatKrn(const Params& params, const Evaluation& SwUnscaled)
     {
-        if (!params.config().enableSatScaling())
+        if (!Policy::enableSatScaling(params))
             return SwUnscaled;
 
-        if (params.config().enableThreePointKrSatScaling()) {
-            return unscaledToScaledSatThreePoint_(SwUnscaled,
-                                                  params.unscaledPoints().saturationKrnPoints(),
-                                                  params.scaledPoints().saturationKrnPoints());
-        }
-        else { // two-point relperm saturation scaling
-            return unscaledToScaledSatTwoPoint_(SwUnscaled,
-                                                params.unscaledPoints().saturationKrnPoints(),
-                                                params.scaledPoints().saturationKrnPoints());
-        }
+        if (Policy::enableThreePointKrSatScaling(params))
+            return params.krnSatTransform().unscaledToScaledThreePoint(SwUnscaled);
+        else // two-point relperm saturation scaling
+            return params.krnSatTransform().unscaledToScaledTwoPoint(SwUnscaled);
     }
 
 private:
-    template <class Evaluation, class PointsContainer>
-    static Evaluation scaledToUnscaledSatTwoPoint_(const Evaluation& scaledSat,
-                                                   const PointsContainer& unscaledSats,
-                                                   const PointsContainer& scaledSats)
-    {
-        return
-            unscaledSats[0]
-            +
-            (scaledSat - scaledSats[0])*((unscaledSats[1] - unscaledSats[0])/(scaledSats[1] - scaledSats[0]));
-    }
-
-    template <class Evaluation, class PointsContainer>
-    static Evaluation unscaledToScaledSatTwoPoint_(const Evaluation& unscaledSat,
-                                                   const PointsContainer& unscaledSats,
-                                                   const PointsContainer& scaledSats)
-    {
-        return
-            scaledSats[0]
-            +
-            (unscaledSat - unscaledSats[0])*((scaledSats[1] - scaledSats[0])/(unscaledSats[1] - unscaledSats[0]));
-    }
-
-    template <class Evaluation, class PointsContainer>
-    static Evaluation scaledToUnscaledSatThreePoint_(const Evaluation& scaledSat,
-                                                     const PointsContainer& unscaledSats,
-                                                     const PointsContainer& scaledSats)
-    {
-        if (unscaledSats[1] >= unscaledSats[2])
-            return scaledToUnscaledSatTwoPoint_(scaledSat, unscaledSats, scaledSats);
-
-        if (scaledSat < scaledSats[1]) {
-            Scalar delta = scaledSats[1] - scaledSats[0];
-            if (delta <= 1e-20)
-                delta = 1.0; // prevent division by zero for (possibly) incorrect input data
-
-            return
-                unscaledSats[0]
-                +
-                (scaledSat - scaledSats[0])*((unscaledSats[1] - unscaledSats[0])/delta);
-        }
-        else {
-            Scalar delta = scaledSats[2] - scaledSats[1];
-            if (delta <= 1e-20)
-                delta = 1.0; // prevent division by zero for (possibly) incorrect input data
-
-            return
-                unscaledSats[1]
-                +
-                (scaledSat - scaledSats[1])*((unscaledSats[2] - unscaledSats[1])/delta);
-        }
-    }
-
-    template <class Evaluation, class PointsContainer>
-    static Evaluation unscaledToScaledSatThreePoint_(const Evaluation& unscaledSat,
-                                                     const PointsContainer& unscaledSats,
-                                                     const PointsContainer& scaledSats)
-    {
-        if (unscaledSats[1] >= unscaledSats[2])
-            return unscaledToScaledSatTwoPoint_(unscaledSat, unscaledSats, scaledSats);
-
-        if (unscaledSat < unscaledSats[1]) {
-            Scalar delta = unscaledSats[1] - unscaledSats[0];
-            if (delta <= 1e-20)
-                delta = 1.0; // prevent division by zero for (possibly) incorrect input data
-
-            return
-                scaledSats[0]
-                +
-                (unscaledSat - unscaledSats[0])*((scaledSats[1] - scaledSats[0])/delta);
-        }
-        else {
-            Scalar delta = unscaledSats[2] - unscaledSats[1];
-            if (delta <= 1e-20)
-                delta = 1.0; // prevent division by zero for (possibly) incorrect input data
-
-            return
-                scaledSats[1]
-                +
-                (unscaledSat - unscaledSats[1])*((scaledSats[2] - scaledSats[1])/delta);
-        }
-    }
-
     /*!
      * \brief Scale the capillary pressure according to the given parameters
      */
     template <class Evaluation>
     static Evaluation unscaledToScaledPcnw_(const Params& params, const Evaluation& unscaledPcnw)
     {
-        if (params.config().enableLeverettScaling()) {
+        if (Policy::enableLeverettScaling(params)) {
             Scalar alpha = params.scaledPoints().leverettFactor();
             return unscaledPcnw*alpha;
         }
-        else if (params.config().enablePcScaling()) {
+        else if (Policy::enablePcScaling(params)) {
             Scalar alpha = params.scaledPoints().maxPcnw()/std::max<Scalar>(1e-10, params.unscaledPoints().maxPcnw());
             return unscaledPcnw*alpha;
         }
@@ -466,11 +365,11 @@ private:
     template <class Evaluation>
     static Evaluation scaledToUnscaledPcnw_(const Params& params, const Evaluation& scaledPcnw)
     {
-        if (params.config().enableLeverettScaling()) {
+        if (Policy::enableLeverettScaling(params)) {
             Scalar alpha = params.scaledPoints().leverettFactor();
             return scaledPcnw/alpha;
         }
-        else if (params.config().enablePcScaling()) {
+        else if (Policy::enablePcScaling(params)) {
             Scalar alpha = params.unscaledPoints().maxPcnw()/std::max<Scalar>(1e-10, params.scaledPoints().maxPcnw());
             return scaledPcnw/std::max<Scalar>(1e-10, alpha);
         }
@@ -484,7 +383,7 @@ private:
     template <class Evaluation>
     static Evaluation unscaledToScaledKrw_(const Params& params, const Evaluation& unscaledKrw)
     {
-        if (!params.config().enableKrwScaling())
+        if (!Policy::enableKrwScaling(params))
             return unscaledKrw;
 
         // TODO: three point krw y-scaling
@@ -495,7 +394,7 @@ private:
     template <class Evaluation>
     static Evaluation scaledToUnscaledKrw_(const Params& params, const Evaluation& scaledKrw)
     {
-        if (!params.config().enableKrwScaling())
+        if (!Policy::enableKrwScaling(params))
             return scaledKrw;
 
         Scalar alpha = params.unscaledPoints().maxKrw()/params.scaledPoints().maxKrw();
@@ -508,7 +407,7 @@ private:
     template <class Evaluation>
     static Evaluation unscaledToScaledKrn_(const Params& params, const Evaluation& unscaledKrn)
     {
-        if (!params.config().enableKrnScaling())
+        if (!Policy::enableKrnScaling(params))
             return unscaledKrn;
 
         //TODO: three point krn y-scaling
@@ -519,7 +418,7 @@ private:
     template <class Evaluation>
     static Evaluation scaledToUnscaledKrn_(const Params& params, const Evaluation& scaledKrn)
     {
-        if (!params.config().enableKrnScaling())
+        if (!Policy::enableKrnScaling(params))
             return scaledKrn;
 
         Scalar alpha = params.unscaledPoints().maxKrn()/params.scaledPoints().maxKrn();
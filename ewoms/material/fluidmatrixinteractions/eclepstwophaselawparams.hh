@@ -54,6 +54,7 @@ class EclEpsTwoPhaseLawParams : public EnsureFinalized
 public:
     typedef typename EffLawParams::Traits Traits;
     typedef Ewoms::EclEpsScalingPoints<Scalar> ScalingPoints;
+    typedef Ewoms::EclEpsSaturationTransform<Scalar> SaturationTransform;
 
     EclEpsTwoPhaseLawParams()
     {
@@ -72,6 +73,16 @@ public:
         }
         assert(effectiveLawParams_);
 #endif
+
+        if (config_->enableSatScaling()) {
+            pcSatTransform_.init(unscaledPoints_->saturationPcPoints(),
+                                 scaledPoints_.saturationPcPoints());
+            krwSatTransform_.init(unscaledPoints_->saturationKrwPoints(),
+                                  scaledPoints_.saturationKrwPoints());
+            krnSatTransform_.init(unscaledPoints_->saturationKrnPoints(),
+                                  scaledPoints_.saturationKrnPoints());
+        }
+
         EnsureFinalized :: finalize();
     }
 
@@ -89,6 +100,9 @@ public:
 
     /*!
      * \brief Set the scaling points which are seen by the nested material law
+     *
+     * The saturation transformations are computed by finalize(), i.e., if the
+     * scaling points are exchanged afterwards, finalize() must be called again.
      */
     void setUnscaledPoints(std::shared_ptr<ScalingPoints> value)
     { unscaledPoints_ = value; }
@@ -101,6 +115,9 @@ public:
 
     /*!
      * \brief Set the scaling points which are seen by the physical model
+     *
+     * The saturation transformations are computed by finalize(), i.e., if the
+     * scaling points are exchanged afterwards, finalize() must be called again.
      */
     void setScaledPoints(std::shared_ptr<ScalingPoints> value)
     { scaledPoints_ = *value; }
@@ -113,10 +130,40 @@ public:
 
     /*!
      * \brief Returns the scaling points which are seen by the physical model
+     *
+     * The saturation transformations are computed by finalize(), i.e., if the
+     * saturation scaling points are modified afterwards, finalize() must be called
+     * again.
      */
     ScalingPoints& scaledPoints()
     { return scaledPoints_; }
 
+    /*!
+     * \brief Returns the transformation of the saturations used for capillary pressure.
+     *
+     * This is only available if saturation scaling is enabled.
+     */
+    const SaturationTransform& pcSatTransform() const
+    { EnsureFinalized::check(); return pcSatTransform_; }
+
+    /*!
+     * \brief Returns the transformation of the saturations used for the relative
+     *        permeability of the wetting phase.
+     *
+     * This is only available if saturation scaling is enabled.
+     */
+    const SaturationTransform& krwSatTransform() const
+    { EnsureFinalized::check(); return krwSatTransform_; }
+
+    /*!
+     * \brief Returns the transformation of the saturations used for the relative
+     *        permeability of the non-wetting phase.
+     *
+     * This is only available if saturation scaling is enabled.
+     */
+    const SaturationTransform& krnSatTransform() const
+    { EnsureFinalized::check(); return krnSatTransform_; }
+
     /*!
      * \brief Sets the parameter object for the effective/nested material law.
      */
@@ -135,6 +182,10 @@ private:
     std::shared_ptr<EclEpsConfig> config_;
     std::shared_ptr<ScalingPoints> unscaledPoints_;
     ScalingPoints scaledPoints_;
+
+    SaturationTransform pcSatTransform_;
+    SaturationTransform krwSatTransform_;
+    SaturationTransform krnSatTransform_;
 };
 
 } // namespace Ewoms
@@ -30,6 +30,7 @@
 #include <ewoms/material/fluidmatrixinteractions/ecltwophasematerialparams.hh>
 #include <ewoms/material/fluidmatrixinteractions/piecewiselineartwophasematerial.hh>
 #include <ewoms/material/fluidmatrixinteractions/eclepstwophaselaw.hh>
+#include <ewoms/material/fluidmatrixinteractions/eclepspolicy.hh>
 #include <ewoms/material/fluidmatrixinteractions/eclhysteresistwophaselaw.hh>
 #include <ewoms/material/fluidmatrixinteractions/eclepsscalingpoints.hh>
 #include <ewoms/material/fluidmatrixinteractions/eclepsconfig.hh>
@@ -37,6 +38,7 @@
 #include <ewoms/material/fluidmatrixinteractions/eclmultiplexermaterial.hh>
 #include <ewoms/material/fluidmatrixinteractions/materialtraits.hh>
 #include <ewoms/material/fluidstates/simplemodularfluidstate.hh>
+#include <ewoms/material/common/regionpermutation.hh>
 
 #if HAVE_EWOMS_COMMON
 #include <ewoms/eclio/opmlog/opmlog.hh>
@@ -46,6 +48,7 @@
 #include <ewoms/eclio/parser/eclipsestate/tables/tablemanager.hh>
 
 #include <algorithm>
+#include <stdexcept>
 
 namespace Ewoms {
 
@@ -54,12 +57,25 @@ namespace Ewoms {
  *
  * \brief Provides an simple way to create and manage the material law objects
  *        for a complete ECL deck.
+ *
+ * The endpoint scaling policies determine how the scaling variants of the gas-oil and
+ * oil-water systems are selected. With the default \c EclEpsRuntimePolicy, they are
+ * taken from the configuration objects for each evaluation. If the scaling variants of
+ * the deck are known, \c EclEpsStaticPolicy can be used to resolve them at compile
+ * time, e.g., \c EclEpsDisabledPolicy for decks without the ENDSCALE keyword. Since
+ * the material laws are instantiated for each combination of policies, such a manager
+ * is best selected once for a whole simulation using \c EclEpsPolicyDispatcher.
+ * initFromEclState() throws if the policies do not match the deck.
  */
-template <class TraitsT>
+template <class TraitsT,
+          class GasOilEpsPolicyT = EclEpsRuntimePolicy,
+          class OilWaterEpsPolicyT = EclEpsRuntimePolicy>
 class EclMaterialLawManager
 {
 private:
     typedef TraitsT Traits;
+    typedef GasOilEpsPolicyT GasOilEpsPolicy;
+    typedef OilWaterEpsPolicyT OilWaterEpsPolicy;
     typedef typename Traits::Scalar Scalar;
     enum { waterPhaseIdx = Traits::wettingPhaseIdx };
     enum { oilPhaseIdx = Traits::nonWettingPhaseIdx };
@@ -76,8 +92,12 @@ private:
     typedef typename OilWaterEffectiveTwoPhaseLaw::Params OilWaterEffectiveTwoPhaseParams;
 
     // the two-phase material law which is defined on absolute (scaled) saturations
-    typedef EclEpsTwoPhaseLaw<GasOilEffectiveTwoPhaseLaw> GasOilEpsTwoPhaseLaw;
-    typedef EclEpsTwoPhaseLaw<OilWaterEffectiveTwoPhaseLaw> OilWaterEpsTwoPhaseLaw;
+    typedef EclEpsTwoPhaseLaw<GasOilEffectiveTwoPhaseLaw,
+                              EclEpsTwoPhaseLawParams<GasOilEffectiveTwoPhaseLaw>,
+                              GasOilEpsPolicy> GasOilEpsTwoPhaseLaw;
+    typedef EclEpsTwoPhaseLaw<OilWaterEffectiveTwoPhaseLaw,
+                              EclEpsTwoPhaseLawParams<OilWaterEffectiveTwoPhaseLaw>,
+                              OilWaterEpsPolicy> OilWaterEpsTwoPhaseLaw;
     typedef typename GasOilEpsTwoPhaseLaw::Params GasOilEpsTwoPhaseParams;
     typedef typename OilWaterEpsTwoPhaseLaw::Params OilWaterEpsTwoPhaseParams;
 
@@ -103,6 +123,10 @@ private:
     typedef std::vector<std::shared_ptr<GasOilTwoPhaseHystParams> > GasOilParamVector;
     typedef std::vector<std::shared_ptr<OilWaterTwoPhaseHystParams> > OilWaterParamVector;
 
+    typedef EclStone1Material<Traits, GasOilTwoPhaseLaw, OilWaterTwoPhaseLaw> Stone1Material;
+    typedef typename Stone1Material::Params Stone1Params;
+    typedef std::vector<std::shared_ptr<const typename Stone1Params::TabulatedFunction> > Stone1EtaPowTableVector;
+
 public:
     EclMaterialLawManager()
     {}
@@ -127,6 +151,12 @@ public:
         oilWaterConfig = std::make_shared<Ewoms::EclEpsConfig>();
         gasOilConfig->initFromEclState(eclState, Ewoms::EclGasOilSystem);
         oilWaterConfig->initFromEclState(eclState, Ewoms::EclOilWaterSystem);
+        if (!GasOilEpsPolicy::isCompatible(*gasOilConfig))
+            throw std::runtime_error("The endpoint scaling policy of the gas-oil system "
+                                     "does not match the deck");
+        if (!OilWaterEpsPolicy::isCompatible(*oilWaterConfig))
+            throw std::runtime_error("The endpoint scaling policy of the oil-water system "
+                                     "does not match the deck");
 
         unscaledEpsInfo_.resize(numSatRegions);
         const auto& stone1exTable = eclState.getTableManager().getStone1exTable();
@@ -159,6 +189,22 @@ public:
             readOilWaterEffectiveParameters_(oilWaterEffectiveParamVector_, eclState, satRegionIdx);
         }
 
+        // the power function of the extended Stone 1 model only depends on the
+        // saturation region, so its tables are shared by all elements of a region
+        stoneEtaPowTables_.clear();
+        if (threePhaseApproach_ == EclMultiplexerApproach::EclStone1Approach
+            && stoneEtaTabulationTolerance_ > 0.0)
+        {
+            stoneEtaPowTables_.resize(numSatRegions);
+            for (unsigned satRegionIdx = 0; satRegionIdx < numSatRegions; ++satRegionIdx) {
+                Scalar eta = stoneEtas.empty() ? 1.0 : stoneEtas[satRegionIdx];
+                stoneEtaPowTables_[satRegionIdx] =
+                    Stone1Params::createEtaPowTable(eta,
+                                                    stoneEtaTabulationMin_,
+                                                    stoneEtaTabulationTolerance_);
+            }
+        }
+
         // copy the SATNUM grid property. in some cases this is not necessary, but it
         // should not require much memory anyway...
         satnumRegionArray_.resize(numCompressedElems);
@@ -181,6 +227,10 @@ public:
             }
         }
 
+        // group the elements by their saturation region for the batched evaluation
+        // of the material laws
+        satnumRegionPermutation_.update(satnumRegionArray_);
+
         // read the scaled end point scaling parameters which are specific for each
         // element
         GasOilScalingInfoVector gasOilScaledInfoVector(numCompressedElems);
@@ -396,6 +446,27 @@ public:
         return Sw;
     }
 
+    /*!
+     * \brief Tabulate the power function of the extended Stone 1 model.
+     *
+     * One table is created for each saturation region by initParamsForElements(), so
+     * this method must be called before it. The table covers the arguments in [minArg,
+     * 1] and its interpolation error is below the given tolerance. If the three-phase
+     * model is not Stone 1, this has no effect.
+     */
+    void setStone1EtaTabulation(Scalar minArg, Scalar tolerance)
+    {
+        if (!(0.0 <= minArg && minArg < 1.0))
+            throw std::invalid_argument("The minimum argument for tabulating the power "
+                                        "function of the Stone 1 model must be within [0, 1)");
+        if (!(tolerance > 0.0))
+            throw std::invalid_argument("The tolerance for tabulating the power function "
+                                        "of the Stone 1 model must be positive");
+
+        stoneEtaTabulationMin_ = minArg;
+        stoneEtaTabulationTolerance_ = tolerance;
+    }
+
     bool enableEndPointScaling() const
     { return enableEndPointScaling_; }
 
@@ -421,6 +492,9 @@ public:
      * In the context of ECL reservoir simulators, this is required to properly handle
      * wells with its own saturation table idx. In order to reset the saturation table idx
      * in the materialLawparams_ call the method with the cells satRegionIdx
+     *
+     * Since the saturation transformations of the endpoint scaling depend on the
+     * unscaled points of the saturation region, they are recomputed for every call.
      */
     const MaterialLawParams& connectionMaterialLawParams(unsigned satRegionIdx, unsigned elemIdx) const
     {
@@ -442,6 +516,8 @@ public:
             realParams.oilWaterParams().drainageParams().setEffectiveLawParams(oilWaterEffectiveParamVector_[satRegionIdx]);
             realParams.gasOilParams().drainageParams().setUnscaledPoints(gasOilUnscaledPointsVector_[satRegionIdx]);
             realParams.gasOilParams().drainageParams().setEffectiveLawParams(gasOilEffectiveParamVector_[satRegionIdx]);
+            realParams.oilWaterParams().drainageParams().finalize();
+            realParams.gasOilParams().drainageParams().finalize();
 //            if (enableHysteresis()) {
 //                realParams.oilWaterParams().imbibitionParams().setUnscaledPoints(oilWaterUnscaledPointsVector_[impRegionIdx]);
 //                realParams.oilWaterParams().imbibitionParams().setEffectiveLawParams(oilWaterEffectiveParamVector_[impRegionIdx]);
@@ -457,6 +533,8 @@ public:
             realParams.oilWaterParams().drainageParams().setEffectiveLawParams(oilWaterEffectiveParamVector_[satRegionIdx]);
             realParams.gasOilParams().drainageParams().setUnscaledPoints(gasOilUnscaledPointsVector_[satRegionIdx]);
             realParams.gasOilParams().drainageParams().setEffectiveLawParams(gasOilEffectiveParamVector_[satRegionIdx]);
+            realParams.oilWaterParams().drainageParams().finalize();
+            realParams.gasOilParams().drainageParams().finalize();
 //            if (enableHysteresis()) {
 //                realParams.oilWaterParams().imbibitionParams().setUnscaledPoints(oilWaterUnscaledPointsVector_[impRegionIdx]);
 //                realParams.oilWaterParams().imbibitionParams().setEffectiveLawParams(oilWaterEffectiveParamVector_[impRegionIdx]);
@@ -472,6 +550,8 @@ public:
             realParams.oilWaterParams().drainageParams().setEffectiveLawParams(oilWaterEffectiveParamVector_[satRegionIdx]);
             realParams.gasOilParams().drainageParams().setUnscaledPoints(gasOilUnscaledPointsVector_[satRegionIdx]);
             realParams.gasOilParams().drainageParams().setEffectiveLawParams(gasOilEffectiveParamVector_[satRegionIdx]);
+            realParams.oilWaterParams().drainageParams().finalize();
+            realParams.gasOilParams().drainageParams().finalize();
 //            if (enableHysteresis()) {
 //                realParams.oilWaterParams().imbibitionParams().setUnscaledPoints(oilWaterUnscaledPointsVector_[impRegionIdx]);
 //                realParams.oilWaterParams().imbibitionParams().setEffectiveLawParams(oilWaterEffectiveParamVector_[impRegionIdx]);
@@ -487,6 +567,8 @@ public:
             realParams.oilWaterParams().drainageParams().setEffectiveLawParams(oilWaterEffectiveParamVector_[satRegionIdx]);
             realParams.gasOilParams().drainageParams().setUnscaledPoints(gasOilUnscaledPointsVector_[satRegionIdx]);
             realParams.gasOilParams().drainageParams().setEffectiveLawParams(gasOilEffectiveParamVector_[satRegionIdx]);
+            realParams.oilWaterParams().drainageParams().finalize();
+            realParams.gasOilParams().drainageParams().finalize();
 //            if (enableHysteresis()) {
 //                realParams.oilWaterParams().imbibitionParams().setUnscaledPoints(oilWaterUnscaledPointsVector_[impRegionIdx]);
 //                realParams.oilWaterParams().imbibitionParams().setEffectiveLawParams(oilWaterEffectiveParamVector_[impRegionIdx]);
@@ -509,6 +591,50 @@ public:
     int imbnumRegionIdx(unsigned elemIdx) const
     { return imbnumRegionArray_[elemIdx]; }
 
+    /*!
+     * \brief Returns the permutation of the elements which groups them by their
+     *        saturation region.
+     */
+    const RegionPermutation& satnumRegionPermutation() const
+    { return satnumRegionPermutation_; }
+
+    /*!
+     * \brief Compute the capillary pressures of all elements.
+     *
+     * The elements are processed region by region, so that the tables of the
+     * saturation functions of a given region stay in the CPU caches. The containers for
+     * the results and the fluid states are indexed by the element index; each entry of
+     * the result container must be an array of numPhases values.
+     */
+    template <class ResultContainer, class FluidStateContainer>
+    void capillaryPressures(ResultContainer& pc, const FluidStateContainer& fluidStates) const
+    {
+        assert(fluidStates.size() == satnumRegionPermutation_.size());
+        for (unsigned satRegionIdx = 0; satRegionIdx < satnumRegionPermutation_.numRegions(); ++satRegionIdx) {
+            auto it = satnumRegionPermutation_.regionBegin(satRegionIdx);
+            const auto& endIt = satnumRegionPermutation_.regionEnd(satRegionIdx);
+            for (; it != endIt; ++it)
+                MaterialLaw::capillaryPressures(pc[*it], materialLawParams(*it), fluidStates[*it]);
+        }
+    }
+
+    /*!
+     * \brief Compute the relative permeabilities of all elements.
+     *
+     * \copydetails capillaryPressures()
+     */
+    template <class ResultContainer, class FluidStateContainer>
+    void relativePermeabilities(ResultContainer& kr, const FluidStateContainer& fluidStates) const
+    {
+        assert(fluidStates.size() == satnumRegionPermutation_.size());
+        for (unsigned satRegionIdx = 0; satRegionIdx < satnumRegionPermutation_.numRegions(); ++satRegionIdx) {
+            auto it = satnumRegionPermutation_.regionBegin(satRegionIdx);
+            const auto& endIt = satnumRegionPermutation_.regionEnd(satRegionIdx);
+            for (; it != endIt; ++it)
+                MaterialLaw::relativePermeabilities(kr[*it], materialLawParams(*it), fluidStates[*it]);
+        }
+    }
+
     std::shared_ptr<MaterialLawParams>& materialLawParamsPointerReferenceHack(unsigned elemIdx)
     {
         assert(0 <= elemIdx && elemIdx <  materialLawParams_.size());
@@ -978,6 +1104,8 @@ private:
             }
             else
                 realParams.setEta(1.0);
+            if (!stoneEtaPowTables_.empty())
+                realParams.setEtaPowTable(stoneEtaPowTables_[satRegionIdx]);
             realParams.finalize();
             break;
         }
@@ -1036,7 +1164,11 @@ private:
 
     std::vector<int> satnumRegionArray_;
     std::vector<int> imbnumRegionArray_;
+    RegionPermutation satnumRegionPermutation_;
     std::vector<Scalar> stoneEtas;
+    Scalar stoneEtaTabulationMin_ = 0.0;
+    Scalar stoneEtaTabulationTolerance_ = 0.0;
+    Stone1EtaPowTableVector stoneEtaPowTables_;
 
     bool hasGas;
     bool hasOil;
@@ -362,8 +362,14 @@ public:
 
             if (SSw >= 1.0 || SSg >= 1.0)
                 beta = 1.0;
-            else
-                beta = Ewoms::pow( SSo/((1 - SSw)*(1 - SSg)), params.eta());
+            else {
+                const Evaluation& x = SSo/((1 - SSw)*(1 - SSg));
+                const auto& etaPowTable = params.etaPowTable();
+                if (etaPowTable && etaPowTable->applies(Ewoms::scalarValue(x)))
+                    beta = etaPowTable->eval(x);
+                else
+                    beta = Ewoms::pow(x, params.eta());
+            }
         }
 
         return Ewoms::max(0.0, Ewoms::min(1.0, beta*kro_ow*kro_go/krocw));
@@ -24,10 +24,12 @@
 #define EWOMS_ECL_STONE1_MATERIAL_PARAMS_HH
 
 #include <ewoms/material/common/ensurefinalized.hh>
+#include <ewoms/material/common/hermitetabulated1dfunction.hh>
 
 #include <type_traits>
 #include <cassert>
 #include <memory>
+#include <stdexcept>
 
 namespace Ewoms {
 
@@ -47,6 +49,7 @@ class EclStone1MaterialParams : public EnsureFinalized
 public:
     typedef typename GasOilLawT::Params GasOilParams;
     typedef typename OilWaterLawT::Params OilWaterParams;
+    typedef Ewoms::HermiteTabulated1DFunction<Scalar> TabulatedFunction;
 
     /*!
      * \brief The default constructor.
@@ -65,6 +68,51 @@ public:
         EnsureFinalized :: finalize();
     }
 
+    /*!
+     * \brief Create a table for the power function of the extended Stone 1 model.
+     *
+     * The table covers the arguments in [minArg, 1] and it is refined until the
+     * interpolation error is below the given tolerance. If this is not possible, an empty
+     * pointer is returned. If the exponent is smaller than one, the derivative of the
+     * power function is unbounded at zero, so the minimum should be larger than that.
+     *
+     * Since the table only depends on the exponent, it is usually shared by all
+     * parameter objects of a saturation region.
+     */
+    static std::shared_ptr<const TabulatedFunction> createEtaPowTable(Scalar eta,
+                                                                      Scalar minArg,
+                                                                      Scalar tolerance)
+    {
+        if (!(0.0 <= minArg && minArg < 1.0))
+            throw std::invalid_argument("The minimum argument for tabulating the power "
+                                        "function of the Stone 1 model must be within [0, 1)");
+        if (!(tolerance > 0.0))
+            throw std::invalid_argument("The tolerance for tabulating the power function "
+                                        "of the Stone 1 model must be positive");
+
+        auto table = std::make_shared<TabulatedFunction>();
+        if (!table->init(EtaPowFunction_(eta), minArg, 1.0, tolerance))
+            return nullptr;
+        return table;
+    }
+
+    /*!
+     * \brief Use a table for the power function of the extended Stone 1 model.
+     *
+     * The table must have been created by createEtaPowTable() for the exponent of this
+     * object. Outside of its range and if no table is set, pow() is used.
+     */
+    void setEtaPowTable(std::shared_ptr<const TabulatedFunction> table)
+    { etaPowTable_ = table; }
+
+    /*!
+     * \brief Return the table of the power function of the extended Stone 1 model.
+     *
+     * The pointer is empty if the power function is not tabulated.
+     */
+    const std::shared_ptr<const TabulatedFunction>& etaPowTable() const
+    { EnsureFinalized::check(); return etaPowTable_; }
+
     /*!
      * \brief The parameter object for the gas-oil twophase law.
      */
@@ -141,12 +189,25 @@ public:
     { EnsureFinalized::check(); return eta_; }
 
 private:
+    struct EtaPowFunction_
+    {
+        explicit EtaPowFunction_(Scalar eta) : eta_(eta) {}
+
+        template <class Evaluation>
+        Evaluation operator()(const Evaluation& x) const
+        { return Ewoms::pow(x, eta_); }
+
+        Scalar eta_;
+    };
+
     std::shared_ptr<GasOilParams> gasOilParams_;
     std::shared_ptr<OilWaterParams> oilWaterParams_;
 
     Scalar Swl_;
     Scalar eta_;
     Scalar krocw_;
+
+    std::shared_ptr<const TabulatedFunction> etaPowTable_;
 };
 } // namespace Ewoms
 
@@ -214,31 +214,24 @@ public:
     {
         const Scalar Sthres = params.pcnwLowSw();
 
-        // calculate the saturation which corrosponds to the
-        // saturation in the non-regularized version of the
-        // Brooks-Corey law. If the input capillary pressure is
-        // smaller than the entry pressure, make sure that we will
-        // regularize.
-        Evaluation Sw = 1.5;
-        if (pcnw >= params.entryPressure())
-            Sw = BrooksCorey::twoPhaseSatSw(params, pcnw);
-
         // make sure that the capilary pressure observes a
         // derivative != 0 for 'illegal' saturations. This is
         // required for example by newton solvers (if the
         // derivative calculated numerically) in order to get the
         // saturation moving to the right direction if it
-        // temporarily is in an 'illegal' range.
-        if (Sw <= Sthres) {
+        // temporarily is in an 'illegal' range. Since the capillary
+        // pressure curve is monotonically decreasing, the regularized
+        // ranges are identified using the capillary pressures at the
+        // threshold saturations, i.e., without evaluating the
+        // non-regularized Brooks-Corey law.
+        if (pcnw >= params.pcnwLow()) {
             // invert the low saturation regularization of pcnw()
-            Scalar m = params.pcnwSlopeLow();
-            Scalar pcnw_SwLow = params.pcnwLow();
-            return Sthres + (pcnw - pcnw_SwLow)/m;
+            return Sthres + (pcnw - params.pcnwLow())*params.pcnwInvSlopeLow();
         }
-        else if (Sw > 1.0) {
-            Scalar m = params.pcnwSlopeHigh();
-            Scalar pcnw_SwHigh = params.pcnwHigh();
-            return 1.0 + (pcnw - pcnw_SwHigh)/m;;
+        else if (pcnw < params.entryPressure()) {
+            // the input capillary pressure is smaller than the entry
+            // pressure, i.e., the saturation is larger than 1
+            return 1.0 + (pcnw - params.pcnwHigh())*params.pcnwInvSlopeHigh();
         }
 
         return BrooksCorey::twoPhaseSatSw(params, pcnw);
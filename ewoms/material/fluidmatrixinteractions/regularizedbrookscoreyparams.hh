@@ -70,6 +70,10 @@ public:
         pcnwSlopeLow_ = dPcnw_dSw_(pcnwLowSw_);
         pcnwHigh_ = BrooksCorey::twoPhaseSatPcnw(*this, 1.0);
         pcnwSlopeHigh_ = dPcnw_dSw_(1.0);
+
+        // the inverse slopes are required to invert the regularization
+        pcnwInvSlopeLow_ = 1.0/pcnwSlopeLow_;
+        pcnwInvSlopeHigh_ = 1.0/pcnwSlopeHigh_;
     }
 
     /*!
@@ -118,6 +122,18 @@ public:
     Scalar pcnwSlopeHigh() const
     { EnsureFinalized::check(); return pcnwSlopeHigh_; }
 
+    /*!
+     * \brief Return the inverse of pcnwSlopeLow().
+     */
+    Scalar pcnwInvSlopeLow() const
+    { EnsureFinalized::check(); return pcnwInvSlopeLow_; }
+
+    /*!
+     * \brief Return the inverse of pcnwSlopeHigh().
+     */
+    Scalar pcnwInvSlopeHigh() const
+    { EnsureFinalized::check(); return pcnwInvSlopeHigh_; }
+
 private:
     Scalar dPcnw_dSw_(Scalar Sw) const
     {
@@ -149,6 +165,8 @@ private:
     Scalar pcnwSlopeLow_;
     Scalar pcnwHigh_;
     Scalar pcnwSlopeHigh_;
+    Scalar pcnwInvSlopeLow_;
+    Scalar pcnwInvSlopeHigh_;
 };
 } // namespace Ewoms
 
@@ -180,19 +180,12 @@ public:
         }
         else if (Sw > SwThHigh)
         {
-            Scalar yTh = params.pcnwHigh();
-            Scalar m1 = (0.0 - yTh)/(1.0 - SwThHigh)*2;
-
-            if (Sw < 1.0) {
+            if (Sw < 1.0)
                 // use spline between threshold Sw and 1.0
-                const Spline<Scalar>& sp = params.pcnwHighSpline();
-
-                return sp.eval(Sw);
-            }
-            else {
+                return params.pcnwHighPolynomial(Sw);
+            else
                 // straight line for Sw > 1.0
-                return m1*(Sw - 1.0) + 0.0;
-            }
+                return params.pcnwSlopeHigh()*(Sw - 1.0) + 0.0;
         }
 
         // if the effective saturation is in an 'reasonable'
@@ -240,15 +233,14 @@ public:
             return pC/m1 + 1.0;
         }
 
-        Evaluation Sw = VanGenuchten::twoPhaseSatSw(params, pC);
-
-        // invert the regularization if necessary
-        if (Sw <= SwThLow) {
+        // the capillary pressure curve is monotonically decreasing, so the regularized
+        // ranges can be identified using the capillary pressures at the threshold
+        // saturations, i.e., without evaluating the unregularized curve
+        if (pC >= params.pcnwLow()) {
             // invert the low saturation regularization of pC()
-            Scalar pC_SwLow = VanGenuchten::twoPhaseSatPcnw(params, SwThLow);
-            return (pC - pC_SwLow)/params.pcnwSlopeLow() + SwThLow;
+            return (pC - params.pcnwLow())/params.pcnwSlopeLow() + SwThLow;
         }
-        else if (SwThHigh < Sw /* && Sw < 1.0*/)
+        else if (pC < params.pcnwHigh())
         {
             // invert spline between threshold saturation and 1.0
             const Spline<Scalar>& spline = params.pcnwHighSpline();
@@ -257,7 +249,7 @@ public:
                                                                  /*a=*/0, /*b=*/0, /*c=*/0, /*d=*/pC);
         }
 
-        return Sw;
+        return VanGenuchten::twoPhaseSatSw(params, pC);
     }
 
     /*!
@@ -28,6 +28,7 @@
 
 #include <ewoms/common/spline.hh>
 
+#include <array>
 #include <cassert>
 
 namespace Ewoms {
@@ -81,6 +82,16 @@ public:
         pcnwHighSpline_.set(pcnwHighSw_, 1.0, // x0, x1
                             pcnwHigh_, 0, // y0, y1
                             mThreshold, pcnwSlopeHigh_); // m0, m1
+
+        // the spline between the high threshold saturation and 1 is a single cubic
+        // Hermite polynomial. store its coefficients in monomial form w.r.t. (Sw -
+        // SwThHigh) so that evaluating it does not require to locate the segment.
+        Scalar h = 1.0 - pcnwHighSw_;
+        Scalar deltaY = 0.0 - pcnwHigh_;
+        pcnwHighCoeffs_[0] = pcnwHigh_;
+        pcnwHighCoeffs_[1] = mThreshold;
+        pcnwHighCoeffs_[2] = (3*deltaY/h - 2*mThreshold - pcnwSlopeHigh_)/h;
+        pcnwHighCoeffs_[3] = (-2*deltaY/h + mThreshold + pcnwSlopeHigh_)/(h*h);
     }
 
     /*!
@@ -143,6 +154,21 @@ public:
     Scalar pcnwSlopeHigh() const
     { EnsureFinalized::check(); return pcnwSlopeHigh_; }
 
+    /*!
+     * \brief Evaluate the regularized capillary pressure between the high threshold
+     *        saturation and 1.
+     *
+     * This yields the same values as pcnwHighSpline(), but it uses the precomputed
+     * coefficients of the polynomial.
+     */
+    template <class Evaluation>
+    Evaluation pcnwHighPolynomial(const Evaluation& Sw) const
+    {
+        EnsureFinalized::check();
+        const Evaluation& x = Sw - pcnwHighSw_;
+        return pcnwHighCoeffs_[0] + x*(pcnwHighCoeffs_[1] + x*(pcnwHighCoeffs_[2] + x*pcnwHighCoeffs_[3]));
+    }
+
     /*!
      * \brief Set the threshold saturation below which the capillary
      *        pressure is regularized.
@@ -171,6 +197,7 @@ private:
     Scalar pcnwSlopeHigh_;
 
     Spline<Scalar> pcnwHighSpline_;
+    std::array<Scalar, 4> pcnwHighCoeffs_;
 };
 } // namespace Ewoms
 
@@ -25,6 +25,8 @@
 
 #include "splinetwophasematerialparams.hh"
 
+#include <ewoms/common/mathtoolbox.hh>
+
 #include <algorithm>
 #include <cmath>
 #include <cassert>
@@ -137,6 +139,10 @@ public:
         if (Sw >= pcnwSpline.xAt(pcnwSpline.numSamples() - 1))
             return Evaluation(pcnwSpline.valueAt(pcnwSpline.numSamples() - 1));
 
+        const auto& pcnwTable = params.pcnwTable();
+        if (pcnwTable.applies(Ewoms::scalarValue(Sw)))
+            return pcnwTable.eval(Sw);
+
         return pcnwSpline.eval(Sw);
     }
 
@@ -149,9 +155,13 @@ public:
         const auto& pcnwSpline = params.pcnwSpline();
         if (pcnw >= pcnwSpline.valueAt(0))
             return Evaluation(pcnwSpline.xAt(0));
-        if (pcnw <= pcnwSpline.y(pcnwSpline.numSamples() - 1))
+        if (pcnw <= pcnwSpline.valueAt(pcnwSpline.numSamples() - 1))
             return Evaluation(pcnwSpline.xAt(pcnwSpline.numSamples() - 1));
 
+        const auto& pcnwInvTable = params.pcnwInvTable();
+        if (pcnwInvTable.applies(Ewoms::scalarValue(pcnw)))
+            return pcnwInvTable.eval(pcnw);
+
         // the intersect() method of splines is a bit slow, but this code path is not too
         // time critical...
         return pcnwSpline.intersect(/*a=*/nil, /*b=*/nil, /*c=*/nil, /*d=*/pcnw);
@@ -161,12 +171,17 @@ public:
      * \brief The saturation-capillary pressure curve
      */
     template <class FluidState, class Evaluation = typename FluidState::Scalar>
-    static Evaluation Sw(const Params& /*params*/, const FluidState& /*fluidState*/)
-    { throw std::logic_error("Not implemented: Sw()"); }
+    static Evaluation Sw(const Params& params, const FluidState& fluidState)
+    {
+        const Evaluation& pC =
+            Ewoms::decay<Evaluation>(fluidState.pressure(Traits::nonWettingPhaseIdx))
+            - Ewoms::decay<Evaluation>(fluidState.pressure(Traits::wettingPhaseIdx));
+        return twoPhaseSatSw(params, pC);
+    }
 
     template <class Evaluation>
-    static Evaluation twoPhaseSatSw(const Params& /*params*/, const Evaluation& /*pC*/)
-    { throw std::logic_error("Not implemented: twoPhaseSatSw()"); }
+    static Evaluation twoPhaseSatSw(const Params& params, const Evaluation& pC)
+    { return twoPhaseSatPcnwInv(params, pC); }
 
     /*!
      * \brief Calculate the non-wetting phase saturations depending on
@@ -202,6 +217,10 @@ public:
         if (Sw >= krwSpline.xAt(krwSpline.numSamples() - 1))
             return Evaluation(krwSpline.valueAt(krwSpline.numSamples() - 1));
 
+        const auto& krwTable = params.krwTable();
+        if (krwTable.applies(Ewoms::scalarValue(Sw)))
+            return krwTable.eval(Sw);
+
         return krwSpline.eval(Sw);
     }
 
@@ -241,6 +260,10 @@ public:
         if (Sw >= krnSpline.xAt(krnSpline.numSamples() - 1))
             return Evaluation(krnSpline.valueAt(krnSpline.numSamples() - 1));
 
+        const auto& krnTable = params.krnTable();
+        if (krnTable.applies(Ewoms::scalarValue(Sw)))
+            return krnTable.eval(Sw);
+
         return krnSpline.eval(Sw);
     }
 
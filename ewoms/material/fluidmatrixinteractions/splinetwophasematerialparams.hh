@@ -25,8 +25,11 @@
 
 #include <ewoms/common/spline.hh>
 #include <ewoms/material/common/ensurefinalized.hh>
+#include <ewoms/material/common/hermitetabulated1dfunction.hh>
 
 #include <vector>
+#include <algorithm>
+#include <stdexcept>
 #include <cassert>
 
 namespace Ewoms {
@@ -40,20 +43,112 @@ template<class TraitsT>
 class SplineTwoPhaseMaterialParams : public EnsureFinalized
 {
     typedef typename TraitsT::Scalar Scalar;
-public:
-    using EnsureFinalized :: finalize;
 
 public:
     typedef std::vector<Scalar> SamplePoints;
     typedef Ewoms::Spline<Scalar> Spline;
     typedef typename Spline::SplineType SplineType;
+    typedef Ewoms::HermiteTabulated1DFunction<Scalar> TabulatedFunction;
 
     typedef TraitsT Traits;
 
     SplineTwoPhaseMaterialParams()
+        : resamplingTolerance_(0.0)
+    {
+    }
+
+    /*!
+     * \brief Calculate all dependent quantities once the independent
+     *        quantities of the parameter object have been set.
+     *
+     * If resampling was requested, this creates the tables with equidistant sampling
+     * points for the splines and for the inverse of the capillary pressure curve.
+     */
+    void finalize()
     {
+        EnsureFinalized :: finalize();
+
+        pcnwTable_.clear();
+        krwTable_.clear();
+        krnTable_.clear();
+        pcnwInvTable_.clear();
+        if (resamplingTolerance_ <= 0.0)
+            return;
+
+        resample_(pcnwTable_, pcwnSpline_);
+        resample_(krwTable_, krwSpline_);
+        resample_(krnTable_, krnSpline_);
+
+        // the inverse of the capillary pressure curve is only well-defined if it is
+        // strictly decreasing. since evaluating the inverse spline requires to solve a
+        // non-linear equation, the number of sampling points is limited.
+        size_t n = pcwnSpline_.numSamples();
+        if (n < 2)
+            return;
+        for (size_t i = 0; i < n; ++i)
+            if (!(pcwnSpline_.evalDerivative(pcwnSpline_.xAt(i)) < 0.0))
+                return;
+        if (pcwnSpline_.monotonic(pcwnSpline_.xAt(0), pcwnSpline_.xAt(n - 1)) >= 0)
+            return;
+
+        pcnwInvTable_.init(PcnwInverseFunction_(pcwnSpline_),
+                           pcwnSpline_.valueAt(n - 1),
+                           pcwnSpline_.valueAt(0),
+                           resamplingTolerance_,
+                           /*minSamples=*/16,
+                           /*maxSamples=*/1 << 12);
     }
 
+    /*!
+     * \brief Resample the splines using equidistant sampling points.
+     *
+     * Locating the segment of a spline with arbitrary sampling points requires a
+     * binary search. If resampling is enabled, finalize() creates cubic Hermite tables
+     * with equidistant sampling points for which the segment can be computed directly.
+     * In addition, the inverse of the capillary pressure curve is tabulated so that
+     * computing the saturation for a given capillary pressure does not require to solve
+     * a non-linear equation. The tables are refined until they reproduce the splines
+     * within the given tolerance relative to the largest value of the respective curve.
+     * If this is not possible, the splines are used directly.
+     */
+    void setResampling(Scalar tolerance)
+    {
+        if (!(tolerance > 0.0))
+            throw std::invalid_argument("The tolerance for resampling the splines must be positive");
+
+        resamplingTolerance_ = tolerance;
+    }
+
+    /*!
+     * \brief Return the resampled capillary pressure curve.
+     *
+     * The table does not apply to any saturation if resampling is disabled.
+     */
+    const TabulatedFunction& pcnwTable() const
+    { EnsureFinalized::check(); return pcnwTable_; }
+
+    /*!
+     * \brief Return the table of the inverse capillary pressure curve.
+     *
+     * The table does not apply to any capillary pressure if resampling is disabled or
+     * if the capillary pressure curve is not strictly decreasing.
+     */
+    const TabulatedFunction& pcnwInvTable() const
+    { EnsureFinalized::check(); return pcnwInvTable_; }
+
+    /*!
+     * \brief Return the resampled relative permeability curve of the wetting phase.
+     */
+    const TabulatedFunction& krwTable() const
+    { EnsureFinalized::check(); return krwTable_; }
+
+    /*!
+     * \brief Return the resampled relative permeability curve of the non-wetting
+     *        phase.
+     */
+    const TabulatedFunction& krnTable() const
+    { EnsureFinalized::check(); return krnTable_; }
+
     /*!
      * \brief Return the sampling points for the capillary pressure curve.
      *
@@ -122,10 +217,62 @@ public:
     }
 
 private:
+    struct SplineFunction_
+    {
+        explicit SplineFunction_(const Spline& spline) : spline_(spline) {}
+
+        template <class Evaluation>
+        Evaluation operator()(const Evaluation& x) const
+        { return spline_.eval(x); }
+
+        const Spline& spline_;
+    };
+
+    // the saturation for a given capillary pressure. the derivative is the inverse of
+    // the slope of the capillary pressure curve
+    struct PcnwInverseFunction_
+    {
+        explicit PcnwInverseFunction_(const Spline& spline) : spline_(spline) {}
+
+        template <class Evaluation>
+        Evaluation operator()(const Evaluation& pcnw) const
+        {
+            // the end points are handled explicitly because the root finder of the
+            // spline is not reliable if the solution coincides with the end of its range
+            Scalar pcnwValue = Ewoms::scalarValue(pcnw);
+            size_t n = spline_.numSamples();
+            Scalar Sw;
+            if (pcnwValue >= spline_.valueAt(0))
+                Sw = spline_.xAt(0);
+            else if (pcnwValue <= spline_.valueAt(n - 1))
+                Sw = spline_.xAt(n - 1);
+            else
+                Sw = spline_.intersect(/*a=*/Scalar(0.0), /*b=*/Scalar(0.0), /*c=*/Scalar(0.0), /*d=*/pcnwValue);
+            return Sw + (pcnw - pcnwValue)/spline_.evalDerivative(Sw);
+        }
+
+        const Spline& spline_;
+    };
+
+    void resample_(TabulatedFunction& table, const Spline& spline) const
+    {
+        size_t n = spline.numSamples();
+        if (n < 2)
+            return;
+
+        table.init(SplineFunction_(spline), spline.xAt(0), spline.xAt(n - 1), resamplingTolerance_);
+    }
+
     Spline SwSpline_;
     Spline pcwnSpline_;
     Spline krwSpline_;
     Spline krnSpline_;
+
+    Scalar resamplingTolerance_;
+    TabulatedFunction pcnwTable_;
+    TabulatedFunction pcnwInvTable_;
+    TabulatedFunction krwTable_;
+    TabulatedFunction krnTable_;
 };
 } // namespace Ewoms
 
@@ -188,6 +188,19 @@ public:
      */
     template <class Evaluation>
     static Evaluation twoPhaseSatPcnw(const Params& params, const Evaluation& Sw)
+    {
+        if (params.pcnwTable().applies(Ewoms::scalarValue(Sw)))
+            return params.pcnwTable().eval(Sw);
+
+        return twoPhaseSatPcnwAnalytic(params, Sw);
+    }
+
+    /*!
+     * \brief The capillary pressure-saturation curve which does not use the table of
+     *        the parameter object.
+     */
+    template <class Evaluation>
+    static Evaluation twoPhaseSatPcnwAnalytic(const Params& params, const Evaluation& Sw)
     {
         return Ewoms::pow(Ewoms::pow(Sw, -1.0/params.vgM()) - 1, 1.0/params.vgN())/params.vgAlpha();
     }
@@ -257,6 +270,19 @@ public:
     {
         assert(0.0 <= Sw && Sw <= 1.0);
 
+        if (params.krwTable().applies(Ewoms::scalarValue(Sw)))
+            return params.krwTable().eval(Sw);
+
+        return twoPhaseSatKrwAnalytic(params, Sw);
+    }
+
+    /*!
+     * \brief The relative permeability of the wetting phase which does not use the
+     *        table of the parameter object.
+     */
+    template <class Evaluation>
+    static Evaluation twoPhaseSatKrwAnalytic(const Params& params, const Evaluation& Sw)
+    {
         Evaluation r = 1.0 - Ewoms::pow(1.0 - Ewoms::pow(Sw, 1/params.vgM()), params.vgM());
         return Ewoms::sqrt(Sw)*r*r;
     }
@@ -284,6 +310,19 @@ public:
     {
         assert(0 <= Sw && Sw <= 1);
 
+        if (params.krnTable().applies(Ewoms::scalarValue(Sw)))
+            return params.krnTable().eval(Sw);
+
+        return twoPhaseSatKrnAnalytic(params, Sw);
+    }
+
+    /*!
+     * \brief The relative permeability of the non-wetting phase which does not use the
+     *        table of the parameter object.
+     */
+    template <class Evaluation>
+    static Evaluation twoPhaseSatKrnAnalytic(const Params& params, const Evaluation& Sw)
+    {
         return
             Ewoms::pow(1 - Sw, 1.0/3) *
             Ewoms::pow(1 - Ewoms::pow(Sw, 1/params.vgM()), 2*params.vgM());
@@ -24,8 +24,14 @@
 #define VAN_GENUCHTEN_PARAMS_HH
 
 #include <ewoms/material/common/ensurefinalized.hh>
+#include <ewoms/material/common/hermitetabulated1dfunction.hh>
+
+#include <stdexcept>
 
 namespace Ewoms {
+template <class TraitsT, class ParamsT>
+class VanGenuchten;
+
 /*!
  * \ingroup FluidMatrixInteractions
  *
@@ -42,21 +48,92 @@ class VanGenuchtenParams : public EnsureFinalized
     typedef typename TraitsT::Scalar Scalar;
 
 public:
-    using EnsureFinalized :: finalize;
-
     typedef TraitsT Traits;
+    typedef Ewoms::HermiteTabulated1DFunction<Scalar> TabulatedFunction;
 
     VanGenuchtenParams()
+        : tabulationTolerance_(0.0)
     {
     }
 
     VanGenuchtenParams(Scalar alphaParam, Scalar nParam)
+        : tabulationTolerance_(0.0)
     {
         setVgAlpha(alphaParam);
         setVgN(nParam);
         finalize();
     }
 
+    /*!
+     * \brief Calculate all dependent quantities once the independent
+     *        quantities of the parameter object have been set.
+     *
+     * If tabulation was requested, this samples the capillary pressure and the relative
+     * permeability curves.
+     */
+    void finalize()
+    {
+        EnsureFinalized :: finalize();
+
+        pcnwTable_.clear();
+        krwTable_.clear();
+        krnTable_.clear();
+        if (tabulationTolerance_ > 0.0) {
+            // the analytic curves are used while the tables are created because the
+            // tables do not apply to anything yet
+            pcnwTable_.init(PcnwFunction_(*this), tabulationSwMin_, tabulationSwMax_, tabulationTolerance_);
+            krwTable_.init(KrwFunction_(*this), tabulationSwMin_, tabulationSwMax_, tabulationTolerance_);
+            krnTable_.init(KrnFunction_(*this), tabulationSwMin_, tabulationSwMax_, tabulationTolerance_);
+        }
+    }
+
+    /*!
+     * \brief Use tables instead of the analytic capillary pressure and relative
+     *        permeability curves for wetting phase saturations within [SwMin, SwMax].
+     *
+     * Evaluating the van Genuchten curves requires up to three calls to pow() with
+     * non-integer exponents. The tables are created by finalize() and they are refined
+     * until the interpolation error is below the given tolerance relative to the
+     * largest value of the respective curve within the saturation range. If this is
+     * not possible, the analytic curve is used. Since the curves exhibit
+     * singularities for Sw -> 0 and Sw -> 1, the range should exclude these.
+     */
+    void setTabulation(Scalar SwMin, Scalar SwMax, Scalar tolerance)
+    {
+        if (!(0.0 <= SwMin && SwMin < SwMax && SwMax <= 1.0))
+            throw std::invalid_argument("The saturation range for tabulating the van "
+                                        "Genuchten curves must be a sub-interval of [0, 1]");
+        if (!(tolerance > 0.0))
+            throw std::invalid_argument("The tolerance for tabulating the van Genuchten "
+                                        "curves must be positive");
+
+        tabulationSwMin_ = SwMin;
+        tabulationSwMax_ = SwMax;
+        tabulationTolerance_ = tolerance;
+    }
+
+    /*!
+     * \brief Return the table of the capillary pressure curve.
+     *
+     * The table does not apply to any saturation if tabulation is disabled.
+     */
+    const TabulatedFunction& pcnwTable() const
+    { EnsureFinalized::check(); return pcnwTable_; }
+
+    /*!
+     * \brief Return the table of the relative permeability curve of the wetting
+     *        phase.
+     */
+    const TabulatedFunction& krwTable() const
+    { EnsureFinalized::check(); return krwTable_; }
+
+    /*!
+     * \brief Return the table of the relative permeability curve of the non-wetting
+     *        phase.
+     */
+    const TabulatedFunction& krnTable() const
+    { EnsureFinalized::check(); return krnTable_; }
+
     /*!
      * \brief Return the \f$\alpha\f$ shape parameter of van Genuchten's
      *        curve.
@@ -104,9 +181,51 @@ public:
     { vgN_ = n; vgM_ = 1 - 1/vgN_; }
 
 private:
+    typedef Ewoms::VanGenuchten<TraitsT, VanGenuchtenParams> VanGenuchtenLaw_;
+
+    struct PcnwFunction_
+    {
+        explicit PcnwFunction_(const VanGenuchtenParams& params) : params_(params) {}
+
+        template <class Evaluation>
+        Evaluation operator()(const Evaluation& Sw) const
+        { return VanGenuchtenLaw_::twoPhaseSatPcnwAnalytic(params_, Sw); }
+
+        const VanGenuchtenParams& params_;
+    };
+
+    struct KrwFunction_
+    {
+        explicit KrwFunction_(const VanGenuchtenParams& params) : params_(params) {}
+
+        template <class Evaluation>
+        Evaluation operator()(const Evaluation& Sw) const
+        { return VanGenuchtenLaw_::twoPhaseSatKrwAnalytic(params_, Sw); }
+
+        const VanGenuchtenParams& params_;
+    };
+
+    struct KrnFunction_
+    {
+        explicit KrnFunction_(const VanGenuchtenParams& params) : params_(params) {}
+
+        template <class Evaluation>
+        Evaluation operator()(const Evaluation& Sw) const
+        { return VanGenuchtenLaw_::twoPhaseSatKrnAnalytic(params_, Sw); }
+
+        const VanGenuchtenParams& params_;
+    };
+
     Scalar vgAlpha_;
     Scalar vgM_;
     Scalar vgN_;
+
+    Scalar tabulationSwMin_;
+    Scalar tabulationSwMax_;
+    Scalar tabulationTolerance_;
+    TabulatedFunction pcnwTable_;
+    TabulatedFunction krwTable_;
+    TabulatedFunction krnTable_;
 };
 } // namespace Ewoms
 
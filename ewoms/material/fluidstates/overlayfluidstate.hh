@@ -0,0 +1,357 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the eWoms project.
+
+  eWoms is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  eWoms is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with eWoms.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*!
+ * \file
+ *
+ * \copydoc Ewoms::OverlayFluidState
+ */
+#ifndef EWOMS_OVERLAY_FLUID_STATE_HH
+#define EWOMS_OVERLAY_FLUID_STATE_HH
+
+#include <ewoms/common/valgrind.hh>
+#include <ewoms/common/conditionalstorage.hh>
+#include <ewoms/common/unused.hh>
+
+#include <array>
+#include <utility>
+#include <type_traits>
+
+namespace Ewoms {
+
+/*!
+ * \brief The quantities which can be overridden by an OverlayFluidState.
+ *
+ * These are bit flags, i.e., they can be combined using the | operator.
+ */
+enum OverlayField {
+    overlayTemperature = 1 << 0,
+    overlayPressure = 1 << 1,
+    overlaySaturation = 1 << 2
+};
+
+/*!
+ * \brief This is a fluid state which allows to set the quantities specified by a
+ *        compile-time mask and takes all other quantities from an other fluid state.
+ *
+ * This generalizes \c TemperatureOverlayFluidState, \c PressureOverlayFluidState and
+ * \c SaturationOverlayFluidState: The overlayMask template argument is a combination
+ * of the flags of the OverlayField enumeration. Only the overridden quantities are
+ * stored by the object, all others are forwarded to the underlying fluid state.
+ *
+ * Nesting several of the specific overlay fluid states leads to one indirection per
+ * layer for the quantities which are not overridden. To avoid this, an overlay of an
+ * OverlayFluidState can be created from it using the OverlayFluidStateType helper
+ * class: The resulting object refers to the original fluid state directly and stores
+ * the union of the overridden quantities.
+ */
+template <class FluidState, unsigned overlayMask>
+class OverlayFluidState
+{
+    template <class OtherFluidState, unsigned otherMask>
+    friend class OverlayFluidState;
+
+    static const bool hasTemperature = (overlayMask & overlayTemperature) != 0;
+    static const bool hasPressure = (overlayMask & overlayPressure) != 0;
+    static const bool hasSaturation = (overlayMask & overlaySaturation) != 0;
+
+    static_assert((overlayMask & ~(overlayTemperature | overlayPressure | overlaySaturation)) == 0,
+                  "Invalid overlay mask");
+
+public:
+    typedef typename FluidState::Scalar Scalar;
+
+    enum { numPhases = FluidState::numPhases };
+    enum { numComponents = FluidState::numComponents };
+
+    /*!
+     * \brief Constructor
+     *
+     * The overlay fluid state copies the overridden quantities from the argument, so it
+     * initially behaves exactly like the underlying fluid state. (The temperature is
+     * taken from the first fluid phase, i.e., the underlying fluid state is assumed to
+     * be in thermal equilibrium.)
+     */
+    OverlayFluidState(const FluidState& fs)
+        : fs_(&fs)
+    { copyOverriddenFrom_(fs); }
+
+    /*!
+     * \brief Create an overlay of the same fluid state which another overlay refers to.
+     *
+     * The quantities which are overridden by the other overlay are copied from it, so
+     * the new object initially behaves exactly like the other overlay, but it does not
+     * refer to it.
+     */
+    template <unsigned otherMask>
+    OverlayFluidState(const OverlayFluidState<FluidState, otherMask>& fs)
+        : fs_(fs.fs_)
+    {
+        static_assert((otherMask & ~overlayMask) == 0,
+                      "The overlay must override all quantities which are overridden by "
+                      "the overlay it is created from");
+        copyOverriddenFrom_(fs);
+    }
+
+    // copy constructor
+    OverlayFluidState(const OverlayFluidState& fs) = default;
+
+    // assignment operator
+    OverlayFluidState& operator=(const OverlayFluidState& fs) = default;
+
+    /*!
+     * \brief Returns the fluid state which provides the quantities that are not
+     *        overridden.
+     */
+    const FluidState& baseFluidState() const
+    { return *fs_; }
+
+    /*****************************************************
+     * Generic access to fluid properties (No assumptions
+     * on thermodynamic equilibrium required)
+     *****************************************************/
+    /*!
+     * \brief Returns the saturation of a phase []
+     */
+    auto saturation(unsigned phaseIdx) const
+        -> typename std::conditional<hasSaturation,
+                                     const Scalar&,
+                                     decltype(std::declval<FluidState>().saturation(phaseIdx))>::type
+    { return saturationImpl_(phaseIdx, std::integral_constant<bool, hasSaturation>()); }
+
+    /*!
+     * \brief The mole fraction of a component in a phase []
+     */
+    auto moleFraction(unsigned phaseIdx, unsigned compIdx) const
+        -> decltype(std::declval<FluidState>().moleFraction(phaseIdx, compIdx))
+    { return fs_->moleFraction(phaseIdx, compIdx); }
+
+    /*!
+     * \brief The mass fraction of a component in a phase []
+     */
+    auto massFraction(unsigned phaseIdx, unsigned compIdx) const
+        -> decltype(std::declval<FluidState>().massFraction(phaseIdx, compIdx))
+    { return fs_->massFraction(phaseIdx, compIdx); }
+
+    /*!
+     * \brief The average molar mass of a fluid phase [kg/mol]
+     *
+     * The average mass is the mean molar mass of a molecule of the
+     * fluid at current composition. It is defined as the sum of the
+     * component's molar masses weighted by the current mole fraction:
+     * \f[ \bar M_\alpha = \sum_\kappa M^\kappa x_\alpha^\kappa \f]
+     */
+    auto averageMolarMass(unsigned phaseIdx) const
+        -> decltype(std::declval<FluidState>().averageMolarMass(phaseIdx))
+    { return fs_->averageMolarMass(phaseIdx); }
+
+    /*!
+     * \brief The molar concentration of a component in a phase [mol/m^3]
+     *
+     * This quantity is usually called "molar concentration" or just
+     * "concentration", but there are many other (though less common)
+     * measures for concentration.
+     *
+     * http://en.wikipedia.org/wiki/Concentration
+     */
+    auto molarity(unsigned phaseIdx, unsigned compIdx) const
+        -> decltype(std::declval<FluidState>().molarity(phaseIdx, compIdx))
+    { return fs_->molarity(phaseIdx, compIdx); }
+
+    /*!
+     * \brief The fugacity of a component in a phase [Pa]
+     */
+    auto fugacity(unsigned phaseIdx, unsigned compIdx) const
+        -> decltype(std::declval<FluidState>().fugacity(phaseIdx, compIdx))
+    { return fs_->fugacity(phaseIdx, compIdx); }
+
+    /*!
+     * \brief The fugacity coefficient of a component in a phase [-]
+     */
+    auto fugacityCoefficient(unsigned phaseIdx, unsigned compIdx) const
+        -> decltype(std::declval<FluidState>().fugacityCoefficient(phaseIdx, compIdx))
+    { return fs_->fugacityCoefficient(phaseIdx, compIdx); }
+
+    /*!
+     * \brief The molar volume of a fluid phase [m^3/mol]
+     */
+    auto molarVolume(unsigned phaseIdx) const
+        -> decltype(std::declval<FluidState>().molarVolume(phaseIdx))
+    { return fs_->molarVolume(phaseIdx); }
+
+    /*!
+     * \brief The mass density of a fluid phase [kg/m^3]
+     */
+    auto density(unsigned phaseIdx) const
+        -> decltype(std::declval<FluidState>().density(phaseIdx))
+    { return fs_->density(phaseIdx); }
+
+    /*!
+     * \brief The molar density of a fluid phase [mol/m^3]
+     */
+    auto molarDensity(unsigned phaseIdx) const
+        -> decltype(std::declval<FluidState>().molarDensity(phaseIdx))
+    { return fs_->molarDensity(phaseIdx); }
+
+    /*!
+     * \brief The temperature of a fluid phase [K]
+     */
+    auto temperature(unsigned phaseIdx) const
+        -> typename std::conditional<hasTemperature,
+                                     const Scalar&,
+                                     decltype(std::declval<FluidState>().temperature(phaseIdx))>::type
+    { return temperatureImpl_(phaseIdx, std::integral_constant<bool, hasTemperature>()); }
+
+    /*!
+     * \brief The pressure of a fluid phase [Pa]
+     */
+    auto pressure(unsigned phaseIdx) const
+        -> typename std::conditional<hasPressure,
+                                     const Scalar&,
+                                     decltype(std::declval<FluidState>().pressure(phaseIdx))>::type
+    { return pressureImpl_(phaseIdx, std::integral_constant<bool, hasPressure>()); }
+
+    /*!
+     * \brief The specific enthalpy of a fluid phase [J/kg]
+     */
+    auto enthalpy(unsigned phaseIdx) const
+        -> decltype(std::declval<FluidState>().enthalpy(phaseIdx))
+    { return fs_->enthalpy(phaseIdx); }
+
+    /*!
+     * \brief The specific internal energy of a fluid phase [J/kg]
+     */
+    auto internalEnergy(unsigned phaseIdx) const
+        -> decltype(std::declval<FluidState>().internalEnergy(phaseIdx))
+    { return fs_->internalEnergy(phaseIdx); }
+
+    /*!
+     * \brief The dynamic viscosity of a fluid phase [Pa s]
+     */
+    auto viscosity(unsigned phaseIdx) const
+        -> decltype(std::declval<FluidState>().viscosity(phaseIdx))
+    { return fs_->viscosity(phaseIdx); }
+
+    /*****************************************************
+     * Setter methods. Note that these are not part of the
+     * generic FluidState interface but specific for each
+     * implementation...
+     *****************************************************/
+    /*!
+     * \brief Set the temperature [K] of all fluid phases
+     */
+    void setTemperature(const Scalar& value)
+    {
+        static_assert(hasTemperature, "The temperature is not overridden by this overlay");
+        *temperature_ = value;
+    }
+
+    /*!
+     * \brief Set the pressure [Pa] of a fluid phase
+     */
+    void setPressure(unsigned phaseIdx, const Scalar& value)
+    {
+        static_assert(hasPressure, "The pressures are not overridden by this overlay");
+        (*pressure_)[phaseIdx] = value;
+    }
+
+    /*!
+     * \brief Set the saturation [-] of a fluid phase
+     */
+    void setSaturation(unsigned phaseIdx, const Scalar& value)
+    {
+        static_assert(hasSaturation, "The saturations are not overridden by this overlay");
+        (*saturation_)[phaseIdx] = value;
+    }
+
+    /*!
+     * \brief Make sure that all attributes are defined.
+     *
+     * This method does not do anything if the program is not run
+     * under valgrind. If it is, then valgrind will print an error
+     * message if some attributes of the object have not been properly
+     * defined.
+     */
+    void checkDefined() const
+    {
+        if (hasTemperature)
+            Valgrind::CheckDefined(*temperature_);
+        if (hasPressure)
+            Valgrind::CheckDefined(*pressure_);
+        if (hasSaturation)
+            Valgrind::CheckDefined(*saturation_);
+    }
+
+protected:
+    template <class OtherFluidState>
+    void copyOverriddenFrom_(const OtherFluidState& fs)
+    {
+        if (hasTemperature)
+            *temperature_ = fs.temperature(/*phaseIdx=*/0);
+
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+            if (hasPressure)
+                (*pressure_)[phaseIdx] = fs.pressure(phaseIdx);
+            if (hasSaturation)
+                (*saturation_)[phaseIdx] = fs.saturation(phaseIdx);
+        }
+    }
+
+    const Scalar& temperatureImpl_(unsigned phaseIdx EWOMS_UNUSED, std::true_type) const
+    { return *temperature_; }
+    auto temperatureImpl_(unsigned phaseIdx, std::false_type) const
+        -> decltype(std::declval<FluidState>().temperature(phaseIdx))
+    { return fs_->temperature(phaseIdx); }
+
+    const Scalar& pressureImpl_(unsigned phaseIdx, std::true_type) const
+    { return (*pressure_)[phaseIdx]; }
+    auto pressureImpl_(unsigned phaseIdx, std::false_type) const
+        -> decltype(std::declval<FluidState>().pressure(phaseIdx))
+    { return fs_->pressure(phaseIdx); }
+
+    const Scalar& saturationImpl_(unsigned phaseIdx, std::true_type) const
+    { return (*saturation_)[phaseIdx]; }
+    auto saturationImpl_(unsigned phaseIdx, std::false_type) const
+        -> decltype(std::declval<FluidState>().saturation(phaseIdx))
+    { return fs_->saturation(phaseIdx); }
+
+    const FluidState* fs_;
+    Ewoms::ConditionalStorage<hasTemperature, Scalar> temperature_;
+    Ewoms::ConditionalStorage<hasPressure, std::array<Scalar, numPhases> > pressure_;
+    Ewoms::ConditionalStorage<hasSaturation, std::array<Scalar, numPhases> > saturation_;
+};
+
+/*!
+ * \brief Determines the type of an overlay fluid state which overrides the quantities
+ *        specified by a mask on top of a given fluid state.
+ *
+ * If the given fluid state is an OverlayFluidState itself, the resulting type refers to
+ * the fluid state underlying it and overrides the union of both masks, i.e., layering
+ * overlays does not add indirections.
+ */
+template <class FluidState, unsigned overlayMask>
+struct OverlayFluidStateType
+{ typedef OverlayFluidState<FluidState, overlayMask> type; };
+
+template <class FluidState, unsigned baseMask, unsigned overlayMask>
+struct OverlayFluidStateType<OverlayFluidState<FluidState, baseMask>, overlayMask>
+{ typedef OverlayFluidState<FluidState, baseMask | overlayMask> type; };
+
+} // namespace Ewoms
+
+#endif
@@ -0,0 +1,534 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the eWoms project.
+
+  eWoms is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  eWoms is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with eWoms.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*!
+ * \file
+ *
+ * \copydoc Ewoms::SoaFluidStateContainer
+ */
+#ifndef EWOMS_SOA_FLUID_STATE_CONTAINER_HH
+#define EWOMS_SOA_FLUID_STATE_CONTAINER_HH
+
+#include <ewoms/common/valgrind.hh>
+#include <ewoms/common/mathtoolbox.hh>
+#include <ewoms/common/unused.hh>
+#include <ewoms/common/hasmembergeneratormacros.hh>
+
+#include <vector>
+#include <type_traits>
+#include <cassert>
+#include <cstddef>
+
+namespace Ewoms {
+
+template <class Scalar, class FluidSystem>
+class SoaFluidStateContainer;
+
+template <class ScalarT, class FluidSystem, bool enableTemperature, bool enableEnergy,
+          bool enableDissolution, bool enableBrine, unsigned numStoragePhases>
+class BlackOilFluidState;
+
+template <class ScalarT, class FluidSystem, bool enableTemperature, bool enableEnergy,
+          bool enableDissolution, bool enableBrine, unsigned numStoragePhases,
+          bool memoizeInvB>
+class LeanBlackOilFluidState;
+
+EWOMS_GENERATE_HAS_MEMBER(viscosity, /*phaseIdx=*/0) // Creates 'HasMember_viscosity<T>'.
+EWOMS_GENERATE_HAS_MEMBER(enthalpy, /*phaseIdx=*/0) // Creates 'HasMember_enthalpy<T>'.
+EWOMS_GENERATE_HAS_MEMBER(fugacityCoefficient, /*phaseIdx=*/0, /*compIdx=*/0) // Creates 'HasMember_fugacityCoefficient<T>'.
+
+/*!
+ * \brief Specifies which of the optional quantities can be retrieved from a fluid state
+ *        by SoaFluidStateView::assign().
+ *
+ * By default, a quantity is retrieved if the fluid state provides a method to access
+ * it. Fluid states which provide such a method but do not store the quantity, i.e., for
+ * which calling the method may throw or require an initialized fluid system, specialize
+ * this class.
+ */
+template <class FluidState>
+struct SoaFluidStateAssignTraits
+{
+    static const bool hasViscosity = HasMember_viscosity<FluidState>::value;
+    static const bool hasEnthalpy = HasMember_enthalpy<FluidState>::value;
+    static const bool hasFugacityCoefficients = HasMember_fugacityCoefficient<FluidState>::value;
+};
+
+/*!
+ * \brief The black-oil fluid state only stores the enthalpies, and only if energy is
+ *        considered. Viscosities and fugacity coefficients are computed by the fluid
+ *        system on the fly.
+ */
+template <class Scalar, class FluidSystem, bool enableTemperature, bool enableEnergy,
+          bool enableDissolution, bool enableBrine, unsigned numStoragePhases>
+struct SoaFluidStateAssignTraits<BlackOilFluidState<Scalar, FluidSystem, enableTemperature,
+                                                    enableEnergy, enableDissolution,
+                                                    enableBrine, numStoragePhases> >
+{
+    static const bool hasViscosity = false;
+    static const bool hasEnthalpy = enableEnergy;
+    static const bool hasFugacityCoefficients = false;
+};
+
+/*!
+ * \brief The lean black-oil fluid state stores the same quantities as the full one.
+ */
+template <class Scalar, class FluidSystem, bool enableTemperature, bool enableEnergy,
+          bool enableDissolution, bool enableBrine, unsigned numStoragePhases,
+          bool memoizeInvB>
+struct SoaFluidStateAssignTraits<LeanBlackOilFluidState<Scalar, FluidSystem, enableTemperature,
+                                                        enableEnergy, enableDissolution,
+                                                        enableBrine, numStoragePhases,
+                                                        memoizeInvB> >
+{
+    static const bool hasViscosity = false;
+    static const bool hasEnthalpy = enableEnergy;
+    static const bool hasFugacityCoefficients = false;
+};
+
+/*!
+ * \brief A view to the fluid state of a single cell which is stored by a
+ *        SoaFluidStateContainer.
+ *
+ * This class provides the same interface as \c CompositionalFluidState, i.e., it can
+ * be passed to the fluid systems, the material laws and the constraint solvers. It only
+ * consists of a pointer to the container and the index of the cell, so it is cheap to
+ * create and to copy. Copying a view does not copy the quantities of the cell, though.
+ * If the \c Container template argument is const, the setters are not available.
+ */
+template <class Container>
+class SoaFluidStateView
+{
+    typedef typename std::remove_const<Container>::type NonConstContainer;
+    typedef typename NonConstContainer::FluidSystem FluidSystem;
+
+public:
+    typedef typename NonConstContainer::Scalar Scalar;
+    enum { numPhases = FluidSystem::numPhases };
+    enum { numComponents = FluidSystem::numComponents };
+
+    SoaFluidStateView(Container& container, std::size_t cellIdx)
+        : container_(&container)
+        , cellIdx_(cellIdx)
+    {}
+
+    /*!
+     * \brief Returns the index of the cell within the container.
+     */
+    std::size_t cellIndex() const
+    { return cellIdx_; }
+
+    /*****************************************************
+     * Generic access to fluid properties
+     *****************************************************/
+
+    const Scalar& temperature(unsigned phaseIdx EWOMS_UNUSED) const
+    { return container_->temperatureArray()[cellIdx_]; }
+
+    const Scalar& pressure(unsigned phaseIdx) const
+    { return container_->pressureArray(phaseIdx)[cellIdx_]; }
+
+    const Scalar& saturation(unsigned phaseIdx) const
+    { return container_->saturationArray(phaseIdx)[cellIdx_]; }
+
+    const Scalar& moleFraction(unsigned phaseIdx, unsigned compIdx) const
+    { return container_->moleFractionArray(phaseIdx, compIdx)[cellIdx_]; }
+
+    Scalar massFraction(unsigned phaseIdx, unsigned compIdx) const
+    {
+        return
+            Ewoms::abs(container_->sumMoleFractionsArray(phaseIdx)[cellIdx_])
+            *moleFraction(phaseIdx, compIdx)
+            *FluidSystem::molarMass(compIdx)
+            / Ewoms::max(1e-40, Ewoms::abs(averageMolarMass(phaseIdx)));
+    }
+
+    const Scalar& averageMolarMass(unsigned phaseIdx) const
+    { return container_->averageMolarMassArray(phaseIdx)[cellIdx_]; }
+
+    Scalar molarity(unsigned phaseIdx, unsigned compIdx) const
+    { return molarDensity(phaseIdx)*moleFraction(phaseIdx, compIdx); }
+
+    const Scalar& density(unsigned phaseIdx) const
+    { return container_->densityArray(phaseIdx)[cellIdx_]; }
+
+    Scalar molarDensity(unsigned phaseIdx) const
+    { return density(phaseIdx)/averageMolarMass(phaseIdx); }
+
+    Scalar molarVolume(unsigned phaseIdx) const
+    { return 1/molarDensity(phaseIdx); }
+
+    const Scalar& viscosity(unsigned phaseIdx) const
+    { return container_->viscosityArray(phaseIdx)[cellIdx_]; }
+
+    const Scalar& enthalpy(unsigned phaseIdx) const
+    { return container_->enthalpyArray(phaseIdx)[cellIdx_]; }
+
+    Scalar internalEnergy(unsigned phaseIdx) const
+    { return enthalpy(phaseIdx) - pressure(phaseIdx)/density(phaseIdx); }
+
+    const Scalar& fugacityCoefficient(unsigned phaseIdx, unsigned compIdx) const
+    { return container_->fugacityCoefficientArray(phaseIdx, compIdx)[cellIdx_]; }
+
+    Scalar fugacity(unsigned phaseIdx, unsigned compIdx) const
+    { return fugacityCoefficient(phaseIdx, compIdx)*moleFraction(phaseIdx, compIdx)*pressure(phaseIdx); }
+
+    /*****************************************************
+     * Setter methods. Note that these are not part of the
+     * generic FluidState interface but specific for each
+     * implementation...
+     *****************************************************/
+
+    void setTemperature(const Scalar& value)
+    { container_->temperatureArray()[cellIdx_] = value; }
+
+    void setPressure(unsigned phaseIdx, const Scalar& value)
+    { container_->pressureArray(phaseIdx)[cellIdx_] = value; }
+
+    void setSaturation(unsigned phaseIdx, const Scalar& value)
+    { container_->saturationArray(phaseIdx)[cellIdx_] = value; }
+
+    /*!
+     * \brief Set the mole fraction of a component  in a phase []
+     *        and update the average molar mass [kg/mol] according
+     *        to the current composition of the phase
+     */
+    void setMoleFraction(unsigned phaseIdx, unsigned compIdx, const Scalar& value)
+    {
+        container_->moleFractionArray(phaseIdx, compIdx)[cellIdx_] = value;
+        updateAverageMolarMass_(phaseIdx);
+    }
+
+    void setDensity(unsigned phaseIdx, const Scalar& value)
+    { container_->densityArray(phaseIdx)[cellIdx_] = value; }
+
+    void setViscosity(unsigned phaseIdx, const Scalar& value)
+    { container_->viscosityArray(phaseIdx)[cellIdx_] = value; }
+
+    void setEnthalpy(unsigned phaseIdx, const Scalar& value)
+    { container_->enthalpyArray(phaseIdx)[cellIdx_] = value; }
+
+    void setFugacityCoefficient(unsigned phaseIdx, unsigned compIdx, const Scalar& value)
+    { container_->fugacityCoefficientArray(phaseIdx, compIdx)[cellIdx_] = value; }
+
+    /*!
+     * \brief Retrieve all parameters from an arbitrary fluid
+     *        state.
+     *
+     * The viscosities, enthalpies and fugacity coefficients are only retrieved if they
+     * are provided by the source fluid state (see SoaFluidStateAssignTraits). Otherwise,
+     * the values which are currently stored for the cell are left unchanged.
+     */
+    template <class FluidState>
+    void assign(const FluidState& fs)
+    {
+        typedef SoaFluidStateAssignTraits<FluidState> AssignTraits;
+
+        setTemperature(Ewoms::decay<Scalar>(fs.temperature(/*phaseIdx=*/0)));
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+            setPressure(phaseIdx, Ewoms::decay<Scalar>(fs.pressure(phaseIdx)));
+            setSaturation(phaseIdx, Ewoms::decay<Scalar>(fs.saturation(phaseIdx)));
+            setDensity(phaseIdx, Ewoms::decay<Scalar>(fs.density(phaseIdx)));
+            assignViscosity_<AssignTraits::hasViscosity>(fs, phaseIdx);
+            assignEnthalpy_<AssignTraits::hasEnthalpy>(fs, phaseIdx);
+
+            for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx) {
+                container_->moleFractionArray(phaseIdx, compIdx)[cellIdx_] =
+                    Ewoms::decay<Scalar>(fs.moleFraction(phaseIdx, compIdx));
+                assignFugacityCoefficient_<AssignTraits::hasFugacityCoefficients>(fs, phaseIdx, compIdx);
+            }
+            updateAverageMolarMass_(phaseIdx);
+        }
+    }
+
+    /*!
+     * \brief Make sure that all attributes are defined.
+     *
+     * This method does not do anything if the program is not run
+     * under valgrind. If it is, then valgrind will print an error
+     * message if some attributes of the object have not been properly
+     * defined.
+     */
+    void checkDefined() const
+    {
+        Valgrind::CheckDefined(temperature(/*phaseIdx=*/0));
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+            Valgrind::CheckDefined(pressure(phaseIdx));
+            Valgrind::CheckDefined(saturation(phaseIdx));
+            Valgrind::CheckDefined(averageMolarMass(phaseIdx));
+            Valgrind::CheckDefined(density(phaseIdx));
+            Valgrind::CheckDefined(viscosity(phaseIdx));
+            Valgrind::CheckDefined(enthalpy(phaseIdx));
+            for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx) {
+                Valgrind::CheckDefined(moleFraction(phaseIdx, compIdx));
+                Valgrind::CheckDefined(fugacityCoefficient(phaseIdx, compIdx));
+            }
+        }
+    }
+
+private:
+    template <bool enable, class FluidState>
+    typename std::enable_if<enable>::type
+    assignViscosity_(const FluidState& fs, unsigned phaseIdx)
+    { setViscosity(phaseIdx, Ewoms::decay<Scalar>(fs.viscosity(phaseIdx))); }
+
+    template <bool enable, class FluidState>
+    typename std::enable_if<!enable>::type
+    assignViscosity_(const FluidState& fs EWOMS_UNUSED, unsigned phaseIdx EWOMS_UNUSED)
+    { }
+
+    template <bool enable, class FluidState>
+    typename std::enable_if<enable>::type
+    assignEnthalpy_(const FluidState& fs, unsigned phaseIdx)
+    { setEnthalpy(phaseIdx, Ewoms::decay<Scalar>(fs.enthalpy(phaseIdx))); }
+
+    template <bool enable, class FluidState>
+    typename std::enable_if<!enable>::type
+    assignEnthalpy_(const FluidState& fs EWOMS_UNUSED, unsigned phaseIdx EWOMS_UNUSED)
+    { }
+
+    template <bool enable, class FluidState>
+    typename std::enable_if<enable>::type
+    assignFugacityCoefficient_(const FluidState& fs, unsigned phaseIdx, unsigned compIdx)
+    {
+        setFugacityCoefficient(phaseIdx, compIdx,
+                               Ewoms::decay<Scalar>(fs.fugacityCoefficient(phaseIdx, compIdx)));
+    }
+
+    template <bool enable, class FluidState>
+    typename std::enable_if<!enable>::type
+    assignFugacityCoefficient_(const FluidState& fs EWOMS_UNUSED,
+                               unsigned phaseIdx EWOMS_UNUSED,
+                               unsigned compIdx EWOMS_UNUSED)
+    { }
+
+    void updateAverageMolarMass_(unsigned phaseIdx)
+    {
+        Scalar sumMoleFractions = 0.0;
+        Scalar averageMolarMass = 0.0;
+        for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx) {
+            const Scalar& x = moleFraction(phaseIdx, compIdx);
+            sumMoleFractions += x;
+            averageMolarMass += x*FluidSystem::molarMass(compIdx);
+        }
+
+        container_->sumMoleFractionsArray(phaseIdx)[cellIdx_] = sumMoleFractions;
+        container_->averageMolarMassArray(phaseIdx)[cellIdx_] = averageMolarMass;
+    }
+
+    Container* container_;
+    std::size_t cellIdx_;
+};
+
+/*!
+ * \brief Stores the fluid states of a set of cells as a structure of arrays.
+ *
+ * The fluid state classes store all quantities of a single cell in one object, i.e.,
+ * an array of fluid states is an "array of structures". Operations on all cells which
+ * only need a few quantities, e.g., writing the pressures of a phase or checking the
+ * saturations for convergence, thus stride through memory. This container instead
+ * keeps a contiguous array for each quantity, e.g., one for the pressure of each phase
+ * and one for each mole fraction. These arrays can be accessed directly by batched
+ * kernels. For everything else, operator[] returns a SoaFluidStateView, which provides
+ * the interface of \c CompositionalFluidState for a single cell. Fluid states of other
+ * types, e.g., \c ImmiscibleFluidState or \c BlackOilFluidState, can be stored using the
+ * assign() method of the view.
+ */
+template <class ScalarT, class FluidSystemT>
+class SoaFluidStateContainer
+{
+public:
+    typedef ScalarT Scalar;
+    typedef FluidSystemT FluidSystem;
+
+    enum { numPhases = FluidSystem::numPhases };
+    enum { numComponents = FluidSystem::numComponents };
+
+    typedef SoaFluidStateView<SoaFluidStateContainer> FluidStateView;
+    typedef SoaFluidStateView<const SoaFluidStateContainer> ConstFluidStateView;
+
+    explicit SoaFluidStateContainer(std::size_t numCells = 0)
+    { resize(numCells); }
+
+    /*!
+     * \brief Set the number of cells.
+     *
+     * This discards the quantities which are currently stored and sets all of them to
+     * zero.
+     */
+    void resize(std::size_t numCells)
+    {
+        numCells_ = numCells;
+        data_.assign(numFields_*numCells, Scalar(0.0));
+    }
+
+    /*!
+     * \brief Returns the number of cells.
+     */
+    std::size_t size() const
+    { return numCells_; }
+
+    /*!
+     * \brief Returns a view to the fluid state of a cell.
+     */
+    FluidStateView operator[](std::size_t cellIdx)
+    { assert(cellIdx < numCells_); return FluidStateView(*this, cellIdx); }
+
+    /*!
+     * \brief Returns a read-only view to the fluid state of a cell.
+     */
+    ConstFluidStateView operator[](std::size_t cellIdx) const
+    { assert(cellIdx < numCells_); return ConstFluidStateView(*this, cellIdx); }
+
+    /*!
+     * \brief The temperatures of all cells [K].
+     */
+    Scalar* temperatureArray()
+    { return field_(temperatureOffset_); }
+    const Scalar* temperatureArray() const
+    { return field_(temperatureOffset_); }
+
+    /*!
+     * \brief The pressures of a phase in all cells [Pa].
+     */
+    Scalar* pressureArray(unsigned phaseIdx)
+    { return field_(pressureOffset_ + phaseIdx); }
+    const Scalar* pressureArray(unsigned phaseIdx) const
+    { return field_(pressureOffset_ + phaseIdx); }
+
+    /*!
+     * \brief The saturations of a phase in all cells [-].
+     */
+    Scalar* saturationArray(unsigned phaseIdx)
+    { return field_(saturationOffset_ + phaseIdx); }
+    const Scalar* saturationArray(unsigned phaseIdx) const
+    { return field_(saturationOffset_ + phaseIdx); }
+
+    /*!
+     * \brief The mole fractions of a component in a phase in all cells [-].
+     *
+     * Note that the average molar masses are not updated if the mole fractions are
+     * modified via this array. Use updateAverageMolarMasses() afterwards.
+     */
+    Scalar* moleFractionArray(unsigned phaseIdx, unsigned compIdx)
+    { return field_(moleFractionOffset_ + phaseIdx*numComponents + compIdx); }
+    const Scalar* moleFractionArray(unsigned phaseIdx, unsigned compIdx) const
+    { return field_(moleFractionOffset_ + phaseIdx*numComponents + compIdx); }
+
+    /*!
+     * \brief The average molar masses of a phase in all cells [kg/mol].
+     */
+    Scalar* averageMolarMassArray(unsigned phaseIdx)
+    { return field_(averageMolarMassOffset_ + phaseIdx); }
+    const Scalar* averageMolarMassArray(unsigned phaseIdx) const
+    { return field_(averageMolarMassOffset_ + phaseIdx); }
+
+    /*!
+     * \brief The sums of the mole fractions of a phase in all cells [-].
+     */
+    Scalar* sumMoleFractionsArray(unsigned phaseIdx)
+    { return field_(sumMoleFractionsOffset_ + phaseIdx); }
+    const Scalar* sumMoleFractionsArray(unsigned phaseIdx) const
+    { return field_(sumMoleFractionsOffset_ + phaseIdx); }
+
+    /*!
+     * \brief The densities of a phase in all cells [kg/m^3].
+     */
+    Scalar* densityArray(unsigned phaseIdx)
+    { return field_(densityOffset_ + phaseIdx); }
+    const Scalar* densityArray(unsigned phaseIdx) const
+    { return field_(densityOffset_ + phaseIdx); }
+
+    /*!
+     * \brief The dynamic viscosities of a phase in all cells [Pa s].
+     */
+    Scalar* viscosityArray(unsigned phaseIdx)
+    { return field_(viscosityOffset_ + phaseIdx); }
+    const Scalar* viscosityArray(unsigned phaseIdx) const
+    { return field_(viscosityOffset_ + phaseIdx); }
+
+    /*!
+     * \brief The specific enthalpies of a phase in all cells [J/kg].
+     */
+    Scalar* enthalpyArray(unsigned phaseIdx)
+    { return field_(enthalpyOffset_ + phaseIdx); }
+    const Scalar* enthalpyArray(unsigned phaseIdx) const
+    { return field_(enthalpyOffset_ + phaseIdx); }
+
+    /*!
+     * \brief The fugacity coefficients of a component in a phase in all cells [-].
+     */
+    Scalar* fugacityCoefficientArray(unsigned phaseIdx, unsigned compIdx)
+    { return field_(fugacityCoefficientOffset_ + phaseIdx*numComponents + compIdx); }
+    const Scalar* fugacityCoefficientArray(unsigned phaseIdx, unsigned compIdx) const
+    { return field_(fugacityCoefficientOffset_ + phaseIdx*numComponents + compIdx); }
+
+    /*!
+     * \brief Recompute the average molar masses of all phases in all cells from the
+     *        mole fractions.
+     *
+     * This is required if the mole fractions were modified using moleFractionArray().
+     */
+    void updateAverageMolarMasses()
+    {
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+            Scalar* sumX = sumMoleFractionsArray(phaseIdx);
+            Scalar* avgM = averageMolarMassArray(phaseIdx);
+            for (std::size_t cellIdx = 0; cellIdx < numCells_; ++cellIdx) {
+                sumX[cellIdx] = 0.0;
+                avgM[cellIdx] = 0.0;
+            }
+
+            for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx) {
+                const Scalar* x = moleFractionArray(phaseIdx, compIdx);
+                const Scalar M = FluidSystem::molarMass(compIdx);
+                for (std::size_t cellIdx = 0; cellIdx < numCells_; ++cellIdx) {
+                    sumX[cellIdx] += x[cellIdx];
+                    avgM[cellIdx] += x[cellIdx]*M;
+                }
+            }
+        }
+    }
+
+private:
+    // the position of the arrays of the individual quantities within the data_ array
+    // in units of the number of cells
+    static const unsigned temperatureOffset_ = 0;
+    static const unsigned pressureOffset_ = temperatureOffset_ + 1;
+    static const unsigned saturationOffset_ = pressureOffset_ + numPhases;
+    static const unsigned moleFractionOffset_ = saturationOffset_ + numPhases;
+    static const unsigned averageMolarMassOffset_ = moleFractionOffset_ + numPhases*numComponents;
+    static const unsigned sumMoleFractionsOffset_ = averageMolarMassOffset_ + numPhases;
+    static const unsigned densityOffset_ = sumMoleFractionsOffset_ + numPhases;
+    static const unsigned viscosityOffset_ = densityOffset_ + numPhases;
+    static const unsigned enthalpyOffset_ = viscosityOffset_ + numPhases;
+    static const unsigned fugacityCoefficientOffset_ = enthalpyOffset_ + numPhases;
+    static const unsigned numFields_ = fugacityCoefficientOffset_ + numPhases*numComponents;
+
+    Scalar* field_(unsigned fieldIdx)
+    { return data_.data() + fieldIdx*numCells_; }
+    const Scalar* field_(unsigned fieldIdx) const
+    { return data_.data() + fieldIdx*numCells_; }
+
+    std::size_t numCells_;
+    std::vector<Scalar> data_;
+};
+
+} // namespace Ewoms
+
+#endif
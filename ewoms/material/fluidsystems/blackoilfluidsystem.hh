@@ -30,6 +30,7 @@
 #include "blackoilpvt/brineco2pvt.hh"
 
 #include <ewoms/material/fluidsystems/basefluidsystem.hh>
+#include <ewoms/material/common/regionpermutation.hh>
 #include <ewoms/material/constants.hh>
 
 #include <ewoms/common/mathtoolbox.hh>
@@ -307,6 +308,43 @@ public:
     static void setWaterPvt(std::shared_ptr<WaterPvt> pvtObj)
     { waterPvt_ = pvtObj; }
 
+    /*!
+     * \brief Tabulate the properties of the saturated oil and gas phases on a (T,p) grid
+     *        if the thermal PVT relations are used.
+     *
+     * This must be called after the PVT relations of the phases have been specified,
+     * e.g., after initFromEclState().
+     */
+    static void setThermalPvtTabulationRange(Scalar temperatureMin, Scalar temperatureMax, unsigned numTemperatures,
+                                             Scalar pressureMin, Scalar pressureMax, unsigned numPressures)
+    {
+        if (gasPvt_)
+            gasPvt_->setThermalTabulationRange(temperatureMin, temperatureMax, numTemperatures,
+                                               pressureMin, pressureMax, numPressures);
+        if (oilPvt_)
+            oilPvt_->setThermalTabulationRange(temperatureMin, temperatureMax, numTemperatures,
+                                               pressureMin, pressureMax, numPressures);
+    }
+
+    /*!
+     * \brief Tabulate the properties of the brine and CO2 phases on a (T,p) grid if the
+     *        CO2 storage PVT relations are used.
+     *
+     * Like setThermalPvtTabulationRange(), this must be called after the PVT relations of
+     * the phases have been specified. Outside of the tabulated range, the analytic
+     * relations are used.
+     */
+    static void setCo2PvtTabulationRange(Scalar temperatureMin, Scalar temperatureMax, unsigned numTemperatures,
+                                         Scalar pressureMin, Scalar pressureMax, unsigned numPressures)
+    {
+        if (gasPvt_)
+            gasPvt_->setCo2TabulationRange(temperatureMin, temperatureMax, numTemperatures,
+                                           pressureMin, pressureMax, numPressures);
+        if (oilPvt_)
+            oilPvt_->setCo2TabulationRange(temperatureMin, temperatureMax, numTemperatures,
+                                           pressureMin, pressureMax, numPressures);
+    }
+
     /*!
      * \brief Initialize the values of the reference densities
      *
@@ -913,6 +951,54 @@ public:
         throw std::logic_error("Unhandled phase or component index");
     }
 
+    /*!
+     * \brief Compute the inverse formation volume factors of a phase for a set of cells.
+     *
+     * The cells are processed region by region as given by the permutation of the PVT
+     * region indices, so that the tables of a given region stay in the CPU caches. The
+     * containers for the results and the fluid states are indexed by the cell index.
+     */
+    template <class ResultContainer, class FluidStateContainer>
+    static void inverseFormationVolumeFactors(ResultContainer& result,
+                                              const FluidStateContainer& fluidStates,
+                                              unsigned phaseIdx,
+                                              const RegionPermutation& pvtRegions)
+    {
+        typedef typename FluidStateContainer::value_type FluidState;
+        typedef typename ResultContainer::value_type LhsEval;
+
+        assert(fluidStates.size() == pvtRegions.size());
+        for (unsigned regionIdx = 0; regionIdx < pvtRegions.numRegions(); ++regionIdx) {
+            auto it = pvtRegions.regionBegin(regionIdx);
+            const auto& endIt = pvtRegions.regionEnd(regionIdx);
+            for (; it != endIt; ++it)
+                result[*it] = inverseFormationVolumeFactor<FluidState, LhsEval>(fluidStates[*it], phaseIdx, regionIdx);
+        }
+    }
+
+    /*!
+     * \brief Compute the viscosities of a phase for a set of cells.
+     *
+     * \copydetails inverseFormationVolumeFactors()
+     */
+    template <class ResultContainer, class FluidStateContainer>
+    static void viscosities(ResultContainer& result,
+                            const FluidStateContainer& fluidStates,
+                            unsigned phaseIdx,
+                            const RegionPermutation& pvtRegions)
+    {
+        typedef typename FluidStateContainer::value_type FluidState;
+        typedef typename ResultContainer::value_type LhsEval;
+
+        assert(fluidStates.size() == pvtRegions.size());
+        for (unsigned regionIdx = 0; regionIdx < pvtRegions.numRegions(); ++regionIdx) {
+            auto it = pvtRegions.regionBegin(regionIdx);
+            const auto& endIt = pvtRegions.regionEnd(regionIdx);
+            for (; it != endIt; ++it)
+                result[*it] = viscosity<FluidState, LhsEval>(fluidStates[*it], phaseIdx, regionIdx);
+        }
+    }
+
     //! \copydoc BaseFluidSystem::viscosity
     template <class FluidState, class LhsEval = typename FluidState::Scalar>
     static LhsEval viscosity(const FluidState& fluidState,
@@ -42,12 +42,31 @@
 #endif
 
 #include <vector>
+#include <ostream>
+#include <algorithm>
+#include <stdexcept>
+#include <cmath>
 
 namespace Ewoms {
 
 /*!
  * \brief This class represents the Pressure-Volume-Temperature relations of the liquid phase
  * for a CO2-Brine system
+ *
+ * By default, all quantities are computed using the analytic correlations for brine,
+ * pure water and the solubility of CO2. These involve quite a few exp(), log() and pow()
+ * calls for each evaluation. Since the salinity is fixed, the expensive parts can
+ * optionally be tabulated on a uniform (T,p) grid during initialization (cf.
+ * setTabulationRange()): The saturated gas dissolution factor is tabulated for each PVT
+ * region, the viscosity of brine and the density of pure water are tabulated once
+ * because they only depend on the global salinity of the brine component. (The density
+ * of brine is determined from the one of pure water by a cheap polynomial.) Within the
+ * range of the tables, these quantities are then determined by bilinear interpolation;
+ * outside of it the analytic correlations are used. tabulationError() reports the
+ * accuracy of the tables.
+ *
+ * For fluid systems which were initialized from an ECL deck, the tables can be
+ * requested using BlackOilFluidSystem::setCo2PvtTabulationRange().
  */
 template <class Scalar, class CO2 = Ewoms::CO2<Scalar, Ewoms::CO2DefaultTables::CO2Tables> >
 class BrineCo2Pvt
@@ -62,6 +81,37 @@ public:
     //! The binary coefficients for brine and CO2 used by this fluid system
     typedef Ewoms::BinaryCoeff::Brine_CO2<Scalar, H2O, CO2> BinaryCoeffBrineCO2;
 
+    typedef Ewoms::UniformTabulated2DFunction<Scalar> TabulatedTwoDFunction;
+
+    /*!
+     * \brief The maximum relative errors of the tabulated quantities.
+     */
+    struct TabulationError
+    {
+        TabulationError()
+            : rsSat(0.0)
+            , brineDensity(0.0)
+            , waterDensity(0.0)
+            , brineViscosity(0.0)
+        {}
+
+        //! Print the errors in a human readable form
+        void print(std::ostream& os) const
+        {
+            os << "max. relative errors of the tabulated brine-CO2 PVT: "
+               << "rsSat: " << rsSat
+               << ", brine density: " << brineDensity
+               << ", water density: " << waterDensity
+               << ", brine viscosity: " << brineViscosity
+               << "\n";
+        }
+
+        Scalar rsSat;
+        Scalar brineDensity;
+        Scalar waterDensity;
+        Scalar brineViscosity;
+    };
+
     explicit BrineCo2Pvt() = default;
     BrineCo2Pvt(const std::vector<Scalar>& brineReferenceDensity,
                 const std::vector<Scalar>& co2ReferenceDensity,
@@ -97,7 +147,7 @@ public:
         const Scalar MmNaCl = 58e-3; // molar mass of NaCl [kg/mol]
         // convert to mass fraction
         Brine::salinity = 1 / ( 1 + 1 / (molality*MmNaCl)); //
-        salinity_[numRegions] = Brine::salinity;
+        salinity_[regionIdx] = Brine::salinity;
         // set the surface conditions using the STCOND keyword
         Scalar T_ref = eclState.getTableManager().stCond().temperature;
         Scalar P_ref = eclState.getTableManager().stCond().pressure;
@@ -126,12 +176,118 @@ public:
         co2ReferenceDensity_[regionIdx] = rhoRefCO2;
     }
 
+    /*!
+     * \brief Specify the (T,p) grid on which the PVT properties of each region are
+     *        tabulated.
+     *
+     * If this method is not called, the analytic correlations are always used. It must
+     * be called before initEnd().
+     */
+    void setTabulationRange(Scalar temperatureMin, Scalar temperatureMax, unsigned numTemperatures,
+                            Scalar pressureMin, Scalar pressureMax, unsigned numPressures)
+    {
+        if (numTemperatures < 2 || numPressures < 2)
+            throw std::invalid_argument("At least two sampling points are required in each direction");
+        if (temperatureMin >= temperatureMax || pressureMin >= pressureMax)
+            throw std::invalid_argument("The range of the tables must not be empty");
+        if (temperatureMin < 273.15 || pressureMax >= 2.5e8)
+            throw std::invalid_argument("The brine-CO2 PVT relations are only defined for "
+                                        "temperatures above 273.15K and pressures below 250MPa");
+
+        enableTabulation_ = true;
+        temperatureMin_ = temperatureMin;
+        temperatureMax_ = temperatureMax;
+        numTemperatures_ = numTemperatures;
+        pressureMin_ = pressureMin;
+        pressureMax_ = pressureMax;
+        numPressures_ = numPressures;
+    }
+
+    /*!
+     * \brief Returns true if the PVT properties are tabulated.
+     */
+    bool isTabulated() const
+    { return enableTabulation_; }
+
     /*!
      * \brief Finish initializing the oil phase PVT properties.
      */
     void initEnd()
     {
+        if (!enableTabulation_)
+            return;
+
+        waterDensityTable_.resize(temperatureMin_, temperatureMax_, numTemperatures_,
+                                  pressureMin_, pressureMax_, numPressures_);
+        brineViscosityTable_.resize(temperatureMin_, temperatureMax_, numTemperatures_,
+                                    pressureMin_, pressureMax_, numPressures_);
+        for (unsigned i = 0; i < numTemperatures_; ++i) {
+            Scalar T = waterDensityTable_.iToX(i);
+            for (unsigned j = 0; j < numPressures_; ++j) {
+                Scalar p = waterDensityTable_.jToY(j);
+
+                waterDensityTable_.setSamplePoint(i, j, H2O::liquidDensity(T, p));
+                brineViscosityTable_.setSamplePoint(i, j, Brine::liquidViscosity(T, p));
+            }
+        }
+
+        // the solubility of CO2 depends on the salinity of the region
+        unsigned numRegions = this->numRegions();
+        rsSatTable_.resize(numRegions);
+        typename BinaryCoeffBrineCO2::template SolubilityContext<Scalar> context;
+        for (unsigned regionIdx = 0; regionIdx < numRegions; ++regionIdx) {
+            auto& rsSatTable = rsSatTable_[regionIdx];
+            rsSatTable.resize(temperatureMin_, temperatureMax_, numTemperatures_,
+                              pressureMin_, pressureMax_, numPressures_);
+
+            for (unsigned i = 0; i < numTemperatures_; ++i) {
+                Scalar T = rsSatTable.iToX(i);
+                for (unsigned j = 0; j < numPressures_; ++j) {
+                    Scalar p = rsSatTable.jToY(j);
+                    rsSatTable.setSamplePoint(i, j, rsSatAnalytic_(context, regionIdx, T, p));
+                }
+            }
+        }
+    }
+
+    /*!
+     * \brief Compare the tabulated quantities of a PVT region with the analytic
+     *        correlations.
+     *
+     * The comparison is done at the centers of the cells of the (T,p) grid, i.e., at the
+     * points which are furthest away from the sampling points.
+     */
+    TabulationError tabulationError(unsigned regionIdx) const
+    {
+        if (!enableTabulation_)
+            throw std::logic_error("The PVT properties of brine are not tabulated");
+
+        TabulationError err;
+        typename BinaryCoeffBrineCO2::template SolubilityContext<Scalar> context;
+
+        const Scalar dT = (temperatureMax_ - temperatureMin_)/(numTemperatures_ - 1);
+        const Scalar dp = (pressureMax_ - pressureMin_)/(numPressures_ - 1);
+        for (unsigned i = 0; i < numTemperatures_ - 1; ++i) {
+            Scalar T = temperatureMin_ + (i + 0.5)*dT;
+            for (unsigned j = 0; j < numPressures_ - 1; ++j) {
+                Scalar p = pressureMin_ + (j + 0.5)*dp;
+
+                updateError_(err.rsSat,
+                             rsSatTable_[regionIdx].eval(T, p),
+                             rsSatAnalytic_(context, regionIdx, T, p));
+                updateError_(err.brineDensity,
+                             Brine::liquidDensityFromWater(T, p, waterDensityTable_.eval(T, p)),
+                             Brine::liquidDensity(T, p));
+                updateError_(err.waterDensity,
+                             waterDensityTable_.eval(T, p),
+                             H2O::liquidDensity(T, p));
+                updateError_(err.brineViscosity,
+                             brineViscosityTable_.eval(T, p),
+                             Brine::liquidViscosity(T, p));
+            }
+        }
 
+        return err;
     }
 
     /*!
@@ -173,6 +329,9 @@ public:
                                   const Evaluation& temperature,
                                   const Evaluation& pressure) const
     {
+        if (enableTabulation_ && brineViscosityTable_.applies(temperature, pressure))
+            return brineViscosityTable_.eval(temperature, pressure);
+
         return Brine::liquidViscosity(temperature, pressure);
     }
 
@@ -200,6 +359,23 @@ public:
         return density_(regionIdx, temperature, pressure, rsSat)/brineReferenceDensity_[regionIdx];
     }
 
+    /*!
+     * \brief Returns the formation volume factor [-] of brine saturated with CO2 at a
+     *        given pressure using a solubility context which is owned by the caller.
+     *
+     * If the same context is passed to saturatedGasDissolutionFactor() for the same
+     * conditions, the mutual solubilities of brine and CO2 are only computed once.
+     */
+    template <class Evaluation>
+    Evaluation saturatedInverseFormationVolumeFactor(typename BinaryCoeffBrineCO2::template SolubilityContext<Evaluation>& context,
+                                                     unsigned regionIdx,
+                                                     const Evaluation& temperature,
+                                                     const Evaluation& pressure) const
+    {
+        Evaluation rsSat = rsSat_(context, regionIdx, temperature, pressure);
+        return density_(regionIdx, temperature, pressure, rsSat)/brineReferenceDensity_[regionIdx];
+    }
+
     /*!
      * \brief Returns the saturation pressure of the brine phase [Pa]
      *        depending on its mass fraction of the gas component
@@ -239,6 +415,19 @@ public:
         return rsSat_(regionIdx, temperature, pressure);
     }
 
+    /*!
+     * \brief Returns the gas dissoluiton factor \f$R_s\f$ [m^3/m^3] of the liquid phase
+     *        using a solubility context which is owned by the caller.
+     */
+    template <class Evaluation>
+    Evaluation saturatedGasDissolutionFactor(typename BinaryCoeffBrineCO2::template SolubilityContext<Evaluation>& context,
+                                             unsigned regionIdx,
+                                             const Evaluation& temperature,
+                                             const Evaluation& pressure) const
+    {
+        return rsSat_(context, regionIdx, temperature, pressure);
+    }
+
     const Scalar oilReferenceDensity(unsigned regionIdx) const
     { return brineReferenceDensity_[regionIdx]; }
 
@@ -250,8 +439,19 @@ public:
 
     bool operator==(const BrineCo2Pvt& data) const
     {
-        return co2ReferenceDensity_ == data.co2ReferenceDensity_ &&
-                brineReferenceDensity_ == data.brineReferenceDensity_;
+        if (co2ReferenceDensity_ != data.co2ReferenceDensity_ ||
+            brineReferenceDensity_ != data.brineReferenceDensity_ ||
+            enableTabulation_ != data.enableTabulation_)
+            return false;
+
+        // the tables are determined by the (T,p) grid and the analytic relations
+        return !enableTabulation_ ||
+            (temperatureMin_ == data.temperatureMin_ &&
+             temperatureMax_ == data.temperatureMax_ &&
+             numTemperatures_ == data.numTemperatures_ &&
+             pressureMin_ == data.pressureMin_ &&
+             pressureMax_ == data.pressureMax_ &&
+             numPressures_ == data.numPressures_);
     }
 
 private:
@@ -259,6 +459,32 @@ private:
     std::vector<Scalar> co2ReferenceDensity_;
     std::vector<Scalar> salinity_;
 
+    bool enableTabulation_ = false;
+    Scalar temperatureMin_ = 0.0;
+    Scalar temperatureMax_ = 0.0;
+    unsigned numTemperatures_ = 0;
+    Scalar pressureMin_ = 0.0;
+    Scalar pressureMax_ = 0.0;
+    unsigned numPressures_ = 0;
+    std::vector<TabulatedTwoDFunction> rsSatTable_;
+    TabulatedTwoDFunction waterDensityTable_;
+    TabulatedTwoDFunction brineViscosityTable_;
+
+    static void updateError_(Scalar& maxError, Scalar tabulatedValue, Scalar exactValue)
+    {
+        Scalar err = std::abs(tabulatedValue - exactValue)/std::max<Scalar>(std::abs(exactValue), 1e-30);
+        maxError = std::max(maxError, err);
+    }
+
+    template <class LhsEval>
+    LhsEval waterDensity_(const LhsEval& T, const LhsEval& pl) const
+    {
+        if (enableTabulation_ && waterDensityTable_.applies(T, pl))
+            return waterDensityTable_.eval(T, pl);
+
+        return H2O::liquidDensity(T, pl);
+    }
+
     template <class LhsEval>
     LhsEval density_(unsigned regionIdx,
                      const LhsEval& temperature,
@@ -296,9 +522,11 @@ private:
             throw NumericalIssue(oss.str());
         }
 
-        const LhsEval& rho_brine = Brine::liquidDensity(T, pl);
-        const LhsEval& rho_pure = H2O::liquidDensity(T, pl);
-        const LhsEval& rho_lCO2 = liquidDensityWaterCO2_(T, pl, xlCO2);
+        // the density of pure water is required by the density of brine as well as by
+        // the partial molar volume term of dissolved CO2, so it is evaluated only once
+        const LhsEval& rho_pure = waterDensity_(T, pl);
+        const LhsEval& rho_brine = Brine::liquidDensityFromWater(T, pl, rho_pure);
+        const LhsEval& rho_lCO2 = liquidDensityWaterCO2_(T, rho_pure, xlCO2);
         const LhsEval& contribCO2 = rho_lCO2 - rho_pure;
 
         return rho_brine + contribCO2;
@@ -306,14 +534,13 @@ private:
 
     template <class LhsEval>
     LhsEval liquidDensityWaterCO2_(const LhsEval& temperature,
-                                          const LhsEval& pl,
-                                          const LhsEval& xlCO2) const
+                                   const LhsEval& rho_pure,
+                                   const LhsEval& xlCO2) const
     {
         Scalar M_CO2 = CO2::molarMass();
         Scalar M_H2O = H2O::molarMass();
 
         const LhsEval& tempC = temperature - 273.15;        /* tempC : temperature in °C */
-        const LhsEval& rho_pure = H2O::liquidDensity(temperature, pl);
         // calculate the mole fraction of CO2 in the liquid. note that xlH2O is available
         // as a function parameter, but in the case of a pure gas phase the value of M_T
         // for the virtual liquid phase can become very large
@@ -382,19 +609,34 @@ private:
                    const LhsEval& temperature,
                    const LhsEval& pressure) const
     {
-        // calulate the equilibrium composition for the given
-        // temperature and pressure.
-        LhsEval xgH2O;
-        LhsEval xlCO2;
-        BinaryCoeffBrineCO2::calculateMoleFractions(temperature,
-                                                    pressure,
-                                                    salinity_[regionIdx],
-                                                    /*knownPhaseIdx=*/-1,
-                                                    xlCO2,
-                                                    xgH2O);
+        typename BinaryCoeffBrineCO2::template SolubilityContext<LhsEval> context;
+        return rsSat_(context, regionIdx, temperature, pressure);
+    }
+
+    template <class LhsEval>
+    LhsEval rsSat_(typename BinaryCoeffBrineCO2::template SolubilityContext<LhsEval>& context,
+                   unsigned regionIdx,
+                   const LhsEval& temperature,
+                   const LhsEval& pressure) const
+    {
+        if (enableTabulation_ && rsSatTable_[regionIdx].applies(temperature, pressure))
+            return rsSatTable_[regionIdx].eval(temperature, pressure);
+
+        return rsSatAnalytic_(context, regionIdx, temperature, pressure);
+    }
+
+    template <class LhsEval>
+    LhsEval rsSatAnalytic_(typename BinaryCoeffBrineCO2::template SolubilityContext<LhsEval>& context,
+                           unsigned regionIdx,
+                           const LhsEval& temperature,
+                           const LhsEval& pressure) const
+    {
+        // calulate the equilibrium composition for the given temperature and
+        // pressure. this does nothing if the context is already up to date.
+        context.update(temperature, pressure, salinity_[regionIdx]);
 
         // normalize the phase compositions
-        xlCO2 = Ewoms::max(0.0, Ewoms::min(1.0, xlCO2));
+        const LhsEval& xlCO2 = Ewoms::max(0.0, Ewoms::min(1.0, context.xlCO2()));
 
         return convertXoGToRs(convertxoGToXoG(xlCO2), regionIdx);
     }
@@ -36,6 +36,10 @@
 #endif
 
 #include <vector>
+#include <ostream>
+#include <algorithm>
+#include <stdexcept>
+#include <cmath>
 
 namespace Ewoms {
 
@@ -53,6 +57,17 @@ namespace CO2DefaultTables {
 /*!
  * \brief This class represents the Pressure-Volume-Temperature relations of the gas phase
  * for CO2
+ *
+ * The viscosity of CO2 can optionally be tabulated on a uniform (T,p) grid during
+ * initialization (cf. setTabulationRange()). Since it does not depend on any region
+ * specific parameters, a single table is used for all PVT regions. The density of CO2
+ * is not tabulated by this class because the CO2 component already determines it by
+ * interpolating in a table; re-sampling this table would only add an additional
+ * interpolation error. Note that the viscosity varies rapidly close to the critical
+ * point of CO2, so the resolution of the table must be chosen accordingly.
+ *
+ * For fluid systems which were initialized from an ECL deck, the table can be
+ * requested using BlackOilFluidSystem::setCo2PvtTabulationRange().
  */
 template <class Scalar, class CO2 = Ewoms::CO2<Scalar, Ewoms::CO2DefaultTables::CO2Tables> >
 class Co2GasPvt
@@ -61,6 +76,27 @@ class Co2GasPvt
 
 public:
     typedef Ewoms::Tabulated1DFunction<Scalar> TabulatedOneDFunction;
+    typedef Ewoms::UniformTabulated2DFunction<Scalar> TabulatedTwoDFunction;
+
+    /*!
+     * \brief The maximum relative errors of the tabulated quantities.
+     */
+    struct TabulationError
+    {
+        TabulationError()
+            : viscosity(0.0)
+        {}
+
+        //! Print the errors in a human readable form
+        void print(std::ostream& os) const
+        {
+            os << "max. relative errors of the tabulated CO2 PVT: "
+               << "viscosity: " << viscosity
+               << "\n";
+        }
+
+        Scalar viscosity;
+    };
 
     explicit Co2GasPvt() = default;
     Co2GasPvt(const std::vector<Scalar>& gasReferenceDensity)
@@ -111,11 +147,74 @@ public:
     }
 
     /*!
-     * \brief Finish initializing the oil phase PVT properties.
+     * \brief Specify the (T,p) grid on which the viscosity of CO2 is tabulated.
+     *
+     * If this method is not called, the analytic relations are always used. It must be
+     * called before initEnd().
+     */
+    void setTabulationRange(Scalar temperatureMin, Scalar temperatureMax, unsigned numTemperatures,
+                            Scalar pressureMin, Scalar pressureMax, unsigned numPressures)
+    {
+        if (numTemperatures < 2 || numPressures < 2)
+            throw std::invalid_argument("At least two sampling points are required in each direction");
+        if (temperatureMin >= temperatureMax || pressureMin >= pressureMax)
+            throw std::invalid_argument("The range of the tables must not be empty");
+
+        enableTabulation_ = true;
+        viscosityTable_.resize(temperatureMin, temperatureMax, numTemperatures,
+                               pressureMin, pressureMax, numPressures);
+    }
+
+    /*!
+     * \brief Returns true if the PVT properties are tabulated.
+     */
+    bool isTabulated() const
+    { return enableTabulation_; }
+
+    /*!
+     * \brief Finish initializing the gas phase PVT properties.
      */
     void initEnd()
     {
+        if (!enableTabulation_)
+            return;
 
+        for (unsigned i = 0; i < viscosityTable_.numX(); ++i) {
+            Scalar T = viscosityTable_.iToX(i);
+            for (unsigned j = 0; j < viscosityTable_.numY(); ++j) {
+                Scalar p = viscosityTable_.jToY(j);
+
+                viscosityTable_.setSamplePoint(i, j, CO2::gasViscosity(T, p));
+            }
+        }
+    }
+
+    /*!
+     * \brief Compare the tabulated viscosity with the analytic relation.
+     *
+     * The comparison is done at the centers of the cells of the (T,p) grid, i.e., at the
+     * points which are furthest away from the sampling points.
+     */
+    TabulationError tabulationError() const
+    {
+        if (!enableTabulation_)
+            throw std::logic_error("The PVT properties of CO2 are not tabulated");
+
+        TabulationError err;
+        const unsigned m = viscosityTable_.numX();
+        const unsigned n = viscosityTable_.numY();
+        const Scalar dT = (viscosityTable_.xMax() - viscosityTable_.xMin())/(m - 1);
+        const Scalar dp = (viscosityTable_.yMax() - viscosityTable_.yMin())/(n - 1);
+        for (unsigned i = 0; i < m - 1; ++i) {
+            Scalar T = viscosityTable_.xMin() + (i + 0.5)*dT;
+            for (unsigned j = 0; j < n - 1; ++j) {
+                Scalar p = viscosityTable_.yMin() + (j + 0.5)*dp;
+
+                updateError_(err.viscosity, viscosityTable_.eval(T, p), CO2::gasViscosity(T, p));
+            }
+        }
+
+        return err;
     }
 
     /*!
@@ -154,6 +253,9 @@ public:
                                   const Evaluation& temperature,
                                   const Evaluation& pressure) const
     {
+        if (enableTabulation_ && viscosityTable_.applies(temperature, pressure))
+            return viscosityTable_.eval(temperature, pressure);
+
         return CO2::gasViscosity(temperature, pressure);
     }
 
@@ -215,11 +317,31 @@ public:
 
     bool operator==(const Co2GasPvt<Scalar>& data) const
     {
-        return gasReferenceDensity_ == data.gasReferenceDensity_;
+        if (gasReferenceDensity_ != data.gasReferenceDensity_ ||
+            enableTabulation_ != data.enableTabulation_)
+            return false;
+
+        // the table is determined by the (T,p) grid and the analytic relation
+        return !enableTabulation_ ||
+            (viscosityTable_.xMin() == data.viscosityTable_.xMin() &&
+             viscosityTable_.xMax() == data.viscosityTable_.xMax() &&
+             viscosityTable_.numX() == data.viscosityTable_.numX() &&
+             viscosityTable_.yMin() == data.viscosityTable_.yMin() &&
+             viscosityTable_.yMax() == data.viscosityTable_.yMax() &&
+             viscosityTable_.numY() == data.viscosityTable_.numY());
     }
 
 private:
+    static void updateError_(Scalar& maxError, Scalar tabulatedValue, Scalar exactValue)
+    {
+        Scalar err = std::abs(tabulatedValue - exactValue)/std::max<Scalar>(std::abs(exactValue), 1e-30);
+        maxError = std::max(maxError, err);
+    }
+
     std::vector<Scalar> gasReferenceDensity_;
+
+    bool enableTabulation_ = false;
+    TabulatedTwoDFunction viscosityTable_;
 };
 
 } // namespace Ewoms
@@ -175,6 +175,44 @@ public:
     void initEnd()
     { EWOMS_GAS_PVT_MULTIPLEXER_CALL(pvtImpl.initEnd()); }
 
+    /*!
+     * \brief Tabulate the properties of the saturated gas phase on a (T,p) grid if the
+     *        thermal PVT relations are used.
+     *
+     * The tables are created immediately, i.e., this can be called after the object has
+     * been initialized. For the isothermal PVT relations, this method does nothing.
+     */
+    void setThermalTabulationRange(Scalar temperatureMin, Scalar temperatureMax, unsigned numTemperatures,
+                                   Scalar pressureMin, Scalar pressureMax, unsigned numPressures)
+    {
+        if (gasPvtApproach_ != ThermalGasPvt)
+            return;
+
+        auto& pvtImpl = getRealPvt<ThermalGasPvt>();
+        pvtImpl.setTabulationRange(temperatureMin, temperatureMax, numTemperatures,
+                                   pressureMin, pressureMax, numPressures);
+        pvtImpl.initEnd();
+    }
+
+    /*!
+     * \brief Tabulate the viscosity of the gas phase on a (T,p) grid if the CO2 PVT
+     *        relations are used.
+     *
+     * The table is created immediately, i.e., this can be called after the object has
+     * been initialized. For all other PVT relations, this method does nothing.
+     */
+    void setCo2TabulationRange(Scalar temperatureMin, Scalar temperatureMax, unsigned numTemperatures,
+                               Scalar pressureMin, Scalar pressureMax, unsigned numPressures)
+    {
+        if (gasPvtApproach_ != Co2GasPvt)
+            return;
+
+        auto& pvtImpl = getRealPvt<Co2GasPvt>();
+        pvtImpl.setTabulationRange(temperatureMin, temperatureMax, numTemperatures,
+                                   pressureMin, pressureMax, numPressures);
+        pvtImpl.initEnd();
+    }
+
     /*!
      * \brief Return the number of PVT regions which are considered by this PVT-object.
      */
@@ -27,6 +27,7 @@
 
 #include <ewoms/common/final.hh>
 #include <ewoms/common/uniformxtabulated2dfunction.hh>
+#include <ewoms/common/uniformtabulated2dfunction.hh>
 #include <ewoms/common/tabulated1dfunction.hh>
 #include <ewoms/common/spline.hh>
 
@@ -37,6 +38,12 @@
 #include <ewoms/eclio/parser/eclipsestate/tables/tablemanager.hh>
 #endif
 
+#include <vector>
+#include <ostream>
+#include <algorithm>
+#include <stdexcept>
+#include <cmath>
+
 namespace Ewoms {
 template <class Scalar, bool enableThermal>
 class GasPvtMultiplexer;
@@ -46,6 +53,16 @@ class GasPvtMultiplexer;
  *
  * Note that this _only_ implements the temperature part, i.e., it requires the
  * isothermal properties as input.
+ *
+ * Evaluating the properties of the saturated gas phase thus involves a lookup of the
+ * isothermal quantity and of the temperature corrections. If a tabulation range is
+ * specified via setTabulationRange(), the saturated viscosity and formation volume
+ * factor of each PVT region, including the temperature corrections, are tabulated on a
+ * uniform (T,p) grid by initEnd(). Within the range of the tables, these quantities are
+ * then determined by a single bilinear interpolation.
+ *
+ * For fluid systems which were initialized from an ECL deck, the tables can be
+ * requested using BlackOilFluidSystem::setThermalPvtTabulationRange().
  */
 template <class Scalar>
 class GasPvtThermal
@@ -53,6 +70,30 @@ class GasPvtThermal
 public:
     typedef GasPvtMultiplexer<Scalar, /*enableThermal=*/false> IsothermalPvt;
     typedef Ewoms::Tabulated1DFunction<Scalar> TabulatedOneDFunction;
+    typedef Ewoms::UniformTabulated2DFunction<Scalar> TabulatedTwoDFunction;
+
+    /*!
+     * \brief The maximum relative errors of the tabulated quantities.
+     */
+    struct TabulationError
+    {
+        TabulationError()
+            : viscosity(0.0)
+            , inverseFormationVolumeFactor(0.0)
+        {}
+
+        //! Print the errors in a human readable form
+        void print(std::ostream& os) const
+        {
+            os << "max. relative errors of the tabulated thermal gas PVT: "
+               << "viscosity: " << viscosity
+               << ", inverse formation volume factor: " << inverseFormationVolumeFactor
+               << "\n";
+        }
+
+        Scalar viscosity;
+        Scalar inverseFormationVolumeFactor;
+    };
 
     GasPvtThermal()
     {
@@ -177,6 +218,8 @@ public:
                 internalEnergyCurves_[regionIdx].setXYContainers(temperatureColumn.vectorCopy(), uSamples);
             }
         }
+
+        initEnd();
     }
 #endif // HAVE_ECL_INPUT
 
@@ -192,11 +235,105 @@ public:
         gasdentCT2_.resize(numRegions);
     }
 
+    /*!
+     * \brief Specify the (T,p) grid on which the properties of the saturated gas phase
+     *        are tabulated.
+     *
+     * The tables are created by initEnd(), i.e., this must be called before it. Outside
+     * of the range of the tables, the properties are computed from the isothermal PVT
+     * relations and the temperature corrections.
+     */
+    void setTabulationRange(Scalar temperatureMin, Scalar temperatureMax, unsigned numTemperatures,
+                            Scalar pressureMin, Scalar pressureMax, unsigned numPressures)
+    {
+        if (numTemperatures < 2 || numPressures < 2)
+            throw std::invalid_argument("At least two sampling points are required in each direction");
+        if (temperatureMin >= temperatureMax || pressureMin >= pressureMax)
+            throw std::invalid_argument("The range of the tables must not be empty");
+
+        enableTabulation_ = true;
+        temperatureMin_ = temperatureMin;
+        temperatureMax_ = temperatureMax;
+        numTemperatures_ = numTemperatures;
+        pressureMin_ = pressureMin;
+        pressureMax_ = pressureMax;
+        numPressures_ = numPressures;
+    }
+
+    /*!
+     * \brief Returns true if the properties of the saturated gas phase are tabulated.
+     */
+    bool isTabulated() const
+    { return enableTabulation_; }
+
+    /*!
+     * \brief Compare the tables of a PVT region with the analytic relations.
+     *
+     * The comparison is done at the centers of the cells of the (T,p) grid, i.e., at the
+     * points which are furthest away from the sampling points.
+     */
+    TabulationError tabulationError(unsigned regionIdx) const
+    {
+        if (regionIdx >= saturatedViscosityTable_.size())
+            throw std::logic_error("The thermal gas PVT properties are not tabulated");
+
+        const auto& muTable = saturatedViscosityTable_[regionIdx];
+        const auto& bTable = saturatedInverseFormationVolumeFactorTable_[regionIdx];
+
+        TabulationError err;
+        const unsigned m = muTable.numX();
+        const unsigned n = muTable.numY();
+        const Scalar dT = (muTable.xMax() - muTable.xMin())/(m - 1);
+        const Scalar dp = (muTable.yMax() - muTable.yMin())/(n - 1);
+        for (unsigned i = 0; i < m - 1; ++i) {
+            Scalar T = muTable.xMin() + (i + 0.5)*dT;
+            for (unsigned j = 0; j < n - 1; ++j) {
+                Scalar p = muTable.yMin() + (j + 0.5)*dp;
+
+                updateError_(err.viscosity,
+                             muTable.eval(T, p),
+                             saturatedViscosityAnalytic_(regionIdx, T, p));
+                updateError_(err.inverseFormationVolumeFactor,
+                             bTable.eval(T, p),
+                             saturatedInverseFormationVolumeFactorAnalytic_(regionIdx, T, p));
+            }
+        }
+
+        return err;
+    }
+
     /*!
      * \brief Finish initializing the thermal part of the gas phase PVT properties.
      */
     void initEnd()
-    { }
+    {
+        saturatedViscosityTable_.clear();
+        saturatedInverseFormationVolumeFactorTable_.clear();
+        if (!enableTabulation_)
+            return;
+
+        unsigned numRegions = this->numRegions();
+        saturatedViscosityTable_.resize(numRegions);
+        saturatedInverseFormationVolumeFactorTable_.resize(numRegions);
+        for (unsigned regionIdx = 0; regionIdx < numRegions; ++regionIdx) {
+            auto& muTable = saturatedViscosityTable_[regionIdx];
+            auto& bTable = saturatedInverseFormationVolumeFactorTable_[regionIdx];
+            muTable.resize(temperatureMin_, temperatureMax_, numTemperatures_,
+                           pressureMin_, pressureMax_, numPressures_);
+            bTable.resize(temperatureMin_, temperatureMax_, numTemperatures_,
+                          pressureMin_, pressureMax_, numPressures_);
+
+            for (unsigned i = 0; i < numTemperatures_; ++i) {
+                Scalar T = muTable.iToX(i);
+                for (unsigned j = 0; j < numPressures_; ++j) {
+                    Scalar p = muTable.jToY(j);
+
+                    muTable.setSamplePoint(i, j, saturatedViscosityAnalytic_(regionIdx, T, p));
+                    bTable.setSamplePoint(i, j, saturatedInverseFormationVolumeFactorAnalytic_(regionIdx, T, p));
+                }
+            }
+        }
+    }
 
     size_t numRegions() const
     { return gasvisctCurves_.size(); }
@@ -256,12 +393,10 @@ public:
                                   const Evaluation& temperature,
                                   const Evaluation& pressure) const
     {
-        if (!enableThermalViscosity())
-            return isothermalPvt_->saturatedViscosity(regionIdx, temperature, pressure);
+        if (tableApplies_(regionIdx, temperature, pressure))
+            return saturatedViscosityTable_[regionIdx].eval(temperature, pressure);
 
-        // compute the viscosity deviation due to temperature
-        const auto& muGasvisct = gasvisctCurves_[regionIdx].eval(temperature, true);
-        return muGasvisct;
+        return saturatedViscosityAnalytic_(regionIdx, temperature, pressure);
     }
 
     /*!
@@ -302,25 +437,10 @@ public:
                                                      const Evaluation& temperature,
                                                      const Evaluation& pressure) const
     {
-        const auto& b =
-            isothermalPvt_->saturatedInverseFormationVolumeFactor(regionIdx, temperature, pressure);
-
-        if (!enableThermalDensity())
-            return b;
-
-        // we use the same approach as for the for water here, but with the eWoms-specific
-        // GASDENT keyword.
-        //
-        // TODO: Since gas is quite a bit more compressible than water, it might be
-        //       necessary to make GASDENT to a table keyword. If the current temperature
-        //       is relatively close to the reference temperature, the current approach
-        //       should be good enough, though.
-        Scalar TRef = gasdentRefTemp_[regionIdx];
-        Scalar cT1 = gasdentCT1_[regionIdx];
-        Scalar cT2 = gasdentCT2_[regionIdx];
-        const Evaluation& Y = temperature - TRef;
+        if (tableApplies_(regionIdx, temperature, pressure))
+            return saturatedInverseFormationVolumeFactorTable_[regionIdx].eval(temperature, pressure);
 
-        return b/(1 + (cT1 + cT2*Y)*Y);
+        return saturatedInverseFormationVolumeFactorAnalytic_(regionIdx, temperature, pressure);
     }
 
     /*!
@@ -404,7 +524,14 @@ public:
                 this->internalEnergyCurves() == data.internalEnergyCurves() &&
                 this->enableThermalDensity() == data.enableThermalDensity() &&
                 this->enableThermalViscosity() == data.enableThermalViscosity() &&
-                this->enableInternalEnergy() == data.enableInternalEnergy();
+                this->enableInternalEnergy() == data.enableInternalEnergy() &&
+                this->enableTabulation_ == data.enableTabulation_ &&
+                this->temperatureMin_ == data.temperatureMin_ &&
+                this->temperatureMax_ == data.temperatureMax_ &&
+                this->numTemperatures_ == data.numTemperatures_ &&
+                this->pressureMin_ == data.pressureMin_ &&
+                this->pressureMax_ == data.pressureMax_ &&
+                this->numPressures_ == data.numPressures_;
     }
 
     GasPvtThermal<Scalar>& operator=(const GasPvtThermal<Scalar>& data)
@@ -421,6 +548,15 @@ public:
         enableThermalDensity_ = data.enableThermalDensity_;
         enableThermalViscosity_ = data.enableThermalViscosity_;
         enableInternalEnergy_ = data.enableInternalEnergy_;
+        enableTabulation_ = data.enableTabulation_;
+        temperatureMin_ = data.temperatureMin_;
+        temperatureMax_ = data.temperatureMax_;
+        numTemperatures_ = data.numTemperatures_;
+        pressureMin_ = data.pressureMin_;
+        pressureMax_ = data.pressureMax_;
+        numPressures_ = data.numPressures_;
+        saturatedViscosityTable_ = data.saturatedViscosityTable_;
+        saturatedInverseFormationVolumeFactorTable_ = data.saturatedInverseFormationVolumeFactorTable_;
 
         return *this;
     }
@@ -442,6 +578,72 @@ private:
     bool enableThermalDensity_;
     bool enableThermalViscosity_;
     bool enableInternalEnergy_;
+
+    // the optional tables of the properties of the saturated phase
+    bool enableTabulation_ = false;
+    Scalar temperatureMin_ = 0.0;
+    Scalar temperatureMax_ = 0.0;
+    unsigned numTemperatures_ = 0;
+    Scalar pressureMin_ = 0.0;
+    Scalar pressureMax_ = 0.0;
+    unsigned numPressures_ = 0;
+    std::vector<TabulatedTwoDFunction> saturatedViscosityTable_;
+    std::vector<TabulatedTwoDFunction> saturatedInverseFormationVolumeFactorTable_;
+
+    template <class Evaluation>
+    bool tableApplies_(unsigned regionIdx,
+                       const Evaluation& temperature,
+                       const Evaluation& pressure) const
+    {
+        return
+            regionIdx < saturatedViscosityTable_.size()
+            && saturatedViscosityTable_[regionIdx].applies(temperature, pressure);
+    }
+
+    static void updateError_(Scalar& maxError, Scalar tabulatedValue, Scalar exactValue)
+    {
+        Scalar err = std::abs(tabulatedValue - exactValue)/std::max<Scalar>(std::abs(exactValue), 1e-30);
+        maxError = std::max(maxError, err);
+    }
+
+    template <class Evaluation>
+    Evaluation saturatedViscosityAnalytic_(unsigned regionIdx,
+                                           const Evaluation& temperature,
+                                           const Evaluation& pressure) const
+    {
+        if (!enableThermalViscosity())
+            return isothermalPvt_->saturatedViscosity(regionIdx, temperature, pressure);
+
+        // compute the viscosity deviation due to temperature
+        const auto& muGasvisct = gasvisctCurves_[regionIdx].eval(temperature, true);
+        return muGasvisct;
+    }
+
+    template <class Evaluation>
+    Evaluation saturatedInverseFormationVolumeFactorAnalytic_(unsigned regionIdx,
+                                                              const Evaluation& temperature,
+                                                              const Evaluation& pressure) const
+    {
+        const auto& b =
+            isothermalPvt_->saturatedInverseFormationVolumeFactor(regionIdx, temperature, pressure);
+
+        if (!enableThermalDensity())
+            return b;
+
+        // we use the same approach as for the for water here, but with the eWoms-specific
+        // GASDENT keyword.
+        //
+        // TODO: Since gas is quite a bit more compressible than water, it might be
+        //       necessary to make GASDENT to a table keyword. If the current temperature
+        //       is relatively close to the reference temperature, the current approach
+        //       should be good enough, though.
+        Scalar TRef = gasdentRefTemp_[regionIdx];
+        Scalar cT1 = gasdentCT1_[regionIdx];
+        Scalar cT2 = gasdentCT2_[regionIdx];
+        const Evaluation& Y = temperature - TRef;
+
+        return b/(1 + (cT1 + cT2*Y)*Y);
+    }
 };
 
 } // namespace Ewoms
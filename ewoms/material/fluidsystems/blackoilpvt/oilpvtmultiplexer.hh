@@ -168,6 +168,44 @@ public:
     void initEnd()
     { EWOMS_OIL_PVT_MULTIPLEXER_CALL(pvtImpl.initEnd()); }
 
+    /*!
+     * \brief Tabulate the properties of the saturated oil phase on a (T,p) grid if the
+     *        thermal PVT relations are used.
+     *
+     * The tables are created immediately, i.e., this can be called after the object has
+     * been initialized. For the isothermal PVT relations, this method does nothing.
+     */
+    void setThermalTabulationRange(Scalar temperatureMin, Scalar temperatureMax, unsigned numTemperatures,
+                                   Scalar pressureMin, Scalar pressureMax, unsigned numPressures)
+    {
+        if (approach_ != ThermalOilPvt)
+            return;
+
+        auto& pvtImpl = getRealPvt<ThermalOilPvt>();
+        pvtImpl.setTabulationRange(temperatureMin, temperatureMax, numTemperatures,
+                                   pressureMin, pressureMax, numPressures);
+        pvtImpl.initEnd();
+    }
+
+    /*!
+     * \brief Tabulate the properties of the CO2 saturated brine phase on a (T,p) grid if
+     *        the brine-CO2 PVT relations are used.
+     *
+     * The tables are created immediately, i.e., this can be called after the object has
+     * been initialized. For all other PVT relations, this method does nothing.
+     */
+    void setCo2TabulationRange(Scalar temperatureMin, Scalar temperatureMax, unsigned numTemperatures,
+                               Scalar pressureMin, Scalar pressureMax, unsigned numPressures)
+    {
+        if (approach_ != BrineCo2Pvt)
+            return;
+
+        auto& pvtImpl = getRealPvt<BrineCo2Pvt>();
+        pvtImpl.setTabulationRange(temperatureMin, temperatureMax, numTemperatures,
+                                   pressureMin, pressureMax, numPressures);
+        pvtImpl.initEnd();
+    }
+
     /*!
      * \brief Return the number of PVT regions which are considered by this PVT-object.
      */
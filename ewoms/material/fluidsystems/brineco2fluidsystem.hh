@@ -25,7 +25,7 @@
 #define EWOMS_BRINE_CO2_SYSTEM_HH
 
 #include "basefluidsystem.hh"
-#include "nullparametercache.hh"
+#include "parametercachebase.hh"
 
 #include <ewoms/material/idealgas.hh>
 
@@ -42,6 +42,7 @@
 #include <ewoms/common/unused.hh>
 
 #include <iostream>
+#include <type_traits>
 
 namespace Ewoms {
 
@@ -51,10 +52,19 @@ namespace Ewoms {
  * This fluid system uses the a tabulated CO2 component to achieve
  * high thermodynamic accuracy and thus requires the tables of the
  * sampling to be supplied as template argument.
+ *
+ * The density and enthalpy of the CO2 component are interpolated from these tables,
+ * while its remaining properties are evaluated analytically. If all properties of CO2
+ * should be tabulated, e.g.,
+ * <tt>Ewoms::TabulatedComponent<Scalar, Ewoms::CO2<Scalar, CO2Tables>, false></tt>
+ * can be passed as the third template argument. Its tables are then created by
+ * init().
  */
-template <class Scalar, class CO2Tables>
+template <class Scalar,
+          class CO2Tables,
+          class CO2Type = Ewoms::CO2<Scalar, CO2Tables> >
 class BrineCO2FluidSystem
-    : public BaseFluidSystem<Scalar, BrineCO2FluidSystem<Scalar, CO2Tables> >
+    : public BaseFluidSystem<Scalar, BrineCO2FluidSystem<Scalar, CO2Tables, CO2Type> >
 {
     typedef Ewoms::H2O<Scalar> H2O_IAPWS;
     typedef Ewoms::Brine<Scalar, H2O_IAPWS> Brine_IAPWS;
@@ -64,18 +74,57 @@ class BrineCO2FluidSystem
     typedef H2O_Tabulated H2O;
 
 public:
-    template <class Evaluation>
-    struct ParameterCache : public Ewoms::NullParameterCache<Evaluation>
-    {};
-
     //! The type of the component for brine used by the fluid system
     typedef Brine_Tabulated Brine;
     //! The type of the component for pure CO2 used by the fluid system
-    typedef Ewoms::CO2<Scalar, CO2Tables> CO2;
+    typedef CO2Type CO2;
 
     //! The binary coefficients for brine and CO2 used by this fluid system
     typedef Ewoms::BinaryCoeff::Brine_CO2<Scalar, H2O, CO2> BinaryCoeffBrineCO2;
 
+    /*!
+     * \brief The parameter cache of the fluid system.
+     *
+     * It keeps the solubility context of brine and CO2 for the conditions of the
+     * liquid phase, so the mutual solubilities are computed once per update instead of
+     * once for each call of fugacityCoefficient().
+     */
+    template <class Evaluation>
+    class ParameterCache
+        : public Ewoms::ParameterCacheBase<ParameterCache<Evaluation> >
+    {
+        typedef Ewoms::ParameterCacheBase<ParameterCache<Evaluation> > ParentType;
+
+    public:
+        typedef typename BinaryCoeffBrineCO2::template SolubilityContext<Evaluation> SolubilityContext;
+
+        ParameterCache()
+        {}
+
+        template <class FluidState>
+        void updatePhase(const FluidState& fluidState,
+                         unsigned phaseIdx,
+                         int /*exceptQuantities*/ = ParentType::None)
+        {
+            if (phaseIdx != liquidPhaseIdx)
+                return;
+
+            // the context does nothing if the conditions did not change
+            solubilityContext_.update(Ewoms::decay<Evaluation>(fluidState.temperature(phaseIdx)),
+                                      Ewoms::decay<Evaluation>(fluidState.pressure(phaseIdx)),
+                                      Brine_IAPWS::salinity);
+        }
+
+        /*!
+         * \brief Returns the solubility context for the conditions of the liquid phase.
+         */
+        const SolubilityContext& solubilityContext() const
+        { return solubilityContext_; }
+
+    private:
+        SolubilityContext solubilityContext_;
+    };
+
     /****************************************
      * Fluid phase related static parameters
      ****************************************/
@@ -219,6 +268,10 @@ public:
             Brine_Tabulated::init(tempMin, tempMax, nTemp,
                                   pressMin, pressMax, nPress);
         }
+
+        if (CO2::isTabulated)
+            CO2::init(tempMin, tempMax, nTemp,
+                      pressMin, pressMax, nPress);
     }
 
     /*!
@@ -304,7 +357,7 @@ public:
      */
     template <class FluidState, class LhsEval = typename FluidState::Scalar, class ParamCacheEval = LhsEval>
     static LhsEval fugacityCoefficient(const FluidState& fluidState,
-                                       const ParameterCache<ParamCacheEval>& /*paramCache*/,
+                                       const ParameterCache<ParamCacheEval>& paramCache,
                                        unsigned phaseIdx,
                                        unsigned compIdx)
     {
@@ -322,21 +375,25 @@ public:
         assert(temperature > 0);
         assert(pressure > 0);
 
-        // calulate the equilibrium composition for the given
-        // temperature and pressure. TODO: calculateMoleFractions()
-        // could use some cleanup.
-        LhsEval xlH2O, xgH2O;
-        LhsEval xlCO2, xgCO2;
-        BinaryCoeffBrineCO2::calculateMoleFractions(temperature,
-                                                    pressure,
-                                                    Brine_IAPWS::salinity,
-                                                    /*knownPhaseIdx=*/-1,
-                                                    xlCO2,
-                                                    xgH2O);
+        // calulate the equilibrium composition for the given temperature and
+        // pressure. the parameter cache already knows it unless it was not updated
+        // for the fluid state.
+        LhsEval xlCO2Eq, ygH2OEq;
+        typedef std::integral_constant<bool,
+                                       std::is_same<LhsEval, ParamCacheEval>::value
+                                       || std::is_same<LhsEval, Scalar>::value> CacheUsable;
+        if (!cachedMoleFractions_(xlCO2Eq, ygH2OEq, paramCache, temperature, pressure, CacheUsable())) {
+            const auto& context =
+                BinaryCoeffBrineCO2::solubilityContext(temperature, pressure, Brine_IAPWS::salinity);
+            xlCO2Eq = context.xlCO2();
+            ygH2OEq = context.ygH2O();
+        }
 
         // normalize the phase compositions
-        xlCO2 = Ewoms::max(0.0, Ewoms::min(1.0, xlCO2));
-        xgH2O = Ewoms::max(0.0, Ewoms::min(1.0, xgH2O));
+        LhsEval xlH2O, xgH2O;
+        LhsEval xlCO2, xgCO2;
+        xlCO2 = Ewoms::max(0.0, Ewoms::min(1.0, xlCO2Eq));
+        xgH2O = Ewoms::max(0.0, Ewoms::min(1.0, ygH2OEq));
 
         xlH2O = 1.0 - xlCO2;
         xgCO2 = 1.0 - xgH2O;
@@ -450,6 +507,37 @@ public:
     }
 
 private:
+    // retrieve the equilibrium mole fractions from the solubility context of the
+    // parameter cache if it was updated for the given conditions
+    template <class LhsEval, class ParamCacheEval>
+    static bool cachedMoleFractions_(LhsEval& xlCO2,
+                                     LhsEval& ygH2O,
+                                     const ParameterCache<ParamCacheEval>& paramCache,
+                                     const LhsEval& temperature,
+                                     const LhsEval& pressure,
+                                     std::true_type /*cacheUsable*/)
+    {
+        const auto& context = paramCache.solubilityContext();
+        if (!context.isValid()
+            || Ewoms::scalarValue(context.temperature()) != Ewoms::scalarValue(temperature)
+            || Ewoms::scalarValue(context.pressure()) != Ewoms::scalarValue(pressure))
+            return false;
+
+        xlCO2 = Ewoms::decay<LhsEval>(context.xlCO2());
+        ygH2O = Ewoms::decay<LhsEval>(context.ygH2O());
+        return true;
+    }
+
+    // the parameter cache cannot provide the derivatives which are required
+    template <class LhsEval, class ParamCacheEval>
+    static bool cachedMoleFractions_(LhsEval& /*xlCO2*/,
+                                     LhsEval& /*ygH2O*/,
+                                     const ParameterCache<ParamCacheEval>& /*paramCache*/,
+                                     const LhsEval& /*temperature*/,
+                                     const LhsEval& /*pressure*/,
+                                     std::false_type /*cacheUsable*/)
+    { return false; }
+
     template <class LhsEval>
     static LhsEval gasDensity_(const LhsEval& T,
                                const LhsEval& pg,
@@ -496,7 +584,7 @@ private:
 
         const LhsEval& rho_brine = Brine::liquidDensity(T, pl);
         const LhsEval& rho_pure = H2O::liquidDensity(T, pl);
-        const LhsEval& rho_lCO2 = liquidDensityWaterCO2_(T, pl, xlH2O, xlCO2);
+        const LhsEval& rho_lCO2 = liquidDensityWaterCO2_(T, rho_pure, xlH2O, xlCO2);
         const LhsEval& contribCO2 = rho_lCO2 - rho_pure;
 
         return rho_brine + contribCO2;
@@ -504,7 +592,7 @@ private:
 
     template <class LhsEval>
     static LhsEval liquidDensityWaterCO2_(const LhsEval& temperature,
-                                          const LhsEval& pl,
+                                          const LhsEval& rho_pure,
                                           const LhsEval& /*xlH2O*/,
                                           const LhsEval& xlCO2)
     {
@@ -512,7 +600,6 @@ private:
         Scalar M_H2O = H2O::molarMass();
 
         const LhsEval& tempC = temperature - 273.15;        /* tempC : temperature in °C */
-        const LhsEval& rho_pure = H2O::liquidDensity(temperature, pl);
         // calculate the mole fraction of CO2 in the liquid. note that xlH2O is available
         // as a function parameter, but in the case of a pure gas phase the value of M_T
         // for the virtual liquid phase can become very large
@@ -28,6 +28,7 @@
 
 #include <ewoms/material/idealgas.hh>
 #include <ewoms/material/binarycoefficients/h2o_air.hh>
+#include <ewoms/material/binarycoefficients/tabulatedbinarycoeff.hh>
 #include <ewoms/material/components/air.hh>
 #include <ewoms/material/components/h2o.hh>
 #include <ewoms/material/components/tabulatedcomponent.hh>
@@ -57,6 +58,8 @@ class H2OAirFluidSystem
     typedef H2OAirFluidSystem<Scalar,H2Otype> ThisType;
     typedef BaseFluidSystem <Scalar, ThisType> Base;
 
+    typedef Ewoms::BinaryCoeff::TabulatedBinaryCoeff<Scalar, Ewoms::BinaryCoeff::H2O_Air> H2O_Air;
+
 public:
     template <class Evaluation>
     struct ParameterCache : public Ewoms::NullParameterCache<Evaluation>
@@ -214,13 +217,12 @@ public:
      */
     static void init()
     {
-        if (H2O::isTabulated)
-            init(/*tempMin=*/273.15,
-                 /*tempMax=*/623.15,
-                 /*numTemp=*/50,
-                 /*pMin=*/-10,
-                 /*pMax=*/20e6,
-                 /*numP=*/50);
+        init(/*tempMin=*/273.15,
+             /*tempMax=*/623.15,
+             /*numTemp=*/50,
+             /*pMin=*/-10,
+             /*pMax=*/20e6,
+             /*numP=*/50);
     }
 
     /*!
@@ -241,6 +243,8 @@ public:
             H2O::init(tempMin, tempMax, nTemp,
                       pressMin, pressMax, nPress);
         }
+
+        H2O_Air::init(tempMin, tempMax, pressMin, pressMax);
     }
 
     //! \copydoc BaseFluidSystem::density
@@ -360,7 +364,7 @@ public:
         if (phaseIdx == liquidPhaseIdx) {
             if (compIdx == H2OIdx)
                 return H2O::vaporPressure(T)/p;
-            return Ewoms::BinaryCoeff::H2O_Air::henry(T)/p;
+            return H2O_Air::henry(T)/p;
         }
 
         // for the gas phase, assume an ideal gas when it comes to
@@ -379,10 +383,10 @@ public:
         const auto& p = Ewoms::decay<LhsEval>(fluidState.pressure(phaseIdx));
 
         if (phaseIdx == liquidPhaseIdx)
-            return BinaryCoeff::H2O_Air::liquidDiffCoeff(T, p);
+            return H2O_Air::liquidDiffCoeff(T, p);
 
         assert(phaseIdx == gasPhaseIdx);
-        return BinaryCoeff::H2O_Air::gasDiffCoeff(T, p);
+        return H2O_Air::gasDiffCoeff(T, p);
     }
 
     //! \copydoc BaseFluidSystem::enthalpy
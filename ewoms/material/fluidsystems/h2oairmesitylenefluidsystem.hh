@@ -37,7 +37,9 @@
 #include <ewoms/material/binarycoefficients/h2o_n2.hh>
 #include <ewoms/material/binarycoefficients/h2o_mesitylene.hh>
 #include <ewoms/material/binarycoefficients/air_mesitylene.hh>
+#include <ewoms/material/binarycoefficients/tabulatedbinarycoeff.hh>
 
+#include <algorithm>
 #include <iostream>
 
 namespace Ewoms {
@@ -46,16 +48,27 @@ namespace Ewoms {
  * \ingroup Fluidsystems
  * \brief A fluid system with water, gas and NAPL as phases and
  *        water, air and mesitylene (DNAPL) as components.
+ *
+ * Water is always tabulated. Air and mesitylene are evaluated analytically by
+ * default, but tabulated components, e.g.,
+ * <tt>Ewoms::TabulatedComponent<Scalar, Ewoms::Air<Scalar>, false></tt>, can be
+ * specified using the template arguments. Their tables are then created by init().
  */
-template <class Scalar>
+template <class Scalar,
+          class AirType = Ewoms::Air<Scalar>,
+          class NAPLType = Ewoms::Mesitylene<Scalar> >
 class H2OAirMesityleneFluidSystem
-    : public BaseFluidSystem<Scalar, H2OAirMesityleneFluidSystem<Scalar> >
+    : public BaseFluidSystem<Scalar, H2OAirMesityleneFluidSystem<Scalar, AirType, NAPLType> >
 {
-    typedef H2OAirMesityleneFluidSystem<Scalar> ThisType;
+    typedef H2OAirMesityleneFluidSystem<Scalar, AirType, NAPLType> ThisType;
     typedef BaseFluidSystem<Scalar, ThisType> Base;
 
     typedef Ewoms::H2O<Scalar> IapwsH2O;
     typedef Ewoms::TabulatedComponent<Scalar, IapwsH2O, /*alongVaporPressure=*/false> TabulatedH2O;
+    typedef Ewoms::BinaryCoeff::TabulatedBinaryCoeff<Scalar, Ewoms::BinaryCoeff::H2O_N2> H2O_N2;
+    typedef Ewoms::BinaryCoeff::TabulatedBinaryCoeff<Scalar, Ewoms::BinaryCoeff::H2O_Air> H2O_Air;
+    typedef Ewoms::BinaryCoeff::TabulatedBinaryCoeff<Scalar, Ewoms::BinaryCoeff::H2O_Mesitylene> H2O_Mesitylene;
+    typedef Ewoms::BinaryCoeff::TabulatedBinaryCoeff<Scalar, Ewoms::BinaryCoeff::Air_Mesitylene> Air_Mesitylene;
 
 public:
     template <class Evaluation>
@@ -63,10 +76,10 @@ public:
     {};
 
     //! The type of the mesithylene/napl component
-    typedef Ewoms::Mesitylene<Scalar> NAPL;
+    typedef NAPLType NAPL;
 
     //! The type of the air component
-    typedef Ewoms::Air<Scalar> Air;
+    typedef AirType Air;
 
     //! The type of the water component
     //typedef SimpleH2O H2O;
@@ -121,6 +134,26 @@ public:
             TabulatedH2O::init(tempMin, tempMax, nTemp,
                                pressMin, pressMax, nPress);
         }
+
+        if (Air::isTabulated)
+            Air::init(tempMin, tempMax, nTemp,
+                      pressMin, pressMax, nPress);
+
+        if (NAPL::isTabulated)
+            NAPL::init(tempMin, tempMax, nTemp,
+                       pressMin, pressMax, nPress);
+
+        // the Henry coefficient of nitrogen uses the vapor pressure of water, which is
+        // regularized below the triple point
+        H2O_N2::init(std::max(tempMin, IapwsH2O::tripleTemperature()), tempMax,
+                     pressMin, pressMax);
+        H2O_Air::init(tempMin, tempMax, pressMin, pressMax);
+
+        // the gas diffusion coefficients of mesitylene are regularized above 500 K. the
+        // tables end below this temperature because the kink cannot be interpolated.
+        Scalar naplTempMax = std::min<Scalar>(tempMax, 499.0);
+        H2O_Mesitylene::init(tempMin, naplTempMax, pressMin, pressMax);
+        Air_Mesitylene::init(tempMin, naplTempMax, pressMin, pressMax);
     }
 
     //! \copydoc BaseFluidSystem::isLiquid
@@ -315,9 +348,9 @@ public:
         LhsEval diffCont;
 
         if (phaseIdx==gasPhaseIdx) {
-            const LhsEval& diffAC = Ewoms::BinaryCoeff::Air_Mesitylene::gasDiffCoeff(T, p);
-            const LhsEval& diffWC = Ewoms::BinaryCoeff::H2O_Mesitylene::gasDiffCoeff(T, p);
-            const LhsEval& diffAW = Ewoms::BinaryCoeff::H2O_Air::gasDiffCoeff(T, p);
+            const LhsEval& diffAC = Air_Mesitylene::gasDiffCoeff(T, p);
+            const LhsEval& diffWC = H2O_Mesitylene::gasDiffCoeff(T, p);
+            const LhsEval& diffAW = H2O_Air::gasDiffCoeff(T, p);
 
             const LhsEval& xga = Ewoms::decay<LhsEval>(fluidState.moleFraction(gasPhaseIdx, airIdx));
             const LhsEval& xgw = Ewoms::decay<LhsEval>(fluidState.moleFraction(gasPhaseIdx, H2OIdx));
@@ -376,9 +409,9 @@ public:
             if (compIdx == H2OIdx)
                 return H2O::vaporPressure(T)/p;
             else if (compIdx == airIdx)
-                return Ewoms::BinaryCoeff::H2O_N2::henry(T)/p;
+                return H2O_N2::henry(T)/p;
             else if (compIdx == NAPLIdx)
-                return Ewoms::BinaryCoeff::H2O_Mesitylene::henry(T)/p;
+                return H2O_Mesitylene::henry(T)/p;
             assert(false);
         }
         // for the NAPL phase, we assume currently that nothing is
@@ -32,10 +32,13 @@
 #include <ewoms/material/binarycoefficients/h2o_air.hh>
 #include <ewoms/material/binarycoefficients/h2o_xylene.hh>
 #include <ewoms/material/binarycoefficients/air_xylene.hh>
+#include <ewoms/material/binarycoefficients/tabulatedbinarycoeff.hh>
 
 #include "basefluidsystem.hh"
 #include "nullparametercache.hh"
 
+#include <algorithm>
+
 namespace Ewoms {
 
 /*!
@@ -50,6 +53,10 @@ class H2OAirXyleneFluidSystem
     typedef H2OAirXyleneFluidSystem<Scalar> ThisType;
     typedef BaseFluidSystem<Scalar, ThisType> Base;
 
+    typedef Ewoms::BinaryCoeff::TabulatedBinaryCoeff<Scalar, Ewoms::BinaryCoeff::H2O_Air> H2O_Air;
+    typedef Ewoms::BinaryCoeff::TabulatedBinaryCoeff<Scalar, Ewoms::BinaryCoeff::H2O_Xylene> H2O_Xylene;
+    typedef Ewoms::BinaryCoeff::TabulatedBinaryCoeff<Scalar, Ewoms::BinaryCoeff::Air_Xylene> Air_Xylene;
+
 public:
     template <class Evaluation>
     struct ParameterCache : public Ewoms::NullParameterCache<Evaluation>
@@ -83,7 +90,32 @@ public:
 
     //! \copydoc BaseFluidSystem::init
     static void init()
-    { }
+    {
+        init(/*tempMin=*/273.15,
+             /*tempMax=*/623.15,
+             /*pMin=*/0.0,
+             /*pMax=*/20e6);
+    }
+
+    /*!
+     * \brief Initialize the fluid system's static parameters using problem specific
+     *        temperature and pressure ranges
+     *
+     * \param tempMin The minimum temperature used for tabulation of the binary coefficients [K]
+     * \param tempMax The maximum temperature used for tabulation of the binary coefficients [K]
+     * \param pressMin The minimum pressure used for tabulation of the binary coefficients [Pa]
+     * \param pressMax The maximum pressure used for tabulation of the binary coefficients [Pa]
+     */
+    static void init(Scalar tempMin, Scalar tempMax, Scalar pressMin, Scalar pressMax)
+    {
+        H2O_Air::init(tempMin, tempMax, pressMin, pressMax);
+
+        // the gas diffusion coefficients of xylene are regularized above 500 K. the
+        // tables end below this temperature because the kink cannot be interpolated.
+        Scalar naplTempMax = std::min<Scalar>(tempMax, 499.0);
+        H2O_Xylene::init(tempMin, naplTempMax, pressMin, pressMax);
+        Air_Xylene::init(tempMin, naplTempMax, pressMin, pressMax);
+    }
 
     //! \copydoc BaseFluidSystem::isLiquid
     static bool isLiquid(unsigned phaseIdx)
@@ -273,9 +305,9 @@ public:
             const auto& T = Ewoms::decay<LhsEval>(fluidState.temperature(phaseIdx));
             const auto& p = Ewoms::decay<LhsEval>(fluidState.pressure(phaseIdx));
 
-            const LhsEval& diffAC = Ewoms::BinaryCoeff::Air_Xylene::gasDiffCoeff(T, p);
-            const LhsEval& diffWC = Ewoms::BinaryCoeff::H2O_Xylene::gasDiffCoeff(T, p);
-            const LhsEval& diffAW = Ewoms::BinaryCoeff::H2O_Air::gasDiffCoeff(T, p);
+            const LhsEval& diffAC = Air_Xylene::gasDiffCoeff(T, p);
+            const LhsEval& diffWC = H2O_Xylene::gasDiffCoeff(T, p);
+            const LhsEval& diffAW = H2O_Air::gasDiffCoeff(T, p);
 
             const LhsEval& xga = Ewoms::decay<LhsEval>(fluidState.moleFraction(gasPhaseIdx, airIdx));
             const LhsEval& xgw = Ewoms::decay<LhsEval>(fluidState.moleFraction(gasPhaseIdx, H2OIdx));
@@ -328,9 +360,9 @@ public:
             if (compIdx == H2OIdx)
                 return H2O::vaporPressure(T)/p;
             else if (compIdx == airIdx)
-                return Ewoms::BinaryCoeff::H2O_Air::henry(T)/p;
+                return H2O_Air::henry(T)/p;
             else if (compIdx == NAPLIdx)
-                return Ewoms::BinaryCoeff::H2O_Xylene::henry(T)/p;
+                return H2O_Xylene::henry(T)/p;
         }
 
         // for the NAPL phase, we assume currently that nothing is
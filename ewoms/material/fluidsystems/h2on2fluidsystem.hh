@@ -32,8 +32,10 @@
 #include <ewoms/material/components/simpleh2o.hh>
 #include <ewoms/material/components/tabulatedcomponent.hh>
 #include <ewoms/material/binarycoefficients/h2o_n2.hh>
+#include <ewoms/material/binarycoefficients/tabulatedbinarycoeff.hh>
 #include <ewoms/common/valgrind.hh>
 
+#include <algorithm>
 #include <iostream>
 #include <cassert>
 
@@ -43,18 +45,23 @@ namespace Ewoms {
  * \ingroup Fluidsystems
  *
  * \brief A two-phase fluid system with water and nitrogen as components.
+ *
+ * Water is always tabulated. Nitrogen is evaluated analytically by default, a tabulated
+ * nitrogen component can be used by passing e.g.
+ * <tt>Ewoms::TabulatedComponent<Scalar, Ewoms::N2<Scalar>, false></tt> as the
+ * second template argument. Its tables are then created by init().
  */
-template <class Scalar>
+template <class Scalar, class N2Type = Ewoms::N2<Scalar> >
 class H2ON2FluidSystem
-    : public BaseFluidSystem<Scalar, H2ON2FluidSystem<Scalar> >
+    : public BaseFluidSystem<Scalar, H2ON2FluidSystem<Scalar, N2Type> >
 {
-    typedef H2ON2FluidSystem<Scalar> ThisType;
+    typedef H2ON2FluidSystem<Scalar, N2Type> ThisType;
     typedef BaseFluidSystem<Scalar, ThisType> Base;
 
     // convenience typedefs
     typedef Ewoms::H2O<Scalar> IapwsH2O;
     typedef Ewoms::TabulatedComponent<Scalar, IapwsH2O > TabulatedH2O;
-    typedef Ewoms::N2<Scalar> SimpleN2;
+    typedef Ewoms::BinaryCoeff::TabulatedBinaryCoeff<Scalar, Ewoms::BinaryCoeff::H2O_N2> H2O_N2;
 
 public:
     //! \copydoc BaseFluidSystem::ParameterCache
@@ -142,7 +149,7 @@ public:
     //typedef IapwsH2O H2O;
 
     //! The component for pure nitrogen
-    typedef SimpleN2 N2;
+    typedef N2Type N2;
 
     //! \copydoc BaseFluidSystem::componentName
     static const char* componentName(unsigned compIdx)
@@ -247,6 +254,15 @@ public:
             TabulatedH2O::init(tempMin, tempMax, nTemp,
                                pressMin, pressMax, nPress);
         }
+
+        if (N2::isTabulated)
+            N2::init(tempMin, tempMax, nTemp,
+                     pressMin, pressMax, nPress);
+
+        // the Henry coefficient of nitrogen uses the vapor pressure of water, which is
+        // regularized below the triple point
+        H2O_N2::init(std::max(tempMin, IapwsH2O::tripleTemperature()), tempMax,
+                     pressMin, pressMax);
     }
 
     /*!
@@ -359,7 +375,7 @@ public:
         if (phaseIdx == liquidPhaseIdx) {
             if (compIdx == H2OIdx)
                 return H2O::vaporPressure(T)/p;
-            return Ewoms::BinaryCoeff::H2O_N2::henry(T)/p;
+            return H2O_N2::henry(T)/p;
         }
 
         assert(phaseIdx == gasPhaseIdx);
@@ -382,11 +398,11 @@ public:
 
         // liquid phase
         if (phaseIdx == liquidPhaseIdx)
-            return BinaryCoeff::H2O_N2::liquidDiffCoeff(T, p);
+            return H2O_N2::liquidDiffCoeff(T, p);
 
         // gas phase
         assert(phaseIdx == gasPhaseIdx);
-        return BinaryCoeff::H2O_N2::gasDiffCoeff(T, p);
+        return H2O_N2::gasDiffCoeff(T, p);
     }
 
     //! \copydoc BaseFluidSystem::enthalpy
@@ -32,8 +32,10 @@
 #include <ewoms/material/components/simpleh2o.hh>
 #include <ewoms/material/components/tabulatedcomponent.hh>
 #include <ewoms/material/binarycoefficients/h2o_n2.hh>
+#include <ewoms/material/binarycoefficients/tabulatedbinarycoeff.hh>
 #include <ewoms/common/valgrind.hh>
 
+#include <algorithm>
 #include <iostream>
 #include <cassert>
 
@@ -56,6 +58,7 @@ class H2ON2LiquidPhaseFluidSystem
     typedef Ewoms::H2O<Scalar> IapwsH2O;
     typedef Ewoms::TabulatedComponent<Scalar, IapwsH2O > TabulatedH2O;
     typedef Ewoms::N2<Scalar> SimpleN2;
+    typedef Ewoms::BinaryCoeff::TabulatedBinaryCoeff<Scalar, Ewoms::BinaryCoeff::H2O_N2> H2O_N2;
 
 public:
     //! \copydoc BaseFluidSystem::ParameterCache
@@ -239,6 +242,11 @@ public:
             TabulatedH2O::init(tempMin, tempMax, nTemp,
                                pressMin, pressMax, nPress);
         }
+
+        // the Henry coefficient of nitrogen uses the vapor pressure of water, which is
+        // regularized below the triple point
+        H2O_N2::init(std::max(tempMin, IapwsH2O::tripleTemperature()), tempMax,
+                     pressMin, pressMax);
     }
 
     //! \copydoc BaseFluidSystem::density
@@ -298,7 +306,7 @@ public:
 
         if (compIdx == H2OIdx)
             return H2O::vaporPressure(T)/p;
-        return Ewoms::BinaryCoeff::H2O_N2::henry(T)/p;
+        return H2O_N2::henry(T)/p;
     }
 
     //! \copydoc BaseFluidSystem::diffusionCoefficient
@@ -314,7 +322,7 @@ public:
         const auto& T = Ewoms::decay<LhsEval>(fluidState.temperature(phaseIdx));
         const auto& p = Ewoms::decay<LhsEval>(fluidState.pressure(phaseIdx));
 
-        return BinaryCoeff::H2O_N2::liquidDiffCoeff(T, p);
+        return H2O_N2::liquidDiffCoeff(T, p);
     }
 
     //! \copydoc BaseFluidSystem::enthalpy
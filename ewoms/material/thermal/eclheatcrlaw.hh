@@ -50,12 +50,29 @@ public:
      */
     template <class FluidState, class Evaluation = typename FluidState::Scalar>
     static Evaluation solidInternalEnergy(const Params& params, const FluidState& fluidState)
+    {
+        return solidInternalEnergy<FluidState, Evaluation>(params.referenceRockHeatCapacity(),
+                                                           params.dRockHeatCapacity_dT(),
+                                                           fluidState);
+    }
+
+    /*!
+     * \brief Given a fluid state, compute the volumetric internal energy of the rock [W/m^3]
+     *        from the values of the HEATCR and HEATCRT keywords.
+     *
+     * This does not require a parameter object, i.e., it can be used if the values are
+     * stored elsewhere.
+     */
+    template <class FluidState, class Evaluation = typename FluidState::Scalar>
+    static Evaluation solidInternalEnergy(Scalar referenceRockHeatCapacity,
+                                          Scalar dRockHeatCapacity_dT,
+                                          const FluidState& fluidState)
     {
         const Evaluation& T = fluidState.temperature(/*phaseIdx=*/0);
-        const Evaluation& deltaT = T - params.referenceTemperature();
+        const Evaluation& deltaT = T - Params::referenceTemperature();
 
-        Scalar C0 = params.referenceRockHeatCapacity();
-        Scalar C1 = params.dRockHeatCapacity_dT();
+        Scalar C0 = referenceRockHeatCapacity;
+        Scalar C1 = dRockHeatCapacity_dT;
 
         return deltaT*(C0 + deltaT*C1 / 2.0);
     }
@@ -54,10 +54,31 @@ public:
     typedef Ewoms::EclHeatcrLawParams<ScalarT> HeatcrLawParams;
     typedef Ewoms::EclSpecrockLawParams<ScalarT> SpecrockLawParams;
 
-    EclSolidEnergyLawMultiplexerParams(const EclSolidEnergyLawMultiplexerParams&) = default;
-
     EclSolidEnergyLawMultiplexerParams()
-    { solidEnergyApproach_ = undefinedApproach; }
+    {
+        solidEnergyApproach_ = undefinedApproach;
+        realParams_ = nullptr;
+    }
+
+    // the parameters of the real law are owned by the object, i.e., they must be
+    // copied instead of the pointer to them
+    EclSolidEnergyLawMultiplexerParams(const EclSolidEnergyLawMultiplexerParams& other)
+        : EnsureFinalized(other)
+    {
+        solidEnergyApproach_ = undefinedApproach;
+        realParams_ = nullptr;
+        copy_(other);
+    }
+
+    EclSolidEnergyLawMultiplexerParams& operator=(const EclSolidEnergyLawMultiplexerParams& other)
+    {
+        if (this != &other) {
+            destroy_();
+            EnsureFinalized::operator=(other);
+            copy_(other);
+        }
+        return *this;
+    }
 
     ~EclSolidEnergyLawMultiplexerParams()
     { destroy_(); }
@@ -123,6 +144,25 @@ public:
     }
 
 private:
+    void copy_(const EclSolidEnergyLawMultiplexerParams& other)
+    {
+        solidEnergyApproach_ = other.solidEnergyApproach_;
+        switch (solidEnergyApproach()) {
+        case heatcrApproach:
+            realParams_ = new HeatcrLawParams(*static_cast<const HeatcrLawParams*>(other.realParams_));
+            break;
+
+        case specrockApproach:
+            realParams_ = new SpecrockLawParams(*static_cast<const SpecrockLawParams*>(other.realParams_));
+            break;
+
+        case undefinedApproach:
+        case nullApproach:
+            realParams_ = nullptr;
+            break;
+        }
+    }
+
     void destroy_()
     {
         switch (solidEnergyApproach()) {
@@ -53,6 +53,17 @@ public:
         const auto& T = fluidState.temperature(/*phaseIdx=*/0);
         return params.internalEnergyFunction().eval(T, /*extrapolate=*/true);
     }
+
+    /*!
+     * \brief Given the volumetric internal energy of the rock [J/m^3], compute its
+     *        temperature [K].
+     *
+     * This is the inverse of solidInternalEnergy(), i.e., a table lookup instead of a
+     * Newton solve.
+     */
+    template <class Evaluation>
+    static Evaluation solidTemperature(const Params& params, const Evaluation& internalEnergy)
+    { return params.temperatureFunction().eval(internalEnergy, /*extrapolate=*/true); }
 };
 } // namespace Ewoms
 
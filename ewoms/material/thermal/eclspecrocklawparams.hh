@@ -27,6 +27,11 @@
 
 #include <ewoms/common/tabulated1dfunction.hh>
 
+#include <cassert>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
 namespace Ewoms {
 
 /*!
@@ -37,6 +42,7 @@ template <class ScalarT>
 class EclSpecrockLawParams : public EnsureFinalized
 {
     typedef Tabulated1DFunction<ScalarT> InternalEnergyFunction;
+    typedef Tabulated1DFunction<ScalarT> TemperatureFunction;
 
 public:
     typedef ScalarT Scalar;
@@ -48,6 +54,12 @@ public:
 
     /*!
      * \brief Specify the volumetric internal energy of rock via heat capacities.
+     *
+     * Besides the internal energy as a function of temperature, this also computes its
+     * inverse. Since the internal energy is piecewise linear, the inverse is piecewise
+     * linear on the same sampling points, i.e., it is exact. This requires the internal
+     * energy to strictly increase with temperature. (Individual heat capacities may
+     * thus be zero as long as the integral over each interval is positive.)
      */
     template <class Container>
     void setHeatCapacities(const Container& temperature,
@@ -64,6 +76,11 @@ public:
             T[i] = temperature[i];
             u[i] = curU;
 
+            if (i > 0 && !(u[i] > u[i - 1]))
+                throw std::invalid_argument("The internal energy of the rock must strictly "
+                                            "increase with temperature (sampling points "
+                                            +std::to_string(i - 1)+" and "+std::to_string(i)+")");
+
             if (i >= temperature.size() - 1)
                 break;
 
@@ -77,6 +94,7 @@ public:
         }
 
         internalEnergyFunction_.setXYContainers(T, u);
+        temperatureFunction_.setXYContainers(u, T);
     }
 
     /*!
@@ -90,8 +108,18 @@ public:
     const InternalEnergyFunction& internalEnergyFunction() const
     { EnsureFinalized::check(); return internalEnergyFunction_; }
 
+    /*!
+     * \brief Return the function which maps the rock's volumetric internal energy to
+     *        temperature
+     *
+     * This is the inverse of internalEnergyFunction().
+     */
+    const TemperatureFunction& temperatureFunction() const
+    { EnsureFinalized::check(); return temperatureFunction_; }
+
 private:
     InternalEnergyFunction internalEnergyFunction_;
+    TemperatureFunction temperatureFunction_;
 };
 
 } // namespace Ewoms
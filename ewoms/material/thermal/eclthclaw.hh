@@ -52,11 +52,31 @@ public:
     template <class FluidState, class Evaluation = typename FluidState::Scalar>
     static Evaluation thermalConductivity(const Params& params,
                                           const FluidState& fluidState EWOMS_UNUSED)
+    {
+        return thermalConductivity(params.porosity(),
+                                   params.thcrock(),
+                                   params.thcoil(),
+                                   params.thcgas(),
+                                   params.thcwater());
+    }
+
+    /*!
+     * \brief Return the total thermal conductivity [W/m^2 / (K/m)] of the porous medium
+     *        from the porosity and the values of the THC* keywords.
+     *
+     * The result does not depend on the fluid state, so this can be used to compute the
+     * thermal conductivity upfront.
+     */
+    static Scalar thermalConductivity(Scalar porosity,
+                                      Scalar thcrock,
+                                      Scalar thcoil,
+                                      Scalar thcgas,
+                                      Scalar thcwater)
     {
         // The thermal conductivity approach based on the THC* keywords.
 
         // let's assume that the porosity of the rock at standard condition is meant
-        Scalar poro = params.porosity();
+        Scalar poro = porosity;
 
         // IMO this approach is very questionable because the total thermal conductivity
         // should at least depend on the current solution's phase saturation. Since ECL
@@ -66,8 +86,8 @@ public:
         // TODO: also follow their fine leadership in the twophase case.
         Scalar numPhases = 3.0;
         Scalar thconAvg =
-            poro*(params.thcoil() + params.thcgas() + params.thcwater()) / numPhases
-            + (1.0 - poro)*params.thcrock();
+            poro*(thcoil + thcgas + thcwater) / numPhases
+            + (1.0 - poro)*thcrock;
 
         return thconAvg;
     }
@@ -50,12 +50,29 @@ public:
     template <class FluidState, class Evaluation = typename FluidState::Scalar>
     static Evaluation thermalConductivity(const Params& params,
                                           const FluidState& fluidState)
+    {
+        return thermalConductivity<FluidState, Evaluation>(params.referenceTotalThermalConductivity(),
+                                                           params.dTotalThermalConductivity_dSg(),
+                                                           fluidState);
+    }
+
+    /*!
+     * \brief Given a fluid state, return the total thermal conductivity [W/m^2 / (K/m)] of the porous
+     *        medium from the values of the THCONR and THCONSF keywords.
+     *
+     * This does not require a parameter object, i.e., it can be used if the values are
+     * stored elsewhere.
+     */
+    template <class FluidState, class Evaluation = typename FluidState::Scalar>
+    static Evaluation thermalConductivity(Scalar referenceTotalThermalConductivity,
+                                          Scalar dTotalThermalConductivity_dSg,
+                                          const FluidState& fluidState)
     {
         // THCONR + THCONSF approach.
-        Scalar lambdaRef = params.referenceTotalThermalConductivity();
+        Scalar lambdaRef = referenceTotalThermalConductivity;
         static constexpr int gasPhaseIdx = FluidSystem::gasPhaseIdx;
         if (FluidSystem::phaseIsActive(gasPhaseIdx)) {
-            Scalar alpha = params.dTotalThermalConductivity_dSg();
+            Scalar alpha = dTotalThermalConductivity_dSg;
             const Evaluation& Sg = Ewoms::decay<Evaluation>(fluidState.saturation(gasPhaseIdx));
             return lambdaRef*(1.0 - alpha*Sg);
         } else {
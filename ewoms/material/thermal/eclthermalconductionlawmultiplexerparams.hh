@@ -54,10 +54,31 @@ public:
     typedef Ewoms::EclThconrLawParams<ScalarT> ThconrLawParams;
     typedef Ewoms::EclThcLawParams<ScalarT> ThcLawParams;
 
-    EclThermalConductionLawMultiplexerParams(const EclThermalConductionLawMultiplexerParams&) = default;
-
     EclThermalConductionLawMultiplexerParams()
-    { thermalConductionApproach_ = undefinedApproach; }
+    {
+        thermalConductionApproach_ = undefinedApproach;
+        realParams_ = nullptr;
+    }
+
+    // the parameters of the real law are owned by the object, i.e., they must be
+    // copied instead of the pointer to them
+    EclThermalConductionLawMultiplexerParams(const EclThermalConductionLawMultiplexerParams& other)
+        : EnsureFinalized(other)
+    {
+        thermalConductionApproach_ = undefinedApproach;
+        realParams_ = nullptr;
+        copy_(other);
+    }
+
+    EclThermalConductionLawMultiplexerParams& operator=(const EclThermalConductionLawMultiplexerParams& other)
+    {
+        if (this != &other) {
+            destroy_();
+            EnsureFinalized::operator=(other);
+            copy_(other);
+        }
+        return *this;
+    }
 
     ~EclThermalConductionLawMultiplexerParams()
     { destroy_(); }
@@ -123,6 +144,25 @@ public:
     }
 
 private:
+    void copy_(const EclThermalConductionLawMultiplexerParams& other)
+    {
+        thermalConductionApproach_ = other.thermalConductionApproach_;
+        switch (thermalConductionApproach()) {
+        case thconrApproach:
+            realParams_ = new ThconrLawParams(*static_cast<const ThconrLawParams*>(other.realParams_));
+            break;
+
+        case thcApproach:
+            realParams_ = new ThcLawParams(*static_cast<const ThcLawParams*>(other.realParams_));
+            break;
+
+        case undefinedApproach:
+        case nullApproach:
+            realParams_ = nullptr;
+            break;
+        }
+    }
+
     void destroy_()
     {
         switch (thermalConductionApproach()) {
@@ -37,6 +37,13 @@
 #include <ewoms/eclio/parser/eclipsestate/tables/tablemanager.hh>
 #include <ewoms/eclio/parser/deck/deck.hh>
 
+#include <cassert>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
 namespace Ewoms {
 
 /*!
@@ -44,6 +51,18 @@ namespace Ewoms {
  *
  * \brief Provides an simple way to create and manage the thermal law objects
  *        for a complete ECL deck.
+ *
+ * By default, a full parameter object of the multiplexer laws is created for each
+ * element if the parameters of the thermal laws are specified per element (HEATCR,
+ * THCONR, THC*). Since each of these objects is allocated on the heap, this is quite
+ * wasteful for large grids. If compact storage is enabled via setUseCompactStorage(),
+ * only the scalar values which vary between the elements are stored in flat arrays,
+ * i.e., a few bytes per element, and data which is constant within a region like the
+ * SPECROCK tables is shared by all elements of the region. In this mode, the thermal laws
+ * should be evaluated via solidInternalEnergy(), thermalConductivity() or their bulk
+ * counterparts. The per-element parameter objects are still available, but they are
+ * created when they are accessed for the first time, i.e., using them forfeits the
+ * memory savings.
  */
 template <class Scalar, class FluidSystem>
 class EclThermalLawManager
@@ -56,13 +75,37 @@ public:
 
     typedef EclThermalConductionLawMultiplexer<Scalar, FluidSystem> ThermalConductionLaw;
     typedef typename ThermalConductionLaw::Params ThermalConductionLawParams;
+    typedef typename ThermalConductionLawParams::ThconrLawParams ThconrLawParams;
+    typedef typename ThermalConductionLawParams::ThcLawParams ThcLawParams;
+
+    typedef EclHeatcrLaw<Scalar, FluidSystem, HeatcrLawParams> HeatcrLaw;
+    typedef EclSpecrockLaw<Scalar, SpecrockLawParams> SpecrockLaw;
+    typedef EclThconrLaw<Scalar, FluidSystem, ThconrLawParams> ThconrLaw;
+    typedef EclThcLaw<Scalar, ThcLawParams> ThcLaw;
 
     EclThermalLawManager()
     {
         solidEnergyApproach_ = SolidEnergyLawParams::undefinedApproach;
         thermalConductivityApproach_ = ThermalConductionLawParams::undefinedApproach;
+        useCompactStorage_ = false;
     }
 
+    /*!
+     * \brief Specify whether only the values which vary between the elements should be
+     *        stored.
+     *
+     * This must be called before initParamsForElements().
+     */
+    void setUseCompactStorage(bool yesno)
+    { useCompactStorage_ = yesno; }
+
+    /*!
+     * \brief Returns true if only the values which vary between the elements are
+     *        stored.
+     */
+    bool useCompactStorage() const
+    { return useCompactStorage_; }
+
     void initParamsForElements(const Ewoms::EclipseState& eclState, size_t numElems)
     {
         const auto& fieldProps = eclState.fieldProps();
@@ -94,6 +137,10 @@ public:
     {
         switch (solidEnergyApproach_) {
         case SolidEnergyLawParams::heatcrApproach:
+            if (useCompactStorage_)
+                std::call_once(*solidEnergyLawParamsCreated_.flag,
+                               &EclThermalLawManager::createHeatcrParams_,
+                               this);
             assert(0 <= elemIdx && elemIdx <  solidEnergyLawParams_.size());
             return solidEnergyLawParams_[elemIdx];
 
@@ -119,6 +166,10 @@ public:
         switch (thermalConductivityApproach_) {
         case ThermalConductionLawParams::thconrApproach:
         case ThermalConductionLawParams::thcApproach:
+            if (useCompactStorage_)
+                std::call_once(*thermalConductionLawParamsCreated_.flag,
+                               &EclThermalLawManager::createThermalConductionParams_,
+                               this);
             assert(0 <= elemIdx && elemIdx <  thermalConductionLawParams_.size());
             return thermalConductionLawParams_[elemIdx];
 
@@ -131,6 +182,169 @@ public:
         }
     }
 
+    /*!
+     * \brief Compute the volumetric internal energy of the rock [J/m^3] of an element.
+     *
+     * In contrast to using solidEnergyLawParams(), this also works if compact storage
+     * is used.
+     */
+    template <class FluidState, class Evaluation = typename FluidState::Scalar>
+    Evaluation solidInternalEnergy(unsigned elemIdx, const FluidState& fluidState) const
+    {
+        if (useCompactStorage_ && solidEnergyApproach_ == SolidEnergyLawParams::heatcrApproach)
+            return HeatcrLaw::template solidInternalEnergy<FluidState, Evaluation>(heatcrReferenceRockHeatCapacity_[elemIdx],
+                                                                                   heatcrDRockHeatCapacity_dT_[elemIdx],
+                                                                                   fluidState);
+
+        return SolidEnergyLaw::template solidInternalEnergy<FluidState, Evaluation>(solidEnergyLawParams(elemIdx),
+                                                                                    fluidState);
+    }
+
+    /*!
+     * \brief Compute the total thermal conductivity [W/(m K)] of an element.
+     *
+     * \copydetails solidInternalEnergy()
+     */
+    template <class FluidState, class Evaluation = typename FluidState::Scalar>
+    Evaluation thermalConductivity(unsigned elemIdx, const FluidState& fluidState) const
+    {
+        if (useCompactStorage_) {
+            if (thermalConductivityApproach_ == ThermalConductionLawParams::thconrApproach)
+                return ThconrLaw::template thermalConductivity<FluidState, Evaluation>(thconrReferenceThermalConductivity_[elemIdx],
+                                                                                       thconrDThermalConductivity_dSg_[elemIdx],
+                                                                                       fluidState);
+            else if (thermalConductivityApproach_ == ThermalConductionLawParams::thcApproach)
+                return thcThermalConductivity_[elemIdx];
+        }
+
+        return ThermalConductionLaw::template thermalConductivity<FluidState, Evaluation>(thermalConductionLawParams(elemIdx),
+                                                                                          fluidState);
+    }
+
+    /*!
+     * \brief Compute the volumetric internal energy of the rock [J/m^3] for all
+     *        elements.
+     *
+     * The result is the same as calling SolidEnergyLaw::solidInternalEnergy() for each
+     * element, but the approach which is used by the deck is only resolved once instead
+     * of for each element. The loops over the elements thus do not contain any branches
+     * and the laws of the respective approach can be inlined. The containers for the
+     * results and for the fluid states are indexed by the element index.
+     */
+    template <class ResultContainer, class FluidStateContainer>
+    void solidInternalEnergies(ResultContainer& result, const FluidStateContainer& fluidStates) const
+    {
+        typedef typename std::decay<decltype(result[0])>::type Evaluation;
+        typedef typename std::decay<decltype(fluidStates[0])>::type FluidState;
+
+        const unsigned numElems = static_cast<unsigned>(fluidStates.size());
+        assert(result.size() == fluidStates.size());
+
+        switch (solidEnergyApproach_) {
+        case SolidEnergyLawParams::heatcrApproach:
+            if (useCompactStorage_) {
+                assert(numElems <= heatcrReferenceRockHeatCapacity_.size());
+                for (unsigned elemIdx = 0; elemIdx < numElems; ++elemIdx)
+                    result[elemIdx] =
+                        HeatcrLaw::template solidInternalEnergy<FluidState, Evaluation>(heatcrReferenceRockHeatCapacity_[elemIdx],
+                                                                                        heatcrDRockHeatCapacity_dT_[elemIdx],
+                                                                                        fluidStates[elemIdx]);
+                break;
+            }
+
+            assert(numElems <= solidEnergyLawParams_.size());
+            for (unsigned elemIdx = 0; elemIdx < numElems; ++elemIdx) {
+                const auto& params =
+                    solidEnergyLawParams_[elemIdx].template getRealParams<SolidEnergyLawParams::heatcrApproach>();
+                result[elemIdx] =
+                    HeatcrLaw::template solidInternalEnergy<FluidState, Evaluation>(params, fluidStates[elemIdx]);
+            }
+            break;
+
+        case SolidEnergyLawParams::specrockApproach:
+            assert(numElems <= elemToSatnumIdx_.size());
+            for (unsigned elemIdx = 0; elemIdx < numElems; ++elemIdx) {
+                const auto& params =
+                    solidEnergyLawParams_[elemToSatnumIdx_[elemIdx]].template getRealParams<SolidEnergyLawParams::specrockApproach>();
+                result[elemIdx] =
+                    SpecrockLaw::template solidInternalEnergy<FluidState, Evaluation>(params, fluidStates[elemIdx]);
+            }
+            break;
+
+        case SolidEnergyLawParams::nullApproach:
+            for (unsigned elemIdx = 0; elemIdx < numElems; ++elemIdx)
+                result[elemIdx] = 0.0;
+            break;
+
+        default:
+            throw std::runtime_error("Attempting to compute the solid internal energies "
+                                     "without a known approach being defined by the deck.");
+        }
+    }
+
+    /*!
+     * \brief Compute the total thermal conductivity [W/(m K)] for all elements.
+     *
+     * \copydetails solidInternalEnergies()
+     */
+    template <class ResultContainer, class FluidStateContainer>
+    void thermalConductivities(ResultContainer& result, const FluidStateContainer& fluidStates) const
+    {
+        typedef typename std::decay<decltype(result[0])>::type Evaluation;
+        typedef typename std::decay<decltype(fluidStates[0])>::type FluidState;
+
+        const unsigned numElems = static_cast<unsigned>(fluidStates.size());
+        assert(result.size() == fluidStates.size());
+
+        switch (thermalConductivityApproach_) {
+        case ThermalConductionLawParams::thconrApproach:
+            if (useCompactStorage_) {
+                assert(numElems <= thconrReferenceThermalConductivity_.size());
+                for (unsigned elemIdx = 0; elemIdx < numElems; ++elemIdx)
+                    result[elemIdx] =
+                        ThconrLaw::template thermalConductivity<FluidState, Evaluation>(thconrReferenceThermalConductivity_[elemIdx],
+                                                                                        thconrDThermalConductivity_dSg_[elemIdx],
+                                                                                        fluidStates[elemIdx]);
+                break;
+            }
+
+            assert(numElems <= thermalConductionLawParams_.size());
+            for (unsigned elemIdx = 0; elemIdx < numElems; ++elemIdx) {
+                const auto& params =
+                    thermalConductionLawParams_[elemIdx].template getRealParams<ThermalConductionLawParams::thconrApproach>();
+                result[elemIdx] =
+                    ThconrLaw::template thermalConductivity<FluidState, Evaluation>(params, fluidStates[elemIdx]);
+            }
+            break;
+
+        case ThermalConductionLawParams::thcApproach:
+            if (useCompactStorage_) {
+                assert(numElems <= thcThermalConductivity_.size());
+                for (unsigned elemIdx = 0; elemIdx < numElems; ++elemIdx)
+                    result[elemIdx] = thcThermalConductivity_[elemIdx];
+                break;
+            }
+
+            assert(numElems <= thermalConductionLawParams_.size());
+            for (unsigned elemIdx = 0; elemIdx < numElems; ++elemIdx) {
+                const auto& params =
+                    thermalConductionLawParams_[elemIdx].template getRealParams<ThermalConductionLawParams::thcApproach>();
+                result[elemIdx] =
+                    ThcLaw::template thermalConductivity<FluidState, Evaluation>(params, fluidStates[elemIdx]);
+            }
+            break;
+
+        case ThermalConductionLawParams::nullApproach:
+            for (unsigned elemIdx = 0; elemIdx < numElems; ++elemIdx)
+                result[elemIdx] = 0.0;
+            break;
+
+        default:
+            throw std::runtime_error("Attempting to compute the thermal conductivities without "
+                                     "a known approach being defined by the deck.");
+        }
+    }
+
 private:
     /*!
      * \brief Initialize the parameters for the solid energy law using using HEATCR and friends.
@@ -146,6 +360,12 @@ private:
         const auto& fieldProps = eclState.fieldProps();
         const std::vector<double>& heatcrData  = fieldProps.get_double("HEATCR");
         const std::vector<double>& heatcrtData = fieldProps.get_double("HEATCRT");
+        if (useCompactStorage_) {
+            heatcrReferenceRockHeatCapacity_.assign(heatcrData.begin(), heatcrData.begin() + numElems);
+            heatcrDRockHeatCapacity_dT_.assign(heatcrtData.begin(), heatcrtData.begin() + numElems);
+            return;
+        }
+
         solidEnergyLawParams_.resize(numElems);
         for (unsigned elemIdx = 0; elemIdx < numElems; ++elemIdx) {
             auto& elemParam = solidEnergyLawParams_[elemIdx];
@@ -205,6 +425,7 @@ private:
         solidEnergyApproach_ = SolidEnergyLawParams::nullApproach;
 
         solidEnergyLawParams_.resize(1);
+        solidEnergyLawParams_[0].setSolidEnergyApproach(SolidEnergyLawParams::nullApproach);
         solidEnergyLawParams_[0].finalize();
     }
 
@@ -225,6 +446,16 @@ private:
         if (fieldProps.has_double("THCONSF"))
             thconsfData = fieldProps.get_double("THCONSF");
 
+        if (useCompactStorage_) {
+            thconrReferenceThermalConductivity_.resize(numElems);
+            thconrDThermalConductivity_dSg_.resize(numElems);
+            for (unsigned elemIdx = 0; elemIdx < numElems; ++elemIdx) {
+                thconrReferenceThermalConductivity_[elemIdx] = thconrData.empty() ? 0.0 : thconrData[elemIdx];
+                thconrDThermalConductivity_dSg_[elemIdx] = thconsfData.empty() ? 0.0 : thconsfData[elemIdx];
+            }
+            return;
+        }
+
         thermalConductionLawParams_.resize(numElems);
         for (unsigned elemIdx = 0; elemIdx < numElems; ++elemIdx) {
             auto& elemParams = thermalConductionLawParams_[elemIdx];
@@ -269,6 +500,20 @@ private:
 
         const std::vector<double>& poroData = fieldProps.get_double("PORO");
 
+        if (useCompactStorage_) {
+            // the THC law does not depend on the fluid state, so the total thermal
+            // conductivity of each element can be computed upfront.
+            thcThermalConductivity_.resize(numElems);
+            for (unsigned elemIdx = 0; elemIdx < numElems; ++elemIdx)
+                thcThermalConductivity_[elemIdx] =
+                    ThcLaw::thermalConductivity(poroData[elemIdx],
+                                                thcrockData.empty() ? 0.0 : thcrockData[elemIdx],
+                                                thcoilData.empty() ? 0.0 : thcoilData[elemIdx],
+                                                thcgasData.empty() ? 0.0 : thcgasData[elemIdx],
+                                                thcwaterData.empty() ? 0.0 : thcwaterData[elemIdx]);
+            return;
+        }
+
         thermalConductionLawParams_.resize(numElems);
         for (unsigned elemIdx = 0; elemIdx < numElems; ++elemIdx) {
             auto& elemParams = thermalConductionLawParams_[elemIdx];
@@ -298,17 +543,117 @@ private:
         thermalConductivityApproach_ = ThermalConductionLawParams::nullApproach;
 
         thermalConductionLawParams_.resize(1);
+        thermalConductionLawParams_[0].setThermalConductionApproach(ThermalConductionLawParams::nullApproach);
         thermalConductionLawParams_[0].finalize();
     }
 
+    /*!
+     * \brief Create the per-element parameter objects of the HEATCR law from the
+     *        compact storage.
+     */
+    void createHeatcrParams_() const
+    {
+        size_t numElems = heatcrReferenceRockHeatCapacity_.size();
+        solidEnergyLawParams_.resize(numElems);
+        for (unsigned elemIdx = 0; elemIdx < numElems; ++elemIdx) {
+            auto& elemParam = solidEnergyLawParams_[elemIdx];
+            elemParam.setSolidEnergyApproach(SolidEnergyLawParams::heatcrApproach);
+            auto& heatcrElemParams = elemParam.template getRealParams<SolidEnergyLawParams::heatcrApproach>();
+
+            heatcrElemParams.setReferenceRockHeatCapacity(heatcrReferenceRockHeatCapacity_[elemIdx]);
+            heatcrElemParams.setDRockHeatCapacity_dT(heatcrDRockHeatCapacity_dT_[elemIdx]);
+            heatcrElemParams.finalize();
+            elemParam.finalize();
+        }
+    }
+
+    /*!
+     * \brief Create the per-element parameter objects of the thermal conduction law
+     *        from the compact storage.
+     *
+     * For the THC approach, only the total thermal conductivity is stored. The
+     * parameter objects thus specify a rock with zero porosity which exhibits this
+     * thermal conductivity. The result of the law is the same, but the parameters do
+     * not correspond to the THC* keywords.
+     */
+    void createThermalConductionParams_() const
+    {
+        if (thermalConductivityApproach_ == ThermalConductionLawParams::thconrApproach) {
+            size_t numElems = thconrReferenceThermalConductivity_.size();
+            thermalConductionLawParams_.resize(numElems);
+            for (unsigned elemIdx = 0; elemIdx < numElems; ++elemIdx) {
+                auto& elemParams = thermalConductionLawParams_[elemIdx];
+                elemParams.setThermalConductionApproach(ThermalConductionLawParams::thconrApproach);
+                auto& thconrElemParams = elemParams.template getRealParams<ThermalConductionLawParams::thconrApproach>();
+
+                thconrElemParams.setReferenceTotalThermalConductivity(thconrReferenceThermalConductivity_[elemIdx]);
+                thconrElemParams.setDTotalThermalConductivity_dSg(thconrDThermalConductivity_dSg_[elemIdx]);
+                thconrElemParams.finalize();
+                elemParams.finalize();
+            }
+            return;
+        }
+
+        assert(thermalConductivityApproach_ == ThermalConductionLawParams::thcApproach);
+        size_t numElems = thcThermalConductivity_.size();
+        thermalConductionLawParams_.resize(numElems);
+        for (unsigned elemIdx = 0; elemIdx < numElems; ++elemIdx) {
+            auto& elemParams = thermalConductionLawParams_[elemIdx];
+            elemParams.setThermalConductionApproach(ThermalConductionLawParams::thcApproach);
+            auto& thcElemParams = elemParams.template getRealParams<ThermalConductionLawParams::thcApproach>();
+
+            thcElemParams.setPorosity(0.0);
+            thcElemParams.setThcrock(thcThermalConductivity_[elemIdx]);
+            thcElemParams.setThcoil(0.0);
+            thcElemParams.setThcgas(0.0);
+            thcElemParams.setThcwater(0.0);
+            thcElemParams.finalize();
+            elemParams.finalize();
+        }
+    }
+
 private:
+    // std::once_flag can neither be copied nor moved. Copies of a manager thus start
+    // with fresh flags, i.e., they create their per-element parameter objects from the
+    // compact storage themselves when they are accessed for the first time.
+    struct CreationFlag_
+    {
+        CreationFlag_()
+            : flag(new std::once_flag)
+        {}
+
+        CreationFlag_(const CreationFlag_&)
+            : flag(new std::once_flag)
+        {}
+
+        CreationFlag_& operator=(const CreationFlag_&)
+        {
+            flag.reset(new std::once_flag);
+            return *this;
+        }
+
+        std::unique_ptr<std::once_flag> flag;
+    };
+
     typename ThermalConductionLawParams::ThermalConductionApproach thermalConductivityApproach_;
     typename SolidEnergyLawParams::SolidEnergyApproach solidEnergyApproach_;
+    bool useCompactStorage_;
 
     std::vector<unsigned> elemToSatnumIdx_;
 
-    std::vector<SolidEnergyLawParams> solidEnergyLawParams_;
-    std::vector<ThermalConductionLawParams> thermalConductionLawParams_;
+    // if compact storage is used, the per-element parameter objects are only created
+    // on demand
+    mutable std::vector<SolidEnergyLawParams> solidEnergyLawParams_;
+    mutable std::vector<ThermalConductionLawParams> thermalConductionLawParams_;
+    CreationFlag_ solidEnergyLawParamsCreated_;
+    CreationFlag_ thermalConductionLawParamsCreated_;
+
+    // compact storage of the per-element parameters
+    std::vector<Scalar> heatcrReferenceRockHeatCapacity_;
+    std::vector<Scalar> heatcrDRockHeatCapacity_dT_;
+    std::vector<Scalar> thconrReferenceThermalConductivity_;
+    std::vector<Scalar> thconrDThermalConductivity_dSg_;
+    std::vector<Scalar> thcThermalConductivity_;
 };
 } // namespace Ewoms
 
@@ -27,16 +27,339 @@
 #include <ewoms/common/densead/evaluation.hh>
 #include <ewoms/common/densead/math.hh>
 #include <ewoms/material/fluidstates/blackoilfluidstate.hh>
+#include <ewoms/material/fluidstates/leanblackoilfluidstate.hh>
+#include <ewoms/material/fluidstates/soafluidstatecontainer.hh>
 #include <ewoms/material/fluidsystems/blackoilfluidsystem.hh>
 #include <ewoms/material/checkfluidsystem.hh>
 
 #include <dune/common/parallel/mpihelper.hh>
 
+#include <iostream>
+#include <chrono>
+#include <vector>
+#include <memory>
+#include <cmath>
+#include <stdexcept>
+
 namespace Ewoms {
 namespace CO2DefaultTables {
 #include <ewoms/material/components/co2tables.inc.cc>
 }}
 
+// initialize the black-oil fluid system without an ECL deck: the water and oil phases
+// are slightly compressible, the gas phase is dry and no component dissolves in
+// another phase. the compressibilities and viscosities differ between the PVT regions.
+template <class Scalar>
+void initBlackOilFluidSystem(unsigned numPvtRegions = 1)
+{
+    typedef typename Ewoms::BlackOilFluidSystem<Scalar> FluidSystem;
+    typedef typename FluidSystem::GasPvt GasPvt;
+    typedef typename FluidSystem::OilPvt OilPvt;
+    typedef typename FluidSystem::WaterPvt WaterPvt;
+
+    const Scalar rhoRefOil = 800.0;
+    const Scalar rhoRefGas = 1.2;
+    const Scalar rhoRefWater = 1000.0;
+
+    FluidSystem::initBegin(numPvtRegions);
+    FluidSystem::setEnableDissolvedGas(false);
+    FluidSystem::setEnableVaporizedOil(false);
+    for (unsigned regionIdx = 0; regionIdx < numPvtRegions; ++regionIdx)
+        FluidSystem::setReferenceDensities(rhoRefOil, rhoRefWater, rhoRefGas, regionIdx);
+    FluidSystem::setReservoirTemperature(350.0);
+
+    auto gasPvt = std::make_shared<GasPvt>();
+    gasPvt->setApproach(GasPvt::DryGasPvt);
+    auto& dryGasPvt = gasPvt->template getRealPvt<GasPvt::DryGasPvt>();
+    dryGasPvt.setNumRegions(numPvtRegions);
+    for (unsigned regionIdx = 0; regionIdx < numPvtRegions; ++regionIdx) {
+        Scalar f = 1.0 + 0.1*regionIdx;
+        dryGasPvt.setReferenceDensities(regionIdx, rhoRefOil, rhoRefGas, rhoRefWater);
+        dryGasPvt.setGasFormationVolumeFactor(regionIdx, {{1e5, 1.0}, {1e7, f*1.2e-2}, {5e7, f*3e-3}});
+        typename Ewoms::DryGasPvt<Scalar>::TabulatedOneDFunction gasMu;
+        gasMu.setXYContainers(std::vector<Scalar>{1e5, 1e7, 5e7},
+                              std::vector<Scalar>{f*1.2e-5, f*1.6e-5, f*3e-5});
+        dryGasPvt.setGasViscosity(regionIdx, gasMu);
+    }
+    gasPvt->initEnd();
+
+    auto oilPvt = std::make_shared<OilPvt>();
+    oilPvt->setApproach(OilPvt::ConstantCompressibilityOilPvt);
+    auto& ccOilPvt = oilPvt->template getRealPvt<OilPvt::ConstantCompressibilityOilPvt>();
+    ccOilPvt.setNumRegions(numPvtRegions);
+    for (unsigned regionIdx = 0; regionIdx < numPvtRegions; ++regionIdx) {
+        Scalar f = 1.0 + 0.1*regionIdx;
+        ccOilPvt.setReferenceDensities(regionIdx, rhoRefOil, rhoRefGas, rhoRefWater);
+        ccOilPvt.setReferencePressure(regionIdx, 1e5);
+        ccOilPvt.setCompressibility(regionIdx, f*1e-9);
+        ccOilPvt.setViscosity(regionIdx, f*2e-3);
+    }
+    oilPvt->initEnd();
+
+    auto waterPvt = std::make_shared<WaterPvt>();
+    waterPvt->setApproach(WaterPvt::ConstantCompressibilityWaterPvt);
+    auto& ccWaterPvt = waterPvt->template getRealPvt<WaterPvt::ConstantCompressibilityWaterPvt>();
+    ccWaterPvt.setNumRegions(numPvtRegions);
+    for (unsigned regionIdx = 0; regionIdx < numPvtRegions; ++regionIdx) {
+        Scalar f = 1.0 + 0.1*regionIdx;
+        ccWaterPvt.setReferenceDensities(regionIdx, rhoRefOil, rhoRefGas, rhoRefWater);
+        ccWaterPvt.setReferencePressure(regionIdx, 1e5);
+        ccWaterPvt.setCompressibility(regionIdx, f*4e-10);
+        ccWaterPvt.setViscosity(regionIdx, f*5e-4);
+    }
+    waterPvt->initEnd();
+
+    FluidSystem::setGasPvt(gasPvt);
+    FluidSystem::setOilPvt(oilPvt);
+    FluidSystem::setWaterPvt(waterPvt);
+    FluidSystem::initEnd();
+}
+
+// make sure that black-oil fluid states can be stored by a structure-of-arrays container
+// even if they do not provide all quantities
+template <bool enableEnergy>
+void testSoaFluidStateContainer()
+{
+    typedef double Scalar;
+    typedef typename Ewoms::BlackOilFluidSystem<Scalar> FluidSystem;
+    typedef Ewoms::BlackOilFluidState<Scalar, FluidSystem, /*enableTemperature=*/true,
+                                      enableEnergy> FluidState;
+    typedef Ewoms::SoaFluidStateContainer<Scalar, FluidSystem> Container;
+
+    enum { numPhases = FluidSystem::numPhases };
+    enum { numComponents = FluidSystem::numComponents };
+
+    const unsigned numCells = 5;
+    Container container(numCells);
+    std::vector<FluidState> fluidStates(numCells);
+    for (unsigned cellIdx = 0; cellIdx < numCells; ++cellIdx) {
+        FluidState& fs = fluidStates[cellIdx];
+        fs.setPvtRegionIndex(0);
+        fs.setTemperature(300.0 + 10.0*cellIdx);
+        fs.setRs(0.0);
+        fs.setRv(0.0);
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+            fs.setPressure(phaseIdx, 1e6*(1.0 + cellIdx) + 1e4*phaseIdx);
+            fs.setSaturation(phaseIdx, 1.0/numPhases);
+        }
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+            fs.setInvB(phaseIdx, FluidSystem::inverseFormationVolumeFactor(fs, phaseIdx, /*regionIdx=*/0));
+            fs.setDensity(phaseIdx, FluidSystem::density(fs, phaseIdx, /*regionIdx=*/0));
+            if (enableEnergy)
+                fs.setEnthalpy(phaseIdx, 1e5*(1.0 + phaseIdx) + 1e3*cellIdx);
+        }
+
+        // the viscosities are not stored by the black-oil fluid state, so the values
+        // set here must be kept by assign()
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx)
+            container[cellIdx].setViscosity(phaseIdx, 1e-3);
+
+        container[cellIdx].assign(fs);
+    }
+
+    for (unsigned cellIdx = 0; cellIdx < numCells; ++cellIdx) {
+        const FluidState& fs = fluidStates[cellIdx];
+        const auto& view = container[cellIdx];
+
+        if (view.temperature(/*phaseIdx=*/0) != fs.temperature(/*phaseIdx=*/0))
+            throw std::logic_error("The temperature was not stored by the container");
+
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+            if (view.pressure(phaseIdx) != fs.pressure(phaseIdx)
+                || view.saturation(phaseIdx) != fs.saturation(phaseIdx)
+                || view.density(phaseIdx) != fs.density(phaseIdx))
+                throw std::logic_error("The pressures, saturations or densities were not stored by the container");
+
+            if (enableEnergy && view.enthalpy(phaseIdx) != fs.enthalpy(phaseIdx))
+                throw std::logic_error("The enthalpies were not stored by the container");
+            if (!enableEnergy && view.enthalpy(phaseIdx) != 0.0)
+                throw std::logic_error("The enthalpies must not be retrieved if energy is disabled");
+
+            if (view.viscosity(phaseIdx) != 1e-3)
+                throw std::logic_error("The viscosities must not be retrieved from a black-oil fluid state");
+
+            for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx)
+                if (view.moleFraction(phaseIdx, compIdx) != fs.moleFraction(phaseIdx, compIdx))
+                    throw std::logic_error("The mole fractions were not stored by the container");
+
+            Scalar M = fs.averageMolarMass(phaseIdx);
+            if (std::abs(view.averageMolarMass(phaseIdx) - M) > 1e-10*M)
+                throw std::logic_error("The average molar mass of the stored fluid state is wrong");
+        }
+    }
+}
+
+// compare the memory footprint and the cost of copying the full and the lean black-oil
+// fluid states
+template <class Evaluation>
+void compareLeanFluidState()
+{
+    typedef typename Ewoms::BlackOilFluidSystem<double> FluidSystem;
+    typedef Ewoms::BlackOilFluidState<Evaluation, FluidSystem, /*enableTemperature=*/true> FluidState;
+    typedef Ewoms::LeanBlackOilFluidState<Evaluation, FluidSystem, /*enableTemperature=*/true> LeanFluidState;
+    typedef Ewoms::LeanBlackOilFluidState<Evaluation, FluidSystem, /*enableTemperature=*/true,
+                                          /*enableEnergy=*/false, /*enableDissolution=*/true,
+                                          /*enableBrine=*/false, FluidSystem::numPhases,
+                                          /*memoizeInvB=*/false> NonMemoizingFluidState;
+
+    static_assert(sizeof(LeanFluidState) < sizeof(FluidState),
+                  "The lean fluid state must be smaller than the full one");
+    static_assert(sizeof(NonMemoizingFluidState) < sizeof(LeanFluidState),
+                  "Not memoizing the inverse formation volume factors must save memory");
+
+    // the inverse formation volume factors which are explicitly set must be used
+    LeanFluidState leanFs;
+    leanFs.setTemperature(300.0);
+    leanFs.setRs(10.0);
+    leanFs.setRv(0.0);
+    for (unsigned phaseIdx = 0; phaseIdx < FluidSystem::numPhases; ++phaseIdx) {
+        leanFs.setPressure(phaseIdx, 1e7);
+        leanFs.setSaturation(phaseIdx, 1.0/3);
+    }
+    for (unsigned phaseIdx = 0; phaseIdx < FluidSystem::numPhases; ++phaseIdx) {
+        if (leanFs.hasInvB(phaseIdx))
+            throw std::logic_error("The inverse formation volume factor must not be known before it is set");
+
+        leanFs.setInvB(phaseIdx, 1.0 + phaseIdx);
+        if (!leanFs.hasInvB(phaseIdx) || leanFs.invB(phaseIdx) != 1.0 + phaseIdx)
+            throw std::logic_error("The inverse formation volume factor which was set is not used");
+    }
+    leanFs.setPressure(FluidSystem::oilPhaseIdx, 2e7);
+    if (leanFs.hasInvB(FluidSystem::oilPhaseIdx) || !leanFs.hasInvB(FluidSystem::waterPhaseIdx))
+        throw std::logic_error("Changing the pressure of a phase must only invalidate its inverse formation volume factor");
+    leanFs.setRs(20.0);
+    if (leanFs.hasInvB(FluidSystem::waterPhaseIdx))
+        throw std::logic_error("Changing the composition must invalidate all inverse formation volume factors");
+
+    // the inverse formation volume factors which are computed lazily and the densities
+    // derived from them must be the ones of the fluid system and of the full fluid state
+    for (unsigned i = 0; i < 5; ++i) {
+        double p = 1e6 + i*1e7;
+        double T = 300.0 + i*10.0;
+
+        FluidState fullFs;
+        LeanFluidState memoizingFs;
+        NonMemoizingFluidState nonMemoizingFs;
+        fullFs.setPvtRegionIndex(0);
+        memoizingFs.setPvtRegionIndex(0);
+        nonMemoizingFs.setPvtRegionIndex(0);
+        fullFs.setTemperature(T);
+        memoizingFs.setTemperature(T);
+        nonMemoizingFs.setTemperature(T);
+        fullFs.setRs(0.0);
+        memoizingFs.setRs(0.0);
+        nonMemoizingFs.setRs(0.0);
+        fullFs.setRv(0.0);
+        memoizingFs.setRv(0.0);
+        nonMemoizingFs.setRv(0.0);
+        for (unsigned phaseIdx = 0; phaseIdx < FluidSystem::numPhases; ++phaseIdx) {
+            fullFs.setPressure(phaseIdx, p + phaseIdx*1e5);
+            memoizingFs.setPressure(phaseIdx, p + phaseIdx*1e5);
+            nonMemoizingFs.setPressure(phaseIdx, p + phaseIdx*1e5);
+            fullFs.setSaturation(phaseIdx, 1.0/3);
+            memoizingFs.setSaturation(phaseIdx, 1.0/3);
+            nonMemoizingFs.setSaturation(phaseIdx, 1.0/3);
+        }
+        for (unsigned phaseIdx = 0; phaseIdx < FluidSystem::numPhases; ++phaseIdx) {
+            fullFs.setInvB(phaseIdx, FluidSystem::inverseFormationVolumeFactor(fullFs, phaseIdx, /*regionIdx=*/0));
+            fullFs.setDensity(phaseIdx, FluidSystem::density(fullFs, phaseIdx, /*regionIdx=*/0));
+        }
+
+        for (unsigned phaseIdx = 0; phaseIdx < FluidSystem::numPhases; ++phaseIdx) {
+            Evaluation bRef =
+                FluidSystem::template inverseFormationVolumeFactor<LeanFluidState, Evaluation>(memoizingFs,
+                                                                                              phaseIdx,
+                                                                                              /*regionIdx=*/0);
+            double tol = 1e-12*std::abs(Ewoms::scalarValue(bRef));
+
+            // the first call computes the value, the second one uses the memoized one
+            for (unsigned j = 0; j < 2; ++j)
+                if (std::abs(Ewoms::scalarValue(memoizingFs.invB(phaseIdx) - bRef)) > tol)
+                    throw std::logic_error("The memoized inverse formation volume factor is wrong");
+            if (!memoizingFs.hasInvB(phaseIdx))
+                throw std::logic_error("The inverse formation volume factor must be known after it was requested");
+            if (std::abs(Ewoms::scalarValue(nonMemoizingFs.invB(phaseIdx) - bRef)) > tol
+                || std::abs(Ewoms::scalarValue(fullFs.invB(phaseIdx) - bRef)) > tol)
+                throw std::logic_error("The inverse formation volume factor is wrong");
+
+            const Evaluation& rhoRef = fullFs.density(phaseIdx);
+            double rhoTol = 1e-12*std::abs(Ewoms::scalarValue(rhoRef));
+            if (std::abs(Ewoms::scalarValue(memoizingFs.density(phaseIdx) - rhoRef)) > rhoTol
+                || std::abs(Ewoms::scalarValue(nonMemoizingFs.density(phaseIdx) - rhoRef)) > rhoTol)
+                throw std::logic_error("The density of the lean fluid state differs from the one of the full fluid state");
+        }
+    }
+
+    // measure the time needed to copy an array of fluid states, e.g., a cache of
+    // intensive quantities
+    const unsigned numCells = 100000;
+    std::vector<FluidState> fullStates(numCells), fullCopy(numCells);
+    std::vector<LeanFluidState> leanStates(numCells), leanCopy(numCells);
+
+    auto startTime = std::chrono::steady_clock::now();
+    fullCopy = fullStates;
+    auto midTime = std::chrono::steady_clock::now();
+    leanCopy = leanStates;
+    auto endTime = std::chrono::steady_clock::now();
+
+    std::cout << "black-oil fluid state: " << sizeof(FluidState) << " bytes (full) vs. "
+              << sizeof(LeanFluidState) << " bytes (lean) vs. "
+              << sizeof(NonMemoizingFluidState) << " bytes (lean, not memoizing); "
+              << std::chrono::duration<double, std::nano>(midTime - startTime).count()/numCells
+              << " ns (full) vs. "
+              << std::chrono::duration<double, std::nano>(endTime - midTime).count()/numCells
+              << " ns (lean) per copy\n";
+}
+
+// make sure that the batched evaluation of the PVT relations yields the same results as
+// evaluating them cell by cell, also if the cells of the PVT regions are interleaved
+void testBatchedPvtEvaluation()
+{
+    typedef double Scalar;
+    typedef typename Ewoms::BlackOilFluidSystem<Scalar> FluidSystem;
+    typedef Ewoms::BlackOilFluidState<Scalar, FluidSystem, /*enableTemperature=*/true> FluidState;
+
+    enum { numPhases = FluidSystem::numPhases };
+
+    const unsigned numCells = 20;
+    std::vector<unsigned> pvtRegionIdx(numCells);
+    std::vector<FluidState> fluidStates(numCells);
+    for (unsigned cellIdx = 0; cellIdx < numCells; ++cellIdx) {
+        pvtRegionIdx[cellIdx] = (cellIdx % 3 == 1)?1:0;
+
+        FluidState& fs = fluidStates[cellIdx];
+        fs.setPvtRegionIndex(pvtRegionIdx[cellIdx]);
+        fs.setTemperature(300.0 + 5.0*cellIdx);
+        fs.setRs(0.0);
+        fs.setRv(0.0);
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+            fs.setPressure(phaseIdx, 1e6 + 2e6*cellIdx + 1e4*phaseIdx);
+            fs.setSaturation(phaseIdx, 1.0/numPhases);
+        }
+    }
+    const Ewoms::RegionPermutation pvtRegions(pvtRegionIdx);
+
+    std::vector<Scalar> b(numCells), mu(numCells);
+    for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+        FluidSystem::inverseFormationVolumeFactors(b, fluidStates, phaseIdx, pvtRegions);
+        FluidSystem::viscosities(mu, fluidStates, phaseIdx, pvtRegions);
+
+        for (unsigned cellIdx = 0; cellIdx < numCells; ++cellIdx) {
+            const FluidState& fs = fluidStates[cellIdx];
+            unsigned regionIdx = pvtRegionIdx[cellIdx];
+
+            if (b[cellIdx] != FluidSystem::inverseFormationVolumeFactor(fs, phaseIdx, regionIdx))
+                throw std::logic_error("The batched inverse formation volume factor differs from the one of a single cell");
+            if (mu[cellIdx] != FluidSystem::viscosity(fs, phaseIdx, regionIdx))
+                throw std::logic_error("The batched viscosity differs from the one of a single cell");
+
+            // make sure that the PVT region of the cell is used
+            if (regionIdx == 1 && mu[cellIdx] == FluidSystem::viscosity(fs, phaseIdx, /*regionIdx=*/0))
+                throw std::logic_error("The batched viscosity does not use the PVT region of the cell");
+        }
+    }
+}
+
 int main()
 {
     {
@@ -69,5 +392,25 @@ int main()
         checkFluidState<Evaluation>(fs);
     }
 
+    {
+        typedef double Scalar;
+        typedef Ewoms::DenseAd::Evaluation<Scalar, 5> Evaluation;
+        typedef typename Ewoms::BlackOilFluidSystem<Scalar> FluidSystem;
+        typedef Ewoms::LeanBlackOilFluidState<Evaluation, FluidSystem> FluidState;
+
+        FluidState fs;
+        checkFluidState<Evaluation>(fs);
+    }
+
+    initBlackOilFluidSystem<double>();
+    testSoaFluidStateContainer</*enableEnergy=*/false>();
+    testSoaFluidStateContainer</*enableEnergy=*/true>();
+
+    compareLeanFluidState<double>();
+    compareLeanFluidState<Ewoms::DenseAd::Evaluation<double, 5> >();
+
+    initBlackOilFluidSystem<double>(/*numPvtRegions=*/2);
+    testBatchedPvtEvaluation();
+
     return 0;
 }
@@ -45,6 +45,13 @@
 
 #include <dune/common/parallel/mpihelper.hh>
 
+#include <iostream>
+#include <chrono>
+#include <type_traits>
+#include <stdexcept>
+#include <vector>
+#include <cmath>
+
 namespace Ewoms {
 namespace CO2DefaultTables {
 #include <ewoms/material/components/co2tables.inc.cc>
@@ -163,6 +170,273 @@ void ensurePvtApi(const BrinePvt& brinePvt, const Co2Pvt& co2Pvt)
     }
 }
 
+/*!
+ * \brief The density of CO2 saturated brine as it was computed before the density of
+ *        pure water was evaluated only once.
+ */
+template <class Evaluation, class Scalar>
+Evaluation unfusedBrineCo2Density(const Evaluation& T,
+                                  const Evaluation& pl,
+                                  const Evaluation& Rs,
+                                  Scalar rhoRefBrine,
+                                  Scalar rhoRefCo2)
+{
+    typedef Ewoms::SimpleHuDuanH2O<Scalar> H2O;
+    typedef Ewoms::Brine<Scalar, H2O> Brine;
+    typedef Ewoms::CO2<Scalar, Ewoms::CO2DefaultTables::CO2Tables> CO2;
+
+    const Scalar M_CO2 = CO2::molarMass();
+    const Scalar M_H2O = H2O::molarMass();
+
+    const Evaluation& XlCO2 = Rs*rhoRefCo2/(rhoRefBrine + Rs*rhoRefCo2);
+    const Evaluation& xlCO2 = XlCO2*M_H2O/(M_CO2*(1 - XlCO2) + XlCO2*M_H2O);
+
+    const Evaluation& rho_brine = Brine::liquidDensity(T, pl);
+    const Evaluation& rho_pure = H2O::liquidDensity(T, pl);
+
+    const Evaluation& tempC = T - 273.15;
+    const Evaluation& rho_pure2 = H2O::liquidDensity(T, pl);
+    const Evaluation& xlH2O = 1.0 - xlCO2;
+    const Evaluation& M_T = M_H2O*xlH2O + M_CO2*xlCO2;
+    const Evaluation& V_phi =
+        (37.51 + tempC*(-9.585e-2 + tempC*(8.74e-4 - tempC*5.044e-7)))/1.0e6;
+    const Evaluation& rho_lCO2 = 1/(xlCO2*V_phi/M_T + M_H2O*xlH2O/(rho_pure2*M_T));
+
+    return rho_brine + rho_lCO2 - rho_pure;
+}
+
+template <class Scalar>
+void benchmarkBrineDensity()
+{
+    typedef Ewoms::BrineCo2Pvt<Scalar> BrinePvt;
+    typedef Ewoms::DenseAd::Evaluation<Scalar, 3> Eval;
+
+    const Scalar rhoRefBrine = 1050.0;
+    const Scalar rhoRefCo2 = 1.8;
+    BrinePvt brinePvt(std::vector<Scalar>{rhoRefBrine},
+                      std::vector<Scalar>{rhoRefCo2},
+                      std::vector<Scalar>{0.1});
+    brinePvt.initEnd();
+
+    // the (T, p, Rs) triples for which the density of the brine is evaluated
+    const unsigned numPoints = 20000;
+    std::vector<Eval> T(numPoints), p(numPoints), Rs(numPoints);
+    for (unsigned i = 0; i < numPoints; ++i) {
+        T[i] = Eval::createVariable(300.0 + 60.0*(i % 97)/97.0, 0);
+        p[i] = Eval::createVariable(5e6 + 3e7*(i % 101)/101.0, 1);
+        Rs[i] = Eval::createVariable(20.0*(i % 89)/89.0, 2);
+    }
+
+    // make sure that the fused evaluation yields the same result as the old one
+    const Scalar tol = std::is_same<Scalar, float>::value ? 1e-5 : 1e-12;
+    for (unsigned i = 0; i < numPoints; ++i) {
+        const Eval& bFused = brinePvt.inverseFormationVolumeFactor(/*regionIdx=*/0, T[i], p[i], Rs[i]);
+        const Eval& bUnfused = unfusedBrineCo2Density(T[i], p[i], Rs[i], rhoRefBrine, rhoRefCo2)/rhoRefBrine;
+        for (int dirIdx = -1; dirIdx < 3; ++dirIdx) {
+            Scalar a = (dirIdx < 0) ? bFused.value() : bFused.derivative(dirIdx);
+            Scalar b = (dirIdx < 0) ? bUnfused.value() : bUnfused.derivative(dirIdx);
+            if (std::abs(a - b) > tol*std::max<Scalar>(std::abs(b), 1e-8))
+                throw std::logic_error("Fused and unfused brine densities differ");
+        }
+    }
+
+    // time both variants
+    Scalar sum = 0.0;
+    auto startTime = std::chrono::steady_clock::now();
+    for (unsigned i = 0; i < numPoints; ++i)
+        sum += unfusedBrineCo2Density(T[i], p[i], Rs[i], rhoRefBrine, rhoRefCo2).derivative(1);
+    auto midTime = std::chrono::steady_clock::now();
+    for (unsigned i = 0; i < numPoints; ++i)
+        sum -= brinePvt.inverseFormationVolumeFactor(/*regionIdx=*/0, T[i], p[i], Rs[i]).derivative(1)*rhoRefBrine;
+    auto endTime = std::chrono::steady_clock::now();
+
+    double unfusedTime = std::chrono::duration<double, std::nano>(midTime - startTime).count()/numPoints;
+    double fusedTime = std::chrono::duration<double, std::nano>(endTime - midTime).count()/numPoints;
+    std::cout << "brine-CO2 density: " << unfusedTime << " ns (unfused) vs. "
+              << fusedTime << " ns (fused) per evaluation"
+              << " (checksum: " << sum << ")\n";
+}
+
+template <class Scalar>
+void testSolubilityContext()
+{
+    typedef Ewoms::BrineCo2Pvt<Scalar> BrinePvt;
+    typedef typename BrinePvt::BinaryCoeffBrineCO2 BinaryCoeff;
+    typedef Ewoms::DenseAd::Evaluation<Scalar, 2> Eval;
+    typedef typename BinaryCoeff::template SolubilityContext<Eval> Context;
+
+    const Scalar tol = std::is_same<Scalar, float>::value ? 1e-4 : 1e-10;
+    const Scalar salinity = 0.1;
+    Context context;
+    for (Scalar T = 300.0; T < 380.0; T += 20.0) {
+        for (Scalar p = 5e6; p < 5e7; p += 1e7) {
+            const Eval& TEval = Eval::createVariable(T, 0);
+            const Eval& pEval = Eval::createVariable(p, 1);
+            context.update(TEval, pEval, salinity);
+
+            // the fused evaluation of the fugacity coefficients must yield the same
+            // result as the individual ones
+            const Eval& phiCO2 = BinaryCoeff::fugacityCoefficientCO2(TEval, pEval);
+            const Eval& phiH2O = BinaryCoeff::fugacityCoefficientH2O(TEval, pEval);
+            for (int dirIdx = -1; dirIdx < 2; ++dirIdx) {
+                Scalar a = (dirIdx < 0) ? context.fugacityCoefficientCO2().value() : context.fugacityCoefficientCO2().derivative(dirIdx);
+                Scalar b = (dirIdx < 0) ? phiCO2.value() : phiCO2.derivative(dirIdx);
+                if (std::abs(a - b) > tol*std::max<Scalar>(std::abs(b), 1e-20))
+                    throw std::logic_error("Fugacity coefficient of CO2 of the solubility context is wrong");
+
+                a = (dirIdx < 0) ? context.fugacityCoefficientH2O().value() : context.fugacityCoefficientH2O().derivative(dirIdx);
+                b = (dirIdx < 0) ? phiH2O.value() : phiH2O.derivative(dirIdx);
+                if (std::abs(a - b) > tol*std::max<Scalar>(std::abs(b), 1e-20))
+                    throw std::logic_error("Fugacity coefficient of H2O of the solubility context is wrong");
+            }
+
+            // the mole fractions must be the same as the ones of the caller-owned context
+            Eval xlCO2, ygH2O;
+            BinaryCoeff::calculateMoleFractions(TEval, pEval, salinity, /*knownPhaseIdx=*/-1, xlCO2, ygH2O);
+            if (!(xlCO2 == context.xlCO2()) || !(ygH2O == context.ygH2O()))
+                throw std::logic_error("Mole fractions of the solubility context are inconsistent");
+
+            Eval xlCO2Ctx, ygH2OCtx;
+            BinaryCoeff::calculateMoleFractions(context, /*knownPhaseIdx=*/-1, xlCO2Ctx, ygH2OCtx);
+            if (!(xlCO2Ctx == xlCO2) || !(ygH2OCtx == ygH2O))
+                throw std::logic_error("Mole fractions computed from a context are inconsistent");
+
+            // a context which is returned by value must not be affected by later calls
+            const Context& ownContext = BinaryCoeff::solubilityContext(TEval, pEval, salinity);
+            const Context& otherContext = BinaryCoeff::solubilityContext(Eval(T + 10.0), Eval(p), salinity);
+            if (!(ownContext.temperature() == TEval) || !(ownContext.pressure() == pEval)
+                || !(ownContext.xlCO2() == context.xlCO2()))
+                throw std::logic_error("The solubility context must be owned by the caller");
+            if (otherContext.temperature() == TEval)
+                throw std::logic_error("The solubility context must be updated");
+
+            // the fugacity coefficients can be computed without the mutual solubilities
+            Context fugacityContext;
+            fugacityContext.updateFugacityCoefficients(TEval, pEval);
+            if (fugacityContext.isValid()
+                || !(fugacityContext.fugacityCoefficientCO2() == context.fugacityCoefficientCO2())
+                || !(fugacityContext.fugacityCoefficientH2O() == context.fugacityCoefficientH2O()))
+                throw std::logic_error("The fugacity coefficients of the solubility context are wrong");
+            fugacityContext.update(TEval, pEval, salinity);
+            if (!fugacityContext.isValid() || !(fugacityContext.xlCO2() == context.xlCO2()))
+                throw std::logic_error("The solubilities of the solubility context are wrong");
+        }
+    }
+
+    // the PVT relations must yield the same results if the caller keeps the context
+    std::vector<Scalar> brineReferenceDensity = { 1050.0, 1100.0 };
+    std::vector<Scalar> co2ReferenceDensity = { 1.8, 1.8 };
+    std::vector<Scalar> regionSalinity = { 0.05, 0.15 };
+    BrinePvt brinePvt(brineReferenceDensity, co2ReferenceDensity, regionSalinity);
+    brinePvt.initEnd();
+
+    Context pvtContext;
+    for (unsigned regionIdx = 0; regionIdx < 2; ++regionIdx) {
+        for (Scalar T = 300.0; T < 380.0; T += 20.0) {
+            for (Scalar p = 5e6; p < 5e7; p += 1e7) {
+                const Eval& TEval = Eval::createVariable(T, 0);
+                const Eval& pEval = Eval::createVariable(p, 1);
+
+                const Eval& rsSat = brinePvt.saturatedGasDissolutionFactor(pvtContext, regionIdx, TEval, pEval);
+                if (!(pvtContext.temperature() == TEval) || pvtContext.salinity() != regionSalinity[regionIdx])
+                    throw std::logic_error("The caller-owned solubility context must be updated");
+                const Eval& bSat = brinePvt.saturatedInverseFormationVolumeFactor(pvtContext, regionIdx, TEval, pEval);
+                if (!(rsSat == brinePvt.saturatedGasDissolutionFactor(regionIdx, TEval, pEval))
+                    || !(bSat == brinePvt.saturatedInverseFormationVolumeFactor(regionIdx, TEval, pEval)))
+                    throw std::logic_error("The caller-owned solubility context changes the PVT relations");
+            }
+        }
+    }
+}
+
+template <class Scalar>
+void testTabulation()
+{
+    typedef Ewoms::BrineCo2Pvt<Scalar> BrinePvt;
+    typedef Ewoms::Co2GasPvt<Scalar> Co2Pvt;
+    typedef Ewoms::DenseAd::Evaluation<Scalar, 2> Eval;
+
+    // two regions with different salinities. note that the temperature range of the
+    // tables stays clear of the critical point of CO2 because the solubility of CO2
+    // exhibits a kink at its vapor pressure curve which cannot be resolved by the
+    // tables.
+    std::vector<Scalar> brineReferenceDensity = { 1050.0, 1100.0 };
+    std::vector<Scalar> co2ReferenceDensity = { 1.8, 1.8 };
+    std::vector<Scalar> salinity = { 0.05, 0.15 };
+
+    BrinePvt analyticBrinePvt(brineReferenceDensity, co2ReferenceDensity, salinity);
+    BrinePvt tabulatedBrinePvt(brineReferenceDensity, co2ReferenceDensity, salinity);
+    tabulatedBrinePvt.setTabulationRange(/*Tmin=*/310.0, /*Tmax=*/370.0, /*numT=*/61,
+                                         /*pmin=*/1e6, /*pmax=*/5e7, /*nump=*/99);
+    analyticBrinePvt.initEnd();
+    tabulatedBrinePvt.initEnd();
+
+    Co2Pvt analyticCo2Pvt(co2ReferenceDensity);
+    Co2Pvt tabulatedCo2Pvt(co2ReferenceDensity);
+    tabulatedCo2Pvt.setTabulationRange(/*Tmin=*/310.0, /*Tmax=*/370.0, /*numT=*/241,
+                                       /*pmin=*/1e6, /*pmax=*/5e7, /*nump=*/491);
+    analyticCo2Pvt.initEnd();
+    tabulatedCo2Pvt.initEnd();
+
+    if (analyticBrinePvt.isTabulated() || !tabulatedBrinePvt.isTabulated())
+        throw std::logic_error("Tabulation of the brine PVT not enabled as requested");
+
+    // the accuracy report
+    const Scalar tol = std::is_same<Scalar, float>::value ? 1e-2 : 5e-3;
+    for (unsigned regionIdx = 0; regionIdx < 2; ++regionIdx) {
+        const auto& err = tabulatedBrinePvt.tabulationError(regionIdx);
+        err.print(std::cout);
+        if (err.rsSat > tol || err.brineDensity > tol
+            || err.waterDensity > tol || err.brineViscosity > tol)
+            throw std::logic_error("Tabulated brine PVT is too inaccurate");
+    }
+    const auto& co2Err = tabulatedCo2Pvt.tabulationError();
+    co2Err.print(std::cout);
+    if (co2Err.viscosity > tol)
+        throw std::logic_error("Tabulated CO2 PVT is too inaccurate");
+
+    // compare the hot path with the analytic one, including the derivatives
+    for (unsigned regionIdx = 0; regionIdx < 2; ++regionIdx) {
+        for (Scalar T = 315.0; T < 370.0; T += 10.0) {
+            for (Scalar p = 2e6; p < 5e7; p += 7e6) {
+                Eval TEval = Eval::createVariable(T, 0);
+                Eval pEval = Eval::createVariable(p, 1);
+
+                const Eval& rsExact =
+                    analyticBrinePvt.saturatedGasDissolutionFactor(regionIdx, TEval, pEval);
+                const Eval& rsTab =
+                    tabulatedBrinePvt.saturatedGasDissolutionFactor(regionIdx, TEval, pEval);
+                if (std::abs(rsTab.value() - rsExact.value()) > tol*rsExact.value())
+                    throw std::logic_error("Tabulated rsSat deviates from the analytic one");
+                // the derivatives of the tables are the slopes of the secants between
+                // the sampling points, so we only check that they are propagated.
+                if (rsTab.derivative(1) <= 0.0 || rsExact.derivative(1) <= 0.0)
+                    throw std::logic_error("The solubility of CO2 must increase with pressure");
+
+                const Eval& Rs = 0.5*rsExact;
+                const Eval& bExact =
+                    analyticBrinePvt.inverseFormationVolumeFactor(regionIdx, TEval, pEval, Rs);
+                const Eval& bTab =
+                    tabulatedBrinePvt.inverseFormationVolumeFactor(regionIdx, TEval, pEval, Rs);
+                if (std::abs(bTab.value() - bExact.value()) > tol*bExact.value())
+                    throw std::logic_error("Tabulated brine FVF deviates from the analytic one");
+
+                const Eval& muExact = analyticCo2Pvt.viscosity(regionIdx, TEval, pEval, Eval(0.0));
+                const Eval& muTab = tabulatedCo2Pvt.viscosity(regionIdx, TEval, pEval, Eval(0.0));
+                if (std::abs(muTab.value() - muExact.value()) > tol*muExact.value())
+                    throw std::logic_error("Tabulated CO2 viscosity deviates from the analytic one");
+            }
+        }
+    }
+
+    // outside of the tabulated range, the analytic relations are used
+    Scalar T = 380.0;
+    Scalar p = 1e7;
+    if (tabulatedBrinePvt.saturatedGasDissolutionFactor(0, T, p)
+        != analyticBrinePvt.saturatedGasDissolutionFactor(0, T, p))
+        throw std::logic_error("The analytic rsSat must be used outside of the tabulated range");
+}
+
 template <class Scalar>
 inline void testAll()
 {
@@ -181,6 +455,32 @@ inline void testAll()
     typedef Ewoms::DenseAd::Evaluation<Scalar, 1> FooEval;
     ensurePvtApi<Scalar>(brinePvt, co2Pvt);
     ensurePvtApi<FooEval>(brinePvt, co2Pvt);
+
+    // the tables can be requested after the PVT relations have been initialized from
+    // the deck. they are part of the state of the PVT objects.
+    typedef Ewoms::GasPvtMultiplexer<Scalar> GasPvt;
+    typedef Ewoms::OilPvtMultiplexer<Scalar> OilPvt;
+    GasPvt tabulatedCo2Pvt(co2Pvt);
+    OilPvt tabulatedBrinePvt(brinePvt);
+    tabulatedCo2Pvt.setCo2TabulationRange(/*Tmin=*/310.0, /*Tmax=*/370.0, /*numT=*/31,
+                                          /*pmin=*/1e6, /*pmax=*/5e7, /*nump=*/50);
+    tabulatedBrinePvt.setCo2TabulationRange(/*Tmin=*/310.0, /*Tmax=*/370.0, /*numT=*/31,
+                                            /*pmin=*/1e6, /*pmax=*/5e7, /*nump=*/50);
+
+    const auto& analyticCo2 = co2Pvt.template getRealPvt<GasPvt::Co2GasPvt>();
+    const auto& analyticBrine = brinePvt.template getRealPvt<OilPvt::BrineCo2Pvt>();
+    const auto& tabulatedCo2 = tabulatedCo2Pvt.template getRealPvt<GasPvt::Co2GasPvt>();
+    const auto& tabulatedBrine = tabulatedBrinePvt.template getRealPvt<OilPvt::BrineCo2Pvt>();
+    if (!tabulatedCo2.isTabulated() || !tabulatedBrine.isTabulated())
+        throw std::logic_error("Tabulation of the CO2 PVT not enabled as requested");
+    if (tabulatedCo2 == analyticCo2 || tabulatedBrine == analyticBrine)
+        throw std::logic_error("Tabulated and analytic PVT objects must not compare equal");
+
+    GasPvt copiedCo2Pvt(tabulatedCo2Pvt);
+    OilPvt copiedBrinePvt(tabulatedBrinePvt);
+    if (!(copiedCo2Pvt.template getRealPvt<GasPvt::Co2GasPvt>() == tabulatedCo2)
+        || !(copiedBrinePvt.template getRealPvt<OilPvt::BrineCo2Pvt>() == tabulatedBrine))
+        throw std::logic_error("Copies of the tabulated PVT objects must compare equal");
 }
 
 int main(int argc, char **argv)
@@ -190,5 +490,14 @@ int main(int argc, char **argv)
     testAll<double>();
     testAll<float>();
 
+    testSolubilityContext<double>();
+    testSolubilityContext<float>();
+
+    testTabulation<double>();
+    testTabulation<float>();
+
+    benchmarkBrineDensity<double>();
+    benchmarkBrineDensity<float>();
+
     return 0;
 }
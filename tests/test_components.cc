@@ -60,6 +60,9 @@ namespace ComponentsTest {
 
 #include <dune/common/parallel/mpihelper.hh>
 
+#include <array>
+#include <type_traits>
+
 template <class Scalar, class Evaluation>
 void testSimpleH2O()
 {
@@ -107,10 +110,310 @@ void testAllComponents()
     checkComponent<Ewoms::SimpleCO2<Scalar>, Evaluation>();
     checkComponent<Ewoms::SimpleH2O<Scalar>, Evaluation>();
     checkComponent<Ewoms::TabulatedComponent<Scalar, H2O>, Evaluation>();
+    checkComponent<Ewoms::TabulatedComponent<Scalar, Ewoms::N2<Scalar>, false>, Evaluation>();
     checkComponent<Ewoms::Unit<Scalar>, Evaluation>();
     checkComponent<Ewoms::Xylene<Scalar>, Evaluation>();
 }
 
+// make sure that components without a liquid phase and supercritical components can be
+// tabulated
+template <class Scalar>
+void testGenericTabulation()
+{
+    typedef Ewoms::DenseAd::Evaluation<Scalar, 2> Evaluation;
+    typedef Ewoms::N2<Scalar> N2;
+    typedef Ewoms::TabulatedComponent<Scalar, N2, /*useVaporPressure=*/false> TabulatedN2;
+    typedef Ewoms::CO2<Scalar, Ewoms::ComponentsTest::CO2Tables> CO2;
+    typedef Ewoms::TabulatedComponent<Scalar, CO2> TabulatedCO2;
+
+    // the temperature range of the CO2 table is above the critical temperature
+    TabulatedN2::init(/*tempMin=*/280.0, /*tempMax=*/400.0, /*nTemp=*/100,
+                      /*pressMin=*/1e5, /*pressMax=*/2e7, /*nPress=*/200);
+    TabulatedCO2::init(/*tempMin=*/320.0, /*tempMax=*/400.0, /*nTemp=*/100,
+                       /*pressMin=*/1e5, /*pressMax=*/2e7, /*nPress=*/200);
+
+    for (Scalar T = 325.0; T < 395.0; T += 7.3) {
+        for (Scalar p = 2e5; p < 1.9e7; p *= 1.7) {
+            const Evaluation& TEval = Evaluation::createVariable(T, 0);
+            const Evaluation& pEval = Evaluation::createVariable(p, 1);
+
+            const Evaluation& rhoN2 = TabulatedN2::gasDensity(TEval, pEval);
+            const Evaluation& rhoN2Ref = N2::gasDensity(TEval, pEval);
+            if (std::abs(rhoN2.value()/rhoN2Ref.value() - 1) > 1e-3
+                || std::abs(rhoN2.derivative(1)/rhoN2Ref.derivative(1) - 1) > 1e-2)
+                throw std::logic_error("The tabulated density of nitrogen is inaccurate");
+
+            Scalar muN2 = TabulatedN2::gasViscosity(T, p);
+            Scalar muN2Ref = N2::gasViscosity(T, p);
+            if (std::abs(muN2/muN2Ref - 1) > 1e-3)
+                throw std::logic_error("The tabulated viscosity of nitrogen is inaccurate");
+
+            Scalar rhoCO2 = TabulatedCO2::gasDensity(T, p);
+            Scalar rhoCO2Ref = CO2::gasDensity(T, p);
+            if (std::abs(rhoCO2/rhoCO2Ref - 1) > 2e-2)
+                throw std::logic_error("The tabulated density of supercritical CO2 is inaccurate");
+
+            Scalar hCO2 = TabulatedCO2::gasEnthalpy(T, p);
+            Scalar hCO2Ref = CO2::gasEnthalpy(T, p);
+            if (std::abs(hCO2 - hCO2Ref) > 1e-2*std::abs(hCO2Ref))
+                throw std::logic_error("The tabulated enthalpy of supercritical CO2 is inaccurate");
+        }
+    }
+
+    // quantities which are not provided by the raw component are not tabulated
+    bool thrown = false;
+    try { TabulatedN2::liquidDensity(Scalar(300.0), Scalar(1e5)); }
+    catch (const std::exception&) { thrown = true; }
+    if (!thrown)
+        throw std::logic_error("The liquid density of tabulated nitrogen must not be available");
+}
+
+// returns the largest relative errors of the tabulated gas density, gas enthalpy,
+// liquid density and liquid enthalpy of water close to the vapor pressure. only the
+// temperature sampling points are considered, i.e., the errors are caused by the
+// interpolation along the pressure axis.
+template <class Scalar, class TabulatedH2O>
+std::array<Scalar, 4> tabulationErrorsNearVaporPressure(Scalar tempMin, Scalar tempMax, unsigned nTemp)
+{
+    typedef Ewoms::H2O<Scalar> H2O;
+
+    std::array<Scalar, 4> errors = {{ 0.0, 0.0, 0.0, 0.0 }};
+    for (unsigned iT = 1; iT < nTemp - 1; ++iT) {
+        Scalar T = tempMin + iT*(tempMax - tempMin)/(nTemp - 1);
+        Scalar pv = H2O::vaporPressure(T);
+        for (unsigned i = 0; i < 50; ++i) {
+            Scalar pg = pv*(0.80 + 0.19*i/49);
+            Scalar pl = pv*(1.01 + 0.24*i/49);
+            errors[0] = std::max(errors[0], std::abs(TabulatedH2O::gasDensity(T, pg)/H2O::gasDensity(T, pg) - 1));
+            errors[1] = std::max(errors[1], std::abs(TabulatedH2O::gasEnthalpy(T, pg)/H2O::gasEnthalpy(T, pg) - 1));
+            errors[2] = std::max(errors[2], std::abs(TabulatedH2O::liquidDensity(T, pl)/H2O::liquidDensity(T, pl) - 1));
+            errors[3] = std::max(errors[3], std::abs(TabulatedH2O::liquidEnthalpy(T, pl)/H2O::liquidEnthalpy(T, pl) - 1));
+        }
+    }
+
+    return errors;
+}
+
+// returns the largest relative errors of the tabulated gas density, gas enthalpy,
+// liquid density and liquid enthalpy of water on the whole tabulated range. the
+// positions are located between the sampling points of both axes.
+template <class Scalar, class TabulatedH2O>
+std::array<Scalar, 4> tabulationErrors(Scalar tempMin, Scalar tempMax, Scalar pressMin, Scalar pressMax)
+{
+    typedef Ewoms::H2O<Scalar> H2O;
+
+    std::array<Scalar, 4> errors = {{ 0.0, 0.0, 0.0, 0.0 }};
+    const unsigned n = 97;
+    for (unsigned iT = 0; iT < n; ++iT) {
+        Scalar T = tempMin + (iT + 0.5)*(tempMax - tempMin)/n;
+        Scalar pv = H2O::vaporPressure(T);
+        for (unsigned iP = 0; iP < n; ++iP) {
+            Scalar u = (iP + 0.5)/n;
+            Scalar pg = pressMin + u*(pv - pressMin);
+            Scalar pl = pv + u*(pressMax - pv);
+            errors[0] = std::max(errors[0], std::abs(TabulatedH2O::gasDensity(T, pg)/H2O::gasDensity(T, pg) - 1));
+            errors[1] = std::max(errors[1], std::abs(TabulatedH2O::gasEnthalpy(T, pg)/H2O::gasEnthalpy(T, pg) - 1));
+            errors[2] = std::max(errors[2], std::abs(TabulatedH2O::liquidDensity(T, pl)/H2O::liquidDensity(T, pl) - 1));
+            errors[3] = std::max(errors[3], std::abs(TabulatedH2O::liquidEnthalpy(T, pl)/H2O::liquidEnthalpy(T, pl) - 1));
+        }
+    }
+
+    return errors;
+}
+
+// make sure that grading the pressure axis towards the vapor pressure allows to use
+// smaller tables without losing accuracy close to the phase boundary and that it does
+// not make tables of the same size less accurate on the whole range. the gain of the
+// smaller tables is limited to the band around the vapor pressure: on the whole range,
+// they are in general less accurate than the larger uniform ones.
+template <class Scalar>
+void testGradedTabulation()
+{
+    typedef Ewoms::H2O<Scalar> H2O;
+    typedef Ewoms::TabulatedComponent<Scalar, H2O> TabulatedH2O;
+
+    const Scalar tempMin = 280.0;
+    const Scalar tempMax = 620.0;
+    const unsigned nTemp = 50;
+    const Scalar pressMin = 1e3;
+    const Scalar pressMax = 2e7;
+
+    // compare tables of the same size on the whole range
+    TabulatedH2O::init(tempMin, tempMax, nTemp, pressMin, pressMax, /*nPress=*/25);
+    const auto& uniformRangeErrors = tabulationErrors<Scalar, TabulatedH2O>(tempMin, tempMax, pressMin, pressMax);
+
+    TabulatedH2O::init(tempMin, tempMax, nTemp, pressMin, pressMax, /*nPress=*/25,
+                       /*pressureGrading=*/0.8);
+    const auto& gradedRangeErrors = tabulationErrors<Scalar, TabulatedH2O>(tempMin, tempMax, pressMin, pressMax);
+
+    // with this resolution of the temperature axis, the errors of the liquid are
+    // dominated by the interpolation along the temperature axis. if the temperature
+    // axis is much finer, the uniform tables of the liquid are more accurate. in single
+    // precision, the errors also include the rounding errors of the raw component.
+    const Scalar slack = std::is_same<Scalar, float>::value ? 1e-3 : 0.0;
+    for (unsigned i = 0; i < gradedRangeErrors.size(); ++i) {
+        if (gradedRangeErrors[i] > uniformRangeErrors[i] + slack)
+            throw std::logic_error("The graded table is less accurate than the uniform one of the same size");
+    }
+
+    // compare a graded table with half the pressure sampling points only close to the
+    // vapor pressure
+    TabulatedH2O::init(tempMin, tempMax, nTemp, pressMin, pressMax, /*nPress=*/50);
+    const auto& uniformErrors = tabulationErrorsNearVaporPressure<Scalar, TabulatedH2O>(tempMin, tempMax, nTemp);
+
+    TabulatedH2O::init(tempMin, tempMax, nTemp, pressMin, pressMax, /*nPress=*/25,
+                       /*pressureGrading=*/0.8);
+    const auto& gradedErrors = tabulationErrorsNearVaporPressure<Scalar, TabulatedH2O>(tempMin, tempMax, nTemp);
+
+    if (gradedErrors[0] > uniformErrors[0] || gradedErrors[1] > uniformErrors[1])
+        throw std::logic_error("The graded table of the gas phase is less accurate than the uniform one");
+
+    // the properties of the liquid are almost linear in pressure
+    if (gradedErrors[2] > 5e-4 || gradedErrors[3] > 5e-4)
+        throw std::logic_error("The graded table of the liquid phase is inaccurate");
+
+    bool thrown = false;
+    try { TabulatedH2O::init(tempMin, tempMax, nTemp, 1e3, 2e7, 25, /*pressureGrading=*/1.0); }
+    catch (const std::invalid_argument&) { thrown = true; }
+    if (!thrown)
+        throw std::logic_error("Invalid grading factors must be rejected");
+}
+
+// make sure that the tabulated saturation curve of water is consistent with the
+// equations of IAPWS '97 in both directions
+template <class Scalar>
+void testSaturationTables()
+{
+    typedef Ewoms::DenseAd::Evaluation<Scalar, 1> Evaluation;
+    typedef Ewoms::H2O<Scalar> H2O;
+    typedef Ewoms::IAPWS::Region4<Scalar> Region4;
+    typedef Ewoms::TabulatedComponent<Scalar, H2O> TabulatedH2O;
+
+    const Scalar tolerance = std::is_same<Scalar, float>::value ? 1e-3 : 1e-7;
+
+    // the vapor pressure of tabulated components does not depend on the resolution of
+    // the temperature axis
+    TabulatedH2O::init(/*tempMin=*/280.0, /*tempMax=*/620.0, /*nTemp=*/20,
+                       /*pressMin=*/1e3, /*pressMax=*/2e7, /*nPress=*/20);
+    // the tolerance of the table applies to each temperature, i.e., the vapor pressure
+    // must also be accurate where it is small
+    for (Scalar T = 285.0; T < 615.0; T += 3.7) {
+        if (std::abs(TabulatedH2O::vaporPressure(T)/Region4::saturationPressure(T) - 1) > tolerance)
+            throw std::logic_error("The vapor pressure of tabulated water is inaccurate");
+    }
+
+    H2O::initSaturationTables();
+    if (H2O::vaporPressureTable().numSamples() == 0 || H2O::vaporTemperatureTable().numSamples() == 0)
+        throw std::logic_error("The saturation curve of water could not be tabulated");
+
+    for (Scalar T = 275.0; T < 645.0; T += 3.7) {
+        const Evaluation& TEval = Evaluation::createVariable(T, 0);
+
+        const Evaluation& pv = H2O::vaporPressure(TEval);
+        const Evaluation& pvRef = Region4::saturationPressure(TEval);
+        if (std::abs(pv.value()/pvRef.value() - 1) > tolerance
+            || std::abs(pv.derivative(0)/pvRef.derivative(0) - 1) > 10*tolerance)
+            throw std::logic_error("The tabulated vapor pressure of water is inaccurate");
+
+        const Evaluation& pEval = Evaluation::createVariable(pvRef.value(), 0);
+        const Evaluation& Tsat = H2O::vaporTemperature(pEval);
+        const Evaluation& TsatRef = Region4::vaporTemperature(pEval);
+        if (std::abs(Tsat.value()/TsatRef.value() - 1) > tolerance
+            || std::abs(Tsat.derivative(0)/TsatRef.derivative(0) - 1) > 10*tolerance)
+            throw std::logic_error("The tabulated saturation temperature of water is inaccurate");
+
+        // both directions must be the inverse of each other
+        if (std::abs(H2O::vaporTemperature(pv.value())/T - 1) > tolerance)
+            throw std::logic_error("The tabulated saturation curve of water is inconsistent");
+
+        if (TabulatedH2O::vaporTemperature(pv.value()) != H2O::vaporTemperature(pv.value()))
+            throw std::logic_error("The saturation temperature of tabulated water must be the one of water");
+    }
+}
+
+// make sure that the temperature computed from the specific energies is consistent with
+// the energies computed from the temperature
+template <class Scalar>
+void testTemperatureFromEnergy()
+{
+    typedef Ewoms::DenseAd::Evaluation<Scalar, 2> Evaluation;
+    typedef Ewoms::H2O<Scalar> H2O;
+    typedef Ewoms::Brine<Scalar, H2O> Brine;
+    typedef Ewoms::TabulatedComponent<Scalar, H2O> TabulatedH2O;
+
+    const Scalar tolerance = std::is_same<Scalar, float>::value ? 1e-3 : 1e-8;
+
+    TabulatedH2O::init(/*tempMin=*/280.0, /*tempMax=*/620.0, /*nTemp=*/100,
+                       /*pressMin=*/1e3, /*pressMax=*/2e7, /*nPress=*/100);
+
+    for (Scalar p = 2e3; p < 1.5e7; p *= 2.3) {
+        Scalar Tsat = H2O::vaporTemperature(p);
+        for (Scalar T = 285.0; T < 615.0; T += 6.1) {
+            // the phase state is ambiguous close to the saturation temperature
+            if (std::abs(T - Tsat) < 1.0)
+                continue;
+
+            const Evaluation& TEval = Evaluation::createVariable(T, 0);
+            const Evaluation& pEval = Evaluation::createVariable(p, 1);
+
+            // the derivatives of the result w.r.t. the temperature must be one and the
+            // ones w.r.t. pressure must vanish
+            const Evaluation& h =
+                (T < Tsat) ? H2O::liquidEnthalpy(TEval, pEval) : H2O::gasEnthalpy(TEval, pEval);
+            const Evaluation& TFromH = H2O::temperatureFromEnthalpy(h, pEval);
+            if (std::abs(TFromH.value() - T) > tolerance*T
+                || std::abs(TFromH.derivative(0) - 1) > 1e2*tolerance
+                || std::abs(TFromH.derivative(1))*p > 1e2*tolerance*T)
+                throw std::logic_error("The temperature of water computed from the enthalpy is inaccurate");
+
+            const Evaluation& u =
+                (T < Tsat) ? H2O::liquidInternalEnergy(TEval, pEval) : H2O::gasInternalEnergy(TEval, pEval);
+            const Evaluation& TFromU = H2O::temperatureFromInternalEnergy(u, pEval);
+            if (std::abs(TFromU.value() - T) > tolerance*T
+                || std::abs(TFromU.derivative(0) - 1) > 1e2*tolerance
+                || std::abs(TFromU.derivative(1))*p > 1e2*tolerance*T)
+                throw std::logic_error("The temperature of water computed from the internal energy is inaccurate");
+
+            // a warm start must not change the result
+            Scalar TWarm = H2O::temperatureFromEnthalpy(h.value(), p, /*temperatureGuess=*/T + 2.0);
+            if (std::abs(TWarm - T) > tolerance*T)
+                throw std::logic_error("The temperature of water computed using a warm start is inaccurate");
+
+            // the tabulated component must be consistent with its tables
+            Scalar hTab = (T < Tsat) ? TabulatedH2O::liquidEnthalpy(T, p) : TabulatedH2O::gasEnthalpy(T, p);
+            if (std::abs(TabulatedH2O::temperatureFromEnthalpy(hTab, p) - T) > tolerance*T)
+                throw std::logic_error("The temperature of tabulated water computed from the enthalpy is inaccurate");
+
+            if (T < Tsat) {
+                Scalar hBrine = Brine::liquidEnthalpy(T, p);
+                if (std::abs(Brine::temperatureFromEnthalpy(hBrine, p) - T) > tolerance*T)
+                    throw std::logic_error("The temperature of brine computed from the enthalpy is inaccurate");
+
+                Scalar uBrine = Brine::liquidInternalEnergy(T, p);
+                if (std::abs(Brine::temperatureFromInternalEnergy(uBrine, p) - T) > tolerance*T)
+                    throw std::logic_error("The temperature of brine computed from the internal energy is inaccurate");
+            }
+        }
+    }
+
+    // if liquid and steam coexist, the temperature is the saturation temperature
+    const Evaluation& p = Evaluation::createVariable(1e6, 1);
+    const Evaluation& Tsat = H2O::vaporTemperature(p);
+    const Evaluation& hLiquid = H2O::liquidEnthalpy(Tsat, p);
+    const Evaluation& hGas = H2O::gasEnthalpy(Tsat, p);
+    const Evaluation& TTwoPhase = H2O::temperatureFromEnthalpy((hLiquid + hGas)/2, p);
+    if (std::abs(TTwoPhase.value() - Tsat.value()) > tolerance*Tsat.value()
+        || std::abs(TTwoPhase.derivative(1) - Tsat.derivative(1)) > tolerance*std::abs(Tsat.derivative(1)))
+        throw std::logic_error("The temperature of saturated water must be the saturation temperature");
+
+    // enthalpies which cannot be attained by liquid water must be rejected
+    bool thrown = false;
+    try { H2O::liquidTemperatureFromEnthalpy(Scalar(1e7), Scalar(1e6)); }
+    catch (const Ewoms::NumericalIssue&) { thrown = true; }
+    if (!thrown)
+        throw std::logic_error("Enthalpies which cannot be attained must be rejected");
+}
+
 template <class Scalar>
 inline void testAll()
 {
@@ -120,6 +423,10 @@ inline void testAll()
     testAllComponents<Scalar, Scalar>();
     testAllComponents<Scalar, Evaluation>();
     testSimpleH2O<Scalar, Evaluation>();
+    testGenericTabulation<Scalar>();
+    testGradedTabulation<Scalar>();
+    testSaturationTables<Scalar>();
+    testTemperatureFromEnergy<Scalar>();
 
 }
 
@@ -40,6 +40,10 @@
 
 #include <dune/common/parallel/mpihelper.hh>
 
+#include <array>
+#include <string>
+#include <vector>
+
 // values of strings taken from the SPE1 test case1 of opm-data
 static const char* fam1DeckString =
     "RUNSPEC\n"
@@ -407,6 +411,68 @@ static const char* fam2DeckStringGasOil =
     "0.999  1       \n"
     "1.0    1       \n /\n";
 
+// two saturation regions with different endpoints and endpoint scaling enabled
+static const char* twoRegionDeckString =
+    "RUNSPEC\n"
+    "\n"
+    "DIMENS\n"
+    "   10 10 3 /\n"
+    "\n"
+    "TABDIMS\n"
+    "   2 /\n"
+    "\n"
+    "OIL\n"
+    "GAS\n"
+    "WATER\n"
+    "\n"
+    "ENDSCALE\n"
+    "/\n"
+    "\n"
+    "FIELD\n"
+    "\n"
+    "GRID\n"
+    "\n"
+    "DX\n"
+    "       300*1000 /\n"
+    "DY\n"
+    "   300*1000 /\n"
+    "DZ\n"
+    "   100*20 100*30 100*50 /\n"
+    "\n"
+    "TOPS\n"
+    "   100*8325 /\n"
+    "\n"
+    "PORO\n"
+    "  300*0.15 /\n"
+    "PROPS\n"
+    "\n"
+    "SWOF\n"
+    "0.12   0       1       4\n"
+    "0.2    0       0.9     2\n"
+    "0.5    0.2     0.2     1\n"
+    "0.8    0.6     0       0.5\n"
+    "1      1       0       0 /\n"
+    "0.25   0       1       6\n"
+    "0.35   0       0.8     3\n"
+    "0.6    0.3     0.1     1\n"
+    "0.7    0.5     0       0.5\n"
+    "1      0.9     0       0 /\n"
+    "\n"
+    "SGOF\n"
+    "0      0       1       0\n"
+    "0.05   0       0.9     0.1\n"
+    "0.5    0.4     0.1     0.5\n"
+    "0.88   0.9     0       1 /\n"
+    "0      0       1       0\n"
+    "0.1    0       0.8     0.2\n"
+    "0.4    0.3     0.2     0.6\n"
+    "0.75   0.8     0       1 /\n"
+    "\n"
+    "REGIONS\n"
+    "\n"
+    "SATNUM\n"
+    "   150*1 150*2 /\n";
+
 template <class Scalar>
 inline void testAll()
 {
@@ -454,6 +520,195 @@ inline void testAll()
         if (materialLawManager.enableHysteresis())
             throw std::logic_error("Discrepancy between the deck and the EclMaterialLawManager");
 
+        // make sure that the region-sorted batched evaluation yields the same results as
+        // evaluating the material laws element by element
+        {
+            std::vector<FluidState> fluidStates(n);
+            for (unsigned elemIdx = 0; elemIdx < n; ++ elemIdx) {
+                Scalar Sw = Scalar(elemIdx % 10)/10;
+                fluidStates[elemIdx].setSaturation(waterPhaseIdx, Sw);
+                fluidStates[elemIdx].setSaturation(oilPhaseIdx, 1 - Sw);
+                fluidStates[elemIdx].setSaturation(gasPhaseIdx, 0.0);
+            }
+
+            std::vector<std::array<Scalar, numPhases> > pcBatched(n);
+            std::vector<std::array<Scalar, numPhases> > krBatched(n);
+            materialLawManager.capillaryPressures(pcBatched, fluidStates);
+            materialLawManager.relativePermeabilities(krBatched, fluidStates);
+
+            for (unsigned elemIdx = 0; elemIdx < n; ++ elemIdx) {
+                std::array<Scalar, numPhases> pc;
+                std::array<Scalar, numPhases> kr;
+                MaterialLaw::capillaryPressures(pc,
+                                                materialLawManager.materialLawParams(elemIdx),
+                                                fluidStates[elemIdx]);
+                MaterialLaw::relativePermeabilities(kr,
+                                                    materialLawManager.materialLawParams(elemIdx),
+                                                    fluidStates[elemIdx]);
+                for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++ phaseIdx) {
+                    if (pc[phaseIdx] != pcBatched[elemIdx][phaseIdx])
+                        throw std::logic_error("Batched capillary pressure differs from the one of a single element");
+                    if (kr[phaseIdx] != krBatched[elemIdx][phaseIdx])
+                        throw std::logic_error("Batched relative permeability differs from the one of a single element");
+                }
+            }
+
+            // the deck does not use endpoint scaling, so a manager which resolves the
+            // scaling variants at compile time must yield the same results
+            typedef Ewoms::EclMaterialLawManager<MaterialTraits,
+                                                 Ewoms::EclEpsDisabledPolicy,
+                                                 Ewoms::EclEpsDisabledPolicy> StaticMaterialLawManager;
+            StaticMaterialLawManager staticMaterialLawManager;
+            staticMaterialLawManager.initFromEclState(eclState);
+            staticMaterialLawManager.initParamsForElements(eclState, n);
+
+            std::vector<std::array<Scalar, numPhases> > pcStatic(n);
+            std::vector<std::array<Scalar, numPhases> > krStatic(n);
+            staticMaterialLawManager.capillaryPressures(pcStatic, fluidStates);
+            staticMaterialLawManager.relativePermeabilities(krStatic, fluidStates);
+            for (unsigned elemIdx = 0; elemIdx < n; ++ elemIdx) {
+                for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++ phaseIdx) {
+                    if (pcStatic[elemIdx][phaseIdx] != pcBatched[elemIdx][phaseIdx]
+                        || krStatic[elemIdx][phaseIdx] != krBatched[elemIdx][phaseIdx])
+                        throw std::logic_error("The compile-time endpoint scaling policy yields different results");
+                }
+            }
+
+            // policies which do not match the deck must be rejected
+            typedef Ewoms::EclEpsStaticPolicy</*satScaling=*/true,
+                                              /*threePointKrSatScaling=*/false,
+                                              /*pcScaling=*/false,
+                                              /*leverettScaling=*/false,
+                                              /*krwScaling=*/false,
+                                              /*krnScaling=*/false> SatScalingPolicy;
+            Ewoms::EclMaterialLawManager<MaterialTraits,
+                                         SatScalingPolicy,
+                                         Ewoms::EclEpsDisabledPolicy> mismatchedMaterialLawManager;
+            bool mismatchDetected = false;
+            try {
+                mismatchedMaterialLawManager.initFromEclState(eclState);
+            }
+            catch (const std::runtime_error&) {
+                mismatchDetected = true;
+            }
+            if (!mismatchDetected)
+                throw std::logic_error("An endpoint scaling policy which does not match the deck was accepted");
+        }
+
+        // make sure that the tables for the power function of the extended Stone 1
+        // model are shared by the elements of a saturation region and that they do not
+        // change the relative permeabilities beyond the requested tolerance
+        {
+            std::string stone1DeckString(fam1DeckString);
+            stone1DeckString.insert(stone1DeckString.find("PROPS\n") + 6,
+                                    "STONE1\n"
+                                    "STONE1EX\n"
+                                    "  0.7 /\n");
+            const auto stone1Deck = parser.parseString(stone1DeckString);
+            const Ewoms::EclipseState stone1EclState(stone1Deck);
+
+            const Scalar tolerance = std::is_same<Scalar, float>::value ? 1e-4 : 1e-8;
+            MaterialLawManager analyticMaterialLawManager;
+            MaterialLawManager tabulatedMaterialLawManager;
+            tabulatedMaterialLawManager.setStone1EtaTabulation(/*minArg=*/0.05, tolerance);
+            for (MaterialLawManager* manager : { &analyticMaterialLawManager, &tabulatedMaterialLawManager }) {
+                manager->initFromEclState(stone1EclState);
+                manager->initParamsForElements(stone1EclState, n);
+            }
+
+            const auto& firstParams =
+                tabulatedMaterialLawManager.materialLawParams(0).template getRealParams<Ewoms::EclMultiplexerApproach::EclStone1Approach>();
+            if (!firstParams.etaPowTable())
+                throw std::logic_error("The power function of the Stone 1 model was not tabulated");
+
+            for (unsigned elemIdx = 0; elemIdx < n; ++ elemIdx) {
+                const auto& analyticParams = analyticMaterialLawManager.materialLawParams(elemIdx);
+                const auto& tabulatedParams = tabulatedMaterialLawManager.materialLawParams(elemIdx);
+                if (analyticParams.template getRealParams<Ewoms::EclMultiplexerApproach::EclStone1Approach>().etaPowTable()
+                    || tabulatedParams.template getRealParams<Ewoms::EclMultiplexerApproach::EclStone1Approach>().etaPowTable()
+                    != firstParams.etaPowTable())
+                    throw std::logic_error("The elements of a saturation region must share the table of the Stone 1 model");
+
+                for (int i = 0; i <= 10; ++ i) {
+                    for (int j = 0; i + j <= 10; ++ j) {
+                        FluidState fs;
+                        fs.setSaturation(waterPhaseIdx, Scalar(i)/10);
+                        fs.setSaturation(gasPhaseIdx, Scalar(j)/10);
+                        fs.setSaturation(oilPhaseIdx, Scalar(10 - i - j)/10);
+
+                        std::array<Scalar, numPhases> krAnalytic;
+                        std::array<Scalar, numPhases> krTabulated;
+                        MaterialLaw::relativePermeabilities(krAnalytic, analyticParams, fs);
+                        MaterialLaw::relativePermeabilities(krTabulated, tabulatedParams, fs);
+                        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++ phaseIdx) {
+                            if (std::abs(krAnalytic[phaseIdx] - krTabulated[phaseIdx]) > 2*tolerance)
+                                throw std::logic_error("Tabulating the power function of the Stone 1 model "
+                                                       "changes the relative permeabilities too much");
+                        }
+                    }
+                }
+            }
+        }
+
+        // make sure that the saturation transformations of the endpoint scaling follow
+        // the saturation region of a connection and that they are restored afterwards
+        {
+            const auto twoRegionDeck = parser.parseString(twoRegionDeckString);
+            const Ewoms::EclipseState twoRegionEclState(twoRegionDeck);
+
+            MaterialLawManager twoRegionMaterialLawManager;
+            twoRegionMaterialLawManager.initFromEclState(twoRegionEclState);
+            twoRegionMaterialLawManager.initParamsForElements(twoRegionEclState, n);
+
+            const unsigned elemIdx = 0;
+            const unsigned elemSatRegionIdx = 0;
+            const unsigned connectionSatRegionIdx = 1;
+
+            std::vector<FluidState> fluidStates(11);
+            std::vector<std::array<Scalar, numPhases> > krOriginal(fluidStates.size());
+            for (unsigned i = 0; i < fluidStates.size(); ++ i) {
+                Scalar Sw = Scalar(i)/10;
+                fluidStates[i].setSaturation(waterPhaseIdx, Sw);
+                fluidStates[i].setSaturation(oilPhaseIdx, 1 - Sw);
+                fluidStates[i].setSaturation(gasPhaseIdx, 0.0);
+                MaterialLaw::relativePermeabilities(krOriginal[i],
+                                                    twoRegionMaterialLawManager.materialLawParams(elemIdx),
+                                                    fluidStates[i]);
+            }
+
+            const auto& connectionParams =
+                twoRegionMaterialLawManager.connectionMaterialLawParams(connectionSatRegionIdx, elemIdx);
+            const auto& drainageParams =
+                connectionParams.template getRealParams<Ewoms::EclMultiplexerApproach::EclDefaultApproach>()
+                .oilWaterParams().drainageParams();
+            if (!drainageParams.config().enableSatScaling())
+                throw std::logic_error("Discrepancy between the deck and the EclMaterialLawManager");
+
+            const auto& unscaledKrwPoints = drainageParams.unscaledPoints().saturationKrwPoints();
+            const auto& scaledKrwPoints = drainageParams.scaledPoints().saturationKrwPoints();
+            const Scalar tolerance = std::is_same<Scalar, float>::value ? 1e-5 : 1e-10;
+            for (unsigned pointIdx = 0; pointIdx < 2; ++ pointIdx) {
+                const Scalar unscaledSat =
+                    drainageParams.krwSatTransform().scaledToUnscaledTwoPoint(scaledKrwPoints[pointIdx]);
+                if (std::abs(unscaledSat - unscaledKrwPoints[pointIdx]) > tolerance)
+                    throw std::logic_error("The saturation transformation does not follow the saturation "
+                                           "region of the connection");
+            }
+
+            twoRegionMaterialLawManager.connectionMaterialLawParams(elemSatRegionIdx, elemIdx);
+            for (unsigned i = 0; i < fluidStates.size(); ++ i) {
+                std::array<Scalar, numPhases> kr;
+                MaterialLaw::relativePermeabilities(kr,
+                                                    twoRegionMaterialLawManager.materialLawParams(elemIdx),
+                                                    fluidStates[i]);
+                for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++ phaseIdx) {
+                    if (std::abs(kr[phaseIdx] - krOriginal[i][phaseIdx]) > tolerance)
+                        throw std::logic_error("Restoring the saturation region of an element does not "
+                                               "restore its relative permeabilities");
+                }
+            }
+        }
+
         {
             const auto fam2Deck = parser.parseString(fam2DeckString);
             const Ewoms::EclipseState fam2EclState(fam2Deck);
@@ -0,0 +1,309 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the eWoms project.
+
+  eWoms is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  eWoms is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with eWoms.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*!
+ * \file
+ *
+ * \brief This is the unit test for the class which manages the parameters for the ECL
+ *        thermal laws.
+ *
+ * This test requires the presence of ewoms-eclio.
+ */
+#include "config.h"
+
+#if !HAVE_ECL_INPUT
+#error "The test for EclThermalLawManager requires ewoms-eclio"
+#endif
+
+#include <ewoms/material/thermal/eclthermallawmanager.hh>
+#include <ewoms/material/fluidstates/simplemodularfluidstate.hh>
+
+#include <ewoms/eclio/parser/parser.hh>
+#include <ewoms/eclio/parser/deck/deck.hh>
+#include <ewoms/eclio/parser/eclipsestate/eclipsestate.hh>
+#include <ewoms/eclio/parser/eclipsestate/grid/eclipsegrid.hh>
+
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+static const char* gridDeckString =
+    "RUNSPEC\n"
+    "\n"
+    "DIMENS\n"
+    "   5 1 1 /\n"
+    "\n"
+    "TABDIMS\n"
+    "/\n"
+    "\n"
+    "OIL\n"
+    "GAS\n"
+    "WATER\n"
+    "\n"
+    "THERMAL\n"
+    "\n"
+    "METRIC\n"
+    "\n"
+    "GRID\n"
+    "\n"
+    "DX\n"
+    "   5*10 /\n"
+    "DY\n"
+    "   5*10 /\n"
+    "DZ\n"
+    "   5*10 /\n"
+    "\n"
+    "TOPS\n"
+    "   5*1000 /\n"
+    "\n"
+    "PORO\n"
+    "   0.1 0.15 0.2 0.25 0.3 /\n"
+    "\n";
+
+// solid energy via HEATCR, thermal conduction via THCONR
+static const char* heatcrThconrDeckString =
+    "THCONR\n"
+    "   100 150 200 250 300 /\n"
+    "\n"
+    "THCONSF\n"
+    "   0.1 0.2 0.3 0.4 0.5 /\n"
+    "\n"
+    "PROPS\n"
+    "\n"
+    "HEATCR\n"
+    "   1000 2000 3000 4000 5000 /\n"
+    "\n"
+    "HEATCRT\n"
+    "   5*2.5 /\n"
+    "\n";
+
+// solid energy via SPECROCK, thermal conduction via the THC* keywords
+static const char* specrockThcDeckString =
+    "THCROCK\n"
+    "   100 150 200 250 300 /\n"
+    "\n"
+    "THCOIL\n"
+    "   5*10 /\n"
+    "\n"
+    "THCGAS\n"
+    "   5*1 /\n"
+    "\n"
+    "THCWATER\n"
+    "   50 55 60 65 70 /\n"
+    "\n"
+    "PROPS\n"
+    "\n"
+    "SPECROCK\n"
+    "   273.15 2000\n"
+    "   373.15 2500\n"
+    "   473.15 2750 /\n"
+    "\n"
+    "REGIONS\n"
+    "\n"
+    "SATNUM\n"
+    "   5*1 /\n"
+    "\n";
+
+// no thermal keywords at all
+static const char* nullDeckString =
+    "PROPS\n"
+    "\n";
+
+// the thermal laws only need to know the surface temperature and whether the gas phase
+// is active, so a full black-oil fluid system is not required
+template <class Scalar>
+struct ThermalTestFluidSystem
+{
+    enum { numPhases = 3 };
+    enum { waterPhaseIdx = 0 };
+    enum { oilPhaseIdx = 1 };
+    enum { gasPhaseIdx = 2 };
+
+    static constexpr Scalar surfaceTemperature = 273.15 + 15.56;
+
+    static bool phaseIsActive(unsigned phaseIdx EWOMS_UNUSED)
+    { return true; }
+};
+
+template <class Scalar>
+using ThermalTestFluidState =
+    Ewoms::SimpleModularFluidState<Scalar,
+                                   /*numPhases=*/3,
+                                   /*numComponents=*/3,
+                                   void,
+                                   /*storePressure=*/false,
+                                   /*storeTemperature=*/true,
+                                   /*storeComposition=*/false,
+                                   /*storeFugacity=*/false,
+                                   /*storeSaturation=*/true,
+                                   /*storeDensity=*/false,
+                                   /*storeViscosity=*/false,
+                                   /*storeEnthalpy=*/false>;
+
+template <class Scalar>
+std::vector<ThermalTestFluidState<Scalar> > createFluidStates(size_t numElems)
+{
+    typedef ThermalTestFluidSystem<Scalar> FluidSystem;
+
+    std::vector<ThermalTestFluidState<Scalar> > fluidStates(numElems);
+    for (unsigned elemIdx = 0; elemIdx < numElems; ++ elemIdx) {
+        Scalar Sg = Scalar(elemIdx)/numElems;
+        for (unsigned phaseIdx = 0; phaseIdx < FluidSystem::numPhases; ++ phaseIdx)
+            fluidStates[elemIdx].setTemperature(phaseIdx, 300.0 + 20.0*elemIdx);
+        fluidStates[elemIdx].setSaturation(FluidSystem::waterPhaseIdx, 0.5*(1 - Sg));
+        fluidStates[elemIdx].setSaturation(FluidSystem::oilPhaseIdx, 0.5*(1 - Sg));
+        fluidStates[elemIdx].setSaturation(FluidSystem::gasPhaseIdx, Sg);
+    }
+
+    return fluidStates;
+}
+
+// make sure that the bulk evaluation of the thermal laws yields the same results as
+// evaluating them element by element
+template <class Scalar>
+void testBulkEvaluation(const Ewoms::EclipseState& eclState)
+{
+    typedef ThermalTestFluidSystem<Scalar> FluidSystem;
+    typedef Ewoms::EclThermalLawManager<Scalar, FluidSystem> ThermalLawManager;
+    typedef typename ThermalLawManager::SolidEnergyLaw SolidEnergyLaw;
+    typedef typename ThermalLawManager::ThermalConductionLaw ThermalConductionLaw;
+
+    size_t n = eclState.getInputGrid().getCartesianSize();
+    const auto& fluidStates = createFluidStates<Scalar>(n);
+
+    ThermalLawManager thermalLawManager;
+    thermalLawManager.initParamsForElements(eclState, n);
+
+    std::vector<Scalar> solidInternalEnergies(n);
+    std::vector<Scalar> thermalConductivities(n);
+    thermalLawManager.solidInternalEnergies(solidInternalEnergies, fluidStates);
+    thermalLawManager.thermalConductivities(thermalConductivities, fluidStates);
+
+    for (unsigned elemIdx = 0; elemIdx < n; ++ elemIdx) {
+        const auto& fs = fluidStates[elemIdx];
+
+        Scalar ue = SolidEnergyLaw::solidInternalEnergy(thermalLawManager.solidEnergyLawParams(elemIdx), fs);
+        if (ue != solidInternalEnergies[elemIdx]
+            || ue != thermalLawManager.solidInternalEnergy(elemIdx, fs))
+            throw std::logic_error("Bulk solid internal energy differs from the one of a single element");
+
+        Scalar lambda = ThermalConductionLaw::thermalConductivity(thermalLawManager.thermalConductionLawParams(elemIdx), fs);
+        if (lambda != thermalConductivities[elemIdx]
+            || lambda != thermalLawManager.thermalConductivity(elemIdx, fs))
+            throw std::logic_error("Bulk thermal conductivity differs from the one of a single element");
+    }
+}
+
+// make sure that storing only the values which vary between the elements yields the same
+// results as storing a full parameter object for each element
+template <class Scalar>
+void testCompactStorage(const Ewoms::EclipseState& eclState)
+{
+    typedef ThermalTestFluidSystem<Scalar> FluidSystem;
+    typedef Ewoms::EclThermalLawManager<Scalar, FluidSystem> ThermalLawManager;
+    typedef typename ThermalLawManager::SolidEnergyLaw SolidEnergyLaw;
+    typedef typename ThermalLawManager::ThermalConductionLaw ThermalConductionLaw;
+
+    size_t n = eclState.getInputGrid().getCartesianSize();
+    const auto& fluidStates = createFluidStates<Scalar>(n);
+
+    ThermalLawManager fullManager;
+    fullManager.initParamsForElements(eclState, n);
+
+    ThermalLawManager compactManager;
+    compactManager.setUseCompactStorage(true);
+    compactManager.initParamsForElements(eclState, n);
+
+    std::vector<Scalar> fullEnergies(n), compactEnergies(n);
+    std::vector<Scalar> fullConductivities(n), compactConductivities(n);
+    fullManager.solidInternalEnergies(fullEnergies, fluidStates);
+    fullManager.thermalConductivities(fullConductivities, fluidStates);
+    compactManager.solidInternalEnergies(compactEnergies, fluidStates);
+    compactManager.thermalConductivities(compactConductivities, fluidStates);
+
+    for (unsigned elemIdx = 0; elemIdx < n; ++ elemIdx) {
+        const auto& fs = fluidStates[elemIdx];
+
+        Scalar ue = fullEnergies[elemIdx];
+        if (compactEnergies[elemIdx] != ue
+            || compactManager.solidInternalEnergy(elemIdx, fs) != ue)
+            throw std::logic_error("Compact storage yields a different solid internal energy");
+
+        Scalar lambda = fullConductivities[elemIdx];
+        if (compactConductivities[elemIdx] != lambda
+            || compactManager.thermalConductivity(elemIdx, fs) != lambda)
+            throw std::logic_error("Compact storage yields a different thermal conductivity");
+    }
+
+    // the per-element parameter objects must also be available if compact storage is
+    // used. this also applies to copies of the manager, regardless of whether the
+    // parameter objects of the original have already been created.
+    ThermalLawManager copiedManager(compactManager);
+    for (const ThermalLawManager* manager : {&compactManager, &copiedManager}) {
+        for (unsigned elemIdx = 0; elemIdx < n; ++ elemIdx) {
+            const auto& fs = fluidStates[elemIdx];
+
+            if (SolidEnergyLaw::solidInternalEnergy(manager->solidEnergyLawParams(elemIdx), fs)
+                != fullEnergies[elemIdx])
+                throw std::logic_error("The solid energy parameters of compact storage are wrong");
+
+            if (ThermalConductionLaw::thermalConductivity(manager->thermalConductionLawParams(elemIdx), fs)
+                != fullConductivities[elemIdx])
+                throw std::logic_error("The thermal conduction parameters of compact storage are wrong");
+        }
+    }
+
+    ThermalLawManager assignedManager;
+    assignedManager = compactManager;
+    ThermalLawManager movedManager(std::move(compactManager));
+    for (unsigned elemIdx = 0; elemIdx < n; ++ elemIdx) {
+        const auto& fs = fluidStates[elemIdx];
+
+        if (SolidEnergyLaw::solidInternalEnergy(assignedManager.solidEnergyLawParams(elemIdx), fs)
+            != fullEnergies[elemIdx]
+            || SolidEnergyLaw::solidInternalEnergy(movedManager.solidEnergyLawParams(elemIdx), fs)
+            != fullEnergies[elemIdx])
+            throw std::logic_error("Copying the thermal law manager changes the solid energy parameters");
+    }
+}
+
+template <class Scalar>
+inline void testAll()
+{
+    Ewoms::Parser parser;
+
+    for (const char* thermalDeckString : {heatcrThconrDeckString, specrockThcDeckString, nullDeckString}) {
+        const auto deck = parser.parseString(std::string(gridDeckString) + thermalDeckString);
+        const Ewoms::EclipseState eclState(deck);
+
+        testBulkEvaluation<Scalar>(eclState);
+        testCompactStorage<Scalar>(eclState);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    Dune::MPIHelper::instance(argc, argv);
+
+    testAll<double>();
+    testAll<float>();
+
+    return 0;
+}
@@ -51,6 +51,9 @@
 // include the helper classes to construct traits
 #include <ewoms/material/fluidmatrixinteractions/materialtraits.hh>
 
+// include the thermal laws
+#include <ewoms/material/thermal/eclspecrocklaw.hh>
+
 // include some fluid states
 #include <ewoms/material/fluidstates/compositionalfluidstate.hh>
 #include <ewoms/material/fluidstates/immisciblefluidstate.hh>
@@ -67,6 +70,9 @@
 
 #include <dune/common/parallel/mpihelper.hh>
 
+#include <chrono>
+#include <iostream>
+
 // this function makes sure that a capillary pressure law adheres to
 // the generic programming interface for such laws. This API _must_ be
 // implemented by all capillary pressure laws. If there are no _very_
@@ -253,6 +259,411 @@ void testThreePhaseSatApi()
 {
 }
 
+// this function makes sure that the temperature computed from the internal energy of
+// the SPECROCK law is consistent with the internal energy computed from the temperature
+template <class Scalar, class FluidState>
+void testSpecrockRoundTrip()
+{
+    typedef Ewoms::EclSpecrockLaw<Scalar> SpecrockLaw;
+    typedef typename FluidState::Scalar Evaluation;
+
+    std::vector<Scalar> T = { 273.15, 300.0, 350.0, 400.0, 500.0 };
+    std::vector<Scalar> cv = { 2.0e6, 2.1e6, 2.3e6, 2.4e6, 2.8e6 };
+
+    typename SpecrockLaw::Params params;
+    params.setHeatCapacities(T, cv);
+    params.finalize();
+
+    FluidState fs;
+    const Scalar tol = std::is_same<Scalar, float>::value ? 1e-3 : 1e-9;
+    // also test the extrapolation beyond the range of the table
+    for (Scalar temperature = 250.0; temperature <= 550.0; temperature += 1.5) {
+        fs.setTemperature(Evaluation::createVariable(temperature, 0));
+        const Evaluation& u = SpecrockLaw::solidInternalEnergy(params, fs);
+        const Evaluation& TRoundTrip = SpecrockLaw::solidTemperature(params, u);
+
+        if (std::abs(TRoundTrip.value() - temperature) > tol*temperature)
+            throw std::logic_error("Temperature computed from the SPECROCK internal energy "
+                                   "does not match: "+std::to_string(TRoundTrip.value())
+                                   +" != "+std::to_string(temperature));
+        if (std::abs(TRoundTrip.derivative(0) - 1.0) > 1e3*tol)
+            throw std::logic_error("Derivative of the temperature computed from the SPECROCK "
+                                   "internal energy is not consistent");
+    }
+
+    // individual heat capacities may be zero as long as the internal energy strictly
+    // increases with temperature
+    std::vector<Scalar> cvWithZero = { 2.0e6, 0.0, 2.3e6, 2.4e6, 2.8e6 };
+    params.setHeatCapacities(T, cvWithZero);
+
+    bool thrown = false;
+    std::vector<Scalar> cvDecreasing = { 2.0e6, -2.5e6, 2.3e6, 2.4e6, 2.8e6 };
+    try { params.setHeatCapacities(T, cvDecreasing); }
+    catch (const std::invalid_argument&) { thrown = true; }
+    if (!thrown)
+        throw std::logic_error("A decreasing SPECROCK internal energy must be rejected");
+}
+
+// compares the endpoint scaling law which uses the policy that matches the run-time
+// configuration to the one which evaluates the configuration at run time
+template <class RawMaterialLaw, class Params>
+struct EpsPolicyComparator
+{
+    typedef typename RawMaterialLaw::Scalar Scalar;
+    typedef Ewoms::EclEpsTwoPhaseLaw<RawMaterialLaw, Params> RuntimeLaw;
+
+    explicit EpsPolicyComparator(const Params& params)
+        : params_(params)
+    {}
+
+    template <class Policy>
+    void apply()
+    {
+        typedef Ewoms::EclEpsTwoPhaseLaw<RawMaterialLaw, Params, Policy> StaticLaw;
+
+        // the scaled saturations are chosen such that the unscaled ones are within
+        // [0, 1] for all scaling variants
+        for (Scalar Sw = 0.2; Sw <= 0.8; Sw += 0.05) {
+            if (StaticLaw::twoPhaseSatPcnw(params_, Sw) != RuntimeLaw::twoPhaseSatPcnw(params_, Sw)
+                || StaticLaw::twoPhaseSatKrw(params_, Sw) != RuntimeLaw::twoPhaseSatKrw(params_, Sw)
+                || StaticLaw::twoPhaseSatKrn(params_, Sw) != RuntimeLaw::twoPhaseSatKrn(params_, Sw))
+                throw std::logic_error("The endpoint scaling law with a compile-time policy "
+                                       "does not match the run-time configuration");
+        }
+    }
+
+    const Params& params_;
+};
+
+template <class Scalar, class TwoPhaseTraits>
+void testEpsPolicies()
+{
+    typedef Ewoms::BrooksCorey<TwoPhaseTraits> RawMaterialLaw;
+    typedef Ewoms::EclEpsTwoPhaseLawParams<RawMaterialLaw> Params;
+    typedef Ewoms::EclEpsScalingPoints<Scalar> ScalingPoints;
+
+    auto rawParams = std::make_shared<typename RawMaterialLaw::Params>();
+    rawParams->setEntryPressure(1e4);
+    rawParams->setLambda(2.0);
+    rawParams->finalize();
+
+    auto unscaledPoints = std::make_shared<ScalingPoints>();
+    auto scaledPoints = std::make_shared<ScalingPoints>();
+    for (unsigned pointIdx = 0; pointIdx < 2; ++pointIdx) {
+        unscaledPoints->setSaturationPcPoint(pointIdx, 0.1 + 0.4*pointIdx);
+        scaledPoints->setSaturationPcPoint(pointIdx, 0.2 + 0.3*pointIdx);
+    }
+    for (unsigned pointIdx = 0; pointIdx < 3; ++pointIdx) {
+        unscaledPoints->setSaturationKrwPoint(pointIdx, 0.1 + 0.4*pointIdx);
+        unscaledPoints->setSaturationKrnPoint(pointIdx, 0.1 + 0.4*pointIdx);
+        scaledPoints->setSaturationKrwPoint(pointIdx, 0.2 + 0.35*pointIdx);
+        scaledPoints->setSaturationKrnPoint(pointIdx, 0.15 + 0.3*pointIdx);
+    }
+    // note that the maximum capillary pressure and the Leverett factor share their
+    // storage
+    unscaledPoints->setMaxPcnw(1e5);
+    unscaledPoints->setMaxKrw(1.0);
+    unscaledPoints->setMaxKrn(1.0);
+    scaledPoints->setMaxPcnw(2e5);
+    scaledPoints->setMaxKrw(0.8);
+    scaledPoints->setMaxKrn(0.9);
+
+    for (unsigned variantIdx = 0; variantIdx < (1 << 6); ++variantIdx) {
+        auto config = std::make_shared<Ewoms::EclEpsConfig>();
+        config->setEnableSatScaling((variantIdx & (1 << 0)) != 0);
+        config->setEnableThreePointKrSatScaling((variantIdx & (1 << 1)) != 0);
+        config->setEnablePcScaling((variantIdx & (1 << 2)) != 0);
+        config->setEnableLeverettScaling((variantIdx & (1 << 3)) != 0);
+        config->setEnableKrwScaling((variantIdx & (1 << 4)) != 0);
+        config->setEnableKrnScaling((variantIdx & (1 << 5)) != 0);
+
+        Params params;
+        params.setConfig(config);
+        params.setUnscaledPoints(unscaledPoints);
+        params.setScaledPoints(scaledPoints);
+        params.setEffectiveLawParams(rawParams);
+        params.finalize();
+
+        EpsPolicyComparator<RawMaterialLaw, Params> comparator(params);
+        Ewoms::EclEpsPolicyDispatcher::apply(*config, comparator);
+
+        // the precomputed saturation transformations must map the scaling points onto
+        // each other
+        if (!config->enableSatScaling())
+            continue;
+
+        typedef Ewoms::EclEpsTwoPhaseLaw<RawMaterialLaw, Params> MaterialLaw;
+        const Scalar tol = std::is_same<Scalar, float>::value ? 1e-5 : 1e-12;
+        unsigned numKrPoints = config->enableThreePointKrSatScaling() ? 3 : 2;
+        for (unsigned pointIdx = 0; pointIdx < numKrPoints; ++pointIdx) {
+            Scalar SwScaled = scaledPoints->saturationKrwPoints()[pointIdx];
+            Scalar SwUnscaled = unscaledPoints->saturationKrwPoints()[pointIdx];
+            if (std::abs(MaterialLaw::scaledToUnscaledSatKrw(params, SwScaled) - SwUnscaled) > tol
+                || std::abs(MaterialLaw::unscaledToScaledSatKrw(params, SwUnscaled) - SwScaled) > tol)
+                throw std::logic_error("The saturation transformation of the wetting phase "
+                                       "relperm does not map the scaling points");
+
+            SwScaled = scaledPoints->saturationKrnPoints()[pointIdx];
+            SwUnscaled = unscaledPoints->saturationKrnPoints()[pointIdx];
+            if (std::abs(MaterialLaw::scaledToUnscaledSatKrn(params, SwScaled) - SwUnscaled) > tol
+                || std::abs(MaterialLaw::unscaledToScaledSatKrn(params, SwUnscaled) - SwScaled) > tol)
+                throw std::logic_error("The saturation transformation of the non-wetting phase "
+                                       "relperm does not map the scaling points");
+        }
+
+        for (unsigned pointIdx = 0; pointIdx < 2; ++pointIdx) {
+            Scalar SwScaled = scaledPoints->saturationPcPoints()[pointIdx];
+            Scalar SwUnscaled = unscaledPoints->saturationPcPoints()[pointIdx];
+            if (std::abs(MaterialLaw::scaledToUnscaledSatPc(params, SwScaled) - SwUnscaled) > tol
+                || std::abs(MaterialLaw::unscaledToScaledSatPc(params, SwUnscaled) - SwScaled) > tol)
+                throw std::logic_error("The saturation transformation of the capillary "
+                                       "pressure does not map the scaling points");
+        }
+    }
+}
+
+// make sure that the precomputed regularization of a capillary pressure law is
+// consistent, i.e., that inverting the capillary pressure yields the original saturation
+template <class MaterialLaw>
+void testRegularizedPcnwRoundTrip(const typename MaterialLaw::Params& params)
+{
+    typedef typename MaterialLaw::Scalar Scalar;
+
+    const Scalar tol = std::is_same<Scalar, float>::value ? 1e-3 : 1e-7;
+    for (Scalar Sw = -0.1; Sw <= 1.1; Sw += 1e-3) {
+        Scalar pcnw = MaterialLaw::twoPhaseSatPcnw(params, Sw);
+        Scalar SwRoundTrip = MaterialLaw::twoPhaseSatSw(params, pcnw);
+        if (std::abs(SwRoundTrip - Sw) > tol)
+            throw std::logic_error("Inverting the regularized capillary pressure at Sw="
+                                   +std::to_string(Sw)+" yields Sw="+std::to_string(SwRoundTrip));
+    }
+}
+
+template <class TwoPhaseTraits>
+void testRegularizedLaws()
+{
+    typedef typename TwoPhaseTraits::Scalar Scalar;
+
+    {
+        typedef Ewoms::RegularizedVanGenuchten<TwoPhaseTraits> MaterialLaw;
+        typename MaterialLaw::Params params(/*alpha=*/1.0/5e3, /*n=*/2.5);
+        testRegularizedPcnwRoundTrip<MaterialLaw>(params);
+
+        // the precomputed polynomial must match the spline of the high saturation range
+        for (Scalar Sw = params.pcnwHighSw(); Sw <= 1.0; Sw += 1e-3) {
+            Scalar pcSpline = params.pcnwHighSpline().eval(Sw);
+            Scalar pcPolynomial = params.pcnwHighPolynomial(Sw);
+            if (std::abs(pcSpline - pcPolynomial) > 1e-4*(1.0 + std::abs(params.pcnwHigh())))
+                throw std::logic_error("The precomputed polynomial of the regularized van "
+                                       "Genuchten law does not match its spline");
+        }
+    }
+
+    {
+        typedef Ewoms::RegularizedBrooksCorey<TwoPhaseTraits> MaterialLaw;
+        typename MaterialLaw::Params params(/*entryPressure=*/1e4, /*lambda=*/2.0);
+        testRegularizedPcnwRoundTrip<MaterialLaw>(params);
+    }
+}
+
+// make sure that the resampled curves of the spline material law match its splines
+template <class TwoPhaseTraits>
+void testSplineResampling()
+{
+    typedef typename TwoPhaseTraits::Scalar Scalar;
+    typedef Ewoms::SplineTwoPhaseMaterial<TwoPhaseTraits> MaterialLaw;
+    typedef typename MaterialLaw::Params Params;
+    typedef Ewoms::DenseAd::Evaluation<Scalar, 1> Evaluation;
+
+    // sample points with a non-uniform spacing
+    std::vector<Scalar> SwSamples = { 0.1, 0.12, 0.15, 0.2, 0.3, 0.45, 0.6, 0.8, 0.9, 1.0 };
+    std::vector<Scalar> pcnwSamples;
+    std::vector<Scalar> krwSamples;
+    std::vector<Scalar> krnSamples;
+    for (Scalar Sw : SwSamples) {
+        Scalar Se = (Sw - 0.1)/0.9;
+        pcnwSamples.push_back(1e4*std::pow(0.05 + Se, -0.5));
+        krwSamples.push_back(Se*Se*Se);
+        krnSamples.push_back((1 - Se)*(1 - Se));
+    }
+
+    Params splineParams;
+    splineParams.setPcnwSamples(SwSamples, pcnwSamples);
+    splineParams.setKrwSamples(SwSamples, krwSamples);
+    splineParams.setKrnSamples(SwSamples, krnSamples);
+    Params resampledParams(splineParams);
+    splineParams.finalize();
+
+    const Scalar tolerance = std::is_same<Scalar, float>::value ? 1e-4 : 1e-7;
+    resampledParams.setResampling(tolerance);
+    resampledParams.finalize();
+
+    if (resampledParams.pcnwTable().numSamples() == 0
+        || resampledParams.krwTable().numSamples() == 0
+        || resampledParams.krnTable().numSamples() == 0
+        || resampledParams.pcnwInvTable().numSamples() == 0)
+        throw std::logic_error("The curves of the spline material law could not be resampled");
+
+    Scalar maxPcnw = pcnwSamples.front();
+    for (Scalar Sw = 0.0; Sw <= 1.05; Sw += 1e-3) {
+        Scalar pcnwSpline = MaterialLaw::twoPhaseSatPcnw(splineParams, Sw);
+        Scalar pcnwResampled = MaterialLaw::twoPhaseSatPcnw(resampledParams, Sw);
+        if (std::abs(pcnwSpline - pcnwResampled) > 2*tolerance*maxPcnw)
+            throw std::logic_error("The resampled capillary pressure does not match the spline");
+
+        if (std::abs(MaterialLaw::twoPhaseSatKrw(splineParams, Sw)
+                     - MaterialLaw::twoPhaseSatKrw(resampledParams, Sw)) > 2*tolerance
+            || std::abs(MaterialLaw::twoPhaseSatKrn(splineParams, Sw)
+                        - MaterialLaw::twoPhaseSatKrn(resampledParams, Sw)) > 2*tolerance)
+            throw std::logic_error("The resampled relative permeabilities do not match the splines");
+
+        // the tabulated inverse must agree with the one which intersects the spline
+        Scalar SwSpline = MaterialLaw::twoPhaseSatSw(splineParams, pcnwSpline);
+        Scalar SwResampled = MaterialLaw::twoPhaseSatSw(resampledParams, pcnwSpline);
+        if (std::abs(SwSpline - SwResampled) > 1e2*tolerance)
+            throw std::logic_error("The tabulated inverse capillary pressure does not match the spline");
+
+        // check the derivatives of the resampled curves
+        if (Sw <= SwSamples.front() || Sw >= SwSamples.back())
+            continue;
+        const Evaluation& SwEval = Evaluation::createVariable(Sw, 0);
+        Scalar dKrw = MaterialLaw::twoPhaseSatKrw(resampledParams, SwEval).derivative(0);
+        Scalar dKrwRef = splineParams.krwSpline().evalDerivative(Sw);
+        if (std::abs(dKrw - dKrwRef) > 1e2*std::sqrt(tolerance))
+            throw std::logic_error("The derivative of the resampled relperm is inconsistent");
+    }
+}
+
+// make sure that the tabulated van Genuchten curves stay within the requested error
+// bound and compare their performance with the analytic curves
+template <class Scalar, class TwoPhaseTraits>
+void testVanGenuchtenTabulation()
+{
+    typedef Ewoms::VanGenuchten<TwoPhaseTraits> MaterialLaw;
+    typedef typename MaterialLaw::Params Params;
+    typedef Ewoms::DenseAd::Evaluation<Scalar, 1> Evaluation;
+
+    const Scalar SwMin = 0.05;
+    const Scalar SwMax = 0.95;
+    const Scalar tolerance = std::is_same<Scalar, float>::value ? 1e-4 : 1e-7;
+
+    Params analyticParams(/*alpha=*/1.0/5e3, /*n=*/2.5);
+    Params tabulatedParams;
+    tabulatedParams.setVgAlpha(1.0/5e3);
+    tabulatedParams.setVgN(2.5);
+    tabulatedParams.setTabulation(SwMin, SwMax, tolerance);
+    tabulatedParams.finalize();
+
+    if (tabulatedParams.pcnwTable().numSamples() == 0
+        || tabulatedParams.krwTable().numSamples() == 0
+        || tabulatedParams.krnTable().numSamples() == 0)
+        throw std::logic_error("The van Genuchten curves could not be tabulated");
+
+    Scalar maxPcnw = MaterialLaw::twoPhaseSatPcnw(analyticParams, SwMin);
+    for (Scalar Sw = 0.0; Sw <= 1.0; Sw += 1e-3) {
+        const Evaluation& SwEval = Evaluation::createVariable(Sw, 0);
+
+        Scalar pcErr = std::abs(MaterialLaw::twoPhaseSatPcnw(tabulatedParams, Sw)
+                                - MaterialLaw::twoPhaseSatPcnw(analyticParams, Sw));
+        Scalar krwErr = std::abs(MaterialLaw::twoPhaseSatKrw(tabulatedParams, Sw)
+                                 - MaterialLaw::twoPhaseSatKrw(analyticParams, Sw));
+        Scalar krnErr = std::abs(MaterialLaw::twoPhaseSatKrn(tabulatedParams, Sw)
+                                 - MaterialLaw::twoPhaseSatKrn(analyticParams, Sw));
+        if (Sw > 0.0 && pcErr > 2*tolerance*maxPcnw)
+            throw std::logic_error("Tabulated van Genuchten capillary pressure exceeds the error bound");
+        if (krwErr > 2*tolerance || krnErr > 2*tolerance)
+            throw std::logic_error("Tabulated van Genuchten relperms exceed the error bound");
+
+        // the derivatives must be consistent with the analytic ones
+        if (Sw < SwMin || Sw > SwMax)
+            continue;
+
+        const Evaluation& krwTab = MaterialLaw::twoPhaseSatKrw(tabulatedParams, SwEval);
+        const Evaluation& krwRef = MaterialLaw::twoPhaseSatKrw(analyticParams, SwEval);
+        if (std::abs(krwTab.derivative(0) - krwRef.derivative(0))
+            > 1e2*std::sqrt(tolerance)*(1 + std::abs(krwRef.derivative(0))))
+            throw std::logic_error("The derivative of the tabulated van Genuchten relperm is inconsistent");
+    }
+
+    // a simple benchmark
+    const unsigned numEvals = 200000;
+    Scalar sumAnalytic = 0.0;
+    Scalar sumTabulated = 0.0;
+    auto startTime = std::chrono::steady_clock::now();
+    for (unsigned i = 0; i < numEvals; ++i) {
+        const Evaluation& Sw = Evaluation::createVariable(SwMin + (SwMax - SwMin)*i/numEvals, 0);
+        sumAnalytic += MaterialLaw::twoPhaseSatPcnw(analyticParams, Sw).derivative(0);
+        sumAnalytic += MaterialLaw::twoPhaseSatKrw(analyticParams, Sw).derivative(0);
+        sumAnalytic += MaterialLaw::twoPhaseSatKrn(analyticParams, Sw).derivative(0);
+    }
+    auto midTime = std::chrono::steady_clock::now();
+    for (unsigned i = 0; i < numEvals; ++i) {
+        const Evaluation& Sw = Evaluation::createVariable(SwMin + (SwMax - SwMin)*i/numEvals, 0);
+        sumTabulated += MaterialLaw::twoPhaseSatPcnw(tabulatedParams, Sw).derivative(0);
+        sumTabulated += MaterialLaw::twoPhaseSatKrw(tabulatedParams, Sw).derivative(0);
+        sumTabulated += MaterialLaw::twoPhaseSatKrn(tabulatedParams, Sw).derivative(0);
+    }
+    auto endTime = std::chrono::steady_clock::now();
+
+    std::cout << "van Genuchten curves (" << tabulatedParams.pcnwTable().numSamples() << "/"
+              << tabulatedParams.krwTable().numSamples() << "/"
+              << tabulatedParams.krnTable().numSamples() << " sampling points): "
+              << std::chrono::duration<double, std::nano>(midTime - startTime).count()/numEvals
+              << " ns (analytic) vs. "
+              << std::chrono::duration<double, std::nano>(endTime - midTime).count()/numEvals
+              << " ns (tabulated) per saturation, checksums "
+              << sumAnalytic << " vs. " << sumTabulated << "\n";
+}
+
+// make sure that tabulating the power function of the extended Stone 1 model does not
+// change the oil relperm beyond the requested error bound
+template <class Scalar, class TwoPhaseTraits, class ThreePhaseTraits, class FluidState>
+void testStone1Tabulation()
+{
+    typedef Ewoms::BrooksCorey<TwoPhaseTraits> TwoPhaseMaterial;
+    typedef Ewoms::EclStone1Material<ThreePhaseTraits,
+                                     /*GasOilMaterial=*/TwoPhaseMaterial,
+                                     /*OilWaterMaterial=*/TwoPhaseMaterial> MaterialLaw;
+    typedef typename MaterialLaw::Params Params;
+    typedef typename FluidState::Scalar Evaluation;
+
+    auto twoPhaseParams = std::make_shared<typename TwoPhaseMaterial::Params>();
+    twoPhaseParams->setEntryPressure(1e4);
+    twoPhaseParams->setLambda(2.0);
+    twoPhaseParams->finalize();
+
+    const Scalar tolerance = std::is_same<Scalar, float>::value ? 1e-4 : 1e-8;
+    Params analyticParams;
+    Params tabulatedParams;
+    for (Params* params : { &analyticParams, &tabulatedParams }) {
+        params->setGasOilParams(twoPhaseParams);
+        params->setOilWaterParams(twoPhaseParams);
+        params->setSwl(0.1);
+        params->setEta(0.7);
+    }
+    tabulatedParams.setEtaPowTable(Params::createEtaPowTable(/*eta=*/0.7, /*minArg=*/0.05, tolerance));
+    analyticParams.finalize();
+    tabulatedParams.finalize();
+
+    if (!tabulatedParams.etaPowTable())
+        throw std::logic_error("The power function of the Stone 1 model could not be tabulated");
+
+    FluidState fs;
+    for (Scalar Sw = 0.15; Sw < 0.9; Sw += 0.05) {
+        for (Scalar Sg = 0.0; Sw + Sg < 0.95; Sg += 0.05) {
+            fs.setSaturation(ThreePhaseTraits::wettingPhaseIdx, Sw);
+            fs.setSaturation(ThreePhaseTraits::gasPhaseIdx, Sg);
+            fs.setSaturation(ThreePhaseTraits::nonWettingPhaseIdx, 1 - Sw - Sg);
+
+            const Evaluation& krnAnalytic = MaterialLaw::template krn<FluidState, Evaluation>(analyticParams, fs);
+            const Evaluation& krnTabulated = MaterialLaw::template krn<FluidState, Evaluation>(tabulatedParams, fs);
+            if (std::abs(Ewoms::scalarValue(krnAnalytic) - Ewoms::scalarValue(krnTabulated)) > 2*tolerance)
+                throw std::logic_error("Tabulating the power function of the Stone 1 model "
+                                       "changes the oil relperm too much");
+        }
+    }
+}
+
 template <class Scalar>
 inline void testAll()
 {
@@ -420,6 +831,13 @@ inline void testAll()
         testTwoPhaseApi<MaterialLaw, TwoPhaseFluidState>();
         testTwoPhaseSatApi<MaterialLaw, TwoPhaseFluidState>();
     }
+
+    testEpsPolicies<Scalar, TwoPhaseTraits>();
+    testRegularizedLaws<TwoPhaseTraits>();
+    testSplineResampling<TwoPhaseTraits>();
+    testVanGenuchtenTabulation<Scalar, TwoPhaseTraits>();
+    testStone1Tabulation<Scalar, TwoPhaseTraits, ThreePhaseTraits, ThreePhaseFluidState>();
+    testSpecrockRoundTrip<Scalar, TwoPhaseFluidState>();
 }
 
 int main(int argc, char **argv)
@@ -39,17 +39,22 @@
 #include <ewoms/material/fluidsystems/h2oairmesitylenefluidsystem.hh>
 #include <ewoms/material/fluidsystems/h2oairxylenefluidsystem.hh>
 
+#include <ewoms/material/binarycoefficients/air_xylene.hh>
+#include <ewoms/material/binarycoefficients/tabulatedbinarycoeff.hh>
+
 #include <ewoms/material/thermal/fluidthermalconductionlaw.hh>
 
 // include all fluid states
 #include <ewoms/material/fluidstates/pressureoverlayfluidstate.hh>
 #include <ewoms/material/fluidstates/saturationoverlayfluidstate.hh>
 #include <ewoms/material/fluidstates/temperatureoverlayfluidstate.hh>
+#include <ewoms/material/fluidstates/overlayfluidstate.hh>
 #include <ewoms/material/fluidstates/compositionalfluidstate.hh>
 #include <ewoms/material/fluidstates/nonequilibriumfluidstate.hh>
 #include <ewoms/material/fluidstates/immisciblefluidstate.hh>
 #include <ewoms/material/fluidstates/simplemodularfluidstate.hh>
 #include <ewoms/material/fluidstates/blackoilfluidstate.hh>
+#include <ewoms/material/fluidstates/soafluidstatecontainer.hh>
 
 // include the tables for CO2 which are delivered with ewoms-material by default
 #include <ewoms/common/uniformtabulated2dfunction.hh>
@@ -118,6 +123,10 @@ void ensureBlackoilApi()
                                            /*gas=*/1.0,
                                            /*regionIdx=*/0);
         FluidSystem::initEnd();
+        FluidSystem::setThermalPvtTabulationRange(/*temperatureMin=*/280.0, /*temperatureMax=*/500.0, /*numTemperatures=*/50,
+                                                  /*pressureMin=*/1e5, /*pressureMax=*/5e7, /*numPressures=*/100);
+        FluidSystem::setCo2PvtTabulationRange(/*temperatureMin=*/280.0, /*temperatureMax=*/500.0, /*numTemperatures=*/50,
+                                              /*pressureMin=*/1e5, /*pressureMax=*/5e7, /*numPressures=*/100);
 
         // the molarMass() method has an optional argument for the PVT region
         unsigned numRegions EWOMS_UNUSED = FluidSystem::numRegions();
@@ -220,6 +229,445 @@ void testAllFluidStates()
     // SaturationOverlayFluidState
     {   Ewoms::SaturationOverlayFluidState<BaseFluidState> fs(baseFs);
         checkFluidState<Scalar>(fs); }
+
+    // OverlayFluidState
+    {   Ewoms::OverlayFluidState<BaseFluidState, Ewoms::overlayTemperature> fs(baseFs);
+        checkFluidState<Scalar>(fs); }
+
+    {   Ewoms::OverlayFluidState<BaseFluidState,
+                                 Ewoms::overlayPressure | Ewoms::overlaySaturation> fs(baseFs);
+        checkFluidState<Scalar>(fs); }
+
+    {   Ewoms::OverlayFluidState<BaseFluidState,
+                                 Ewoms::overlayTemperature
+                                 | Ewoms::overlayPressure
+                                 | Ewoms::overlaySaturation> fs(baseFs);
+        checkFluidState<Scalar>(fs); }
+
+    // SoaFluidStateContainer
+    {   typedef Ewoms::SoaFluidStateContainer<Scalar, FluidSystem> Container;
+        Container container(/*numCells=*/2);
+        const Container& constContainer = container;
+        checkFluidState<Scalar>(container[1]);
+        checkFluidState<Scalar>(constContainer[0]); }
+}
+
+// make sure that the fluid states stored by a structure-of-arrays container can be used
+// by the fluid systems and that they correspond to the raw arrays of the container
+template <class Scalar>
+void testSoaFluidStateContainer()
+{
+    typedef Ewoms::H2ON2FluidSystem<Scalar> FluidSystem;
+    typedef Ewoms::CompositionalFluidState<Scalar, FluidSystem> FluidState;
+    typedef Ewoms::SoaFluidStateContainer<Scalar, FluidSystem> Container;
+    typedef typename FluidSystem::template ParameterCache<Scalar> ParameterCache;
+
+    enum { numPhases = FluidSystem::numPhases };
+    enum { numComponents = FluidSystem::numComponents };
+
+    const unsigned numCells = 10;
+    Container container(numCells);
+    std::vector<FluidState> fluidStates(numCells);
+    for (unsigned cellIdx = 0; cellIdx < numCells; ++cellIdx) {
+        FluidState& fs = fluidStates[cellIdx];
+        fs.setTemperature(300.0 + cellIdx);
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+            fs.setPressure(phaseIdx, 1e5*(1.0 + cellIdx) + 1e3*phaseIdx);
+            fs.setSaturation(phaseIdx, 1.0/numPhases);
+            for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx)
+                fs.setMoleFraction(phaseIdx, compIdx, (compIdx == phaseIdx) ? 0.99 : 0.01);
+        }
+
+        ParameterCache paramCache;
+        paramCache.updateAll(fs);
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+            fs.setDensity(phaseIdx, FluidSystem::density(fs, paramCache, phaseIdx));
+            fs.setViscosity(phaseIdx, FluidSystem::viscosity(fs, paramCache, phaseIdx));
+            fs.setEnthalpy(phaseIdx, FluidSystem::enthalpy(fs, paramCache, phaseIdx));
+            for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx)
+                fs.setFugacityCoefficient(phaseIdx, compIdx,
+                                          FluidSystem::fugacityCoefficient(fs, paramCache, phaseIdx, compIdx));
+        }
+
+        container[cellIdx].assign(fs);
+    }
+
+    for (unsigned cellIdx = 0; cellIdx < numCells; ++cellIdx) {
+        const FluidState& fs = fluidStates[cellIdx];
+        auto view = container[cellIdx];
+
+        ParameterCache paramCache;
+        paramCache.updateAll(view);
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+            if (container.pressureArray(phaseIdx)[cellIdx] != fs.pressure(phaseIdx)
+                || container.densityArray(phaseIdx)[cellIdx] != fs.density(phaseIdx))
+                throw std::logic_error("The raw arrays of the container do not match the stored fluid states");
+
+            if (view.averageMolarMass(phaseIdx) != fs.averageMolarMass(phaseIdx)
+                || view.massFraction(phaseIdx, /*compIdx=*/0) != fs.massFraction(phaseIdx, /*compIdx=*/0))
+                throw std::logic_error("The composition of the fluid state view does not match");
+
+            if (FluidSystem::density(view, paramCache, phaseIdx) != fs.density(phaseIdx))
+                throw std::logic_error("The fluid system computes a different density for the fluid state view");
+        }
+    }
+
+    // modify the mole fractions using the raw arrays
+    for (unsigned cellIdx = 0; cellIdx < numCells; ++cellIdx) {
+        container.moleFractionArray(/*phaseIdx=*/0, /*compIdx=*/0)[cellIdx] = 0.5;
+        container.moleFractionArray(/*phaseIdx=*/0, /*compIdx=*/1)[cellIdx] = 0.5;
+    }
+    container.updateAverageMolarMasses();
+
+    Scalar MRef = 0.5*(FluidSystem::molarMass(0) + FluidSystem::molarMass(1));
+    if (std::abs(container[0].averageMolarMass(/*phaseIdx=*/0) - MRef) > 1e-6*MRef)
+        throw std::logic_error("The average molar masses were not updated");
+}
+
+// make sure that the generic overlay fluid state behaves like the specific overlays
+template <class Scalar>
+void testOverlayFluidState()
+{
+    typedef Ewoms::H2ON2FluidSystem<Scalar> FluidSystem;
+    typedef Ewoms::CompositionalFluidState<Scalar, FluidSystem> BaseFluidState;
+
+    enum { numPhases = FluidSystem::numPhases };
+    enum { numComponents = FluidSystem::numComponents };
+
+    BaseFluidState baseFs;
+    baseFs.setTemperature(300.0);
+    for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+        baseFs.setPressure(phaseIdx, 1e5 + 1e3*phaseIdx);
+        baseFs.setSaturation(phaseIdx, 1.0/numPhases);
+        baseFs.setDensity(phaseIdx, 1000.0 - 900.0*phaseIdx);
+        for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx)
+            baseFs.setMoleFraction(phaseIdx, compIdx, (compIdx == phaseIdx) ? 0.99 : 0.01);
+    }
+
+    // the specific overlays, layered on top of each other
+    typedef Ewoms::TemperatureOverlayFluidState<BaseFluidState> TFluidState;
+    typedef Ewoms::PressureOverlayFluidState<TFluidState> PtFluidState;
+    typedef Ewoms::SaturationOverlayFluidState<PtFluidState> SptFluidState;
+
+    // the generic overlays. layering them must collapse them into a single overlay of
+    // the base fluid state
+    typedef Ewoms::OverlayFluidState<BaseFluidState, Ewoms::overlayTemperature> TOverlay;
+    typedef typename Ewoms::OverlayFluidStateType<TOverlay, Ewoms::overlayPressure>::type PtOverlay;
+    typedef typename Ewoms::OverlayFluidStateType<PtOverlay, Ewoms::overlaySaturation>::type SptOverlay;
+    static_assert(std::is_same<SptOverlay,
+                               Ewoms::OverlayFluidState<BaseFluidState,
+                                                        Ewoms::overlayTemperature
+                                                        | Ewoms::overlayPressure
+                                                        | Ewoms::overlaySaturation> >::value,
+                  "Layered overlay fluid states must refer to the base fluid state");
+    static_assert(sizeof(TOverlay) < sizeof(SptOverlay),
+                  "Overlay fluid states must only store the overridden quantities");
+
+    TFluidState tFs(baseFs);
+    TOverlay genericTFs(baseFs);
+    tFs.setTemperature(350.0);
+    genericTFs.setTemperature(350.0);
+
+    PtFluidState ptFs(tFs);
+    PtOverlay genericPtFs(genericTFs);
+    for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+        ptFs.setPressure(phaseIdx, 2e5 + 1e3*phaseIdx);
+        genericPtFs.setPressure(phaseIdx, 2e5 + 1e3*phaseIdx);
+    }
+
+    SptFluidState sptFs(ptFs);
+    SptOverlay genericSptFs(genericPtFs);
+    for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+        sptFs.setSaturation(phaseIdx, (phaseIdx == 0) ? 0.8 : 0.2);
+        genericSptFs.setSaturation(phaseIdx, (phaseIdx == 0) ? 0.8 : 0.2);
+    }
+
+    if (&genericSptFs.baseFluidState() != &baseFs)
+        throw std::logic_error("The layered overlay fluid state does not refer to the base fluid state");
+
+    for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+        if (genericTFs.temperature(phaseIdx) != tFs.temperature(phaseIdx)
+            || genericTFs.pressure(phaseIdx) != tFs.pressure(phaseIdx)
+            || genericTFs.saturation(phaseIdx) != tFs.saturation(phaseIdx))
+            throw std::logic_error("The generic temperature overlay does not match the specific one");
+
+        if (genericPtFs.temperature(phaseIdx) != ptFs.temperature(phaseIdx)
+            || genericPtFs.pressure(phaseIdx) != ptFs.pressure(phaseIdx)
+            || genericPtFs.saturation(phaseIdx) != ptFs.saturation(phaseIdx))
+            throw std::logic_error("The generic pressure overlay does not match the specific one");
+
+        if (genericSptFs.temperature(phaseIdx) != sptFs.temperature(phaseIdx)
+            || genericSptFs.pressure(phaseIdx) != sptFs.pressure(phaseIdx)
+            || genericSptFs.saturation(phaseIdx) != sptFs.saturation(phaseIdx)
+            || genericSptFs.density(phaseIdx) != sptFs.density(phaseIdx))
+            throw std::logic_error("The generic saturation overlay does not match the specific one");
+
+        for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx)
+            if (genericSptFs.moleFraction(phaseIdx, compIdx) != sptFs.moleFraction(phaseIdx, compIdx))
+                throw std::logic_error("The generic overlay does not forward the composition");
+    }
+
+    // the quantities which are not overridden must be taken from the base fluid state
+    baseFs.setDensity(/*phaseIdx=*/0, 1100.0);
+    if (genericSptFs.density(/*phaseIdx=*/0) != 1100.0
+        || genericSptFs.pressure(/*phaseIdx=*/0) != 2e5)
+        throw std::logic_error("The generic overlay does not forward the non-overridden quantities");
+}
+
+// make sure that the tabulated binary coefficients match the untabulated ones
+template <class Scalar>
+void testTabulatedBinaryCoeff()
+{
+    typedef Ewoms::BinaryCoeff::H2O_N2 RawBinaryCoeff;
+    typedef Ewoms::BinaryCoeff::TabulatedBinaryCoeff<Scalar, RawBinaryCoeff> BinaryCoeff;
+    typedef Ewoms::DenseAd::Evaluation<Scalar, 1> Evaluation;
+
+    Scalar tempMin = 280.0;
+    Scalar tempMax = 500.0;
+    BinaryCoeff::init(tempMin, tempMax, /*pressMin=*/1e4, /*pressMax=*/1e7);
+    if (BinaryCoeff::henryTable().numSamples() == 0
+        || BinaryCoeff::gasDiffCoeffTable().numSamples() == 0)
+        throw std::logic_error("The binary coefficients could not be tabulated");
+
+    Scalar tol = std::is_same<Scalar, float>::value ? 1e-3 : 1e-6;
+    Scalar p = 2e5;
+    for (Scalar T = tempMin; T <= tempMax; T += 0.73) {
+        const Evaluation& TEval = Evaluation::createVariable(T, 0);
+
+        const Evaluation& henry = BinaryCoeff::henry(TEval);
+        const Evaluation& henryRef = RawBinaryCoeff::henry(TEval);
+        if (std::abs(henry.value()/henryRef.value() - 1) > tol
+            || std::abs(henry.derivative(0)/henryRef.derivative(0) - 1) > 1e2*tol)
+            throw std::logic_error("The tabulated Henry coefficient does not match");
+
+        const Evaluation& diffCoeff = BinaryCoeff::gasDiffCoeff(TEval, Evaluation(p));
+        const Evaluation& diffCoeffRef = RawBinaryCoeff::gasDiffCoeff(TEval, Evaluation(p));
+        if (std::abs(diffCoeff.value()/diffCoeffRef.value() - 1) > tol
+            || std::abs(diffCoeff.derivative(0)/diffCoeffRef.derivative(0) - 1) > 1e2*tol)
+            throw std::logic_error("The tabulated diffusion coefficient does not match");
+    }
+
+    // outside of the tabulated range, the untabulated coefficients must be used
+    Scalar T = tempMax + 50.0;
+    if (BinaryCoeff::henry(T) != RawBinaryCoeff::henry(T)
+        || BinaryCoeff::gasDiffCoeff(T, p) != RawBinaryCoeff::gasDiffCoeff(T, p))
+        throw std::logic_error("The tabulated binary coefficients do not fall back to the "
+                               "untabulated ones");
+    T = 0.5*(tempMin + tempMax);
+    p = 2e7;
+    if (BinaryCoeff::gasDiffCoeff(T, p) != RawBinaryCoeff::gasDiffCoeff(T, p))
+        throw std::logic_error("The tabulated diffusion coefficient does not fall back to the "
+                               "untabulated one above the maximum pressure");
+}
+
+// make sure that the tabulated binary coefficients respect the regularization of the
+// untabulated ones
+template <class Scalar>
+void testClampedTabulatedBinaryCoeff()
+{
+    // the gas diffusion coefficient of air and xylene is clamped to temperatures below
+    // 500 K and pressures below 100 MPa. the Henry coefficient is not available.
+    typedef Ewoms::BinaryCoeff::Air_Xylene RawBinaryCoeff;
+    typedef Ewoms::BinaryCoeff::TabulatedBinaryCoeff<Scalar, RawBinaryCoeff> BinaryCoeff;
+
+    Scalar tempMin = 280.0;
+    Scalar tempMax = 499.0;
+    Scalar tol = std::is_same<Scalar, float>::value ? 1e-3 : 1e-6;
+
+    BinaryCoeff::init(tempMin, tempMax, /*pressMin=*/0.0, /*pressMax=*/50e6);
+    if (BinaryCoeff::henryTable().numSamples() != 0
+        || BinaryCoeff::gasDiffCoeffTable().numSamples() == 0)
+        throw std::logic_error("The binary coefficients of air and xylene were not tabulated "
+                               "as expected");
+
+    bool henryThrows = false;
+    try { BinaryCoeff::henry(Scalar(300.0)); }
+    catch (const std::runtime_error&) { henryThrows = true; }
+    if (!henryThrows)
+        throw std::logic_error("The Henry coefficient of air and xylene must not be available");
+
+    // above 500 K, the untabulated coefficient is used
+    for (Scalar T = tempMin; T <= 600.0; T += 0.73) {
+        for (Scalar p = 1e5; p <= 50e6; p *= 3) {
+            Scalar diffCoeff = BinaryCoeff::gasDiffCoeff(T, p);
+            Scalar diffCoeffRef = RawBinaryCoeff::gasDiffCoeff(T, p);
+            if (std::abs(diffCoeff/diffCoeffRef - 1) > tol)
+                throw std::logic_error("The tabulated diffusion coefficient of air and xylene "
+                                       "does not match");
+        }
+    }
+
+    // above 100 MPa, the diffusion coefficient is not inversely proportional to the
+    // pressure anymore, so the table must not be used if it would apply there
+    BinaryCoeff::init(tempMin, tempMax, /*pressMin=*/0.0, /*pressMax=*/200e6);
+    if (BinaryCoeff::gasDiffCoeffTable().numSamples() != 0)
+        throw std::logic_error("The clamped diffusion coefficient of air and xylene must not "
+                               "be tabulated above 100 MPa");
+    Scalar T = 350.0;
+    Scalar p = 150e6;
+    if (BinaryCoeff::gasDiffCoeff(T, p) != RawBinaryCoeff::gasDiffCoeff(T, p))
+        throw std::logic_error("The diffusion coefficient of air and xylene does not fall back "
+                               "to the untabulated one");
+}
+
+// make sure that the tables of the thermal black-oil PVT relations match the analytic
+// relations and that they can be enabled through the PVT multiplexers
+template <class Scalar>
+void testThermalPvtTabulation()
+{
+    typedef Ewoms::GasPvtMultiplexer<Scalar> GasPvt;
+    typedef Ewoms::OilPvtMultiplexer<Scalar> OilPvt;
+    typedef Ewoms::GasPvtThermal<Scalar> ThermalGasPvt;
+    typedef Ewoms::OilPvtThermal<Scalar> ThermalOilPvt;
+    typedef typename ThermalGasPvt::TabulatedOneDFunction TabulatedOneDFunction;
+
+    const Scalar rhoRefOil = 800.0;
+    const Scalar rhoRefGas = 1.2;
+    const Scalar rhoRefWater = 1000.0;
+
+    // the kinks of the piecewise linear input curves coincide with sampling points
+    Scalar Tmin = 290.0, Tmax = 440.0;
+    Scalar pmin = 1e6, pmax = 4e7;
+    unsigned nT = 51, np = 196;
+
+    // isothermal parts
+    auto* isoGasPvt = new typename ThermalGasPvt::IsothermalPvt;
+    isoGasPvt->setApproach(ThermalGasPvt::IsothermalPvt::DryGasPvt);
+    auto& dryGasPvt = isoGasPvt->template getRealPvt<ThermalGasPvt::IsothermalPvt::DryGasPvt>();
+    dryGasPvt.setNumRegions(/*numRegions=*/1);
+    dryGasPvt.setReferenceDensities(/*regionIdx=*/0, rhoRefOil, rhoRefGas, rhoRefWater);
+    dryGasPvt.setGasFormationVolumeFactor(/*regionIdx=*/0, {{1e5, 1.0}, {1e7, 1.2e-2}, {5e7, 3e-3}});
+    TabulatedOneDFunction gasMu;
+    gasMu.setXYContainers(std::vector<Scalar>{1e5, 1e7, 5e7},
+                          std::vector<Scalar>{1.2e-5, 1.6e-5, 3e-5});
+    dryGasPvt.setGasViscosity(/*regionIdx=*/0, gasMu);
+    isoGasPvt->initEnd();
+
+    auto* isoOilPvt = new typename ThermalOilPvt::IsothermalPvt;
+    isoOilPvt->setApproach(ThermalOilPvt::IsothermalPvt::ConstantCompressibilityOilPvt);
+    auto& ccOilPvt =
+        isoOilPvt->template getRealPvt<ThermalOilPvt::IsothermalPvt::ConstantCompressibilityOilPvt>();
+    ccOilPvt.setNumRegions(/*numRegions=*/1);
+    ccOilPvt.setReferenceDensities(/*regionIdx=*/0, rhoRefOil, rhoRefGas, rhoRefWater);
+    ccOilPvt.setReferencePressure(/*regionIdx=*/0, 1e5);
+    ccOilPvt.setCompressibility(/*regionIdx=*/0, 1e-9);
+    ccOilPvt.setViscosity(/*regionIdx=*/0, 2e-3);
+    isoOilPvt->initEnd();
+
+    // thermal parts, i.e., the equivalents of GASVISCT, GASDENT, OILVISCT and OILDENT
+    TabulatedOneDFunction gasvisct;
+    gasvisct.setXYContainers(std::vector<Scalar>{280.0, 350.0, 500.0},
+                             std::vector<Scalar>{1.1e-5, 1.4e-5, 2.2e-5});
+    TabulatedOneDFunction oilvisct;
+    oilvisct.setXYContainers(std::vector<Scalar>{280.0, 350.0, 500.0},
+                             std::vector<Scalar>{5e-3, 2e-3, 5e-4});
+    std::vector<TabulatedOneDFunction> internalEnergyCurves(1);
+
+    GasPvt gasPvt;
+    gasPvt.setApproach(GasPvt::ThermalGasPvt);
+    gasPvt.template getRealPvt<GasPvt::ThermalGasPvt>() =
+        ThermalGasPvt(isoGasPvt, {gasvisct}, {288.0}, {4e-3}, {1e-6}, internalEnergyCurves,
+                      /*enableThermalDensity=*/true,
+                      /*enableThermalViscosity=*/true,
+                      /*enableInternalEnergy=*/false);
+
+    OilPvt oilPvt;
+    oilPvt.setApproach(OilPvt::ThermalOilPvt);
+    oilPvt.template getRealPvt<OilPvt::ThermalOilPvt>() =
+        ThermalOilPvt(isoOilPvt, {oilvisct}, {1e5}, {0.0}, {2e-3}, {288.0}, {8e-4}, {1e-6},
+                      internalEnergyCurves,
+                      /*enableThermalDensity=*/true,
+                      /*enableThermalViscosity=*/true,
+                      /*enableInternalEnergy=*/false);
+
+    const GasPvt analyticGasPvt(gasPvt);
+    const OilPvt analyticOilPvt(oilPvt);
+    gasPvt.setThermalTabulationRange(Tmin, Tmax, nT, pmin, pmax, np);
+    oilPvt.setThermalTabulationRange(Tmin, Tmax, nT, pmin, pmax, np);
+
+    const auto& tabGasPvt = gasPvt.template getRealPvt<GasPvt::ThermalGasPvt>();
+    const auto& tabOilPvt = oilPvt.template getRealPvt<OilPvt::ThermalOilPvt>();
+    if (!tabGasPvt.isTabulated() || !tabOilPvt.isTabulated())
+        throw std::logic_error("The thermal PVT relations could not be tabulated via the multiplexers");
+
+    // the viscosity curves are piecewise linear in temperature and the isothermal
+    // properties are piecewise linear in pressure or almost linear, so a moderate number
+    // of sampling points yields small errors
+    Scalar tol = 1e-3;
+    const auto& gasErr = tabGasPvt.tabulationError(/*regionIdx=*/0);
+    const auto& oilErr = tabOilPvt.tabulationError(/*regionIdx=*/0);
+    if (gasErr.viscosity > tol || gasErr.inverseFormationVolumeFactor > tol) {
+        gasErr.print(std::cerr);
+        throw std::logic_error("The tabulated thermal gas PVT properties are too inaccurate");
+    }
+    if (oilErr.viscosity > tol || oilErr.inverseFormationVolumeFactor > tol) {
+        oilErr.print(std::cerr);
+        throw std::logic_error("The tabulated thermal oil PVT properties are too inaccurate");
+    }
+
+    // the values which are returned by the multiplexers must match as well
+    for (Scalar T = Tmin; T < Tmax; T += 7.3) {
+        for (Scalar p = pmin; p < pmax; p += 1.37e6) {
+            Scalar muG = gasPvt.saturatedViscosity(/*regionIdx=*/0, T, p);
+            Scalar bG = gasPvt.saturatedInverseFormationVolumeFactor(/*regionIdx=*/0, T, p);
+            Scalar muO = oilPvt.saturatedViscosity(/*regionIdx=*/0, T, p);
+            Scalar bO = oilPvt.saturatedInverseFormationVolumeFactor(/*regionIdx=*/0, T, p);
+
+            if (std::abs(muG/analyticGasPvt.saturatedViscosity(/*regionIdx=*/0, T, p) - 1) > tol
+                || std::abs(bG/analyticGasPvt.saturatedInverseFormationVolumeFactor(/*regionIdx=*/0, T, p) - 1) > tol
+                || std::abs(muO/analyticOilPvt.saturatedViscosity(/*regionIdx=*/0, T, p) - 1) > tol
+                || std::abs(bO/analyticOilPvt.saturatedInverseFormationVolumeFactor(/*regionIdx=*/0, T, p) - 1) > tol)
+                throw std::logic_error("The tabulated thermal PVT properties do not match the analytic ones");
+        }
+    }
+
+    // outside of the range of the tables, the analytic relations must be used
+    Scalar T = Tmax + 20.0;
+    Scalar p = 2e7;
+    if (gasPvt.saturatedViscosity(/*regionIdx=*/0, T, p) != analyticGasPvt.saturatedViscosity(/*regionIdx=*/0, T, p)
+        || oilPvt.saturatedViscosity(/*regionIdx=*/0, T, p) != analyticOilPvt.saturatedViscosity(/*regionIdx=*/0, T, p))
+        throw std::logic_error("The tabulated thermal PVT properties do not fall back to the "
+                               "analytic ones");
+}
+
+// make sure that the fugacity coefficients of the brine-CO2 fluid system do not depend
+// on whether the solubility context of the parameter cache is up to date
+template <class Scalar>
+void testBrineCo2ParameterCache()
+{
+    typedef Ewoms::BrineCO2FluidSystem<Scalar, Ewoms::CO2DefaultTables::CO2Tables> FluidSystem;
+    typedef Ewoms::DenseAd::Evaluation<Scalar, 2> Evaluation;
+    typedef Ewoms::CompositionalFluidState<Evaluation, FluidSystem> FluidState;
+    typedef typename FluidSystem::template ParameterCache<Evaluation> ParameterCache;
+
+    enum { liquidPhaseIdx = FluidSystem::liquidPhaseIdx };
+    enum { gasPhaseIdx = FluidSystem::gasPhaseIdx };
+
+    FluidState fluidState;
+    ParameterCache updatedParamCache;
+    ParameterCache paramCache;
+    for (Scalar T = 300.0; T < 380.0; T += 20.0) {
+        for (Scalar p = 5e6; p < 5e7; p += 1e7) {
+            fluidState.setTemperature(Evaluation::createVariable(T, 0));
+            fluidState.setPressure(liquidPhaseIdx, Evaluation::createVariable(p, 1));
+            fluidState.setPressure(gasPhaseIdx, Evaluation::createVariable(p, 1));
+            updatedParamCache.updateAll(fluidState);
+            if (!updatedParamCache.solubilityContext().isValid()
+                || !(updatedParamCache.solubilityContext().pressure() == fluidState.pressure(liquidPhaseIdx)))
+                throw std::logic_error("The parameter cache of the brine-CO2 fluid system was not updated");
+
+            // the cache which was never updated is stale
+            for (unsigned compIdx = 0; compIdx < FluidSystem::numComponents; ++compIdx) {
+                const Evaluation& phi =
+                    FluidSystem::fugacityCoefficient(fluidState, updatedParamCache, liquidPhaseIdx, compIdx);
+                const Evaluation& phiRef =
+                    FluidSystem::fugacityCoefficient(fluidState, paramCache, liquidPhaseIdx, compIdx);
+                if (!(phi == phiRef))
+                    throw std::logic_error("The fugacity coefficients of the brine-CO2 fluid system "
+                                           "depend on the parameter cache");
+            }
+        }
+    }
 }
 
 template <class Scalar, class FluidStateEval, class LhsEval>
@@ -242,10 +690,19 @@ void testAllFluidSystems()
     {   typedef Ewoms::BrineCO2FluidSystem<Scalar, Ewoms::CO2DefaultTables::CO2Tables> FluidSystem;
         checkFluidSystem<Scalar, FluidSystem, FluidStateEval, LhsEval>(); }
 
+    {   typedef Ewoms::CO2<Scalar, Ewoms::CO2DefaultTables::CO2Tables> CO2;
+        typedef Ewoms::TabulatedComponent<Scalar, CO2, /*useVaporPressure=*/false> TabulatedCO2;
+        typedef Ewoms::BrineCO2FluidSystem<Scalar, Ewoms::CO2DefaultTables::CO2Tables, TabulatedCO2> FluidSystem;
+        checkFluidSystem<Scalar, FluidSystem, FluidStateEval, LhsEval>(); }
+
     // H2O -- N2
     {   typedef Ewoms::H2ON2FluidSystem<Scalar> FluidSystem;
         checkFluidSystem<Scalar, FluidSystem, FluidStateEval, LhsEval>(); }
 
+    {   typedef Ewoms::TabulatedComponent<Scalar, Ewoms::N2<Scalar>, /*useVaporPressure=*/false> TabulatedN2;
+        typedef Ewoms::H2ON2FluidSystem<Scalar, TabulatedN2> FluidSystem;
+        checkFluidSystem<Scalar, FluidSystem, FluidStateEval, LhsEval>(); }
+
     // H2O -- N2 -- liquid phase
     {   typedef Ewoms::H2ON2LiquidPhaseFluidSystem<Scalar> FluidSystem;
         checkFluidSystem<Scalar, FluidSystem, FluidStateEval, LhsEval>(); }
@@ -259,6 +716,11 @@ void testAllFluidSystems()
     {   typedef Ewoms::H2OAirMesityleneFluidSystem<Scalar> FluidSystem;
         checkFluidSystem<Scalar, FluidSystem, FluidStateEval, LhsEval>(); }
 
+    {   typedef Ewoms::TabulatedComponent<Scalar, Ewoms::Air<Scalar>, /*useVaporPressure=*/false> TabulatedAir;
+        typedef Ewoms::TabulatedComponent<Scalar, Ewoms::Mesitylene<Scalar> > TabulatedMesitylene;
+        typedef Ewoms::H2OAirMesityleneFluidSystem<Scalar, TabulatedAir, TabulatedMesitylene> FluidSystem;
+        checkFluidSystem<Scalar, FluidSystem, FluidStateEval, LhsEval>(); }
+
     // H2O -- Air -- Xylene
     {   typedef Ewoms::H2OAirXyleneFluidSystem<Scalar> FluidSystem;
         checkFluidSystem<Scalar, FluidSystem, FluidStateEval, LhsEval>(); }
@@ -289,6 +751,12 @@ inline void testAll()
     // ensure that all fluid states are API-compliant
     testAllFluidStates<Scalar>();
     testAllFluidStates<Evaluation>();
+    testSoaFluidStateContainer<Scalar>();
+    testOverlayFluidState<Scalar>();
+    testTabulatedBinaryCoeff<Scalar>();
+    testClampedTabulatedBinaryCoeff<Scalar>();
+    testThermalPvtTabulation<Scalar>();
+    testBrineCo2ParameterCache<Scalar>();
 
     // ensure that all fluid systems are API-compliant: Each fluid system must be usable
     // for both, scalars and function evaluations. The fluid systems for function
@@ -32,6 +32,7 @@
 #include <ewoms/material/constraintsolvers/misciblemultiphasecomposition.hh>
 #include <ewoms/material/constraintsolvers/computefromreferencephase.hh>
 #include <ewoms/material/constraintsolvers/immiscibleflash.hh>
+#include <ewoms/material/constraintsolvers/flashcache.hh>
 
 #include <ewoms/material/fluidstates/immisciblefluidstate.hh>
 
@@ -45,6 +46,7 @@
 #include <dune/common/parallel/mpihelper.hh>
 
 #include <sstream>
+#include <stdexcept>
 
 template <class Scalar, class FluidState>
 void checkSame(const FluidState& fsRef, const FluidState& fsFlash)
@@ -128,6 +130,55 @@ void checkImmiscibleFlash(const FluidState& fsRef,
     checkSame<Scalar>(fsRef, fsFlash);
 }
 
+template <class Scalar, class FluidSystem, class MaterialLaw, class FluidState>
+void checkFlashCache(const FluidState& fsRef,
+                     typename MaterialLaw::Params& matParams)
+{
+    enum { numPhases = FluidSystem::numPhases };
+    enum { numComponents = FluidSystem::numComponents };
+    typedef Dune::FieldVector<Scalar, numComponents> ComponentVector;
+    typedef Ewoms::ImmiscibleFlash<Scalar, FluidSystem> ImmiscibleFlash;
+    typedef Ewoms::FlashCache<Scalar, FluidSystem, FluidState> FlashCache;
+
+    ComponentVector globalMolarities(0.0);
+    for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx) {
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+            globalMolarities[compIdx] +=
+                fsRef.saturation(phaseIdx)*fsRef.molarity(phaseIdx, compIdx);
+        }
+    }
+
+    FlashCache flashCache(/*numCells=*/1, /*skipTolerance=*/1e-5);
+    typename FluidSystem::template ParameterCache<typename FluidState::Scalar> paramCache;
+
+    // cold start, skipped flash and warm start. only a skipped flash calculation
+    // reports zero iterations.
+    FluidState fsFlash;
+    fsFlash.setTemperature(fsRef.temperature(/*phaseIdx=*/0));
+    unsigned numIterations =
+        flashCache.template solve<ImmiscibleFlash, MaterialLaw>(/*cellIdx=*/0, fsFlash, matParams, paramCache, globalMolarities);
+    checkSame<Scalar>(fsRef, fsFlash);
+    if (numIterations == 0)
+        throw std::logic_error("The flash calculation of a cold start was reported as skipped");
+
+    fsFlash = FluidState();
+    fsFlash.setTemperature(fsRef.temperature(/*phaseIdx=*/0));
+    numIterations =
+        flashCache.template solve<ImmiscibleFlash, MaterialLaw>(/*cellIdx=*/0, fsFlash, matParams, paramCache, globalMolarities);
+    checkSame<Scalar>(fsRef, fsFlash);
+    if (numIterations != 0)
+        throw std::logic_error("The flash calculation was expected to be skipped");
+
+    globalMolarities *= 1.001;
+    fsFlash = FluidState();
+    fsFlash.setTemperature(fsRef.temperature(/*phaseIdx=*/0));
+    flashCache.template solve<ImmiscibleFlash, MaterialLaw>(/*cellIdx=*/0, fsFlash, matParams, paramCache, globalMolarities);
+
+    const auto& stats = flashCache.statistics();
+    if (stats.numColdStarts != 1 || stats.numSkipped != 1 || stats.numWarmStarts != 1)
+        throw std::logic_error("Unexpected statistics of the flash cache");
+}
+
 template <class Scalar, class FluidSystem, class MaterialLaw, class FluidState>
 void completeReferenceFluidState(FluidState& fs,
                                  typename MaterialLaw::Params& matParams,
@@ -273,6 +324,7 @@ inline void testAll()
 
     // check the flash calculation
     checkImmiscibleFlash<Scalar, FluidSystem, MaterialLaw>(fsRef, matParams2);
+    checkFlashCache<Scalar, FluidSystem, MaterialLaw>(fsRef, matParams2);
 }
 
 int main(int argc, char **argv)
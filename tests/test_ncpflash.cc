@@ -29,6 +29,8 @@
 #include "config.h"
 
 #include <ewoms/material/constraintsolvers/ncpflash.hh>
+#include <ewoms/material/constraintsolvers/rachfordriceflash.hh>
+#include <ewoms/material/constraintsolvers/flashcache.hh>
 #include <ewoms/material/constraintsolvers/misciblemultiphasecomposition.hh>
 #include <ewoms/material/constraintsolvers/computefromreferencephase.hh>
 
@@ -43,6 +45,10 @@
 
 #include <dune/common/parallel/mpihelper.hh>
 
+#include <chrono>
+#include <stdexcept>
+#include <iostream>
+
 template <class Scalar, class FluidState>
 void checkSame(const FluidState& fsRef, const FluidState& fsFlash)
 {
@@ -91,18 +97,16 @@ void checkSame(const FluidState& fsRef, const FluidState& fsFlash)
     }
 }
 
-template <class Scalar, class FluidSystem, class MaterialLaw, class FluidState>
-void checkNcpFlash(const FluidState& fsRef,
-                   typename MaterialLaw::Params& matParams)
+template <class Scalar, class FluidSystem, class FluidState>
+Dune::FieldVector<Scalar, FluidSystem::numComponents>
+computeGlobalMolarities(const FluidState& fsRef)
 {
     enum { numPhases = FluidSystem::numPhases };
     enum { numComponents = FluidSystem::numComponents };
-    typedef Dune::FieldVector<Scalar, numComponents> ComponentVector;
-    typedef typename FluidSystem::template ParameterCache<typename FluidState::Scalar> ParameterCache;
 
     // calculate the total amount of stuff in the reference fluid
     // phase
-    ComponentVector globalMolarities(0.0);
+    Dune::FieldVector<Scalar, numComponents> globalMolarities(0.0);
     for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx) {
         for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
             globalMolarities[compIdx] +=
@@ -110,8 +114,18 @@ void checkNcpFlash(const FluidState& fsRef,
         }
     }
 
+    return globalMolarities;
+}
+
+template <class Scalar, class FluidSystem, class Flash, class MaterialLaw, class FluidState>
+void checkFlash(const FluidState& fsRef,
+                typename MaterialLaw::Params& matParams)
+{
+    typedef typename FluidSystem::template ParameterCache<typename FluidState::Scalar> ParameterCache;
+
+    const auto& globalMolarities = computeGlobalMolarities<Scalar, FluidSystem>(fsRef);
+
     // initialize the fluid state for the flash calculation
-    typedef Ewoms::NcpFlash<Scalar, FluidSystem> NcpFlash;
     FluidState fsFlash;
 
     fsFlash.setTemperature(fsRef.temperature(/*phaseIdx=*/0));
@@ -119,13 +133,105 @@ void checkNcpFlash(const FluidState& fsRef,
     // run the flash calculation
     ParameterCache paramCache;
     paramCache.updateAll(fsFlash);
-    NcpFlash::guessInitial(fsFlash, globalMolarities);
-    NcpFlash::template solve<MaterialLaw>(fsFlash, matParams, paramCache, globalMolarities);
+    Flash::guessInitial(fsFlash, globalMolarities);
+    Flash::template solve<MaterialLaw>(fsFlash, matParams, paramCache, globalMolarities);
 
     // compare the "flashed" fluid state with the reference one
     checkSame<Scalar>(fsRef, fsFlash);
 }
 
+template <class Scalar, class FluidSystem, class Flash, class MaterialLaw, class FluidState>
+void checkFlashCache(const FluidState& fsRef,
+                     typename MaterialLaw::Params& matParams)
+{
+    typedef typename FluidSystem::template ParameterCache<typename FluidState::Scalar> ParameterCache;
+    typedef Ewoms::FlashCache<Scalar, FluidSystem, FluidState> FlashCache;
+
+    auto globalMolarities = computeGlobalMolarities<Scalar, FluidSystem>(fsRef);
+
+    FlashCache flashCache(/*numCells=*/1, /*skipTolerance=*/1e-5);
+    ParameterCache paramCache;
+
+    // the first flash calculation must start from scratch
+    FluidState fsFlash;
+    fsFlash.setTemperature(fsRef.temperature(/*phaseIdx=*/0));
+    paramCache.updateAll(fsFlash);
+    unsigned coldIterations =
+        flashCache.template solve<Flash, MaterialLaw>(/*cellIdx=*/0, fsFlash, matParams, paramCache, globalMolarities);
+    checkSame<Scalar>(fsRef, fsFlash);
+
+    // the second one is skipped because nothing changed
+    fsFlash = FluidState();
+    fsFlash.setTemperature(fsRef.temperature(/*phaseIdx=*/0));
+    if (flashCache.template solve<Flash, MaterialLaw>(/*cellIdx=*/0, fsFlash, matParams, paramCache, globalMolarities) != 0)
+        throw std::logic_error("Unchanged flash calculation was not skipped");
+    checkSame<Scalar>(fsRef, fsFlash);
+
+    // the third one is warm-started from the cached result
+    for (unsigned compIdx = 0; compIdx < FluidSystem::numComponents; ++compIdx)
+        globalMolarities[compIdx] *= 1.0 + 1e-3*(compIdx + 1);
+    fsFlash = FluidState();
+    fsFlash.setTemperature(fsRef.temperature(/*phaseIdx=*/0));
+    unsigned warmIterations =
+        flashCache.template solve<Flash, MaterialLaw>(/*cellIdx=*/0, fsFlash, matParams, paramCache, globalMolarities);
+
+    const auto& stats = flashCache.statistics();
+    if (stats.numColdStarts != 1 || stats.numSkipped != 1 || stats.numWarmStarts != 1)
+        throw std::logic_error("Unexpected statistics of the flash cache");
+    if (warmIterations > coldIterations)
+        throw std::logic_error("Warm-started flash calculation needed more iterations than a cold one");
+
+    stats.print(std::cout);
+}
+
+template <class Scalar, class FluidSystem, class Flash, class MaterialLaw, class FluidState>
+double timeFlash(const FluidState& fsRef,
+                 typename MaterialLaw::Params& matParams,
+                 unsigned numRuns)
+{
+    typedef typename FluidSystem::template ParameterCache<typename FluidState::Scalar> ParameterCache;
+
+    const auto& globalMolarities = computeGlobalMolarities<Scalar, FluidSystem>(fsRef);
+
+    auto startTime = std::chrono::steady_clock::now();
+    for (unsigned runIdx = 0; runIdx < numRuns; ++runIdx) {
+        FluidState fsFlash;
+        fsFlash.setTemperature(fsRef.temperature(/*phaseIdx=*/0));
+
+        ParameterCache paramCache;
+        paramCache.updateAll(fsFlash);
+        Flash::guessInitial(fsFlash, globalMolarities);
+        Flash::template solve<MaterialLaw>(fsFlash, matParams, paramCache, globalMolarities);
+    }
+    auto endTime = std::chrono::steady_clock::now();
+
+    // return the average time per flash in microseconds
+    return std::chrono::duration<double, std::micro>(endTime - startTime).count()/numRuns;
+}
+
+template <class Scalar, class FluidSystem, class MaterialLaw, class FluidState>
+void checkNcpFlash(const FluidState& fsRef,
+                   typename MaterialLaw::Params& matParams)
+{
+    typedef Ewoms::NcpFlash<Scalar, FluidSystem> NcpFlash;
+    typedef Ewoms::RachfordRiceFlash<Scalar, FluidSystem> RachfordRiceFlash;
+
+    checkFlash<Scalar, FluidSystem, NcpFlash, MaterialLaw>(fsRef, matParams);
+    checkFlashCache<Scalar, FluidSystem, NcpFlash, MaterialLaw>(fsRef, matParams);
+
+    // the reduced-variable flash must yield the same result
+    checkFlash<Scalar, FluidSystem, RachfordRiceFlash, MaterialLaw>(fsRef, matParams);
+
+    // compare the performance of both solvers
+    const unsigned numRuns = 100;
+    double ncpTime = timeFlash<Scalar, FluidSystem, NcpFlash, MaterialLaw>(fsRef, matParams, numRuns);
+    double rrTime = timeFlash<Scalar, FluidSystem, RachfordRiceFlash, MaterialLaw>(fsRef, matParams, numRuns);
+    std::cout << "NcpFlash: " << ncpTime << " us/flash, "
+              << "RachfordRiceFlash: " << rrTime << " us/flash "
+              << "(S_gas = " << fsRef.saturation(FluidSystem::gasPhaseIdx)
+              << ", sizeof(Scalar) = " << sizeof(Scalar) << ")\n";
+}
+
 template <class Scalar, class FluidSystem, class MaterialLaw, class FluidState>
 void completeReferenceFluidState(FluidState& fs,
                                  typename MaterialLaw::Params& matParams,
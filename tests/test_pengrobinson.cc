@@ -20,20 +20,237 @@
  * \file
  *
  * \brief This is test for the SPE5 fluid system (which uses the
- *        Peng-Robinson EOS) and the NCP flash solver.
+ *        Peng-Robinson EOS), the NCP flash solver and the Rachford-Rice flash
+ *        solver.
  */
 #include "config.h"
 
 #include <ewoms/common/densead/evaluation.hh>
 #include <ewoms/material/constraintsolvers/computefromreferencephase.hh>
+#include <ewoms/material/constraintsolvers/batchedcompositionfromfugacities.hh>
 #include <ewoms/material/constraintsolvers/ncpflash.hh>
+#include <ewoms/material/constraintsolvers/rachfordriceflash.hh>
 #include <ewoms/material/fluidstates/compositionalfluidstate.hh>
 #include <ewoms/material/fluidsystems/spe5fluidsystem.hh>
 #include <ewoms/material/fluidmatrixinteractions/linearmaterial.hh>
+#include <ewoms/material/fluidmatrixinteractions/nullmaterial.hh>
 #include <ewoms/material/fluidmatrixinteractions/materialtraits.hh>
 
 #include <dune/common/parallel/mpihelper.hh>
 
+#include <array>
+#include <chrono>
+#include <iostream>
+#include <sstream>
+
+/*!
+ * \brief The parameter cache of the hydrocarbon part of the SPE-5 fluid system.
+ *
+ * This corresponds to Ewoms::Spe5ParameterCache, but it does not know a water phase.
+ */
+template <class Scalar, class FluidSystem>
+class Spe5HydrocarbonParameterCache
+    : public Ewoms::ParameterCacheBase<Spe5HydrocarbonParameterCache<Scalar, FluidSystem> >
+{
+    typedef Spe5HydrocarbonParameterCache<Scalar, FluidSystem> ThisType;
+    typedef Ewoms::ParameterCacheBase<ThisType> ParentType;
+
+    typedef Ewoms::PengRobinson<Scalar> PengRobinson;
+
+    enum { numPhases = FluidSystem::numPhases };
+    enum { oilPhaseIdx = FluidSystem::oilPhaseIdx };
+    enum { gasPhaseIdx = FluidSystem::gasPhaseIdx };
+
+public:
+    typedef Ewoms::PengRobinsonParamsMixture<Scalar, FluidSystem, oilPhaseIdx, /*useSpe5=*/true> OilPhaseParams;
+    typedef Ewoms::PengRobinsonParamsMixture<Scalar, FluidSystem, gasPhaseIdx, /*useSpe5=*/true> GasPhaseParams;
+
+    Spe5HydrocarbonParameterCache()
+    {
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx)
+            VmUpToDate_[phaseIdx] = false;
+    }
+
+    template <class FluidState>
+    void updatePhase(const FluidState& fluidState,
+                     unsigned phaseIdx,
+                     int exceptQuantities = ParentType::None)
+    {
+        if (phaseIdx == gasPhaseIdx)
+            updatePhaseParams_(gasPhaseParams_, fluidState, phaseIdx, exceptQuantities);
+        else
+            updatePhaseParams_(oilPhaseParams_, fluidState, phaseIdx, exceptQuantities);
+
+        const int allQuantities = ParentType::Temperature | ParentType::Pressure | ParentType::Composition;
+        if (exceptQuantities != allQuantities || !VmUpToDate_[phaseIdx])
+            updateMolarVolume_(fluidState, phaseIdx);
+    }
+
+    template <class FluidState>
+    void updateSingleMoleFraction(const FluidState& fluidState,
+                                  unsigned phaseIdx,
+                                  unsigned compIdx)
+    {
+        if (phaseIdx == gasPhaseIdx)
+            gasPhaseParams_.updateSingleMoleFraction(fluidState, compIdx);
+        else
+            oilPhaseParams_.updateSingleMoleFraction(fluidState, compIdx);
+
+        updateMolarVolume_(fluidState, phaseIdx);
+    }
+
+    Scalar a(unsigned phaseIdx) const
+    { return (phaseIdx == gasPhaseIdx) ? gasPhaseParams_.a() : oilPhaseParams_.a(); }
+
+    Scalar b(unsigned phaseIdx) const
+    { return (phaseIdx == gasPhaseIdx) ? gasPhaseParams_.b() : oilPhaseParams_.b(); }
+
+    Scalar aPure(unsigned phaseIdx, unsigned compIdx) const
+    {
+        return (phaseIdx == gasPhaseIdx)
+            ? gasPhaseParams_.pureParams(compIdx).a()
+            : oilPhaseParams_.pureParams(compIdx).a();
+    }
+
+    Scalar bPure(unsigned phaseIdx, unsigned compIdx) const
+    {
+        return (phaseIdx == gasPhaseIdx)
+            ? gasPhaseParams_.pureParams(compIdx).b()
+            : oilPhaseParams_.pureParams(compIdx).b();
+    }
+
+    Scalar molarVolume(unsigned phaseIdx) const
+    { assert(VmUpToDate_[phaseIdx]); return Vm_[phaseIdx]; }
+
+private:
+    template <class PhaseParams, class FluidState>
+    static void updatePhaseParams_(PhaseParams& params,
+                                   const FluidState& fluidState,
+                                   unsigned phaseIdx,
+                                   int exceptQuantities)
+    {
+        if (!(exceptQuantities & ParentType::Temperature)) {
+            Scalar T = fluidState.temperature(phaseIdx);
+            Scalar p = fluidState.pressure(phaseIdx);
+            params.updatePure(T, p);
+            params.updateMix(fluidState);
+        }
+        else if (!(exceptQuantities & ParentType::Composition))
+            params.updateMix(fluidState);
+    }
+
+    template <class FluidState>
+    void updateMolarVolume_(const FluidState& fluidState, unsigned phaseIdx)
+    {
+        Vm_[phaseIdx] =
+            PengRobinson::computeMolarVolume(fluidState,
+                                             *this,
+                                             phaseIdx,
+                                             /*isGasPhase=*/phaseIdx == gasPhaseIdx);
+        VmUpToDate_[phaseIdx] = true;
+    }
+
+    bool VmUpToDate_[numPhases];
+    Scalar Vm_[numPhases];
+
+    OilPhaseParams oilPhaseParams_;
+    GasPhaseParams gasPhaseParams_;
+};
+
+/*!
+ * \brief The hydrocarbon part of the SPE-5 fluid system.
+ *
+ * I.e., the gas and oil phases and the six hydrocarbon components of the SPE-5 fluid
+ * system without water. This allows to apply flash solvers which are restricted to two
+ * fluid phases to a mixture with more than a handful of components.
+ */
+template <class Scalar>
+class Spe5HydrocarbonFluidSystem
+    : public Ewoms::BaseFluidSystem<Scalar, Spe5HydrocarbonFluidSystem<Scalar> >
+{
+    typedef Spe5HydrocarbonFluidSystem<Scalar> ThisType;
+    typedef Ewoms::Spe5FluidSystem<Scalar> Spe5FluidSystem;
+    typedef Ewoms::PengRobinsonMixture<Scalar, ThisType> PengRobinsonMixture;
+
+    // the index of a component in the SPE-5 fluid system
+    static unsigned spe5CompIdx_(unsigned compIdx)
+    { return compIdx + 1; }
+
+public:
+    template <class Evaluation>
+    struct ParameterCache : public Spe5HydrocarbonParameterCache<Evaluation, ThisType>
+    {};
+
+    static const int numPhases = 2;
+    static const int gasPhaseIdx = 0;
+    static const int oilPhaseIdx = 1;
+
+    static const int numComponents = 6;
+    static const int C1Idx = 0;
+    static const int C3Idx = 1;
+    static const int C6Idx = 2;
+    static const int C10Idx = 3;
+    static const int C15Idx = 4;
+    static const int C20Idx = 5;
+
+    static const char* phaseName(unsigned phaseIdx)
+    { return (phaseIdx == gasPhaseIdx)?"gas":"oil"; }
+
+    static bool isLiquid(unsigned phaseIdx)
+    { return phaseIdx != gasPhaseIdx; }
+
+    static bool isCompressible(unsigned /*phaseIdx*/)
+    { return true; }
+
+    static bool isIdealGas(unsigned /*phaseIdx*/)
+    { return false; }
+
+    static bool isIdealMixture(unsigned /*phaseIdx*/)
+    { return false; }
+
+    static const char* componentName(unsigned compIdx)
+    { return Spe5FluidSystem::componentName(spe5CompIdx_(compIdx)); }
+
+    static Scalar molarMass(unsigned compIdx)
+    { return Spe5FluidSystem::molarMass(spe5CompIdx_(compIdx)); }
+
+    static Scalar criticalTemperature(unsigned compIdx)
+    { return Spe5FluidSystem::criticalTemperature(spe5CompIdx_(compIdx)); }
+
+    static Scalar criticalPressure(unsigned compIdx)
+    { return Spe5FluidSystem::criticalPressure(spe5CompIdx_(compIdx)); }
+
+    static Scalar criticalMolarVolume(unsigned compIdx)
+    { return Spe5FluidSystem::criticalMolarVolume(spe5CompIdx_(compIdx)); }
+
+    static Scalar acentricFactor(unsigned compIdx)
+    { return Spe5FluidSystem::acentricFactor(spe5CompIdx_(compIdx)); }
+
+    static Scalar interactionCoefficient(unsigned comp1Idx, unsigned comp2Idx)
+    { return Spe5FluidSystem::interactionCoefficient(spe5CompIdx_(comp1Idx), spe5CompIdx_(comp2Idx)); }
+
+    static void init(Scalar minT, Scalar maxT, Scalar minP, Scalar maxP)
+    { Spe5FluidSystem::init(minT, maxT, minP, maxP); }
+
+    template <class FluidState, class LhsEval = typename FluidState::Scalar, class ParamCacheEval = LhsEval>
+    static LhsEval density(const FluidState& fluidState,
+                           const ParameterCache<ParamCacheEval>& paramCache,
+                           unsigned phaseIdx)
+    { return fluidState.averageMolarMass(phaseIdx)/paramCache.molarVolume(phaseIdx); }
+
+    template <class FluidState, class LhsEval = typename FluidState::Scalar, class ParamCacheEval = LhsEval>
+    static LhsEval fugacityCoefficient(const FluidState& fluidState,
+                                       const ParameterCache<ParamCacheEval>& paramCache,
+                                       unsigned phaseIdx,
+                                       unsigned compIdx)
+    {
+        return PengRobinsonMixture::computeFugacityCoefficient(fluidState,
+                                                               paramCache,
+                                                               phaseIdx,
+                                                               compIdx);
+    }
+};
+
 template <class FluidSystem, class FluidState>
 void createSurfaceGasFluidSystem(FluidState& gasFluidState)
 {
@@ -249,6 +466,69 @@ Scalar bringOilToSurface(FluidState& surfaceFluidState, Scalar alpha, const Flui
     return alpha;
 }
 
+template <class Scalar, class FluidSystem, class FluidState>
+void checkBatchedCompositionFromFugacities(const FluidState& refFluidState)
+{
+    enum {
+        gasPhaseIdx = FluidSystem::gasPhaseIdx,
+        oilPhaseIdx = FluidSystem::oilPhaseIdx,
+        numPhases = FluidSystem::numPhases,
+        numComponents = FluidSystem::numComponents
+    };
+
+    typedef typename FluidSystem::template ParameterCache<Scalar> ParameterCache;
+    typedef Ewoms::CompositionFromFugacities<Scalar, FluidSystem> CompositionFromFugacities;
+    typedef Ewoms::BatchedCompositionFromFugacities<Scalar, FluidSystem> BatchedCompositionFromFugacities;
+    typedef typename CompositionFromFugacities::ComponentVector ComponentVector;
+
+    // compute the composition of the gas phase which is in equilibrium with the
+    // reservoir oil for a range of pressures, cell by cell and for all cells at once
+    const unsigned numCells = 50;
+    std::vector<FluidState> fluidStates(numCells);
+    std::vector<ParameterCache> paramCaches(numCells);
+    std::vector<ComponentVector> targetFugacities(numCells);
+    for (unsigned cellIdx = 0; cellIdx < numCells; ++cellIdx) {
+        FluidState& fs = fluidStates[cellIdx];
+        fs.assign(refFluidState);
+        Scalar p = refFluidState.pressure(oilPhaseIdx)*(1.0 - 0.5*cellIdx/numCells);
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx)
+            fs.setPressure(phaseIdx, p);
+
+        ParameterCache& paramCache = paramCaches[cellIdx];
+        paramCache.updateAll(fs);
+        for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx) {
+            Scalar phi = FluidSystem::fugacityCoefficient(fs, paramCache, oilPhaseIdx, compIdx);
+            targetFugacities[cellIdx][compIdx] = phi*fs.moleFraction(oilPhaseIdx, compIdx)*p;
+        }
+
+        guessInitial<FluidSystem>(fs, gasPhaseIdx);
+        paramCache.updateAll(fs);
+    }
+
+    std::vector<FluidState> refFluidStates(fluidStates);
+    std::vector<ParameterCache> refParamCaches(paramCaches);
+    for (unsigned cellIdx = 0; cellIdx < numCells; ++cellIdx)
+        CompositionFromFugacities::solve(refFluidStates[cellIdx],
+                                         refParamCaches[cellIdx],
+                                         gasPhaseIdx,
+                                         targetFugacities[cellIdx]);
+
+    BatchedCompositionFromFugacities::solve(fluidStates, paramCaches, gasPhaseIdx, targetFugacities);
+
+    for (unsigned cellIdx = 0; cellIdx < numCells; ++cellIdx) {
+        for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx) {
+            Scalar xRef = refFluidStates[cellIdx].moleFraction(gasPhaseIdx, compIdx);
+            Scalar x = fluidStates[cellIdx].moleFraction(gasPhaseIdx, compIdx);
+            if (std::abs(x - xRef) > 1e-10) {
+                std::ostringstream oss;
+                oss << "Batched composition from fugacities differs from the one of a single cell: "
+                    << "cell " << cellIdx << ", component " << compIdx << ": " << x << " vs. " << xRef;
+                throw std::runtime_error(oss.str());
+            }
+        }
+    }
+}
+
 template <class RawTable>
 void printResult(const RawTable& rawTable,
                  const std::string& fieldName,
@@ -285,6 +565,140 @@ void printResult(const RawTable& rawTable,
     std::cout << "};\n";
 }
 
+// make sure that the Rachford-Rice flash yields the same results as the NCP flash for
+// the six-component hydrocarbon mixture of SPE-5 and compare the performance of both
+// solvers. the reservoir oil is expanded at constant temperature, i.e., the mixture is
+// single-phase oil at first and gas evolves as it is expanded further.
+template <class Scalar>
+void checkRachfordRiceFlash()
+{
+    typedef Spe5HydrocarbonFluidSystem<Scalar> FluidSystem;
+
+    enum {
+        numPhases = FluidSystem::numPhases,
+        gasPhaseIdx = FluidSystem::gasPhaseIdx,
+        oilPhaseIdx = FluidSystem::oilPhaseIdx,
+        numComponents = FluidSystem::numComponents
+    };
+
+    typedef Ewoms::NcpFlash<Scalar, FluidSystem> NcpFlash;
+    typedef Ewoms::RachfordRiceFlash<Scalar, FluidSystem> RachfordRiceFlash;
+    typedef Dune::FieldVector<Scalar, numComponents> ComponentVector;
+    typedef Ewoms::CompositionalFluidState<Scalar, FluidSystem> FluidState;
+    typedef typename FluidSystem::template ParameterCache<Scalar> ParameterCache;
+
+    typedef Ewoms::NullMaterialTraits<Scalar, numPhases> MaterialTraits;
+    typedef Ewoms::NullMaterial<MaterialTraits> MaterialLaw;
+    typedef typename MaterialLaw::Params MaterialLawParams;
+
+    MaterialLawParams matParams;
+
+    Scalar T = 273.15 + 20;
+    FluidSystem::init(/*minTemperature=*/T - 1,
+                      /*maxTemperature=*/T + 1,
+                      /*minPressure=*/1.0e4,
+                      /*maxPressure=*/40.0e6);
+
+    // SPE-5 reservoir oil at 4000 PSI
+    FluidState reservoirFluidState;
+    reservoirFluidState.setTemperature(T);
+    std::array<Scalar, numComponents> z = {{ 0.50, 0.03, 0.07, 0.20, 0.15, 0.05 }};
+    for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+        reservoirFluidState.setPressure(phaseIdx, 4000 * 6894.7573);
+        reservoirFluidState.setSaturation(phaseIdx, (phaseIdx == oilPhaseIdx)?1.0:0.0);
+        for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx)
+            reservoirFluidState.setMoleFraction(phaseIdx, compIdx, z[compIdx]);
+    }
+    ParameterCache paramCache;
+    paramCache.updateAll(reservoirFluidState);
+    for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+        reservoirFluidState.setDensity(phaseIdx, FluidSystem::density(reservoirFluidState, paramCache, phaseIdx));
+        for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx)
+            reservoirFluidState.setFugacityCoefficient(phaseIdx, compIdx,
+                                                       FluidSystem::fugacityCoefficient(reservoirFluidState,
+                                                                                        paramCache,
+                                                                                        phaseIdx,
+                                                                                        compIdx));
+    }
+
+    ComponentVector reservoirMolarities;
+    for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx)
+        reservoirMolarities[compIdx] = reservoirFluidState.molarity(oilPhaseIdx, compIdx);
+
+    const std::array<Scalar, 7> alphas = {{ 1.0, 1.05, 1.1, 1.2, 1.5, 2.0, 3.0 }};
+    const unsigned numRuns = 20;
+    double ncpTime = 0.0;
+    double rrTime = 0.0;
+    FluidState initialFluidState;
+    initialFluidState.assign(reservoirFluidState);
+    for (Scalar alpha : alphas) {
+        ComponentVector molarities = reservoirMolarities;
+        molarities /= alpha;
+
+        // both solvers start at the result of the previous expansion step
+        FluidState ncpFluidState, rrFluidState;
+        ParameterCache ncpParamCache, rrParamCache;
+        auto startTime = std::chrono::steady_clock::now();
+        for (unsigned runIdx = 0; runIdx < numRuns; ++runIdx) {
+            ncpFluidState.assign(initialFluidState);
+            ncpParamCache.updateAll(ncpFluidState);
+            NcpFlash::template solve<MaterialLaw>(ncpFluidState, matParams, ncpParamCache, molarities);
+        }
+        auto midTime = std::chrono::steady_clock::now();
+        for (unsigned runIdx = 0; runIdx < numRuns; ++runIdx) {
+            rrFluidState.assign(initialFluidState);
+            rrParamCache.updateAll(rrFluidState);
+            RachfordRiceFlash::template solve<MaterialLaw>(rrFluidState, matParams, rrParamCache, molarities);
+        }
+        auto endTime = std::chrono::steady_clock::now();
+        ncpTime += std::chrono::duration<double, std::micro>(midTime - startTime).count()/numRuns;
+        rrTime += std::chrono::duration<double, std::micro>(endTime - midTime).count()/numRuns;
+
+        Scalar p = ncpFluidState.pressure(oilPhaseIdx);
+        if (std::abs(rrFluidState.pressure(oilPhaseIdx) - p) > 1e-5*p) {
+            std::ostringstream oss;
+            oss << "The Rachford-Rice flash yields a different pressure than the NCP flash: "
+                << rrFluidState.pressure(oilPhaseIdx) << " vs. " << p << " (alpha = " << alpha << ")";
+            throw std::runtime_error(oss.str());
+        }
+
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+            Scalar S = ncpFluidState.saturation(phaseIdx);
+            if (std::abs(rrFluidState.saturation(phaseIdx) - S) > 1e-5) {
+                std::ostringstream oss;
+                oss << "The Rachford-Rice flash yields a different saturation than the NCP flash: "
+                    << rrFluidState.saturation(phaseIdx) << " vs. " << S
+                    << " (phase " << phaseIdx << ", alpha = " << alpha << ")";
+                throw std::runtime_error(oss.str());
+            }
+
+            // the composition of a phase which is not present is not unique
+            if (S < 1e-5)
+                continue;
+
+            for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx) {
+                Scalar x = ncpFluidState.moleFraction(phaseIdx, compIdx);
+                if (std::abs(rrFluidState.moleFraction(phaseIdx, compIdx) - x) > 1e-5) {
+                    std::ostringstream oss;
+                    oss << "The Rachford-Rice flash yields a different composition than the NCP flash: "
+                        << rrFluidState.moleFraction(phaseIdx, compIdx) << " vs. " << x
+                        << " (phase " << phaseIdx << ", component " << compIdx << ", alpha = " << alpha << ")";
+                    throw std::runtime_error(oss.str());
+                }
+            }
+        }
+
+        std::cout << "SPE-5 hydrocarbons, alpha = " << alpha
+                  << ": p = " << p << " Pa, S_gas = " << ncpFluidState.saturation(gasPhaseIdx) << "\n";
+
+        initialFluidState.assign(ncpFluidState);
+    }
+
+    std::cout << "SPE-5 hydrocarbons (" << numComponents << " components): "
+              << "NcpFlash: " << ncpTime/alphas.size() << " us/flash, "
+              << "RachfordRiceFlash: " << rrTime/alphas.size() << " us/flash\n";
+}
+
 template <class Scalar>
 inline void testAll()
 {
@@ -383,6 +797,8 @@ inline void testAll()
                 /*setViscosity=*/false,
                 /*setEnthalpy=*/false);
 
+    checkBatchedCompositionFromFugacities<Scalar, FluidSystem>(fluidState);
+
     ////////////
     // Calculate the total molarities of the components
     ////////////
@@ -478,6 +894,7 @@ int main(int argc, char **argv)
     Dune::MPIHelper::instance(argc, argv);
 
     testAll<double>();
+    checkRachfordRiceFlash<double>();
 
     // the Peng-Robinson test currently does not work with single-precision floating
     // point scalars because of precision issues. (these are caused by the fact that the